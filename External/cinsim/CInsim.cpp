@@ -1419,7 +1419,7 @@ bool expand_prefix(const char *prefix, char *expanded_prefix, size_t size)
         }
         else // mod
         {
-            sprintf_s(expanded_prefix, size, "%06X", *(unsigned *)prefix); // regard the prefix as an unsigned integer and expand it as a 6-digit hexadecimal string
+            snprintf(expanded_prefix, size, "%06X", *(unsigned *)prefix); // regard the prefix as an unsigned integer and expand it as a 6-digit hexadecimal string
         }
 
         return true;
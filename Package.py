@@ -57,12 +57,15 @@ zf = zipfile.ZipFile(".\\Releases\\" + zipName, "w")
 zf.write(".\\LICENSE.txt")
 zf.write(".\\Docs\\README.txt", "README.txt")
 zf.write(".\\Bin\\x64\\Release\\SliProSuperPro.exe", "SliProSuperPro.exe")
+zf.write(".\\Bin\\x64\\Release\\SliProSuperPro.PluginHost.exe", "SliProSuperPro.PluginHost.exe")
 zf.write(".\\Bin\\x64\\Release\\RBR-NGP.Plugin.dll", "RBR-NGP.Plugin.dll")
 zf.write(".\\Bin\\x64\\Release\\iRacing.Plugin.dll", "iRacing.Plugin.dll")
 zf.write(".\\Bin\\x64\\Release\\ATS.Plugin.dll", "ATS.Plugin.dll")
 zf.write(".\\Bin\\x64\\Release\\SPSP.ATS.Plugin.dll", "Game Plugins\\American Truck Simulator\\SPSP.ATS.Plugin.dll")
 zf.write(".\\Bin\\x64\\Release\\LiveForSpeed.Plugin.dll", "LiveForSpeed.Plugin.dll")
 zf.write(".\\Bin\\x64\\Release\\ACR.Plugin.dll", "ACR.Plugin.dll")
+zf.write(".\\Data\\SliProSuperPro.Config.json", "SliProSuperPro.Config.json")
+zf.write(".\\Data\\RBR-NGP.Config.json", "RBR-NGP.Config.json")
 zf.write(".\\Data\\iRacing.Overrides.json", "iRacing.Overrides.json")
 zf.write(".\\Data\\LiveForSpeed.Config.json", "LiveForSpeed.Config.json")
 zf.write(".\\Data\\LiveForSpeed.CarData.json", "LiveForSpeed.CarData.json")
@@ -0,0 +1,152 @@
+//
+// SliProSuperPro
+// A Shift Light Indicator controller
+// Copyright 2025 Fixfactory
+//
+// This file is part of SliProSuperPro.
+//
+// SliProSuperPro is free software: you can redistribute it and/or modify it under
+// the terms of the GNU General Public License as published by the Free
+// Software Foundation, either version 3 of the License, or any later version.
+//
+// SliProSuperPro is distributed in the hope that it will be useful, but WITHOUT
+// ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+// FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+// more details.
+//
+// You should have received a copy of the GNU General Public License along
+// with SliProSuperPro. If not, see <http://www.gnu.org/licenses/>.
+//
+
+#include <Windows.h>
+#include <string>
+#include <chrono>
+
+#include "Host.h"
+#include "Log.h"
+
+HostManager &HostManager::getSingleton()
+{
+    static HostManager s_singleton;
+    return s_singleton;
+}
+
+HostManager::HostManager()
+{
+}
+
+HostManager::~HostManager()
+{
+}
+
+bool HostManager::init(const std::string &libraryPath, unsigned long controllerPid, const std::string &gamePath)
+{
+    // Exit by ourselves if the controller goes away without stopping us.
+    m_controllerProcess = OpenProcess(SYNCHRONIZE, FALSE, controllerPid);
+    if (m_controllerProcess == nullptr)
+    {
+        LOG_ERROR("Could not open the controller process (pid: %lu)", controllerPid);
+        return false;
+    }
+
+    // The controller creates the shared memory and the event before starting us.
+    if (!m_sharedMemory.open(pluginHost::getRingName(controllerPid), sizeof(pluginHost::Ring), true))
+    {
+        LOG_ERROR("Could not open the plugin host shared memory");
+        return false;
+    }
+
+    m_ring = reinterpret_cast<pluginHost::Ring *>(m_sharedMemory.getBuffer());
+    if (m_ring->protocolVersion != pluginHost::kProtocolVersion)
+    {
+        LOG_ERROR("Unsupported plugin host protocol version %i", m_ring->protocolVersion);
+        return false;
+    }
+
+    m_event = OpenEventA(EVENT_MODIFY_STATE, FALSE, pluginHost::getEventName(controllerPid).c_str());
+    if (m_event == nullptr)
+    {
+        LOG_ERROR("Could not open the plugin host event");
+        return false;
+    }
+
+    if (!m_plugin.load(libraryPath))
+    {
+        return false;
+    }
+    LOG_INFO("Loaded %s", libraryPath.c_str());
+
+    m_ring->physicsDataEveryFrame.store(m_plugin.getPhysicsDataEveryFrame());
+    m_plugin.setGameIsRunning(true, gamePath);
+    m_ring->state.store((int)pluginHost::HostState::kRunning);
+
+    TimingManager::getSingleton().registerUpdateable(this);
+    return true;
+}
+
+void HostManager::deinit()
+{
+    if (m_plugin.isLoaded())
+    {
+        TimingManager::getSingleton().unregisterUpdateable(this);
+        m_plugin.setGameIsRunning(false, "");
+        m_plugin.unload();
+    }
+
+    if (m_ring != nullptr)
+    {
+        m_ring->state.store((int)pluginHost::HostState::kStopped);
+        m_ring = nullptr;
+    }
+
+    m_sharedMemory.close();
+
+    if (m_event != nullptr)
+    {
+        CloseHandle(m_event);
+        m_event = nullptr;
+    }
+
+    if (m_controllerProcess != nullptr)
+    {
+        CloseHandle(m_controllerProcess);
+        m_controllerProcess = nullptr;
+    }
+}
+
+void HostManager::update(timing::seconds deltaTimeSecs)
+{
+    if (m_ring->state.load() == (int)pluginHost::HostState::kStopRequested ||
+        WaitForSingleObject(m_controllerProcess, 0) == WAIT_OBJECT_0)
+    {
+        m_shouldExit = true;
+        return;
+    }
+
+    m_ring->heartbeat.fetch_add(1);
+
+    pluginHost::Frame frame{};
+    frame.fetchTimeNs =
+        std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch())
+            .count();
+    frame.hasTelemetryData = m_plugin.getTelemetryData(&frame.telemetryData, sizeof(frame.telemetryData));
+
+    // Same rules as the controller's PhysicsManager so plugins behave as if they were loaded in-process.
+    if (m_ring->physicsDataEveryFrame.load())
+    {
+        frame.hasPhysicsData = m_plugin.getPhysicsData(&frame.physicsData, sizeof(frame.physicsData));
+    }
+    else if (m_physicsDataRequest.update(frame.hasTelemetryData, frame.telemetryData))
+    {
+        frame.hasPhysicsData = m_plugin.getPhysicsData(&frame.physicsData, sizeof(frame.physicsData));
+        m_physicsDataRequest.setReceived(frame.hasPhysicsData);
+    }
+
+    pluginHost::publishFrame(*m_ring, frame);
+    SetEvent(m_event);
+}
+
+bool HostManager::shouldExit() const
+{
+    return m_shouldExit;
+}
@@ -0,0 +1,57 @@
+//
+// SliProSuperPro
+// A Shift Light Indicator controller
+// Copyright 2025 Fixfactory
+//
+// This file is part of SliProSuperPro.
+//
+// SliProSuperPro is free software: you can redistribute it and/or modify it under
+// the terms of the GNU General Public License as published by the Free
+// Software Foundation, either version 3 of the License, or any later version.
+//
+// SliProSuperPro is distributed in the hope that it will be useful, but WITHOUT
+// ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+// FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+// more details.
+//
+// You should have received a copy of the GNU General Public License along
+// with SliProSuperPro. If not, see <http://www.gnu.org/licenses/>.
+//
+
+#pragma once
+
+#include <Windows.h>
+#include <string>
+
+#include "Timing.h"
+#include "SharedMemory.h"
+#include "PluginHostProtocol.h"
+#include "PluginLibrary.h"
+
+// Runs a single plugin inside SliProSuperPro.PluginHost.exe and publishes its data to the controller every frame.
+class HostManager : public Updateable
+{
+public:
+    static HostManager &getSingleton();
+
+    HostManager();
+    ~HostManager();
+
+    bool init(const std::string &libraryPath, unsigned long controllerPid, const std::string &gamePath);
+    void deinit();
+
+    void update(timing::seconds deltaTimeSecs) override;
+
+    bool shouldExit() const;
+
+private:
+    PluginLibrary m_plugin;
+
+    SharedMemory m_sharedMemory;
+    pluginHost::Ring *m_ring{ nullptr };
+    HANDLE m_event{ nullptr };
+    HANDLE m_controllerProcess{ nullptr };
+
+    pluginHost::PhysicsDataRequest m_physicsDataRequest;
+    bool m_shouldExit{ false };
+};
@@ -0,0 +1,67 @@
+//
+// SliProSuperPro
+// A Shift Light Indicator controller
+// Copyright 2025 Fixfactory
+//
+// This file is part of SliProSuperPro.
+//
+// SliProSuperPro is free software: you can redistribute it and/or modify it under
+// the terms of the GNU General Public License as published by the Free
+// Software Foundation, either version 3 of the License, or any later version.
+//
+// SliProSuperPro is distributed in the hope that it will be useful, but WITHOUT
+// ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+// FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+// more details.
+//
+// You should have received a copy of the GNU General Public License along
+// with SliProSuperPro. If not, see <http://www.gnu.org/licenses/>.
+//
+
+#include <Windows.h>
+#include <string>
+#include <vector>
+#include <string_view>
+
+#include "Libraries.h"
+#include "Log.h"
+#include "CommandLine.h"
+#include "Timing.h"
+#include "Host.h"
+
+// Usage: SliProSuperPro.PluginHost.exe --plugin [path] --controllerPid [pid] --gamePath [path]
+// Started and supervised by SliProSuperPro.exe when running with --isolatePlugins.
+int main(int argc, char *argv[])
+{
+    LogManager::getSingleton().init();
+
+    const std::vector<std::string_view> args(argv + 1, argv + argc);
+    std::string libraryPath(cmdLine::getOption(args, "--plugin"));
+    std::string controllerPid(cmdLine::getOption(args, "--controllerPid"));
+    std::string gamePath(cmdLine::getOption(args, "--gamePath"));
+
+    if (libraryPath.empty() || controllerPid.empty())
+    {
+        LOG_ERROR("Missing command line arguments. This program is started by SliProSuperPro.exe.");
+        LogManager::getSingleton().deinit();
+        return EXIT_FAILURE;
+    }
+
+    TimingManager::getSingleton().init();
+
+    int exitCode = EXIT_FAILURE;
+    if (HostManager::getSingleton().init(libraryPath, std::stoul(controllerPid), gamePath))
+    {
+        while (!HostManager::getSingleton().shouldExit())
+        {
+            TimingManager::getSingleton().run();
+        }
+        exitCode = EXIT_SUCCESS;
+    }
+
+    HostManager::getSingleton().deinit();
+    TimingManager::getSingleton().deinit();
+    LogManager::getSingleton().deinit();
+
+    return exitCode;
+}
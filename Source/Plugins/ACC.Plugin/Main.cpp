@@ -28,9 +28,78 @@
 #include "PluginInterface.h"
 #include "Defines.h"
 #include "Telemetry.h"
+#include "Exports.h"
 
+namespace acc
+{
+    std::string g_gameExecPath{};
+
+    int PluginExports::getPluginInterfaceVersion()
+    {
+        return plugin::kInterfaceVersion;
+    }
+
+    bool PluginExports::supportsInterfaceVersion(int interfaceVersion)
+    {
+        return interfaceVersion >= 1 && interfaceVersion <= 4;
+    }
+
+    void PluginExports::getGameExecFileName(std::string &outExecFileName)
+    {
+        outExecFileName = "acc.exe";
+    }
+
+    void PluginExports::setGameIsRunning(bool isRunning, std::string execPath)
+    {
+        if (isRunning)
+        {
+            g_gameExecPath = execPath;
+            TelemetryManager::getSingleton().init();
+        }
+        else
+        {
+            TelemetryManager::getSingleton().deinit();
+            g_gameExecPath.clear();
+        }
+    }
+
+    bool PluginExports::getTelemetryData(plugin::TelemetryData *outTelemetryData, size_t telemetryDataSize)
+    {
+        if (TelemetryManager::getSingleton().fetchTelemetryData())
+        {
+            auto &telemetryData = TelemetryManager::getSingleton().getTelemetryData();
+            if (sizeof(telemetryData) >= telemetryDataSize)
+            {
+                memcpy(outTelemetryData, &telemetryData, telemetryDataSize);
+                return true;
+            }
+        }
+        return false;
+    }
+
+    bool PluginExports::getPhysicsData(plugin::PhysicsData *outPhysicsData, size_t physicsDataSize)
+    {
+        TelemetryManager &telemetryManager = TelemetryManager::getSingleton();
+        if (telemetryManager.fetchTelemetryData() && telemetryManager.isPhysicsDataReady())
+        {
+            auto &physicsData = TelemetryManager::getSingleton().getPhysicsData();
+            if (sizeof(physicsData) >= physicsDataSize)
+            {
+                memcpy(outPhysicsData, &physicsData, physicsDataSize);
+                return true;
+            }
+        }
+        return false;
+    }
+
+    bool PluginExports::getPhysicsDataEveryFrame()
+    {
+        return false;
+    }
+} // namespace acc
+
+#ifndef SPSP_STATIC_PLUGINS
 std::atomic<int> g_dllAttachCount = 0;
-std::string g_gameExecPath{};
 
 BOOL APIENTRY DllMain(HMODULE hModule, DWORD ul_reason_for_call, LPVOID lpReserved)
 {
@@ -66,63 +135,37 @@ extern "C"
 {
     int DLL_EXPORT getPluginInterfaceVersion()
     {
-        return plugin::kInterfaceVersion;
+        return acc::PluginExports::getPluginInterfaceVersion();
     }
 
     bool DLL_EXPORT supportsInterfaceVersion(int interfaceVersion)
     {
-        return interfaceVersion >= 1 && interfaceVersion <= 1;
+        return acc::PluginExports::supportsInterfaceVersion(interfaceVersion);
     }
 
     void DLL_EXPORT getGameExecFileName(std::string &outExecFileName)
     {
-        outExecFileName = "acc.exe";
+        acc::PluginExports::getGameExecFileName(outExecFileName);
     }
 
     void DLL_EXPORT setGameIsRunning(bool isRunning, std::string execPath)
     {
-        if (isRunning)
-        {
-            g_gameExecPath = execPath;
-            TelemetryManager::getSingleton().init();
-        }
-        else
-        {
-            TelemetryManager::getSingleton().deinit();
-            g_gameExecPath.clear();
-        }
+        acc::PluginExports::setGameIsRunning(isRunning, execPath);
     }
 
     bool DLL_EXPORT getTelemetryData(plugin::TelemetryData *outTelemetryData, size_t telemetryDataSize)
     {
-        if (TelemetryManager::getSingleton().fetchTelemetryData())
-        {
-            auto &telemetryData = TelemetryManager::getSingleton().getTelemetryData();
-            if (sizeof(telemetryData) >= telemetryDataSize)
-            {
-                memcpy(outTelemetryData, &telemetryData, telemetryDataSize);
-                return true;
-            }
-        }
-        return false;
+        return acc::PluginExports::getTelemetryData(outTelemetryData, telemetryDataSize);
     }
 
     bool DLL_EXPORT getPhysicsData(plugin::PhysicsData *outPhysicsData, size_t physicsDataSize)
     {
-        if (TelemetryManager::getSingleton().fetchTelemetryData())
-        {
-            auto &physicsData = TelemetryManager::getSingleton().getPhysicsData();
-            if (sizeof(physicsData) >= physicsDataSize)
-            {
-                memcpy(outPhysicsData, &physicsData, physicsDataSize);
-                return true;
-            }
-        }
-        return false;
+        return acc::PluginExports::getPhysicsData(outPhysicsData, physicsDataSize);
     }
 
     bool DLL_EXPORT getPhysicsDataEveryFrame()
     {
-        return false;
+        return acc::PluginExports::getPhysicsDataEveryFrame();
     }
 }
+#endif
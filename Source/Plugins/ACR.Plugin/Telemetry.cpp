@@ -19,7 +19,9 @@
 //
 
 #include <Windows.h>
-#include <fstream>
+#include <atomic>
+#include <cstdio>
+#include <cwchar>
 
 #include "SharedMemoryACCS/SharedFileOut.h"
 
@@ -27,239 +29,265 @@
 #include "Telemetry.h"
 #include "Log.h"
 
-void dismiss(SMElement element)
+namespace acr
 {
-    UnmapViewOfFile(element.mapFileBuffer);
-    CloseHandle(element.hMapFile);
+    // Reading a page the game is writing is tried this many times, before the values read before are kept.
+    constexpr int kMaxReadAttempts = 3;
 
-}
-
-TelemetryManager &TelemetryManager::getSingleton()
-{
-    static TelemetryManager s_singleton;
-    return s_singleton;
-}
-
-TelemetryManager::TelemetryManager()
-{
-}
-
-TelemetryManager::~TelemetryManager()
-{
-}
-
-void TelemetryManager::init()
-{
-    memset(&m_telemetryData, 0, sizeof(m_telemetryData));
-    memset(&m_physicsData, 0, sizeof(m_physicsData));
-    memset(m_rpmDownshiftOverride, 0, sizeof(m_rpmDownshiftOverride));
-    memset(m_rpmUpshiftOverride, 0, sizeof(m_rpmDownshiftOverride));
-
-    m_lastCarPath.clear();
-    m_hasOverride = false;
-    m_gearCountOverride = 0;
-
-    readOverrides();
-
-    initPhysics();
-    initGraphics();
-    initStatic();
-}
-
-void TelemetryManager::initPhysics()
-{
-    TCHAR szName[] = TEXT("Local\\acpmf_physics");
-    m_physics.hMapFile = CreateFileMapping(INVALID_HANDLE_VALUE, NULL, PAGE_READWRITE, 0, sizeof(SPageFilePhysics), szName);
-    if (!m_physics.hMapFile)
+    // The fields of the physics page that are used.
+    struct PhysicsSample
     {
-        LOG_ERROR("CreateFileMapping failed");
-        return;
-    }
-
-    m_physics.mapFileBuffer = (unsigned char *)MapViewOfFile(m_physics.hMapFile, FILE_MAP_READ, 0, 0, sizeof(SPageFilePhysics));
-    if (!m_physics.mapFileBuffer)
+        int packetId;
+        int gear;
+        int rpms;
+        float speedKmh;
+        int currentMaxRpm;
+    };
+
+    // The game writes the page while it is read, so it is read again if the packet ID changed meanwhile. Returns false
+    // if it changed on every attempt.
+    bool readPhysics(const SPageFilePhysics *page, PhysicsSample &outSample)
     {
-        LOG_ERROR("MapViewOfFile failed");
-        return;
-    }
-}
+        const volatile SPageFilePhysics *volatilePage = page;
+        for (int attempt = 0; attempt < kMaxReadAttempts; attempt++)
+        {
+            int packetId = volatilePage->packetId;
+            std::atomic_thread_fence(std::memory_order_acquire);
+            outSample.gear = volatilePage->gear;
+            outSample.rpms = volatilePage->rpms;
+            outSample.speedKmh = volatilePage->speedKmh;
+            outSample.currentMaxRpm = volatilePage->currentMaxRpm;
+            std::atomic_thread_fence(std::memory_order_acquire);
+            if (volatilePage->packetId == packetId)
+            {
+                outSample.packetId = packetId;
+                return true;
+            }
+        }
 
-void TelemetryManager::initGraphics()
-{
-    TCHAR szName[] = TEXT("Local\\acpmf_graphics");
-    m_graphics.hMapFile = CreateFileMapping(INVALID_HANDLE_VALUE, NULL, PAGE_READWRITE, 0, sizeof(SPageFileGraphic), szName);
-    if (!m_graphics.hMapFile)
-    {
-        LOG_ERROR("CreateFileMapping failed");
-        return;
+        return false;
     }
 
-    m_graphics.mapFileBuffer = (unsigned char *)MapViewOfFile(m_graphics.hMapFile, FILE_MAP_READ, 0, 0, sizeof(SPageFileGraphic));
-    if (!m_graphics.mapFileBuffer)
+    void dismiss(SMElement element)
     {
-        LOG_ERROR("MapViewOfFile failed");
-        return;
+        UnmapViewOfFile(element.mapFileBuffer);
+        CloseHandle(element.hMapFile);
+
     }
-}
 
-void TelemetryManager::initStatic()
-{
-    TCHAR szName[] = TEXT("Local\\acpmf_static");
-    m_static.hMapFile = CreateFileMapping(INVALID_HANDLE_VALUE, NULL, PAGE_READWRITE, 0, sizeof(SPageFileStatic), szName);
-    if (!m_static.hMapFile)
+    TelemetryManager &TelemetryManager::getSingleton()
     {
-        LOG_ERROR("CreateFileMapping failed");
-        return;
+        static TelemetryManager s_singleton;
+        return s_singleton;
     }
 
-    m_static.mapFileBuffer = (unsigned char *)MapViewOfFile(m_static.hMapFile, FILE_MAP_READ, 0, 0, sizeof(SPageFileStatic));
-    if (!m_static.mapFileBuffer)
+    TelemetryManager::TelemetryManager()
     {
-        LOG_ERROR("MapViewOfFile failed");
-        return;
     }
-}
-
-void TelemetryManager::deinit()
-{
-    dismiss(m_graphics);
-    dismiss(m_physics);
-    dismiss(m_static);
-}
 
-bool TelemetryManager::fetchTelemetryData()
-{
-    SPageFilePhysics *pfPhysics = (SPageFilePhysics *)m_physics.mapFileBuffer;
-    SPageFileGraphic *pfGraphics = (SPageFileGraphic *)m_graphics.mapFileBuffer;
-    SPageFileStatic *pfStatic = (SPageFileStatic *)m_static.mapFileBuffer;
-    if (!pfPhysics || !pfGraphics || !pfStatic)
+    TelemetryManager::~TelemetryManager()
     {
-        return false;
     }
 
-    if (pfPhysics->rpms < 20)
+    void TelemetryManager::init()
     {
-        return false;
+        memset(&m_telemetryData, 0, sizeof(m_telemetryData));
+        memset(&m_physicsData, 0, sizeof(m_physicsData));
+
+        m_packetId = -1;
+        m_hasTelemetryData = false;
+        wmemset(m_carModel, L'\0', kCarModelLength);
+        m_carPath.clear();
+        m_rpmLimit = 0;
+        m_isPhysicsDataDirty = true;
+        m_carOverride = nullptr;
+        m_isCarPending = false;
+
+        m_carOverrides.init("ACR.Overrides.json", overrides::parseCarOverride);
+
+        initPhysics();
+        initGraphics();
+        initStatic();
     }
 
-    m_carPath = string::convertFromWide(pfStatic->carModel);
-    if (m_carPath != m_lastCarPath)
+    void TelemetryManager::initPhysics()
     {
-        m_lastCarPath = m_carPath;
-        LOG_INFO("Changed car: %s", m_carPath.c_str());
-        parseOverrides();
+        TCHAR szName[] = TEXT("Local\\acpmf_physics");
+        m_physics.hMapFile = CreateFileMapping(INVALID_HANDLE_VALUE, NULL, PAGE_READWRITE, 0, sizeof(SPageFilePhysics), szName);
+        if (!m_physics.hMapFile)
+        {
+            LOG_ERROR("CreateFileMapping failed");
+            return;
+        }
+
+        m_physics.mapFileBuffer = (unsigned char *)MapViewOfFile(m_physics.hMapFile, FILE_MAP_READ, 0, 0, sizeof(SPageFilePhysics));
+        if (!m_physics.mapFileBuffer)
+        {
+            LOG_ERROR("MapViewOfFile failed");
+            return;
+        }
     }
 
-    m_telemetryData.gear = pfPhysics->gear;
-    m_telemetryData.rpm = (float)pfPhysics->rpms;
-    m_telemetryData.speedKph = pfPhysics->speedKmh;
+    void TelemetryManager::initGraphics()
+    {
+        TCHAR szName[] = TEXT("Local\\acpmf_graphics");
+        m_graphics.hMapFile = CreateFileMapping(INVALID_HANDLE_VALUE, NULL, PAGE_READWRITE, 0, sizeof(SPageFileGraphic), szName);
+        if (!m_graphics.hMapFile)
+        {
+            LOG_ERROR("CreateFileMapping failed");
+            return;
+        }
 
-    m_physicsData.gearCount = 8;
-    m_physicsData.rpmIdle = 800.0f;
-    m_physicsData.rpmLimit = (float)pfPhysics->currentMaxRpm;
+        m_graphics.mapFileBuffer = (unsigned char *)MapViewOfFile(m_graphics.hMapFile, FILE_MAP_READ, 0, 0, sizeof(SPageFileGraphic));
+        if (!m_graphics.mapFileBuffer)
+        {
+            LOG_ERROR("MapViewOfFile failed");
+            return;
+        }
+    }
 
-    for (int i = 0; i < plugin::kMaxGearCount; i++)
+    void TelemetryManager::initStatic()
     {
-        m_physicsData.rpmDownshift[i] = m_physicsData.rpmLimit * 0.20f;
-        m_physicsData.rpmUpshift[i] = m_physicsData.rpmLimit * 0.90f;
+        TCHAR szName[] = TEXT("Local\\acpmf_static");
+        m_static.hMapFile = CreateFileMapping(INVALID_HANDLE_VALUE, NULL, PAGE_READWRITE, 0, sizeof(SPageFileStatic), szName);
+        if (!m_static.hMapFile)
+        {
+            LOG_ERROR("CreateFileMapping failed");
+            return;
+        }
+
+        m_static.mapFileBuffer = (unsigned char *)MapViewOfFile(m_static.hMapFile, FILE_MAP_READ, 0, 0, sizeof(SPageFileStatic));
+        if (!m_static.mapFileBuffer)
+        {
+            LOG_ERROR("MapViewOfFile failed");
+            return;
+        }
     }
 
-    if (m_hasOverride)
+    void TelemetryManager::deinit()
     {
-        m_physicsData.gearCount = m_gearCountOverride;
-        memcpy(m_physicsData.rpmDownshift, m_rpmDownshiftOverride, sizeof(m_physicsData.rpmDownshift));
-        memcpy(m_physicsData.rpmUpshift, m_rpmUpshiftOverride, sizeof(m_physicsData.rpmUpshift));
+        m_carOverrides.deinit();
+        dismiss(m_graphics);
+        dismiss(m_physics);
+        dismiss(m_static);
     }
 
-    return true;
-}
+    bool TelemetryManager::fetchTelemetryData()
+    {
+        SPageFilePhysics *pfPhysics = (SPageFilePhysics *)m_physics.mapFileBuffer;
+        SPageFileGraphic *pfGraphics = (SPageFileGraphic *)m_graphics.mapFileBuffer;
+        SPageFileStatic *pfStatic = (SPageFileStatic *)m_static.mapFileBuffer;
+        if (!pfPhysics || !pfGraphics || !pfStatic)
+        {
+            return false;
+        }
 
-const plugin::TelemetryData &TelemetryManager::getTelemetryData() const
-{
-    return m_telemetryData;
-}
+        // Nothing is read again until the game writes a new packet.
+        PhysicsSample sample;
+        if (pfPhysics->packetId != m_packetId && readPhysics(pfPhysics, sample))
+        {
+            m_packetId = sample.packetId;
+            m_hasTelemetryData = sample.rpms >= 20;
+            if (m_hasTelemetryData)
+            {
+                static_assert(sizeof(m_carModel) == sizeof(pfStatic->carModel));
+                if (wmemcmp(pfStatic->carModel, m_carModel, kCarModelLength) != 0)
+                {
+                    selectCar(pfStatic->carModel);
+                }
+
+                m_telemetryData.gear = sample.gear;
+                m_telemetryData.rpm = (float)sample.rpms;
+                m_telemetryData.speedKph = sample.speedKmh;
+
+                if (sample.currentMaxRpm != m_rpmLimit)
+                {
+                    m_rpmLimit = sample.currentMaxRpm;
+                    m_isPhysicsDataDirty = true;
+                }
+            }
+        }
 
-const plugin::PhysicsData &TelemetryManager::getPhysicsData() const
-{
-    return m_physicsData;
-}
+        // The car being driven gets the values of an edited overrides file.
+        if (m_carOverrides.update())
+        {
+            selectOverride();
+        }
 
-void TelemetryManager::readOverrides()
-{
-    std::ifstream file("ACR.Overrides.json");
-    if (file.good())
-    {
-        LOG_INFO("Reading ACR.Overrides.json");
-        m_overrides = json::parse(file);
-    }
-}
+        if (m_isCarPending && m_carOverrides.isLoaded())
+        {
+            m_isCarPending = false;
+            selectOverride();
+        }
 
-void TelemetryManager::parseOverrides()
-{
-    m_hasOverride = false;
-    m_gearCountOverride = 0;
-    memset(m_rpmDownshiftOverride, 0, sizeof(m_rpmDownshiftOverride));
-    memset(m_rpmUpshiftOverride, 0, sizeof(m_rpmDownshiftOverride));
+        if (m_hasTelemetryData && m_isPhysicsDataDirty)
+        {
+            buildPhysicsData();
+        }
 
-    if (m_carPath.empty() || m_overrides.empty())
-    {
-        return;
+        return m_hasTelemetryData;
     }
 
-    json overrides = m_overrides["cars"][m_carPath];  
-    if (overrides.empty())
+    void TelemetryManager::buildPhysicsData()
     {
-        return;
-    }
+        m_isPhysicsDataDirty = false;
 
-    if (!overrides["gearCount"].empty() && !overrides["rpmDownshift"].empty() && !overrides["rpmUpshift"].empty())
-    {
-        m_gearCountOverride = overrides["gearCount"].template get<int>() + 2; // Add reverse and neutral
-        int rpmDownshift = overrides["rpmDownshift"].template get<int>();
-        int rpmUpshift = overrides["rpmUpshift"].template get<int>();
+        // The controller only asks for physics data when telemetry starts, or when this changes.
+        m_telemetryData.physicsGeneration++;
+
+        m_physicsData.gearCount = 8;
+        m_physicsData.rpmIdle = 800.0f;
+        m_physicsData.rpmLimit = (float)m_rpmLimit;
+        snprintf(m_physicsData.carId, sizeof(m_physicsData.carId), "%s", m_carPath.c_str());
 
         for (int i = 0; i < plugin::kMaxGearCount; i++)
         {
-            m_rpmDownshiftOverride[i] = (float)rpmDownshift;
-            m_rpmUpshiftOverride[i] = (float)rpmUpshift;
+            m_physicsData.rpmDownshift[i] = m_physicsData.rpmLimit * 0.20f;
+            m_physicsData.rpmUpshift[i] = m_physicsData.rpmLimit * 0.90f;
         }
-    }
-    else
-    {
-        for (auto &gear : overrides["gears"].items())
+
+        if (m_carOverride)
         {
-            if (gear.value()["gear"].empty() || gear.value()["rpmDownshift"].empty() || gear.value()["rpmUpshift"].empty())
+            if (m_carOverride->gearCount > 0)
             {
-                continue;
+                m_physicsData.gearCount = m_carOverride->gearCount;
             }
+            memcpy(m_physicsData.rpmDownshift, m_carOverride->rpmDownshift, sizeof(m_physicsData.rpmDownshift));
+            memcpy(m_physicsData.rpmUpshift, m_carOverride->rpmUpshift, sizeof(m_physicsData.rpmUpshift));
+        }
+    }
 
-            std::string gearName = gear.value()["gear"].template get<std::string>();
-            int rpmDownshift = gear.value()["rpmDownshift"].template get<int>();
-            int rpmUpshift = gear.value()["rpmUpshift"].template get<int>();
+    const plugin::TelemetryData &TelemetryManager::getTelemetryData() const
+    {
+        return m_telemetryData;
+    }
 
-            int gearIdx = -1;
-            if (gearName == "R")
-            {
-                gearIdx = 0;
-            }
-            else if (gearName == "N")
-            {
-                gearIdx = 1;
-            }
-            else
-            {
-                gearIdx = atoi(gearName.c_str());
-                gearIdx++; // e.g. gear "1" is at index 2.
-            }
+    const plugin::PhysicsData &TelemetryManager::getPhysicsData() const
+    {
+        return m_physicsData;
+    }
 
-            if (gearIdx >= 0 && gearIdx < plugin::kMaxGearCount)
-            {
-                m_rpmDownshiftOverride[gearIdx] = (float)rpmDownshift;
-                m_rpmUpshiftOverride[gearIdx] = (float)rpmUpshift;
-            }
-        }
+    bool TelemetryManager::isPhysicsDataReady() const
+    {
+        return !m_isCarPending;
     }
 
-    m_hasOverride = true;
-}
+    void TelemetryManager::selectCar(const wchar_t *carModel)
+    {
+        // Only converted when the car changes.
+        wmemcpy(m_carModel, carModel, kCarModelLength);
+        m_carPath = string::convertFromWide(std::wstring(m_carModel, wcsnlen(m_carModel, kCarModelLength)));
+        LOG_INFO("Changed car: %s", m_carPath.c_str());
+
+        // The override of the car before isn't used while the new car's is looked up.
+        m_carOverride = nullptr;
+        m_isCarPending = true;
+        m_isPhysicsDataDirty = true;
+    }
 
+    void TelemetryManager::selectOverride()
+    {
+        m_carOverride = m_carOverrides.find(m_carPath);
+        m_isPhysicsDataDirty = true;
+    }
+} // namespace acr
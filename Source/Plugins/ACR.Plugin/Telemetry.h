@@ -20,54 +20,71 @@
 
 #pragma once
 
-#include "PluginInterface.h"
+#include <string>
 
-#include "json/json.hpp"
-using json = nlohmann::json;
+#include "PluginInterface.h"
+#include "OverrideIndex.h"
 
-struct SMElement
+namespace acr
 {
-    HANDLE hMapFile;
-    unsigned char *mapFileBuffer;
-};
+    struct SMElement
+    {
+        HANDLE hMapFile;
+        unsigned char *mapFileBuffer;
+    };
 
-class TelemetryManager
-{
-public:
-    static TelemetryManager &getSingleton();
+    class TelemetryManager
+    {
+    public:
+        static TelemetryManager &getSingleton();
+
+        TelemetryManager();
+        ~TelemetryManager();
+
+        void init();
+        void deinit();
 
-    TelemetryManager();
-    ~TelemetryManager();
+        bool fetchTelemetryData();
+        const plugin::TelemetryData &getTelemetryData() const;
+        const plugin::PhysicsData &getPhysicsData() const;
 
-    void init();
-    void deinit();
+        // False while the overrides of the car are still being read.
+        bool isPhysicsDataReady() const;
 
-    bool fetchTelemetryData();
-    const plugin::TelemetryData &getTelemetryData() const;
-    const plugin::PhysicsData &getPhysicsData() const;
+    private:
+        plugin::TelemetryData m_telemetryData{};
+        plugin::PhysicsData m_physicsData{};
 
-private:
-    plugin::TelemetryData m_telemetryData{};
-    plugin::PhysicsData m_physicsData{};
+        // The game increments the packet ID each time it writes the physics page, so an unchanged page isn't read
+        // again. -1 until a page is read.
+        int m_packetId{ -1 };
+        bool m_hasTelemetryData{ false };
 
-    json m_overrides;
+        // The car model as the game writes it, compared without converting it, and the car path converted from it.
+        static constexpr size_t kCarModelLength = 33;
+        wchar_t m_carModel[kCarModelLength]{};
+        std::string m_carPath;
 
-    std::string m_carPath;
-    std::string m_lastCarPath;
+        // The physics data is only built again when the car, its RPM limit or its override changes.
+        int m_rpmLimit{ 0 };
+        bool m_isPhysicsDataDirty{ false };
 
-    bool m_hasOverride{ false };
-    int m_gearCountOverride{ 0 };
-    float m_rpmDownshiftOverride[plugin::kMaxGearCount]{};
-    float m_rpmUpshiftOverride[plugin::kMaxGearCount]{};
+        // Every car of the overrides file, read in the background when the game starts so a car change is a lookup,
+        // and again when the file is edited.
+        overrides::WatchedCarIndex<overrides::CarOverride> m_carOverrides;
+        const overrides::CarOverride *m_carOverride{ nullptr };
+        bool m_isCarPending{ false };
 
-    SMElement m_graphics{};
-    SMElement m_physics{};
-    SMElement m_static{};
+        SMElement m_graphics{};
+        SMElement m_physics{};
+        SMElement m_static{};
 
-    void initPhysics();
-    void initGraphics();
-    void initStatic();
+        void initPhysics();
+        void initGraphics();
+        void initStatic();
 
-    void readOverrides();
-    void parseOverrides();
-};
+        void selectCar(const wchar_t *carModel);
+        void selectOverride();
+        void buildPhysicsData();
+    };
+} // namespace acr
@@ -0,0 +1,43 @@
+//
+// SliProSuperPro
+// A Shift Light Indicator controller
+// Copyright 2025 Fixfactory
+//
+// This file is part of SliProSuperPro.
+//
+// SliProSuperPro is free software: you can redistribute it and/or modify it under
+// the terms of the GNU General Public License as published by the Free
+// Software Foundation, either version 3 of the License, or any later version.
+//
+// SliProSuperPro is distributed in the hope that it will be useful, but WITHOUT
+// ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+// FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+// more details.
+//
+// You should have received a copy of the GNU General Public License along
+// with SliProSuperPro. If not, see <http://www.gnu.org/licenses/>.
+//
+
+#pragma once
+
+#include <string>
+
+#include "PluginInterface.h"
+
+namespace ats
+{
+    // The plugin interface. Exported from the plugin library by Main.cpp, or called directly when the plugin is
+    // linked into SliProSuperPro with SPSP_STATIC_PLUGINS.
+    struct PluginExports
+    {
+        static constexpr const char *kName = "ATS.Plugin";
+
+        static int getPluginInterfaceVersion();
+        static bool supportsInterfaceVersion(int interfaceVersion);
+        static void getGameExecFileName(std::string &outExecFileName);
+        static void setGameIsRunning(bool isRunning, std::string execPath);
+        static bool getTelemetryData(plugin::TelemetryData *outTelemetryData, size_t telemetryDataSize);
+        static bool getPhysicsData(plugin::PhysicsData *outPhysicsData, size_t physicsDataSize);
+        static bool getPhysicsDataEveryFrame();
+    };
+} // namespace ats
@@ -26,27 +26,30 @@
 
 class SharedMemory;
 
-class TelemetryManager
+namespace ats
 {
-public:
-    static TelemetryManager &getSingleton();
-
-    TelemetryManager();
-    ~TelemetryManager();
-
-    void init();
-    void deinit();
-
-    bool fetchTelemetryData();
-    const plugin::TelemetryData &getTelemetryData() const;
-    const plugin::PhysicsData &getPhysicsData() const;
-
-private:
-    bool m_receivingTelemetry{ false };
-    plugin::TelemetryData m_telemetryData{};
-    plugin::PhysicsData m_physicsData{};
-    SharedMemory *m_sharedMemory{ nullptr };
-
-    using time_point = std::chrono::steady_clock::time_point;
-    time_point m_lastTryOpen = {};
-};
+    class TelemetryManager
+    {
+    public:
+        static TelemetryManager &getSingleton();
+
+        TelemetryManager();
+        ~TelemetryManager();
+
+        void init();
+        void deinit();
+
+        bool fetchTelemetryData();
+        const plugin::TelemetryData &getTelemetryData() const;
+        const plugin::PhysicsData &getPhysicsData() const;
+
+    private:
+        bool m_receivingTelemetry{ false };
+        plugin::TelemetryData m_telemetryData{};
+        plugin::PhysicsData m_physicsData{};
+        SharedMemory *m_sharedMemory{ nullptr };
+
+        using time_point = std::chrono::steady_clock::time_point;
+        time_point m_lastTryOpen = {};
+    };
+} // namespace ats
@@ -0,0 +1,139 @@
+//
+// SliProSuperPro
+// A Shift Light Indicator controller
+// Copyright 2025 Fixfactory
+//
+// This file is part of SliProSuperPro.
+//
+// SliProSuperPro is free software: you can redistribute it and/or modify it under
+// the terms of the GNU General Public License as published by the Free
+// Software Foundation, either version 3 of the License, or any later version.
+//
+// SliProSuperPro is distributed in the hope that it will be useful, but WITHOUT
+// ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+// FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+// more details.
+//
+// You should have received a copy of the GNU General Public License along
+// with SliProSuperPro. If not, see <http://www.gnu.org/licenses/>.
+//
+
+#include <cstdio>
+#include <iterator>
+
+#include "CarData.h"
+#include "OverrideIndex.h"
+#include "Log.h"
+
+namespace lfs
+{
+    enum CarWarning : uint32_t
+    {
+        kNoName = 1 << 0,
+        kNoFinalGear = 1 << 1,
+        kNoRpmLimit = 1 << 2,
+        kMissingRpms = 1 << 3,
+    };
+
+    const char *kCarWarnings[] = {
+        "name not specified in car data file",
+        "finalGear not specified in car data file",
+        "rpmLimit not specified in car data file",
+        "missing rpm info in car data file",
+    };
+
+    void parseCar(const json &carData, Car &outCar)
+    {
+        plugin::PhysicsData &physicsData = outCar.physicsData;
+
+        auto name = carData.find("name");
+        if (name != carData.end() && name->is_string())
+        {
+            snprintf(outCar.name, sizeof(outCar.name), "%s", name->get_ref<const std::string &>().c_str());
+        }
+        else
+        {
+            outCar.warnings |= kNoName;
+        }
+
+        auto finalGear = carData.find("finalGear");
+        if (finalGear != carData.end() && finalGear->is_number())
+        {
+            physicsData.gearCount = finalGear->get<int>();
+            if (physicsData.gearCount == 0)
+            {
+                // When finalGear is 0 it means we don't know the value for that car.
+                // The shift lights will blink when reaching the upshift rpm on the last gear.
+                physicsData.gearCount = plugin::kMaxGearCount;
+            }
+            else
+            {
+                // Add reverse and neutral
+                physicsData.gearCount += 2;
+            }
+        }
+        else
+        {
+            outCar.warnings |= kNoFinalGear;
+        }
+
+        auto rpmLimit = carData.find("rpmLimit");
+        if (rpmLimit != carData.end() && rpmLimit->is_number())
+        {
+            physicsData.rpmLimit = rpmLimit->get<float>();
+        }
+        else
+        {
+            outCar.warnings |= kNoRpmLimit;
+        }
+
+        int gearFound = overrides::readGearRpms(carData, "rpmDownshift", "rpmUpshift", physicsData.rpmDownshift,
+                                                physicsData.rpmUpshift);
+        if (gearFound < physicsData.gearCount)
+        {
+            outCar.warnings |= kMissingRpms;
+        }
+
+        // Optional. With both, SliProSuperPro computes the shift points from them.
+        // "gearRatios": [ first, second, ... ], "torqueCurve": [ [ rpm, torque ], ... ]
+        auto gearRatios = carData.find("gearRatios");
+        if (gearRatios != carData.end() && gearRatios->is_array())
+        {
+            int ratioIdx = 2;
+            for (const json &ratio : *gearRatios)
+            {
+                if (ratioIdx < plugin::kMaxGearCount && ratio.is_number())
+                {
+                    physicsData.gearRatio[ratioIdx++] = ratio.get<float>();
+                }
+            }
+        }
+
+        auto torqueCurve = carData.find("torqueCurve");
+        if (torqueCurve != carData.end() && torqueCurve->is_array())
+        {
+            for (const json &point : *torqueCurve)
+            {
+                int &pointCount = physicsData.torqueCurvePointCount;
+                if (pointCount < plugin::kMaxTorqueCurvePointCount && point.is_array() && point.size() == 2 &&
+                    point[0].is_number() && point[1].is_number())
+                {
+                    physicsData.torqueCurveRpm[pointCount] = point[0].get<float>();
+                    physicsData.torqueCurveTorque[pointCount] = point[1].get<float>();
+                    pointCount++;
+                }
+            }
+        }
+    }
+
+    void logCarWarnings(const Car &car)
+    {
+        for (int i = 0; i < (int)std::size(kCarWarnings); i++)
+        {
+            if (car.warnings & (1u << i))
+            {
+                LOG_WARN("%s", kCarWarnings[i]);
+            }
+        }
+    }
+} // namespace lfs
@@ -0,0 +1,50 @@
+//
+// SliProSuperPro
+// A Shift Light Indicator controller
+// Copyright 2025 Fixfactory
+//
+// This file is part of SliProSuperPro.
+//
+// SliProSuperPro is free software: you can redistribute it and/or modify it under
+// the terms of the GNU General Public License as published by the Free
+// Software Foundation, either version 3 of the License, or any later version.
+//
+// SliProSuperPro is distributed in the hope that it will be useful, but WITHOUT
+// ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+// FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+// more details.
+//
+// You should have received a copy of the GNU General Public License along
+// with SliProSuperPro. If not, see <http://www.gnu.org/licenses/>.
+//
+
+#pragma once
+
+#include <cstdint>
+
+#include "PluginInterface.h"
+
+#include "json/json.hpp"
+using json = nlohmann::json;
+
+namespace lfs
+{
+    constexpr size_t kMaxCarNameLength = 64;
+
+    // A car of LiveForSpeed.CarData.json, stored as is in its compiled file.
+    struct Car
+    {
+        // Changes whenever the fields of Car do in the low bits, and with PhysicsData in the high ones, so compiled
+        // files of the old ones are parsed again.
+        static constexpr uint32_t kCompiledVersion = ((uint32_t)plugin::kInterfaceVersion << 16) | 1;
+
+        char name[kMaxCarNameLength]{};
+        plugin::PhysicsData physicsData{};
+
+        // What the car data file doesn't give for the car, one bit per warning. Logged when the car is entered.
+        uint32_t warnings{ 0 };
+    };
+
+    void parseCar(const json &carData, Car &outCar);
+    void logCarWarnings(const Car &car);
+} // namespace lfs
@@ -0,0 +1,298 @@
+//
+// SliProSuperPro
+// A Shift Light Indicator controller
+// Copyright 2025 Fixfactory
+//
+// This file is part of SliProSuperPro.
+//
+// SliProSuperPro is free software: you can redistribute it and/or modify it under
+// the terms of the GNU General Public License as published by the Free
+// Software Foundation, either version 3 of the License, or any later version.
+//
+// SliProSuperPro is distributed in the hope that it will be useful, but WITHOUT
+// ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+// FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+// more details.
+//
+// You should have received a copy of the GNU General Public License along
+// with SliProSuperPro. If not, see <http://www.gnu.org/licenses/>.
+//
+
+#include "cinsim/CInsim.h" // Must include before Windows.h to avoid redefines
+
+#include <algorithm>
+#include <cstring>
+
+#include "InSimClient.h"
+#include "Network.h"
+#include "Log.h"
+
+namespace lfs
+{
+    const char *kProductName = "SliProSuperPro";
+
+    // LFS may not be running yet, or InSim not opened with /insim, so keep trying.
+    const std::chrono::seconds kReconnectDelay{ 2 };
+    const std::chrono::seconds kHandshakeTimeout{ 5 };
+
+    // LFS sends a keep-alive every 30 seconds when there is nothing else to send.
+    const std::chrono::seconds kReceiveTimeout{ 70 };
+
+    InSimClient::InSimClient()
+    {
+    }
+
+    InSimClient::~InSimClient()
+    {
+    }
+
+    void InSimClient::open(const std::string &hostname, int port, const std::string &password)
+    {
+        m_hostname = hostname;
+        m_port = port;
+        m_password = password;
+        m_isConnectFailureLogged = false;
+        connect();
+    }
+
+    void InSimClient::close()
+    {
+        if (m_state == State::kConnected)
+        {
+            sendTiny(TINY_CLOSE, 0);
+            LOG_INFO("InSim connection closed");
+        }
+
+        m_socket.reset();
+        m_readIndex = 0;
+        m_writeIndex = 0;
+        setState(State::kClosed);
+    }
+
+    bool InSimClient::isConnected() const
+    {
+        return m_state == State::kConnected;
+    }
+
+    void InSimClient::update()
+    {
+        auto time = std::chrono::steady_clock::now();
+
+        switch (m_state)
+        {
+        case State::kClosed:
+            break;
+
+        case State::kWaitingToConnect:
+            if (time - m_stateTime >= kReconnectDelay)
+            {
+                connect();
+            }
+            break;
+
+        case State::kConnecting:
+            try
+            {
+                if (m_socket->isConnected())
+                {
+                    setState(State::kWaitingForVersion);
+                    m_lastReceiveTime = time;
+
+                    IS_ISI isi{};
+                    isi.Type = ISP_ISI;
+                    isi.ReqI = 1; // Asks for an IS_VER, which completes the handshake.
+                    isi.InSimVer = INSIM_VERSION;
+                    strncpy(isi.Admin, m_password.c_str(), sizeof(isi.Admin) - 1);
+                    strncpy(isi.IName, kProductName, sizeof(isi.IName) - 1);
+                    sendPacket(&isi, sizeof(isi));
+                }
+                else if (time - m_stateTime > kHandshakeTimeout)
+                {
+                    disconnect("timed out");
+                }
+            }
+            catch (const std::system_error &error)
+            {
+                disconnect(error.what());
+            }
+            break;
+
+        case State::kWaitingForVersion:
+            receive();
+            if (m_state == State::kWaitingForVersion && time - m_stateTime > kHandshakeTimeout)
+            {
+                disconnect("no version received");
+            }
+            break;
+
+        case State::kConnected:
+            receive();
+            if (m_state == State::kConnected && time - m_lastReceiveTime > kReceiveTimeout)
+            {
+                disconnect("timed out");
+            }
+            break;
+        }
+    }
+
+    const unsigned char *InSimClient::nextPacket()
+    {
+        while (m_socket)
+        {
+            unsigned int available = m_writeIndex - m_readIndex;
+            int size = available > 0 ? m_ring[m_readIndex & (kRingSize - 1)] * 4 : 0;
+            if (available == 0 || available < (unsigned int)size)
+            {
+                // The rest of the packet may have arrived since update().
+                receive();
+                if (!m_socket)
+                {
+                    return nullptr;
+                }
+
+                available = m_writeIndex - m_readIndex;
+                size = available > 0 ? m_ring[m_readIndex & (kRingSize - 1)] * 4 : 0;
+                if (available == 0 || available < (unsigned int)size)
+                {
+                    return nullptr;
+                }
+            }
+
+            if (size == 0)
+            {
+                disconnect("malformed packet");
+                return nullptr;
+            }
+
+            // The caller gets contiguous bytes even when the packet wraps around the end of the ring.
+            unsigned int offset = m_readIndex & (kRingSize - 1);
+            const unsigned char *packet = &m_ring[offset];
+            if (offset + size > kRingSize)
+            {
+                unsigned int firstPart = kRingSize - offset;
+                memcpy(m_packet, &m_ring[offset], firstPart);
+                memcpy(m_packet + firstPart, m_ring, size - firstPart);
+                packet = m_packet;
+            }
+            m_readIndex += size;
+
+            if (packet[1] == ISP_TINY && packet[3] == TINY_NONE)
+            {
+                sendTiny(TINY_NONE, 0);
+                continue;
+            }
+
+            if (packet[1] == ISP_VER && m_state == State::kWaitingForVersion)
+            {
+                setState(State::kConnected);
+                m_isConnectFailureLogged = false;
+                LOG_INFO("InSim connection established at %s:%i", m_hostname.c_str(), m_port);
+            }
+
+            return packet;
+        }
+
+        return nullptr;
+    }
+
+    void InSimClient::sendPacket(const void *packet, int size)
+    {
+        if (!m_socket || m_state == State::kConnecting || size < 4 || size > kMaxPacketSize || size % 4 != 0)
+        {
+            return;
+        }
+
+        unsigned char buffer[kMaxPacketSize];
+        memcpy(buffer, packet, size);
+        buffer[0] = (unsigned char)(size / 4);
+
+        try
+        {
+            m_socket->sendData(reinterpret_cast<const char *>(buffer), size);
+        }
+        catch (const std::system_error &error)
+        {
+            disconnect(error.what());
+        }
+    }
+
+    void InSimClient::sendTiny(unsigned char subType, unsigned char requestId)
+    {
+        IS_TINY tiny{};
+        tiny.Type = ISP_TINY;
+        tiny.ReqI = requestId;
+        tiny.SubT = subType;
+        sendPacket(&tiny, sizeof(tiny));
+    }
+
+    void InSimClient::connect()
+    {
+        try
+        {
+            m_socket = std::make_unique<TCPSocket>();
+            m_socket->connectTo(m_hostname, (unsigned short)m_port);
+            setState(State::kConnecting);
+        }
+        catch (const std::system_error &error)
+        {
+            disconnect(error.what());
+        }
+    }
+
+    void InSimClient::disconnect(const char *reason)
+    {
+        if (m_state == State::kConnected)
+        {
+            LOG_INFO("InSim connection lost (%s)", reason);
+        }
+        else if (!m_isConnectFailureLogged)
+        {
+            // LFS is often started after us, so only say it once.
+            LOG_WARN("Could not open InSim connection at %s:%i (%s), will keep trying", m_hostname.c_str(), m_port,
+                     reason);
+            m_isConnectFailureLogged = true;
+        }
+
+        m_socket.reset();
+        m_readIndex = 0;
+        m_writeIndex = 0;
+        setState(State::kWaitingToConnect);
+    }
+
+    void InSimClient::receive()
+    {
+        if (!m_socket || m_state == State::kConnecting)
+        {
+            return;
+        }
+
+        try
+        {
+            // Reads until the socket is drained or the ring is full, one contiguous chunk at a time.
+            while (m_writeIndex - m_readIndex < kRingSize)
+            {
+                unsigned int offset = m_writeIndex & (kRingSize - 1);
+                unsigned int space =
+                    std::min<unsigned int>(kRingSize - (m_writeIndex - m_readIndex), kRingSize - offset);
+                int received = m_socket->recvData(reinterpret_cast<char *>(&m_ring[offset]), (int)space);
+                if (received == 0)
+                {
+                    break;
+                }
+
+                m_writeIndex += received;
+                m_lastReceiveTime = std::chrono::steady_clock::now();
+            }
+        }
+        catch (const std::system_error &error)
+        {
+            disconnect(error.what());
+        }
+    }
+
+    void InSimClient::setState(State state)
+    {
+        m_state = state;
+        m_stateTime = std::chrono::steady_clock::now();
+    }
+} // namespace lfs
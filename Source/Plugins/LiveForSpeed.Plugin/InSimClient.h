@@ -0,0 +1,94 @@
+//
+// SliProSuperPro
+// A Shift Light Indicator controller
+// Copyright 2025 Fixfactory
+//
+// This file is part of SliProSuperPro.
+//
+// SliProSuperPro is free software: you can redistribute it and/or modify it under
+// the terms of the GNU General Public License as published by the Free
+// Software Foundation, either version 3 of the License, or any later version.
+//
+// SliProSuperPro is distributed in the hope that it will be useful, but WITHOUT
+// ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+// FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+// more details.
+//
+// You should have received a copy of the GNU General Public License along
+// with SliProSuperPro. If not, see <http://www.gnu.org/licenses/>.
+//
+
+#pragma once
+
+#include <chrono>
+#include <memory>
+#include <string>
+
+class TCPSocket;
+
+namespace lfs
+{
+    // Talks to Live For Speed's InSim over TCP without ever blocking, so it can be polled every frame.
+    // Connects in the background, answers keep-alives, and connects again when LFS closes InSim or isn't running yet.
+    // TCP can split and join packets, so they are reassembled in a ring buffer.
+    class InSimClient
+    {
+    public:
+        InSimClient();
+        ~InSimClient();
+
+        void open(const std::string &hostname, int port, const std::string &password);
+        void close();
+        bool isConnected() const;
+
+        // Connects or receives what is waiting, and returns immediately.
+        void update();
+
+        // Returns the next complete packet, or nullptr if there is none yet. Keep-alives are answered and not
+        // returned. The packet is only valid until the next call to update() or nextPacket().
+        const unsigned char *nextPacket();
+
+        // size is in bytes, and packet starts with the usual Size and Type fields.
+        void sendPacket(const void *packet, int size);
+        void sendTiny(unsigned char subType, unsigned char requestId);
+
+    private:
+        enum class State
+        {
+            kClosed,
+            kWaitingToConnect,
+            kConnecting,
+            kWaitingForVersion,
+            kConnected,
+        };
+
+        using time_point = std::chrono::steady_clock::time_point;
+
+        // Packet sizes are a byte counting 4 byte words. The ring holds a few of the largest ones.
+        static const int kMaxPacketSize = 255 * 4;
+        static const unsigned int kRingSize = 4096;
+
+        std::string m_hostname;
+        int m_port{ 0 };
+        std::string m_password;
+
+        std::unique_ptr<TCPSocket> m_socket;
+        State m_state{ State::kClosed };
+        time_point m_stateTime{};
+        time_point m_lastReceiveTime{};
+        bool m_isConnectFailureLogged{ false };
+
+        // Free-running indices, wrapped with kRingSize - 1.
+        alignas(4) unsigned char m_ring[kRingSize]{};
+        unsigned int m_readIndex{ 0 };
+        unsigned int m_writeIndex{ 0 };
+
+        // A packet that wraps around the end of the ring is copied here.
+        alignas(4) unsigned char m_packet[kMaxPacketSize]{};
+
+        void connect();
+        void disconnect(const char *reason);
+        void receive();
+        void setState(State state);
+    };
+} // namespace lfs
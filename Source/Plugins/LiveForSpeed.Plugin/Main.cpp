@@ -18,9 +18,12 @@
 // with SliProSuperPro. If not, see <http://www.gnu.org/licenses/>.
 //
 
-#include <Windows.h>
+#ifdef _WIN32
+    #include <Windows.h>
+#endif
 
 #include <string>
+#include <cstring>
 #include <iostream>
 #include <atomic>
 
@@ -29,9 +32,77 @@
 #include "PluginInterface.h"
 #include "Defines.h"
 #include "Telemetry.h"
+#include "Exports.h"
 
+namespace lfs
+{
+    std::string g_gameExecPath{};
+
+    int PluginExports::getPluginInterfaceVersion()
+    {
+        return plugin::kInterfaceVersion;
+    }
+
+    bool PluginExports::supportsInterfaceVersion(int interfaceVersion)
+    {
+        return interfaceVersion >= 1 && interfaceVersion <= 4;
+    }
+
+    void PluginExports::getGameExecFileName(std::string &outExecFileName)
+    {
+        outExecFileName = "LFS.exe";
+    }
+
+    void PluginExports::setGameIsRunning(bool isRunning, std::string execPath)
+    {
+        if (isRunning)
+        {
+            g_gameExecPath = execPath;
+            TelemetryManager::getSingleton().init();
+        }
+        else
+        {
+            TelemetryManager::getSingleton().deinit();
+            g_gameExecPath.clear();
+        }
+    }
+
+    bool PluginExports::getTelemetryData(plugin::TelemetryData *outTelemetryData, size_t telemetryDataSize)
+    {
+        if (TelemetryManager::getSingleton().fetchTelemetryData())
+        {
+            auto &telemetryData = TelemetryManager::getSingleton().getTelemetryData();
+            if (sizeof(telemetryData) >= telemetryDataSize)
+            {
+                memcpy(outTelemetryData, &telemetryData, telemetryDataSize);
+                return true;
+            }
+        }
+        return false;
+    }
+
+    bool PluginExports::getPhysicsData(plugin::PhysicsData *outPhysicsData, size_t physicsDataSize)
+    {
+        if (TelemetryManager::getSingleton().fetchTelemetryData())
+        {
+            auto &physicsData = TelemetryManager::getSingleton().getPhysicsData();
+            if (sizeof(physicsData) >= physicsDataSize)
+            {
+                memcpy(outPhysicsData, &physicsData, physicsDataSize);
+                return true;
+            }
+        }
+        return false;
+    }
+
+    bool PluginExports::getPhysicsDataEveryFrame()
+    {
+        return true;
+    }
+} // namespace lfs
+
+#if !defined(SPSP_STATIC_PLUGINS) && defined(_WIN32)
 std::atomic<int> g_dllAttachCount = 0;
-std::string g_gameExecPath{};
 
 BOOL APIENTRY DllMain(HMODULE hModule, DWORD ul_reason_for_call, LPVOID lpReserved)
 {
@@ -62,68 +133,57 @@ BOOL APIENTRY DllMain(HMODULE hModule, DWORD ul_reason_for_call, LPVOID lpReserv
 
     return TRUE;
 }
+#elif !defined(SPSP_STATIC_PLUGINS)
+// Shared objects are attached once, when they are loaded.
+__attribute__((constructor)) static void onLibraryLoaded()
+{
+    LogManager::getSingleton().init();
+    LOG_INFO("Loaded Live For Speed Plugin version 0.1.0");
+}
+
+__attribute__((destructor)) static void onLibraryUnloaded()
+{
+    LOG_INFO("Live For Speed Plugin unloaded");
+    LogManager::getSingleton().deinit();
+}
+#endif
 
+#ifndef SPSP_STATIC_PLUGINS
 extern "C"
 {
     int DLL_EXPORT getPluginInterfaceVersion()
     {
-        return plugin::kInterfaceVersion;
+        return lfs::PluginExports::getPluginInterfaceVersion();
     }
 
     bool DLL_EXPORT supportsInterfaceVersion(int interfaceVersion)
     {
-        return interfaceVersion >= 1 && interfaceVersion <= 1;
+        return lfs::PluginExports::supportsInterfaceVersion(interfaceVersion);
     }
 
     void DLL_EXPORT getGameExecFileName(std::string &outExecFileName)
     {
-        outExecFileName = "LFS.exe";
+        lfs::PluginExports::getGameExecFileName(outExecFileName);
     }
 
     void DLL_EXPORT setGameIsRunning(bool isRunning, std::string execPath)
     {
-        if (isRunning)
-        {
-            g_gameExecPath = execPath;
-            TelemetryManager::getSingleton().init();
-        }
-        else
-        {
-            TelemetryManager::getSingleton().deinit();
-            g_gameExecPath.clear();
-        }
+        lfs::PluginExports::setGameIsRunning(isRunning, execPath);
     }
 
     bool DLL_EXPORT getTelemetryData(plugin::TelemetryData *outTelemetryData, size_t telemetryDataSize)
     {
-        if (TelemetryManager::getSingleton().fetchTelemetryData())
-        {
-            auto &telemetryData = TelemetryManager::getSingleton().getTelemetryData();
-            if (sizeof(telemetryData) >= telemetryDataSize)
-            {
-                memcpy(outTelemetryData, &telemetryData, telemetryDataSize);
-                return true;
-            }
-        }
-        return false;
+        return lfs::PluginExports::getTelemetryData(outTelemetryData, telemetryDataSize);
     }
 
     bool DLL_EXPORT getPhysicsData(plugin::PhysicsData *outPhysicsData, size_t physicsDataSize)
     {
-        if (TelemetryManager::getSingleton().fetchTelemetryData())
-        {
-            auto &physicsData = TelemetryManager::getSingleton().getPhysicsData();
-            if (sizeof(physicsData) >= physicsDataSize)
-            {
-                memcpy(outPhysicsData, &physicsData, physicsDataSize);
-                return true;
-            }
-        }
-        return false;
+        return lfs::PluginExports::getPhysicsData(outPhysicsData, physicsDataSize);
     }
 
     bool DLL_EXPORT getPhysicsDataEveryFrame()
     {
-        return true;
+        return lfs::PluginExports::getPhysicsDataEveryFrame();
     }
 }
+#endif
@@ -19,219 +19,352 @@
 //
 
 #include "cinsim/CInsim.h" // Must include before Windows.h to avoid redefines
+#include "cinsim/OutSimPack.h"
 
-#include <Windows.h>
+#ifdef _WIN32
+    #include <Windows.h>
+#endif
 #include <fstream>
+#include <cstdio>
+#include <cstring>
+#include <cstddef>
 
 #include "Telemetry.h"
 #include "Network.h"
 #include "Log.h"
 
-const char *kConfigFileName = "LiveForSpeed.Config.json";
-const char *kCarDataFileName = "LiveForSpeed.CarData.json";
-const float kMpsToKph = 3.6f;
-const std::chrono::duration<float> kDataTimeout{ 2.f };
+namespace lfs
+{
+    const char *kConfigFileName = "LiveForSpeed.Config.json";
+    const char *kCarDataFileName = "LiveForSpeed.CarData.json";
+    const float kMpsToKph = 3.6f;
+    const std::chrono::duration<float> kDataTimeout{ 2.f };
 
-// Because when no ID is specified, the ID field is omitted.
-const size_t kOutGaugePackSizeNoId = sizeof(OutGaugePack) - sizeof(int);
+    // Because when no ID is specified, the ID field is omitted.
+    const size_t kOutGaugePackSizeNoId = sizeof(OutGaugePack) - sizeof(int);
 
-TelemetryManager &TelemetryManager::getSingleton()
-{
-    static TelemetryManager s_singleton;
-    return s_singleton;
-}
+    const float kRadPerSecToRpm = 60.f / (2.f * 3.14159265f);
 
-TelemetryManager::TelemetryManager()
-{
-}
+    // Packets older than the last one are out of order, unless time went back this far, when LFS restarted its clock.
+    const unsigned kTimeResetMs = 1000;
 
-TelemetryManager::~TelemetryManager()
-{
-}
+    // The Gear to MaxTorqueAtVel fields of OutSimPack2.
+    const int kDriveSize = offsetof(OutSimPack2, CurrentLapDist) - offsetof(OutSimPack2, Gear);
+    const int kEngineAngVelOffset = offsetof(OutSimPack2, EngineAngVel) - offsetof(OutSimPack2, Gear);
 
-void TelemetryManager::init()
-{
-    readCarData();
-    readConfig();
-    initOutGauge();
-    openInSim();
-}
+    // The fields OutSim sends are chosen with "OutSim Opts" in cfg.txt. Returns the size of the packet, and the offsets
+    // of the Time field and of the Gear to MaxTorqueAtVel fields.
+    static int getOutSimLayout(int options, int &outTimeOffset, int &outDriveOffset)
+    {
+        int size = 0;
+        size += (options & OSO_HEADER) ? 4 : 0;
+        size += (options & OSO_ID) ? sizeof(int) : 0;
+        outTimeOffset = size;
+        size += (options & OSO_TIME) ? sizeof(unsigned) : 0;
+        size += (options & OSO_MAIN) ? sizeof(OutSimMain) : 0;
+        size += (options & OSO_INPUTS) ? sizeof(OutSimInputs) : 0;
+        outDriveOffset = size;
+        size += (options & OSO_DRIVE) ? kDriveSize : 0;
+        size += (options & OSO_DISTANCE) ? 2 * sizeof(float) : 0;
+        size += (options & OSO_WHEELS) ? 4 * sizeof(OutSimWheel) : 0;
+        return size;
+    }
 
-void TelemetryManager::deinit()
-{
-    closeInSim();
-    deinitOutGauge();
-}
+    TelemetryManager &TelemetryManager::getSingleton()
+    {
+        static TelemetryManager s_singleton;
+        return s_singleton;
+    }
 
-void TelemetryManager::initOutGauge()
-{
-    m_session = new WSASession();
-    m_udpSocket = new UDPSocket();
+    TelemetryManager::TelemetryManager()
+    {
+    }
 
-    try
+    TelemetryManager::~TelemetryManager()
     {
-        m_udpSocket->bindTo(m_outGaugePort);
-        LOG_INFO("Listening to OutGauge data on port %i", m_outGaugePort);
     }
-    catch (const std::system_error &error)
+
+    void TelemetryManager::init()
     {
-        LOG_ERROR(error);
+        m_cars.init(kCarDataFileName, parseCar);
+        readConfig();
+        initOutGauge();
+        initOutSim();
+        openInSim();
     }
 
-    m_recvBuf.resize(kOutGaugePackSizeNoId);
-}
+    void TelemetryManager::deinit()
+    {
+        m_cars.deinit();
+        closeInSim();
+        deinitOutSim();
+        deinitOutGauge();
+    }
 
-void TelemetryManager::deinitOutGauge()
-{
-    if (m_udpSocket)
+    void TelemetryManager::initOutGauge()
     {
-        delete m_udpSocket;
-        m_udpSocket = nullptr;
-    }    
+        m_session = new WSASession();
+        m_udpSocket = new UDPSocket();
 
-    if (m_session)
+        try
+        {
+            m_udpSocket->bindTo(m_outGaugePort);
+            LOG_INFO("Listening to OutGauge data on port %i", m_outGaugePort);
+            addRelayDestinations(m_udpSocket, m_outGaugeRelay, "OutGauge");
+        }
+        catch (const std::system_error &error)
+        {
+            LOG_ERROR(error);
+        }
+
+        m_recvBuf.resize(kOutGaugePackSizeNoId);
+    }
+
+    void TelemetryManager::deinitOutGauge()
     {
-        delete m_session;
-        m_session = nullptr;
-    }    
-}
+        if (m_udpSocket)
+        {
+            delete m_udpSocket;
+            m_udpSocket = nullptr;
+        }
 
-bool TelemetryManager::recvOutGauge(OutGaugePack &outGaugePack)
-{
-    sockaddr_in fromAddr;
-    bool gotData = false;
+        if (m_session)
+        {
+            delete m_session;
+            m_session = nullptr;
+        }
+
+        m_outGaugeEngine = {};
+    }
 
-    try
+    const OutGaugePack *TelemetryManager::recvOutGauge()
     {
-        while (m_udpSocket->hasData())
+        bool gotData = false;
+
+        try
         {
-            m_udpSocket->recvData(m_recvBuf, fromAddr);
-            if (m_recvBuf.size() != kOutGaugePackSizeNoId)
+            // Only the newest packet is used, so the older ones waiting are skipped without being decoded.
+            int count = 0;
+            int malformedCount = 0;
+            gotData = m_udpSocket->recvLatest(m_recvBuf.data(), (int)m_recvBuf.size(), count, malformedCount);
+            if (malformedCount > 0)
             {
-                LOG_ERROR("Malformed OutGauge data (size %i, expected %i)", m_recvBuf.size(), kOutGaugePackSizeNoId);
-                continue;
+                LOG_ERROR("Malformed OutGauge data (%i packets, expected size %i)", malformedCount,
+                          (int)kOutGaugePackSizeNoId);
             }
+        }
+        catch (const std::system_error &error)
+        {
+            LOG_ERROR(error);
+        }
+
+        return gotData ? reinterpret_cast<const OutGaugePack *>(m_recvBuf.data()) : nullptr;
+    }
 
-            outGaugePack = *reinterpret_cast<OutGaugePack *>(m_recvBuf.data());
-            gotData = true;
+    void TelemetryManager::initOutSim()
+    {
+        if (!m_useOutSim)
+        {
+            return;
         }
+
+        int size = getOutSimLayout(m_outSimOptions, m_outSimTimeOffset, m_outSimDriveOffset);
+        if (!(m_outSimOptions & OSO_TIME) || !(m_outSimOptions & OSO_DRIVE))
+        {
+            LOG_ERROR("OutSim options must include time (%x) and drive (%x) data", OSO_TIME, OSO_DRIVE);
+            return;
+        }
+
+        m_outSimSocket = new UDPSocket();
+
+        try
+        {
+            m_outSimSocket->bindTo(m_outSimPort);
+            LOG_INFO("Listening to OutSim data on port %i", m_outSimPort);
+            addRelayDestinations(m_outSimSocket, m_outSimRelay, "OutSim");
+        }
+        catch (const std::system_error &error)
+        {
+            LOG_ERROR(error);
+        }
+
+        m_outSimRecvBuf.resize(size);
     }
-    catch (const std::system_error &error)
+
+    void TelemetryManager::deinitOutSim()
     {
-        LOG_ERROR(error);
+        if (m_outSimSocket)
+        {
+            delete m_outSimSocket;
+            m_outSimSocket = nullptr;
+        }
+
+        m_outSimEngine = {};
     }
 
-    return gotData;
-}
+    void TelemetryManager::recvOutSim()
+    {
+        bool gotData = false;
 
-bool TelemetryManager::fetchTelemetryData()
-{
-    // We currently don't use InSim because we get all the data we need from OutGauge.
-    // TODO: refactor CInsim::next_packet() to avoid a blocking call.
-    if (m_useInSim)
+        try
+        {
+            int count = 0;
+            int malformedCount = 0;
+            gotData =
+                m_outSimSocket->recvLatest(m_outSimRecvBuf.data(), (int)m_outSimRecvBuf.size(), count, malformedCount);
+            if (malformedCount > 0)
+            {
+                LOG_ERROR("Malformed OutSim data (%i packets, expected size %i), check OutSim Opts in cfg.txt",
+                          malformedCount, (int)m_outSimRecvBuf.size());
+            }
+        }
+        catch (const std::system_error &error)
+        {
+            LOG_ERROR(error);
+        }
+
+        if (!gotData)
+        {
+            return;
+        }
+
+        const char *packet = m_outSimRecvBuf.data();
+        unsigned time;
+        float engineAngVel;
+        memcpy(&time, packet + m_outSimTimeOffset, sizeof(time));
+        memcpy(&engineAngVel, packet + m_outSimDriveOffset + kEngineAngVelOffset, sizeof(engineAngVel));
+
+        if (isNewer(m_outSimEngine, time))
+        {
+            m_outSimEngine.time = time;
+            m_outSimEngine.receiveTime = std::chrono::steady_clock::now();
+            m_outSimEngine.gear = (unsigned char)packet[m_outSimDriveOffset];
+            m_outSimEngine.rpm = engineAngVel * kRadPerSecToRpm;
+        }
+    }
+
+    bool TelemetryManager::isNewer(const EngineSample &sample, unsigned time) const
     {
-        if (CInsim::getInstance()->next_packet() == 0)
+        return sample.receiveTime == time_point{} || time > sample.time || sample.time - time > kTimeResetMs;
+    }
+
+    void TelemetryManager::fuseEngineSamples(time_point time)
+    {
+        // Both streams are stamped with LFS's clock, so the newest engine state wins. OutSim is usually sent more
+        // often, so it fills in between OutGauge packets.
+        const EngineSample *engine = &m_outGaugeEngine;
+        if (m_outSimEngine.receiveTime != time_point{} && time - m_outSimEngine.receiveTime <= kDataTimeout &&
+            m_outSimEngine.time >= m_outGaugeEngine.time)
         {
-            char packetType = CInsim::getInstance()->peek_packet();
-            void *packet = CInsim::getInstance()->get_packet();
+            engine = &m_outSimEngine;
+        }
+
+        m_telemetryData.gear = engine->gear;
+        m_telemetryData.rpm = engine->rpm;
+    }
+
+    bool TelemetryManager::fetchTelemetryData()
+    {
+        recvInSim();
 
-            switch (packetType)
+        auto time = std::chrono::steady_clock::now();
+        if (m_udpSocket && m_udpSocket->isBound())
+        {
+            const OutGaugePack *outGaugePack = recvOutGauge();
+            if (outGaugePack)
             {
-            case ISP_NPL: {
-                // New player joining race
-                IS_NPL *npl = reinterpret_cast<IS_NPL *>(packet);
+                if (isNewer(m_outGaugeEngine, outGaugePack->Time))
+                {
+                    m_outGaugeEngine.time = outGaugePack->Time;
+                    m_outGaugeEngine.receiveTime = time;
+                    m_outGaugeEngine.gear = outGaugePack->Gear;
+                    m_outGaugeEngine.rpm = outGaugePack->RPM;
+                }
+
+                m_telemetryData.speedKph = outGaugePack->Speed * kMpsToKph;
+                const unsigned kSpeedLimiterFlag = 1 << DL_PITSPEED;
+                m_telemetryData.speedLimiter = outGaugePack->ShowLights & kSpeedLimiterFlag;
 
-                // 0 is local player
-                if (npl->UCID == 0)
+                // Leaves the car found by InSim when OutGauge doesn't name one.
+                if (outGaugePack->Car[0] != '\0')
                 {
                     const size_t kSize = 8;
                     char expanded_name[kSize];
-                    expand_prefix(npl->CName, expanded_name, kSize);
+                    expand_prefix(outGaugePack->Car, expanded_name, kSize);
                     m_carId = expanded_name;
                 }
-            }
-            break;
 
-            default:
-                break;
+                if (!m_receivingTelemetry)
+                {
+                    LOG_INFO("Started receiving OutGauge data");
+                    m_receivingTelemetry = true;
+                }
+
+                m_lastDataTime = time;
             }
         }
-    }
 
-    auto time = std::chrono::steady_clock::now();
-    if (m_udpSocket && m_udpSocket->isBound())
-    {
-        OutGaugePack outGaugePack;
-        if (recvOutGauge(outGaugePack))
+        if (m_outSimSocket && m_outSimSocket->isBound())
         {
-            m_telemetryData.gear = outGaugePack.Gear;
-            m_telemetryData.rpm = outGaugePack.RPM;
-            m_telemetryData.speedKph = outGaugePack.Speed * kMpsToKph;
-            const unsigned kSpeedLimiterFlag = 1 << DL_PITSPEED;
-            m_telemetryData.speedLimiter = outGaugePack.ShowLights & kSpeedLimiterFlag;
-
-            const size_t kSize = 8;
-            char expanded_name[kSize];
-            expand_prefix(outGaugePack.Car, expanded_name, kSize);
-            m_carId = expanded_name;
-
-            if (!m_receivingTelemetry)
+            recvOutSim();
+        }
+        fuseEngineSamples(time);
+
+        if (m_receivingTelemetry && time - m_lastDataTime > kDataTimeout)
+        {
+            LOG_INFO("Stopped receiving OutGauge data");
+            m_receivingTelemetry = false;
+        }
+
+        if (m_carId != m_lastCarId)
+        {
+            m_isCarPending = !m_carId.empty();
+            if (m_carId.empty())
             {
-                LOG_INFO("Started receiving OutGauge data");
-                m_receivingTelemetry = true;
+                LOG_INFO("Player exited car", m_carId.c_str());
             }
 
-            m_lastDataTime = time;
+            m_lastCarId = m_carId;
         }
-    }
-
-    if (m_receivingTelemetry && time - m_lastDataTime > kDataTimeout)
-    {
-        LOG_INFO("Stopped receiving OutGauge data");
-        m_receivingTelemetry = false;
-    }
 
-    if (m_carId != m_lastCarId)
-    {
-        if (!m_carId.empty())
+        // The car being driven gets the values of an edited car data file.
+        if (m_cars.update() && !m_isCarPending && !m_carId.empty())
         {
-            parseCarData();
-            LOG_INFO("Player entered new car (id: %s) (name: %s)", m_carId.c_str(), m_carName.c_str());
+            selectCar();
+            LOG_INFO("Read the car data of %s again", m_carId.c_str());
         }
-        else
+
+        if (m_isCarPending && m_cars.isLoaded())
         {
-            LOG_INFO("Player exited car", m_carId.c_str());
+            m_isCarPending = false;
+            selectCar();
+            LOG_INFO("Player entered new car (id: %s) (name: %s)", m_carId.c_str(), m_carName.c_str());
         }
-        
-        m_lastCarId = m_carId;
-    }
-    
-    return m_receivingTelemetry;
-}
 
-const plugin::TelemetryData &TelemetryManager::getTelemetryData() const
-{
-    return m_telemetryData;
-}
+        return m_receivingTelemetry;
+    }
 
-const plugin::PhysicsData &TelemetryManager::getPhysicsData() const
-{
-    return m_physicsData;
-}
+    const plugin::TelemetryData &TelemetryManager::getTelemetryData() const
+    {
+        return m_telemetryData;
+    }
 
-void TelemetryManager::readConfig()
-{
-    std::ifstream file(kConfigFileName);
-    if (!file.good())
+    const plugin::PhysicsData &TelemetryManager::getPhysicsData() const
     {
-        LOG_ERROR("Could not open %s", kConfigFileName);
-        return;
+        return m_physicsData;
     }
 
-    auto config = json::parse(file);
-    if (!config.empty())
+    void TelemetryManager::readConfig()
     {
-        if (m_useInSim)
+        std::ifstream file(kConfigFileName);
+        if (!file.good())
+        {
+            LOG_ERROR("Could not open %s", kConfigFileName);
+            return;
+        }
+
+        auto config = json::parse(file);
+        if (!config.empty())
         {
             auto inSim = config["InSim"];
             if (!inSim.empty())
@@ -266,194 +399,143 @@ void TelemetryManager::readConfig()
             {
                 LOG_ERROR("Missing InSim settings in config file");
             }
-        }
 
-        auto outGauge = config["OutGauge"];
-        if (!outGauge.empty())
-        {
-            auto port = outGauge["port"];
-            if (!port.empty())
+            auto outGauge = config["OutGauge"];
+            if (!outGauge.empty())
             {
-                m_outGaugePort = port.template get<int>();
+                auto port = outGauge["port"];
+                if (!port.empty())
+                {
+                    m_outGaugePort = port.template get<int>();
+                }
+                else
+                {
+                    LOG_ERROR("Missing port in config file");
+                }
+
+                m_outGaugeRelay = readRelayDestinations(outGauge);
             }
             else
             {
-                LOG_ERROR("Missing port in config file");
+                LOG_ERROR("Missing OutGauge settings in config file");
+            }
+
+            // OutSim is optional, for more frequent engine data.
+            auto outSim = config["OutSim"];
+            if (!outSim.empty() && !outSim["enabled"].empty() && outSim["enabled"].template get<bool>())
+            {
+                auto port = outSim["port"];
+                auto options = outSim["options"];
+                if (!port.empty() && !options.empty())
+                {
+                    m_outSimPort = port.template get<int>();
+
+                    // Hexadecimal like in cfg.txt.
+                    std::string optionsStr = options.template get<std::string>();
+                    m_outSimOptions = (int)strtol(optionsStr.c_str(), nullptr, 16);
+                    m_useOutSim = true;
+
+                    m_outSimRelay = readRelayDestinations(outSim);
+                }
+                else
+                {
+                    LOG_ERROR("Missing OutSim port or options in config file");
+                }
             }
         }
         else
         {
-            LOG_ERROR("Missing OutGauge settings in config file");
+            LOG_ERROR("Empty config file");
         }
     }
-    else
-    {
-        LOG_ERROR("Empty config file");
-    }
-}
 
-void TelemetryManager::readCarData()
-{
-    std::ifstream file(kCarDataFileName);
-    if (file.good())
+    void TelemetryManager::addRelayDestinations(UDPSocket *socket, const RelayDestinations &destinations,
+                                                const char *name)
     {
-        LOG_INFO("Reading %s", kCarDataFileName);
-        m_carData = json::parse(file);
+        for (const auto &destination : destinations)
+        {
+            socket->addRelayDestination(destination.first, destination.second);
+            LOG_INFO("Relaying %s data to %s:%i", name, destination.first.c_str(), destination.second);
+        }
     }
-}
 
-void TelemetryManager::parseCarData()
-{
-    memset(&m_physicsData, 0, sizeof(m_physicsData));
-
-    if (m_carId.empty())
+    void TelemetryManager::selectCar()
     {
-        return;
-    }
+        memset(&m_physicsData, 0, sizeof(m_physicsData));
 
-    if (m_carData.empty())
-    {
-        LOG_WARN("Empty car data file");
-        return;
-    }
+        if (m_carId.empty())
+        {
+            return;
+        }
+        snprintf(m_physicsData.carId, sizeof(m_physicsData.carId), "%s", m_carId.c_str());
 
-    auto carData = m_carData["cars"][m_carId];
-    if (carData.empty())
-    {
-        carData = m_carData["cars"]["mods"][m_carId];
-        if (carData.empty())
+        if (m_cars.getCarCount() == 0)
+        {
+            LOG_WARN("Empty car data file");
+            return;
+        }
+
+        const Car *car = m_cars.find(m_carId);
+        if (!car)
         {
             LOG_WARN("Car not found in car data file");
             return;
         }
-    }
 
-    auto name = carData["name"];
-    if (!name.empty())
-    {
-        m_carName = name.template get<std::string>();
-    }
-    else
-    {
-        LOG_WARN("name not specified in car data file");
+        logCarWarnings(*car);
+        m_carName = car->name;
+        m_physicsData = car->physicsData;
+        snprintf(m_physicsData.carId, sizeof(m_physicsData.carId), "%s", m_carId.c_str());
     }
 
-    auto finalGear = carData["finalGear"];
-    if (!finalGear.empty())
+    void TelemetryManager::openInSim()
     {
-        m_physicsData.gearCount = finalGear.template get<int>();
-        if (m_physicsData.gearCount == 0)
+        if (m_inSimHostname.empty() || m_inSimPort == 0)
         {
-            // When finalGear is 0 it means we don't know the value for that car.
-            // The shift lights will blink when reaching the upshift rpm on the last gear.
-            m_physicsData.gearCount = plugin::kMaxGearCount;
+            return;
         }
-        else
-        {
-            // Add reverse and neutral
-            m_physicsData.gearCount += 2;
-        }        
-    }
-    else
-    {
-        LOG_WARN("finalGear not specified in car data file");
+
+        // Connects in the background, so LFS can be started before or after us.
+        m_inSim.open(m_inSimHostname, m_inSimPort, m_inSimPassword);
     }
-    
-    auto rpmLimit = carData["rpmLimit"];
-    if (!rpmLimit.empty())
-    {
-        m_physicsData.rpmLimit = rpmLimit.template get<float>();
-    }    
-    else
+
+    void TelemetryManager::closeInSim()
     {
-        LOG_WARN("rpmLimit not specified in car data file");
+        m_inSim.close();
     }
 
-    int gearFound = 0;
-    if (!carData["rpmDownshift"].empty() && !carData["rpmUpshift"].empty())
+    void TelemetryManager::recvInSim()
     {
-        float rpmDownshift = carData["rpmDownshift"].template get<float>();
-        float rpmUpshift = carData["rpmUpshift"].template get<float>();
+        m_inSim.update();
 
-        for (int i = 0; i < plugin::kMaxGearCount; i++)
+        while (const unsigned char *packet = m_inSim.nextPacket())
         {
-            m_physicsData.rpmDownshift[i] = rpmDownshift;
-            m_physicsData.rpmUpshift[i] = rpmUpshift;
-            gearFound++;
-        }
-    }
-    else
-    {
-        for (auto &gear : carData["gears"].items())
-        {
-            if (gear.value()["gear"].empty() || gear.value()["rpmDownshift"].empty() || gear.value()["rpmUpshift"].empty())
+            switch (packet[1])
             {
-                continue;
-            }
+            case ISP_VER:
+                // Asks for the players already in the race, as we only hear about players joining later.
+                m_inSim.sendTiny(TINY_NPL, 2);
+                break;
 
-            std::string gearName = gear.value()["gear"].template get<std::string>();
-            float rpmDownshift = gear.value()["rpmDownshift"].template get<float>();
-            float rpmUpshift = gear.value()["rpmUpshift"].template get<float>();
+            case ISP_NPL: {
+                // New player joining race
+                const IS_NPL *npl = reinterpret_cast<const IS_NPL *>(packet);
 
-            int gearIdx = -1;
-            if (gearName == "R")
-            {
-                gearIdx = 0;
-            }
-            else if (gearName == "N")
-            {
-                gearIdx = 1;
-            }
-            else
-            {
-                gearIdx = atoi(gearName.c_str());
-                gearIdx++; // e.g. gear "1" is at index 2.
+                // 0 is local player. AI drivers on our connection have it too.
+                const unsigned char kAIPlayer = 2;
+                if (npl->UCID == 0 && !(npl->PType & kAIPlayer))
+                {
+                    const size_t kSize = 8;
+                    char expanded_name[kSize];
+                    expand_prefix(npl->CName, expanded_name, kSize);
+                    m_carId = expanded_name;
+                }
             }
+            break;
 
-            if (gearIdx >= 0 && gearIdx < plugin::kMaxGearCount)
-            {
-                m_physicsData.rpmDownshift[gearIdx] = rpmDownshift;
-                m_physicsData.rpmUpshift[gearIdx] = rpmUpshift;
-                gearFound++;
+            default:
+                break;
             }
         }
     }
-
-    if (gearFound < m_physicsData.gearCount)
-    {
-        LOG_WARN("missing rpm info in car data file");
-    }
-}
-
-void TelemetryManager::openInSim()
-{
-    if (!m_useInSim)
-    {
-        return;
-    }
-
-    CInsim::getInstance()->setHost(m_inSimHostname);
-    CInsim::getInstance()->setTCPPort(m_inSimPort);
-    CInsim::getInstance()->setPassword(m_inSimPassword);
-    CInsim::getInstance()->setProduct("SliProSuperPro");
-    CInsim::getInstance()->setVersion(9);
-
-    if (CInsim::getInstance()->init() < 0)
-    {
-        LOG_ERROR("Could not open InSim connection at %s:%i", m_inSimHostname.c_str(), m_inSimPort);
-        return;
-    }
-
-    LOG_INFO("InSim connection established at %s:%i", m_inSimHostname.c_str(), m_inSimPort);
-}
-
-void TelemetryManager::closeInSim()
-{
-    if (!m_useInSim)
-    {
-        return;
-    }
-
-    CInsim::getInstance()->disconnect();
-    CInsim::getInstance()->removeInstance();
-}
+} // namespace lfs
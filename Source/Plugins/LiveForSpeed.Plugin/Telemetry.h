@@ -20,62 +20,111 @@
 
 #pragma once
 
-#include "PluginInterface.h"
+#include <string>
+#include <vector>
+#include <utility>
+#include <chrono>
 
-#include "json/json.hpp"
-using json = nlohmann::json;
+#include "PluginInterface.h"
+#include "InSimClient.h"
+#include "OverrideIndex.h"
+#include "CarData.h"
 
 class WSASession;
 class UDPSocket;
 struct OutGaugePack;
 
-class TelemetryManager
+namespace lfs
 {
-public:
-    static TelemetryManager &getSingleton();
-
-    TelemetryManager();
-    ~TelemetryManager();
-
-    void init();
-    void deinit();
-
-    bool fetchTelemetryData();
-    const plugin::TelemetryData &getTelemetryData() const;
-    const plugin::PhysicsData &getPhysicsData() const;
-
-private:
-    WSASession *m_session = nullptr;
-    UDPSocket *m_udpSocket = nullptr;
-    std::vector<char> m_recvBuf;
-    bool m_receivingTelemetry{ false };
-
-    using time_point = std::chrono::steady_clock::time_point;
-    time_point m_lastDataTime = {};
-
-    plugin::TelemetryData m_telemetryData{};
-    plugin::PhysicsData m_physicsData{};
-
-    json m_carData;
-    std::string m_carId;
-    std::string m_lastCarId;
-    std::string m_carName;
-
-    bool m_useInSim{ false };
-    std::string m_inSimHostname;
-    int m_inSimPort{ 0 };
-    std::string m_inSimPassword;
-
-    int m_outGaugePort{ 0 };
-
-    void readConfig();
-    void readCarData();
-    void parseCarData();
-
-    void openInSim();
-    void closeInSim();
-
-    void initOutGauge();
-    void deinitOutGauge();
-    bool recvOutGauge(OutGaugePack &outGaugePack);
-};
+    class TelemetryManager
+    {
+    public:
+        static TelemetryManager &getSingleton();
+
+        TelemetryManager();
+        ~TelemetryManager();
+
+        void init();
+        void deinit();
+
+        bool fetchTelemetryData();
+        const plugin::TelemetryData &getTelemetryData() const;
+        const plugin::PhysicsData &getPhysicsData() const;
+
+    private:
+        WSASession *m_session = nullptr;
+        UDPSocket *m_udpSocket = nullptr;
+        std::vector<char> m_recvBuf;
+        bool m_receivingTelemetry{ false };
+
+        using time_point = std::chrono::steady_clock::time_point;
+        time_point m_lastDataTime = {};
+
+        // Engine state from OutGauge or OutSim, with LFS's time of the packet and when it was received.
+        struct EngineSample
+        {
+            unsigned time{ 0 };
+            time_point receiveTime{};
+            int gear{ 0 };
+            float rpm{ 0.f };
+        };
+
+        EngineSample m_outGaugeEngine;
+        EngineSample m_outSimEngine;
+
+        plugin::TelemetryData m_telemetryData{};
+        plugin::PhysicsData m_physicsData{};
+
+        // Every car of the car data file, read in the background when the plugin starts so entering a car is a lookup,
+        // and again when the file is edited.
+        overrides::WatchedCarIndex<Car> m_cars;
+
+        // The car was entered while the car data was still being read. Its values are set once it is read, and the
+        // previous car's are kept until then.
+        bool m_isCarPending{ false };
+
+        std::string m_carId;
+        std::string m_lastCarId;
+        std::string m_carName;
+
+        InSimClient m_inSim;
+        std::string m_inSimHostname;
+        int m_inSimPort{ 0 };
+        std::string m_inSimPassword;
+
+        // Where OutGauge and OutSim packets are forwarded to, so other apps can get them too.
+        using RelayDestinations = std::vector<std::pair<std::string, int>>;
+
+        int m_outGaugePort{ 0 };
+        RelayDestinations m_outGaugeRelay;
+
+        // OutSim packets are laid out according to the options set in LFS's cfg.txt.
+        bool m_useOutSim{ false };
+        int m_outSimPort{ 0 };
+        int m_outSimOptions{ 0 };
+        int m_outSimTimeOffset{ 0 };
+        int m_outSimDriveOffset{ 0 };
+        RelayDestinations m_outSimRelay;
+        UDPSocket *m_outSimSocket = nullptr;
+        std::vector<char> m_outSimRecvBuf;
+
+        void readConfig();
+        void addRelayDestinations(UDPSocket *socket, const RelayDestinations &destinations, const char *name);
+        void selectCar();
+
+        void openInSim();
+        void closeInSim();
+        void recvInSim();
+
+        void initOutGauge();
+        void deinitOutGauge();
+        const OutGaugePack *recvOutGauge();
+
+        void initOutSim();
+        void deinitOutSim();
+        void recvOutSim();
+
+        bool isNewer(const EngineSample &sample, unsigned time) const;
+        void fuseEngineSamples(time_point time);
+    };
+} // namespace lfs
@@ -0,0 +1,303 @@
+//
+// SliProSuperPro
+// A Shift Light Indicator controller
+// Copyright 2025 Fixfactory
+//
+// This file is part of SliProSuperPro.
+//
+// SliProSuperPro is free software: you can redistribute it and/or modify it under
+// the terms of the GNU General Public License as published by the Free
+// Software Foundation, either version 3 of the License, or any later version.
+//
+// SliProSuperPro is distributed in the hope that it will be useful, but WITHOUT
+// ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+// FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+// more details.
+//
+// You should have received a copy of the GNU General Public License along
+// with SliProSuperPro. If not, see <http://www.gnu.org/licenses/>.
+//
+
+#include <array>
+#include <charconv>
+#include <cstdint>
+#include <string_view>
+
+#include "LspParser.h"
+
+namespace rbrNgp
+{
+    namespace ngp
+    {
+        enum class KeyType
+        {
+            kNumberOfGears,
+            kRpmLimit,
+            kTorqueCurve,
+            kGearRatio,
+            kGearUpshift,
+            kGearDownshift,
+        };
+
+        struct Key
+        {
+            std::string_view name;
+            KeyType type;
+            int gear;
+        };
+
+        constexpr Key kKeys[] = {
+            { "NumberOfGears", KeyType::kNumberOfGears, 0 },
+            { "RPMLimit", KeyType::kRpmLimit, 0 },
+            { "TorqueCurve", KeyType::kTorqueCurve, 0 },
+            { "Gear0Ratio", KeyType::kGearRatio, 0 },
+            { "Gear0Upshift", KeyType::kGearUpshift, 0 },
+            { "Gear0Downshift", KeyType::kGearDownshift, 0 },
+            { "Gear1Ratio", KeyType::kGearRatio, 1 },
+            { "Gear1Upshift", KeyType::kGearUpshift, 1 },
+            { "Gear1Downshift", KeyType::kGearDownshift, 1 },
+            { "Gear2Ratio", KeyType::kGearRatio, 2 },
+            { "Gear2Upshift", KeyType::kGearUpshift, 2 },
+            { "Gear2Downshift", KeyType::kGearDownshift, 2 },
+            { "Gear3Ratio", KeyType::kGearRatio, 3 },
+            { "Gear3Upshift", KeyType::kGearUpshift, 3 },
+            { "Gear3Downshift", KeyType::kGearDownshift, 3 },
+            { "Gear4Ratio", KeyType::kGearRatio, 4 },
+            { "Gear4Upshift", KeyType::kGearUpshift, 4 },
+            { "Gear4Downshift", KeyType::kGearDownshift, 4 },
+            { "Gear5Ratio", KeyType::kGearRatio, 5 },
+            { "Gear5Upshift", KeyType::kGearUpshift, 5 },
+            { "Gear5Downshift", KeyType::kGearDownshift, 5 },
+            { "Gear6Ratio", KeyType::kGearRatio, 6 },
+            { "Gear6Upshift", KeyType::kGearUpshift, 6 },
+            { "Gear6Downshift", KeyType::kGearDownshift, 6 },
+            { "Gear7Ratio", KeyType::kGearRatio, 7 },
+            { "Gear7Upshift", KeyType::kGearUpshift, 7 },
+            { "Gear7Downshift", KeyType::kGearDownshift, 7 },
+        };
+        constexpr int kKeyCount = sizeof(kKeys) / sizeof(kKeys[0]);
+        static_assert(kKeyCount < 128, "Slots hold key indices in a signed char");
+
+        constexpr size_t kMinKeyLength = 8;
+        constexpr size_t kMaxKeyLength = 14;
+        constexpr uint32_t kSlotCount = 128;
+
+        constexpr bool hasKeyLengths()
+        {
+            for (const Key &key : kKeys)
+            {
+                if (key.name.size() < kMinKeyLength || key.name.size() > kMaxKeyLength)
+                {
+                    return false;
+                }
+            }
+            return true;
+        }
+        static_assert(hasKeyLengths(), "Words outside the key lengths are skipped without hashing");
+
+        // FNV-1a, starting from a seed that gives every key its own slot.
+        constexpr uint32_t hashKey(std::string_view key, uint32_t seed)
+        {
+            uint32_t hash = seed;
+            for (char c : key)
+            {
+                hash = (hash ^ (unsigned char)c) * 16777619u;
+            }
+            return hash;
+        }
+
+        constexpr bool isPerfect(uint32_t seed)
+        {
+            bool isUsed[kSlotCount]{};
+            for (const Key &key : kKeys)
+            {
+                uint32_t slot = hashKey(key.name, seed) % kSlotCount;
+                if (isUsed[slot])
+                {
+                    return false;
+                }
+                isUsed[slot] = true;
+            }
+            return true;
+        }
+
+        constexpr uint32_t findSeed()
+        {
+            uint32_t seed = 2166136261u;
+            while (!isPerfect(seed))
+            {
+                seed++;
+            }
+            return seed;
+        }
+
+        constexpr uint32_t kSeed = findSeed();
+
+        constexpr std::array<signed char, kSlotCount> makeSlots()
+        {
+            std::array<signed char, kSlotCount> slots{};
+            slots.fill(-1);
+            for (int i = 0; i < kKeyCount; i++)
+            {
+                slots[hashKey(kKeys[i].name, kSeed) % kSlotCount] = (signed char)i;
+            }
+            return slots;
+        }
+
+        constexpr std::array<signed char, kSlotCount> kSlots = makeSlots();
+
+        static const Key *findKey(std::string_view word)
+        {
+            if (word.size() < kMinKeyLength || word.size() > kMaxKeyLength)
+            {
+                return nullptr;
+            }
+
+            int index = kSlots[hashKey(word, kSeed) % kSlotCount];
+            if (index < 0 || kKeys[index].name != word)
+            {
+                return nullptr;
+            }
+            return &kKeys[index];
+        }
+
+        static bool isSpace(char c)
+        {
+            return c == ' ' || c == '\t' || c == '\r' || c == '\n';
+        }
+
+        static bool isDelimiter(char c)
+        {
+            return isSpace(c) || c == '(' || c == ')' || c == ';' || c == '"';
+        }
+
+        static void setValue(const Key &key, float value, CarPhysics &outCarPhysics)
+        {
+            switch (key.type)
+            {
+            case KeyType::kNumberOfGears:
+                outCarPhysics.drive.numberOfGears = (int)value;
+                break;
+            case KeyType::kRpmLimit:
+                outCarPhysics.controlUnit.rpmLimit = value;
+                break;
+            case KeyType::kGearRatio:
+                outCarPhysics.drive.gearRatio[key.gear] = value;
+                break;
+            case KeyType::kGearUpshift:
+                outCarPhysics.controlUnit.gearUpShift[key.gear] = value;
+                break;
+            case KeyType::kGearDownshift:
+                outCarPhysics.controlUnit.gearDownShift[key.gear] = value;
+                break;
+            case KeyType::kTorqueCurve:
+                break;
+            }
+        }
+
+        void parseCommon(const char *data, size_t size, CarPhysics &outCarPhysics)
+        {
+            const char *p = data;
+            const char *end = data + size;
+
+            // The key whose value is the next word.
+            const Key *key = nullptr;
+
+            int depth = 0;
+
+            // The depth of the list after TorqueCurve while in it, or -1.
+            int torqueCurveDepth = -1;
+            bool hasRpm = false;
+            Engine &engine = outCarPhysics.engine;
+
+            while (p < end)
+            {
+                char c = *p;
+                if (isSpace(c))
+                {
+                    p++;
+                }
+                else if (c == ';')
+                {
+                    while (p < end && *p != '\n')
+                    {
+                        p++;
+                    }
+                }
+                else if (c == '"')
+                {
+                    for (p++; p < end && *p != '"'; p++)
+                    {
+                    }
+                    p++;
+                    key = nullptr;
+                }
+                else if (c == '(')
+                {
+                    depth++;
+                    p++;
+                    if (key && key->type == KeyType::kTorqueCurve)
+                    {
+                        torqueCurveDepth = depth;
+                        engine.torqueCurvePointCount = 0;
+                        hasRpm = false;
+                    }
+                    key = nullptr;
+                }
+                else if (c == ')')
+                {
+                    if (depth == torqueCurveDepth)
+                    {
+                        torqueCurveDepth = -1;
+                    }
+                    depth--;
+                    p++;
+                    key = nullptr;
+                }
+                else
+                {
+                    const char *start = p;
+                    while (p < end && !isDelimiter(*p))
+                    {
+                        p++;
+                    }
+
+                    // Only a value that is kept is converted. from_chars doesn't take the + sign that stream
+                    // extraction did.
+                    float value = 0.f;
+                    bool isNumber = false;
+                    if (key || torqueCurveDepth >= 0)
+                    {
+                        const char *number = (*start == '+') ? start + 1 : start;
+                        isNumber = number < p && std::from_chars(number, p, value).ptr == p;
+                    }
+
+                    if (torqueCurveDepth >= 0)
+                    {
+                        if (isNumber && engine.torqueCurvePointCount < (int)kMaxTorqueCurvePointCount)
+                        {
+                            if (!hasRpm)
+                            {
+                                engine.torqueCurveRpm[engine.torqueCurvePointCount] = value;
+                            }
+                            else
+                            {
+                                engine.torqueCurveTorque[engine.torqueCurvePointCount++] = value;
+                            }
+                            hasRpm = !hasRpm;
+                        }
+                    }
+                    else if (key && isNumber)
+                    {
+                        setValue(*key, value, outCarPhysics);
+                        key = nullptr;
+                    }
+                    else
+                    {
+                        key = findKey(std::string_view(start, p - start));
+                    }
+                }
+            }
+        }
+    } // namespace ngp
+} // namespace rbrNgp
@@ -0,0 +1,38 @@
+//
+// SliProSuperPro
+// A Shift Light Indicator controller
+// Copyright 2025 Fixfactory
+//
+// This file is part of SliProSuperPro.
+//
+// SliProSuperPro is free software: you can redistribute it and/or modify it under
+// the terms of the GNU General Public License as published by the Free
+// Software Foundation, either version 3 of the License, or any later version.
+//
+// SliProSuperPro is distributed in the hope that it will be useful, but WITHOUT
+// ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+// FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+// more details.
+//
+// You should have received a copy of the GNU General Public License along
+// with SliProSuperPro. If not, see <http://www.gnu.org/licenses/>.
+//
+
+#pragma once
+
+#include <cstddef>
+
+#include "NGP.h"
+
+namespace rbrNgp
+{
+    namespace ngp
+    {
+        // Reads a car's common.lsp in one pass. Values follow their key, separated by whitespace. Keys are looked up
+        // with a perfect hash, and everything else is skipped: unknown keys, strings, and ; comments.
+        // The torque curve is a list of rpm and torque pairs in parentheses after TorqueCurve. Pairs may also be in
+        // parentheses of their own.
+        // Fields not found are left as they are. Doesn't log, so it can run on any thread.
+        void parseCommon(const char *data, size_t size, CarPhysics &outCarPhysics);
+    } // namespace ngp
+} // namespace rbrNgp
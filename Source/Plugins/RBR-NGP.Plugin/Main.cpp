@@ -18,9 +18,12 @@
 // with SliProSuperPro. If not, see <http://www.gnu.org/licenses/>.
 //
 
-#include <Windows.h>
+#ifdef _WIN32
+    #include <Windows.h>
+#endif
 
 #include <string>
+#include <cstring>
 #include <iostream>
 #include <atomic>
 
@@ -29,10 +32,76 @@
 #include "PluginInterface.h"
 #include "Defines.h"
 #include "Telemetry.h"
+#include "Exports.h"
 #include "NGP.h"
 
+namespace rbrNgp
+{
+    int PluginExports::getPluginInterfaceVersion()
+    {
+        return plugin::kInterfaceVersion;
+    }
+
+    bool PluginExports::supportsInterfaceVersion(int interfaceVersion)
+    {
+        return interfaceVersion >= 1 && interfaceVersion <= 4;
+    }
+
+    void PluginExports::getGameExecFileName(std::string &outExecFileName)
+    {
+        outExecFileName = "RichardBurnsRally_SSE.exe";
+    }
+
+    void PluginExports::setGameIsRunning(bool isRunning, std::string execPath)
+    {
+        if (isRunning)
+        {
+            TelemetryManager::getSingleton().init();
+            NgpManager::getSingleton().init(execPath);
+        }
+        else
+        {
+            NgpManager::getSingleton().deinit();
+            TelemetryManager::getSingleton().deinit();
+        }
+    }
+
+    bool PluginExports::getTelemetryData(plugin::TelemetryData *outTelemetryData, size_t telemetryDataSize)
+    {
+        if (TelemetryManager::getSingleton().fetchTelemetryData())
+        {
+            auto &telemetryData = TelemetryManager::getSingleton().getTelemetryData();
+            if (sizeof(telemetryData) >= telemetryDataSize)
+            {
+                memcpy(outTelemetryData, &telemetryData, telemetryDataSize);
+                return true;
+            }
+        }
+        return false;
+    }
+
+    bool PluginExports::getPhysicsData(plugin::PhysicsData *outPhysicsData, size_t physicsDataSize)
+    {
+        if (NgpManager::getSingleton().fetchPhysicsData())
+        {
+            auto &physicsData = NgpManager::getSingleton().getPhysicsData();
+            if (sizeof(physicsData) >= physicsDataSize)
+            {
+                memcpy(outPhysicsData, &physicsData, physicsDataSize);
+                return true;
+            }
+        }
+        return false;
+    }
+
+    bool PluginExports::getPhysicsDataEveryFrame()
+    {
+        return false;
+    }
+} // namespace rbrNgp
+
+#if !defined(SPSP_STATIC_PLUGINS) && defined(_WIN32)
 std::atomic<int> g_dllAttachCount = 0;
-std::string g_gameExecPath{};
 
 BOOL APIENTRY DllMain(HMODULE hModule, DWORD ul_reason_for_call, LPVOID lpReserved)
 {
@@ -63,70 +132,57 @@ BOOL APIENTRY DllMain(HMODULE hModule, DWORD ul_reason_for_call, LPVOID lpReserv
 
     return TRUE;
 }
+#elif !defined(SPSP_STATIC_PLUGINS)
+// Shared objects are attached once, when they are loaded.
+__attribute__((constructor)) static void onLibraryLoaded()
+{
+    LogManager::getSingleton().init();
+    LOG_INFO("Loaded RBR-NGP Plugin version 0.1.0");
+}
+
+__attribute__((destructor)) static void onLibraryUnloaded()
+{
+    LOG_INFO("RBR-NGP Plugin unloaded");
+    LogManager::getSingleton().deinit();
+}
+#endif
 
+#ifndef SPSP_STATIC_PLUGINS
 extern "C"
 {
     int DLL_EXPORT getPluginInterfaceVersion()
     {
-        return plugin::kInterfaceVersion;
+        return rbrNgp::PluginExports::getPluginInterfaceVersion();
     }
 
     bool DLL_EXPORT supportsInterfaceVersion(int interfaceVersion)
     {
-        return interfaceVersion >= 1 && interfaceVersion <= 1;
+        return rbrNgp::PluginExports::supportsInterfaceVersion(interfaceVersion);
     }
 
     void DLL_EXPORT getGameExecFileName(std::string &outExecFileName)
     {
-        outExecFileName = "RichardBurnsRally_SSE.exe";
+        rbrNgp::PluginExports::getGameExecFileName(outExecFileName);
     }
 
     void DLL_EXPORT setGameIsRunning(bool isRunning, std::string execPath)
     {
-        if (isRunning)
-        {
-            g_gameExecPath = execPath;
-            TelemetryManager::getSingleton().init();
-            NgpManager::getSingleton().init();
-        }
-        else
-        {
-            NgpManager::getSingleton().deinit();
-            TelemetryManager::getSingleton().deinit();
-            g_gameExecPath.clear();
-        }
+        rbrNgp::PluginExports::setGameIsRunning(isRunning, execPath);
     }
 
     bool DLL_EXPORT getTelemetryData(plugin::TelemetryData *outTelemetryData, size_t telemetryDataSize)
     {
-        if (TelemetryManager::getSingleton().fetchTelemetryData())
-        {
-            auto &telemetryData = TelemetryManager::getSingleton().getTelemetryData();
-            if (sizeof(telemetryData) >= telemetryDataSize)
-            {
-                memcpy(outTelemetryData, &telemetryData, telemetryDataSize);
-                return true;
-            }
-        }
-        return false;
+        return rbrNgp::PluginExports::getTelemetryData(outTelemetryData, telemetryDataSize);
     }
 
     bool DLL_EXPORT getPhysicsData(plugin::PhysicsData *outPhysicsData, size_t physicsDataSize)
     {
-        if (NgpManager::getSingleton().fetchPhysicsData(g_gameExecPath))
-        {
-            auto &physicsData = NgpManager::getSingleton().getPhysicsData();
-            if (sizeof(physicsData) >= physicsDataSize)
-            {
-                memcpy(outPhysicsData, &physicsData, physicsDataSize);
-                return true;
-            }
-        }
-        return false;
+        return rbrNgp::PluginExports::getPhysicsData(outPhysicsData, physicsDataSize);
     }
 
     bool DLL_EXPORT getPhysicsDataEveryFrame()
     {
-        return false;
+        return rbrNgp::PluginExports::getPhysicsDataEveryFrame();
     }
 }
+#endif
@@ -18,135 +18,121 @@
 // with SliProSuperPro. If not, see <http://www.gnu.org/licenses/>.
 //
 
-#include <fstream>
-#include <sstream>
+#include <cstdio>
+#include <cstring>
 
 #include "NGP.h"
 #include "Log.h"
+#include "PhysicsIndex.h"
 #include "Telemetry.h"
 
 #include "PhysicsNG/rbr.telemetry.data.TelemetryData.h"
 
-namespace ngp
+namespace rbrNgp
 {
-    const char *kFolderNames[kFolderNameCount] = { "c_xsara", "h_accent", "mg_zr",    "m_lancer",
-                                                   "p_206",   "s_i2003",  "t_coroll", "s_i2000" };
-}
-
-NgpManager &NgpManager::getSingleton()
-{
-    static NgpManager s_singleton;
-    return s_singleton;
-}
-
-NgpManager::NgpManager()
-{
-}
-
-NgpManager::~NgpManager()
-{
-}
-
-void NgpManager::init()
-{
-    memset(&m_carPhysics.controlUnit, 0, sizeof(m_carPhysics.controlUnit));
-}
-
-void NgpManager::deinit()
-{
-}
-
-bool NgpManager::fetchPhysicsData(const std::string &gamePath)
-{
-    if (TelemetryManager::getSingleton().isReceivingTelemetry() && !gamePath.empty())
+    namespace ngp
     {
-        auto carIndex = TelemetryManager::getSingleton().getRBRTelemetryData().car_.index_;
-        if (readCommon(carIndex, gamePath))
-        {
-            m_physicsData.gearCount = m_carPhysics.drive.numberOfGears;
-            m_physicsData.rpmLimit = m_carPhysics.controlUnit.rpmLimit;
+        const char *kFolderNames[kFolderNameCount] = { "c_xsara", "h_accent", "mg_zr",    "m_lancer",
+                                                       "p_206",   "s_i2003",  "t_coroll", "s_i2000" };
+    }
 
-            static_assert(sizeof(m_physicsData.rpmDownshift) >= sizeof(m_carPhysics.controlUnit.gearDownShift));
-            static_assert(sizeof(m_physicsData.rpmUpshift) >= sizeof(m_carPhysics.controlUnit.gearUpShift));
+    // Next to the config, in the working directory.
+    static const char *kPhysicsIndexFileName = "RBR-NGP.Physics.cache";
 
-            memcpy(m_physicsData.rpmDownshift, m_carPhysics.controlUnit.gearDownShift,
-                   sizeof(m_carPhysics.controlUnit.gearDownShift));
+    NgpManager &NgpManager::getSingleton()
+    {
+        static NgpManager s_singleton;
+        return s_singleton;
+    }
 
-            memcpy(m_physicsData.rpmUpshift, m_carPhysics.controlUnit.gearUpShift,
-                   sizeof(m_carPhysics.controlUnit.gearUpShift));
+    NgpManager::NgpManager()
+    {
+    }
 
-            return true;
-        }
+    NgpManager::~NgpManager()
+    {
     }
-    return false;
-}
 
-const plugin::PhysicsData &NgpManager::getPhysicsData() const
-{
-    return m_physicsData;
-}
+    void NgpManager::init(const std::string &gamePath)
+    {
+        memset(&m_carPhysics, 0, sizeof(m_carPhysics));
 
-bool NgpManager::readCommon(unsigned int carIndex, const std::string &gamePath)
-{
-    LOG_INFO("Reading physics file for car index %u", carIndex);
-    memset(&m_carPhysics, 0, sizeof(m_carPhysics));
+        m_missingCarIndex = -1;
 
-    if (carIndex >= ngp::kFolderNameCount)
-    {
-        LOG_ERROR("Invalid car index %u", carIndex);
-        return false;
+        // The first scan of an RSF install reads hundreds of files, and this is called from SliProSuperPro's update.
+        // Every car is indexed before the stage loads, so a car change never waits on the disk.
+        m_physicsIndex = new PhysicsIndex();
+        m_physicsIndexTask.start([physicsIndex = m_physicsIndex, gamePath]() {
+            physicsIndex->init(kPhysicsIndexFileName, gamePath);
+        });
     }
 
-    std::stringstream filePath;
-    filePath << gamePath << "\\Physics\\" << ngp::kFolderNames[carIndex] << "\\common.lsp";
-    std::ifstream file(filePath.str());
-    if (!file.is_open())
+    void NgpManager::deinit()
     {
-        LOG_ERROR("Could not open file %ls", filePath.str());
-        return false;
+        m_physicsIndexTask.wait();
+        if (m_physicsIndex)
+        {
+            m_physicsIndex->deinit();
+        }
+        delete m_physicsIndex;
+        m_physicsIndex = nullptr;
     }
 
-    std::string line;
-    while (std::getline(file, line))
+    bool NgpManager::fetchPhysicsData()
     {
-        std::istringstream stream(line);
-        std::string name;
-        float value;
-        if (stream >> name >> value)
+        if (TelemetryManager::getSingleton().isReceivingTelemetry() && m_physicsIndex && isPhysicsIndexLoaded())
         {
-            if (name.find("NumberOfGears") != std::string::npos)
+            auto carIndex = TelemetryManager::getSingleton().getRBRTelemetryData().car_.index_;
+            const ngp::CarPhysics *carPhysics = m_physicsIndex->findCar(carIndex);
+            if (carPhysics)
             {
-                m_carPhysics.drive.numberOfGears = (int)value;
-            }
-            else if (name.find("Gear") != std::string::npos)
-            {
-                if (name.find("Upshift") != std::string::npos)
-                {
-                    int gear = atoi(&name[4]);
-                    if (gear < 0 || gear >= ngp::kGearCount)
-                    {
-                        LOG_WARN("Failed parsing upshift gear. %i", gear);
-                        continue;
-                    }
-                    m_carPhysics.controlUnit.gearUpShift[gear] = value;
-                }
-                else if (name.find("Downshift") != std::string::npos)
-                {
-                    int gear = atoi(&name[4]);
-                    if (gear < 0 || gear >= ngp::kGearCount)
-                    {
-                        LOG_WARN("Failed parsing downshift gear. %i", gear);
-                        continue;
-                    }
-                    m_carPhysics.controlUnit.gearDownShift[gear] = value;
-                }
+                m_carPhysics = *carPhysics;
+                snprintf(m_physicsData.carId, sizeof(m_physicsData.carId), "%s",
+                         m_physicsIndex->getCarFolder(carIndex).c_str());
+                m_physicsData.gearCount = m_carPhysics.drive.numberOfGears;
+                m_physicsData.rpmLimit = m_carPhysics.controlUnit.rpmLimit;
+
+                static_assert(sizeof(m_physicsData.rpmDownshift) >= sizeof(m_carPhysics.controlUnit.gearDownShift));
+                static_assert(sizeof(m_physicsData.rpmUpshift) >= sizeof(m_carPhysics.controlUnit.gearUpShift));
+
+                memcpy(m_physicsData.rpmDownshift, m_carPhysics.controlUnit.gearDownShift,
+                       sizeof(m_carPhysics.controlUnit.gearDownShift));
+
+                memcpy(m_physicsData.rpmUpshift, m_carPhysics.controlUnit.gearUpShift,
+                       sizeof(m_carPhysics.controlUnit.gearUpShift));
+
+                // Lets SliProSuperPro compute the shift points from the engine rather than the automatic gearbox's.
+                static_assert(sizeof(m_physicsData.gearRatio) >= sizeof(m_carPhysics.drive.gearRatio));
+                static_assert(ngp::kMaxTorqueCurvePointCount <= plugin::kMaxTorqueCurvePointCount);
+
+                memcpy(m_physicsData.gearRatio, m_carPhysics.drive.gearRatio, sizeof(m_carPhysics.drive.gearRatio));
+
+                m_physicsData.torqueCurvePointCount = m_carPhysics.engine.torqueCurvePointCount;
+                memcpy(m_physicsData.torqueCurveRpm, m_carPhysics.engine.torqueCurveRpm,
+                       sizeof(m_carPhysics.engine.torqueCurveRpm));
+                memcpy(m_physicsData.torqueCurveTorque, m_carPhysics.engine.torqueCurveTorque,
+                       sizeof(m_carPhysics.engine.torqueCurveTorque));
+
+                return true;
             }
-            else if (name.find("RPMLimit") != std::string::npos)
+
+            // SliProSuperPro asks again every frame.
+            if (carIndex != m_missingCarIndex)
             {
-                m_carPhysics.controlUnit.rpmLimit = value;
+                m_missingCarIndex = carIndex;
+                LOG_ERROR("No physics found for car index %i", carIndex);
             }
         }
+        return false;
     }
 
-    return true;
-}
+    bool NgpManager::isPhysicsIndexLoaded() const
+    {
+        return m_physicsIndexTask.isDone();
+    }
+
+    const plugin::PhysicsData &NgpManager::getPhysicsData() const
+    {
+        return m_physicsData;
+    }
+} // namespace rbrNgp
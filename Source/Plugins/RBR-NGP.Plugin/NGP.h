@@ -23,50 +23,70 @@
 #include <string>
 
 #include "PluginInterface.h"
+#include "BackgroundTask.h"
 
-namespace ngp
+namespace rbrNgp
 {
-    constexpr unsigned int kFolderNameCount = 8;
-    extern const char *kFolderNames[kFolderNameCount];
-    constexpr unsigned int kGearCount = 8;
-
-    struct Drive
+    namespace ngp
     {
-        int numberOfGears;
-    };
+        constexpr unsigned int kFolderNameCount = 8;
+        extern const char *kFolderNames[kFolderNameCount];
+        constexpr unsigned int kGearCount = 8;
+        constexpr unsigned int kMaxTorqueCurvePointCount = 64;
 
-    struct ControlUnit
-    {
-        float gearUpShift[kGearCount];
-        float gearDownShift[kGearCount];
-        float rpmLimit;
-    };
+        struct Drive
+        {
+            int numberOfGears;
+            float gearRatio[kGearCount];
+        };
 
-    struct CarPhysics
-    {
-        Drive drive;
-        ControlUnit controlUnit;
-    };
-} // namespace ngp
+        struct Engine
+        {
+            int torqueCurvePointCount;
+            float torqueCurveRpm[kMaxTorqueCurvePointCount];
+            float torqueCurveTorque[kMaxTorqueCurvePointCount];
+        };
 
-class NgpManager
-{
-public:
-    static NgpManager &getSingleton();
+        struct ControlUnit
+        {
+            float gearUpShift[kGearCount];
+            float gearDownShift[kGearCount];
+            float rpmLimit;
+        };
+
+        struct CarPhysics
+        {
+            Drive drive;
+            Engine engine;
+            ControlUnit controlUnit;
+        };
+    } // namespace ngp
+
+    class PhysicsIndex;
 
-    NgpManager();
-    ~NgpManager();
+    class NgpManager
+    {
+    public:
+        static NgpManager &getSingleton();
+
+        NgpManager();
+        ~NgpManager();
 
-    void init();
-    void deinit();
+        void init(const std::string &gamePath);
+        void deinit();
 
-    bool fetchPhysicsData(const std::string &gamePath);
-    const plugin::PhysicsData &getPhysicsData() const;
+        // Returns false until the physics index is loaded, so SliProSuperPro keeps asking.
+        bool fetchPhysicsData();
+        const plugin::PhysicsData &getPhysicsData() const;
 
-private:
-    bool readCommon(unsigned int carIndex, const std::string &gamePath);
+        bool isPhysicsIndexLoaded() const;
 
-    bool m_wasReceivingTelemetry = false;
-    ngp::CarPhysics m_carPhysics = {};
-    plugin::PhysicsData m_physicsData{};
-};
+    private:
+        bool m_wasReceivingTelemetry = false;
+        PhysicsIndex *m_physicsIndex = nullptr;
+        BackgroundTask m_physicsIndexTask;
+        int m_missingCarIndex = -1;
+        ngp::CarPhysics m_carPhysics = {};
+        plugin::PhysicsData m_physicsData{};
+    };
+} // namespace rbrNgp
@@ -0,0 +1,302 @@
+//
+// SliProSuperPro
+// A Shift Light Indicator controller
+// Copyright 2025 Fixfactory
+//
+// This file is part of SliProSuperPro.
+//
+// SliProSuperPro is free software: you can redistribute it and/or modify it under
+// the terms of the GNU General Public License as published by the Free
+// Software Foundation, either version 3 of the License, or any later version.
+//
+// SliProSuperPro is distributed in the hope that it will be useful, but WITHOUT
+// ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+// FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+// more details.
+//
+// You should have received a copy of the GNU General Public License along
+// with SliProSuperPro. If not, see <http://www.gnu.org/licenses/>.
+//
+
+#include <algorithm>
+#include <cctype>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <unordered_set>
+#include <vector>
+
+#include "PhysicsIndex.h"
+#include "BinaryFile.h"
+#include "LspParser.h"
+#include "Log.h"
+#include "MappedFile.h"
+
+namespace rbrNgp
+{
+    // Each car is a uint16_t folder name length, the folder name, the common.lsp write time as an int64_t, its size
+    // as a uint64_t, and its CarPhysics. The physics are stored as they are in memory, so the file is dropped when
+    // they change.
+    const char kFileMagic[4] = { 'R', 'P', 'H', 'I' };
+    const uint32_t kFileVersion = 2;
+    const size_t kFixedRecordSize = sizeof(uint16_t) + sizeof(int64_t) + sizeof(uint64_t) + sizeof(ngp::CarPhysics);
+
+    static std::string toLower(std::string str)
+    {
+        std::transform(str.begin(), str.end(), str.begin(), [](unsigned char c) { return (char)std::tolower(c); });
+        return str;
+    }
+
+    PhysicsIndex::PhysicsIndex()
+    {
+    }
+
+    PhysicsIndex::~PhysicsIndex()
+    {
+    }
+
+    void PhysicsIndex::init(const std::string &filePath, const std::string &gamePath)
+    {
+        m_filePath = filePath;
+        m_cars.clear();
+        for (unsigned int i = 0; i < ngp::kFolderNameCount; i++)
+        {
+            m_slotFolders[i] = ngp::kFolderNames[i];
+        }
+
+        if (gamePath.empty())
+        {
+            return;
+        }
+
+        read();
+        if (scan(std::filesystem::path(gamePath) / "Physics"))
+        {
+            write();
+        }
+        readCarList(std::filesystem::path(gamePath) / "Cars" / "Cars.ini");
+    }
+
+    void PhysicsIndex::deinit()
+    {
+        m_cars.clear();
+    }
+
+    const ngp::CarPhysics *PhysicsIndex::findCar(unsigned int carIndex) const
+    {
+        if (carIndex >= ngp::kFolderNameCount)
+        {
+            return nullptr;
+        }
+
+        auto it = m_cars.find(m_slotFolders[carIndex]);
+        return it != m_cars.end() ? &it->second.physics : nullptr;
+    }
+
+    std::string PhysicsIndex::getCarFolder(unsigned int carIndex) const
+    {
+        return carIndex < ngp::kFolderNameCount ? m_slotFolders[carIndex] : std::string();
+    }
+
+    size_t PhysicsIndex::getCarCount() const
+    {
+        return m_cars.size();
+    }
+
+    void PhysicsIndex::read()
+    {
+        std::ifstream file(m_filePath, std::ios::binary);
+        if (!file.good())
+        {
+            return;
+        }
+
+        std::vector<char> data((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+        if (!binaryFile::checkHeader(m_filePath, data.data(), data.size(),
+                                     binaryFile::makeHeader(kFileMagic, kFileVersion, kFixedRecordSize)))
+        {
+            return;
+        }
+
+        BinaryFileHeader header{};
+        memcpy(&header, data.data(), sizeof(header));
+        size_t offset = sizeof(header);
+        for (uint32_t i = 0; i < header.recordCount; i++)
+        {
+            uint16_t nameLength = 0;
+            if (offset + sizeof(nameLength) > data.size())
+            {
+                break;
+            }
+            memcpy(&nameLength, data.data() + offset, sizeof(nameLength));
+            offset += sizeof(nameLength);
+
+            Car car;
+            if (offset + nameLength + sizeof(car.writeTime) + sizeof(car.fileSize) + sizeof(car.physics) >
+                data.size())
+            {
+                break;
+            }
+
+            std::string name(data.data() + offset, nameLength);
+            offset += nameLength;
+            memcpy(&car.writeTime, data.data() + offset, sizeof(car.writeTime));
+            offset += sizeof(car.writeTime);
+            memcpy(&car.fileSize, data.data() + offset, sizeof(car.fileSize));
+            offset += sizeof(car.fileSize);
+            memcpy(&car.physics, data.data() + offset, sizeof(car.physics));
+            offset += sizeof(car.physics);
+            m_cars[name] = car;
+        }
+    }
+
+    void PhysicsIndex::write()
+    {
+        BinaryFileHeader header = binaryFile::makeHeader(kFileMagic, kFileVersion, kFixedRecordSize);
+
+        std::vector<char> file(sizeof(header));
+        for (const auto &[name, car] : m_cars)
+        {
+            if (name.size() > UINT16_MAX)
+            {
+                continue;
+            }
+
+            uint16_t nameLength = (uint16_t)name.size();
+            const char *data = reinterpret_cast<const char *>(&nameLength);
+            file.insert(file.end(), data, data + sizeof(nameLength));
+            file.insert(file.end(), name.begin(), name.end());
+            data = reinterpret_cast<const char *>(&car.writeTime);
+            file.insert(file.end(), data, data + sizeof(car.writeTime));
+            data = reinterpret_cast<const char *>(&car.fileSize);
+            file.insert(file.end(), data, data + sizeof(car.fileSize));
+            data = reinterpret_cast<const char *>(&car.physics);
+            file.insert(file.end(), data, data + sizeof(car.physics));
+            header.recordCount++;
+        }
+        memcpy(file.data(), &header, sizeof(header));
+
+        binaryFile::write(m_filePath, file);
+    }
+
+    bool PhysicsIndex::scan(const std::filesystem::path &physicsPath)
+    {
+        int readCount = 0;
+        int errorCount = 0;
+        std::unordered_set<std::string> found;
+
+        std::error_code error;
+        for (const auto &entry : std::filesystem::directory_iterator(physicsPath, error))
+        {
+            if (!entry.is_directory(error))
+            {
+                continue;
+            }
+
+            // Only the write time and size are checked, so an unchanged car costs a stat and no read.
+            std::filesystem::path path = entry.path() / "common.lsp";
+            auto writeTime = std::filesystem::last_write_time(path, error);
+            if (error)
+            {
+                continue;
+            }
+            uint64_t fileSize = std::filesystem::file_size(path, error);
+            if (error)
+            {
+                continue;
+            }
+
+            std::string name = toLower(entry.path().filename().string());
+            found.insert(name);
+
+            auto it = m_cars.find(name);
+            int64_t time = (int64_t)writeTime.time_since_epoch().count();
+            if (it != m_cars.end() && it->second.writeTime == time && it->second.fileSize == fileSize)
+            {
+                continue;
+            }
+
+            MappedFile file;
+            if (!file.open(path.string()))
+            {
+                LOG_ERROR("Could not open file %s", path.string().c_str());
+                errorCount++;
+                continue;
+            }
+
+            Car &car = m_cars[name];
+            car.writeTime = time;
+            car.fileSize = fileSize;
+            car.physics = {};
+            ngp::parseCommon(file.getData(), file.getSize(), car.physics);
+            readCount++;
+        }
+
+        if (error)
+        {
+            LOG_ERROR("Could not scan %s", physicsPath.string().c_str());
+        }
+
+        size_t removedCount =
+            std::erase_if(m_cars, [&found](const auto &car) { return found.count(car.first) == 0; });
+
+        LOG_INFO("Indexed %zu cars in %s, read %i changed, removed %zu", m_cars.size(), physicsPath.string().c_str(),
+                 readCount, removedCount);
+        return readCount > 0 || removedCount > 0 || errorCount > 0;
+    }
+
+    // RBR lists the car in each slot in Cars\Cars.ini, as a [CarNN] section. RSF installs a car in a slot by
+    // rewriting its section, with a FileName in the car's own folder under Cars. When the Physics folder has a car of
+    // the same name, the slot uses it. Otherwise it keeps its original NGP folder.
+    void PhysicsIndex::readCarList(const std::filesystem::path &carListPath)
+    {
+        std::ifstream file(carListPath);
+        if (!file.good())
+        {
+            return;
+        }
+
+        int slot = -1;
+        std::string line;
+        while (std::getline(file, line))
+        {
+            if (!line.empty() && line.back() == '\r')
+            {
+                line.pop_back();
+            }
+
+            if (line.size() >= 6 && line[0] == '[')
+            {
+                std::string section = toLower(line);
+                slot = (section.compare(1, 3, "car") == 0) ? atoi(section.c_str() + 4) : -1;
+                continue;
+            }
+
+            size_t equals = line.find('=');
+            if (slot < 0 || slot >= (int)ngp::kFolderNameCount || equals == std::string::npos)
+            {
+                continue;
+            }
+
+            std::string key = toLower(line.substr(0, equals));
+            key.erase(key.find_last_not_of(" \t") + 1);
+            if (key != "filename")
+            {
+                continue;
+            }
+
+            // FileName=Cars\Folder\Car.sgc, possibly in quotes.
+            std::string value = line.substr(equals + 1);
+            value.erase(std::remove(value.begin(), value.end(), '"'), value.end());
+            std::replace(value.begin(), value.end(), '\\', '/');
+            std::filesystem::path carPath(value);
+            std::string folder = toLower(carPath.parent_path().filename().string());
+            if (!folder.empty() && m_cars.count(folder) != 0)
+            {
+                m_slotFolders[slot] = folder;
+                LOG_INFO("Car slot %i uses the physics in %s", slot, folder.c_str());
+            }
+        }
+    }
+} // namespace rbrNgp
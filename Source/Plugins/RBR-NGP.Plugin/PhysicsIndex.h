@@ -0,0 +1,74 @@
+//
+// SliProSuperPro
+// A Shift Light Indicator controller
+// Copyright 2025 Fixfactory
+//
+// This file is part of SliProSuperPro.
+//
+// SliProSuperPro is free software: you can redistribute it and/or modify it under
+// the terms of the GNU General Public License as published by the Free
+// Software Foundation, either version 3 of the License, or any later version.
+//
+// SliProSuperPro is distributed in the hope that it will be useful, but WITHOUT
+// ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+// FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+// more details.
+//
+// You should have received a copy of the GNU General Public License along
+// with SliProSuperPro. If not, see <http://www.gnu.org/licenses/>.
+//
+
+#pragma once
+
+#include <cstdint>
+#include <filesystem>
+#include <string>
+#include <unordered_map>
+
+#include "NGP.h"
+
+namespace rbrNgp
+{
+    // Indexes every car in RBR's Physics folder with the values read from its common.lsp.
+    // RSF installs hold hundreds of cars, so the index is kept in a small binary file and a scan only reads the cars
+    // whose common.lsp changed since the last one. A car change is then a lookup.
+    class PhysicsIndex
+    {
+    public:
+        PhysicsIndex();
+        ~PhysicsIndex();
+
+        // Reads the index file, scans the game's Physics folder, and writes the index file when a car changed.
+        void init(const std::string &filePath, const std::string &gamePath);
+        void deinit();
+
+        // The physics of the car in one of the game's 8 car slots, or nullptr if its common.lsp wasn't found.
+        const ngp::CarPhysics *findCar(unsigned int carIndex) const;
+
+        // The Physics folder of the car in a slot, in lower case.
+        std::string getCarFolder(unsigned int carIndex) const;
+
+        size_t getCarCount() const;
+
+    private:
+        struct Car
+        {
+            int64_t writeTime{ 0 };
+            uint64_t fileSize{ 0 };
+            ngp::CarPhysics physics{};
+        };
+
+        std::string m_filePath;
+
+        // By folder name in lower case, since the names in Cars.ini don't always match the folders' case.
+        std::unordered_map<std::string, Car> m_cars;
+
+        // The folder of the car installed in each slot.
+        std::string m_slotFolders[ngp::kFolderNameCount];
+
+        void read();
+        void write();
+        bool scan(const std::filesystem::path &physicsPath);
+        void readCarList(const std::filesystem::path &carListPath);
+    };
+} // namespace rbrNgp
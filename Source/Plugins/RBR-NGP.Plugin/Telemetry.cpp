@@ -18,123 +18,171 @@
 // with SliProSuperPro. If not, see <http://www.gnu.org/licenses/>.
 //
 
+#include <cstring>
+#include <fstream>
+
 #include "Telemetry.h"
 #include "Network.h"
 #include "Log.h"
 
-static const std::chrono::duration<float> kDataTimeout{ 2.f };
-
-TelemetryManager &TelemetryManager::getSingleton()
-{
-    static TelemetryManager s_singleton;
-    return s_singleton;
-}
-
-TelemetryManager::TelemetryManager()
+namespace rbrNgp
 {
-}
+    static const std::chrono::duration<float> kDataTimeout{ 2.f };
+    static const char *kConfigFileName = "RBR-NGP.Config.json";
 
-TelemetryManager::~TelemetryManager()
-{
-}
+    // The address the README asks to set in the RSF Launcher.
+    static const int kDefaultPort = 6776;
 
-void TelemetryManager::init()
-{
-    m_session = new WSASession();
-    m_udpSocket = new UDPSocket();
+    TelemetryManager &TelemetryManager::getSingleton()
+    {
+        static TelemetryManager s_singleton;
+        return s_singleton;
+    }
 
-    try
+    TelemetryManager::TelemetryManager()
     {
-        // TODO: Port should be user configurable.
-        constexpr short kTempPort = 6776;
-        m_udpSocket->bindTo(kTempPort);
-        LOG_INFO("Listening to telemetry on port %i", kTempPort);
     }
-    catch (const std::system_error &error)
+
+    TelemetryManager::~TelemetryManager()
     {
-        LOG_ERROR(error);
     }
 
-    m_recvBuf.resize(sizeof(RBRTelemetryData));
-    memset(&m_rbrTelemetryData, 0, sizeof(RBRTelemetryData));
-}
+    void TelemetryManager::init()
+    {
+        readConfig();
 
-void TelemetryManager::deinit()
-{
-    delete m_udpSocket;
-    m_udpSocket = nullptr;
+        m_session = new WSASession();
+        m_udpSocket = new UDPSocket();
 
-    delete m_session;
-    m_session = nullptr;
-}
+        try
+        {
+            m_udpSocket->bindTo(m_port);
+            LOG_INFO("Listening to telemetry on port %i", m_port);
 
-bool TelemetryManager::fetchTelemetryData()
-{
-    if (m_udpSocket->isBound())
+            for (const auto &destination : m_relayDestinations)
+            {
+                m_udpSocket->addRelayDestination(destination.first, destination.second);
+                LOG_INFO("Relaying telemetry to %s:%i", destination.first.c_str(), destination.second);
+            }
+        }
+        catch (const std::system_error &error)
+        {
+            LOG_ERROR(error);
+        }
+
+        m_recvBuf.resize(sizeof(RBRTelemetryData));
+        memset(&m_rbrTelemetryData, 0, sizeof(RBRTelemetryData));
+    }
+
+    void TelemetryManager::deinit()
     {
-        recvTelemetry();
-        if (m_receivingTelemetry)
+        delete m_udpSocket;
+        m_udpSocket = nullptr;
+
+        delete m_session;
+        m_session = nullptr;
+    }
+
+    bool TelemetryManager::fetchTelemetryData()
+    {
+        if (m_udpSocket->isBound())
         {
-            m_telemetryData.gear = m_rbrTelemetryData.control_.gear_;
-            m_telemetryData.rpm = m_rbrTelemetryData.car_.engine_.rpm_;
-            m_telemetryData.speedKph = m_rbrTelemetryData.car_.speed_;
-            return true;
+            recvTelemetry();
+            if (m_receivingTelemetry)
+            {
+                m_telemetryData.gear = m_rbrTelemetryData.control_.gear_;
+                m_telemetryData.rpm = m_rbrTelemetryData.car_.engine_.rpm_;
+                m_telemetryData.speedKph = m_rbrTelemetryData.car_.speed_;
+                return true;
+            }
         }
+        return false;
     }
-    return false;
-}
 
-bool TelemetryManager::isReceivingTelemetry() const
-{
-    return m_receivingTelemetry;
-}
+    bool TelemetryManager::isReceivingTelemetry() const
+    {
+        return m_receivingTelemetry;
+    }
 
-const plugin::TelemetryData &TelemetryManager::getTelemetryData() const
-{
-    return m_telemetryData;
-}
+    const plugin::TelemetryData &TelemetryManager::getTelemetryData() const
+    {
+        return m_telemetryData;
+    }
 
-const RBRTelemetryData &TelemetryManager::getRBRTelemetryData() const
-{
-    return m_rbrTelemetryData;
-}
+    const RBRTelemetryData &TelemetryManager::getRBRTelemetryData() const
+    {
+        return m_rbrTelemetryData;
+    }
 
-void TelemetryManager::recvTelemetry()
-{
-    sockaddr_in fromAddr;
+    void TelemetryManager::readConfig()
+    {
+        m_port = kDefaultPort;
+        m_relayDestinations.clear();
 
-    try
+        std::ifstream file(kConfigFileName);
+        if (!file.good())
+        {
+            LOG_WARN("Could not open %s, using default settings", kConfigFileName);
+            return;
+        }
+
+        auto config = json::parse(file);
+        auto udp = config["UDP"];
+        if (udp.empty())
+        {
+            LOG_ERROR("Missing UDP settings in config file");
+            return;
+        }
+
+        auto port = udp["port"];
+        if (!port.empty())
+        {
+            m_port = port.template get<int>();
+        }
+        else
+        {
+            LOG_ERROR("Missing port in config file");
+        }
+
+        m_relayDestinations = readRelayDestinations(udp);
+    }
+
+    void TelemetryManager::recvTelemetry()
     {
-        auto time = std::chrono::steady_clock::now();
-        while (m_udpSocket->hasData())
+        try
         {
-            m_udpSocket->recvData(m_recvBuf, fromAddr);
-            if (m_recvBuf.size() != sizeof(RBRTelemetryData))
+            // Only the newest packet is used. The others are only relayed.
+            auto time = std::chrono::steady_clock::now();
+            int count = 0;
+            int malformedCount = 0;
+            if (m_udpSocket->recvLatest(m_recvBuf.data(), (int)m_recvBuf.size(), count, malformedCount))
             {
-                LOG_ERROR("Malformed TelemetryData (size %i)", m_recvBuf.size());
-                continue;
-            }
+                m_rbrTelemetryData = *reinterpret_cast<RBRTelemetryData *>(m_recvBuf.data());
 
-            m_rbrTelemetryData = *reinterpret_cast<RBRTelemetryData *>(m_recvBuf.data());
+                if (!m_receivingTelemetry)
+                {
+                    LOG_INFO("Started receiving telemetry data");
+                    m_receivingTelemetry = true;
+                }
 
-            if (!m_receivingTelemetry)
+                m_lastDataTime = time;
+            }
+
+            if (malformedCount > 0)
             {
-                LOG_INFO("Started receiving telemetry data");
-                m_receivingTelemetry = true;
+                LOG_ERROR("Malformed TelemetryData (%i packets)", malformedCount);
             }
 
-            m_lastDataTime = time;
+            if (m_receivingTelemetry && time - m_lastDataTime > kDataTimeout)
+            {
+                LOG_INFO("Stopped receiving telemetry data");
+                m_receivingTelemetry = false;
+            }
         }
-
-        if (m_receivingTelemetry && time - m_lastDataTime > kDataTimeout)
+        catch (const std::system_error &error)
         {
-            LOG_INFO("Stopped receiving telemetry data");
+            LOG_ERROR(error);
             m_receivingTelemetry = false;
         }
     }
-    catch (const std::system_error &error)
-    {
-        LOG_ERROR(error);
-        m_receivingTelemetry = false;
-    }
-}
+} // namespace rbrNgp
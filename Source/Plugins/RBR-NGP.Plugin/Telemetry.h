@@ -21,43 +21,55 @@
 #pragma once
 
 #include <vector>
+#include <string>
+#include <utility>
 #include <chrono>
 
 #include "PhysicsNG/rbr.telemetry.data.TelemetryData.h"
 #include "PluginInterface.h"
 
+#include "json/json.hpp"
+using json = nlohmann::json;
+
 using RBRTelemetryData = rbr::telemetry::data::TelemetryData;
 
 class WSASession;
 class UDPSocket;
 
-class TelemetryManager
+namespace rbrNgp
 {
-public:
-    static TelemetryManager &getSingleton();
+    class TelemetryManager
+    {
+    public:
+        static TelemetryManager &getSingleton();
+
+        TelemetryManager();
+        ~TelemetryManager();
 
-    TelemetryManager();
-    ~TelemetryManager();
+        void init();
+        void deinit();
 
-    void init();
-    void deinit();
+        bool fetchTelemetryData();
 
-    bool fetchTelemetryData();
+        bool isReceivingTelemetry() const;
+        const plugin::TelemetryData &getTelemetryData() const;
+        const RBRTelemetryData &getRBRTelemetryData() const;
 
-    bool isReceivingTelemetry() const;
-    const plugin::TelemetryData &getTelemetryData() const;
-    const RBRTelemetryData &getRBRTelemetryData() const;
+    private:
+        void readConfig();
+        void recvTelemetry();
 
-private:
-    void recvTelemetry();
+        int m_port{ 0 };
+        std::vector<std::pair<std::string, int>> m_relayDestinations;
 
-    WSASession *m_session = nullptr;
-    UDPSocket *m_udpSocket = nullptr;
-    std::vector<char> m_recvBuf;
-    bool m_receivingTelemetry = false;
-    plugin::TelemetryData m_telemetryData{};
-    RBRTelemetryData m_rbrTelemetryData{};
+        WSASession *m_session = nullptr;
+        UDPSocket *m_udpSocket = nullptr;
+        std::vector<char> m_recvBuf;
+        bool m_receivingTelemetry = false;
+        plugin::TelemetryData m_telemetryData{};
+        RBRTelemetryData m_rbrTelemetryData{};
 
-    using time_point = std::chrono::steady_clock::time_point;
-    time_point m_lastDataTime = {};
-};
+        using time_point = std::chrono::steady_clock::time_point;
+        time_point m_lastDataTime = {};
+    };
+} // namespace rbrNgp
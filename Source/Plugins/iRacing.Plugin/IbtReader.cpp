@@ -0,0 +1,178 @@
+//
+// SliProSuperPro
+// A Shift Light Indicator controller
+// Copyright 2025 Fixfactory
+//
+// This file is part of SliProSuperPro.
+//
+// SliProSuperPro is free software: you can redistribute it and/or modify it under
+// the terms of the GNU General Public License as published by the Free
+// Software Foundation, either version 3 of the License, or any later version.
+//
+// SliProSuperPro is distributed in the hope that it will be useful, but WITHOUT
+// ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+// FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+// more details.
+//
+// You should have received a copy of the GNU General Public License along
+// with SliProSuperPro. If not, see <http://www.gnu.org/licenses/>.
+//
+
+#include <climits>
+
+#include "IbtReader.h"
+
+namespace iracing
+{
+    bool IbtReader::open(const std::string &path)
+    {
+        close();
+        if (!m_file.open(path))
+        {
+            return false;
+        }
+
+        const char *data = m_file.getData();
+        size_t size = m_file.getSize();
+        if (size < sizeof(m_header) + sizeof(m_diskSubHeader))
+        {
+            close();
+            return false;
+        }
+
+        memcpy(&m_header, data, sizeof(m_header));
+        memcpy(&m_diskSubHeader, data + sizeof(m_header), sizeof(m_diskSubHeader));
+
+        size_t varHeadersEnd = (size_t)m_header.varHeaderOffset + (size_t)m_header.numVars * sizeof(irsdk_varHeader);
+        size_t sessionInfoEnd = (size_t)m_header.sessionInfoOffset + (size_t)m_header.sessionInfoLen;
+        if (m_header.numVars <= 0 || m_header.varHeaderOffset < 0 || varHeadersEnd > size ||
+            m_header.sessionInfoOffset < 0 || m_header.sessionInfoLen < 0 || sessionInfoEnd > size ||
+            m_header.bufLen <= 0 || m_header.varBuf[0].bufOffset < 0 || (size_t)m_header.varBuf[0].bufOffset > size)
+        {
+            close();
+            return false;
+        }
+
+        m_varHeaders = reinterpret_cast<const irsdk_varHeader *>(data + m_header.varHeaderOffset);
+        m_samples = data + m_header.varBuf[0].bufOffset;
+
+        // The record count is only written when the file is closed, so it is 0 if the sim didn't close it.
+        // Trust the size of the file instead, which can't end with a partial line either.
+        size_t storedCount = (size - m_header.varBuf[0].bufOffset) / m_header.bufLen;
+        if (m_diskSubHeader.sessionRecordCount > 0 && (size_t)m_diskSubHeader.sessionRecordCount < storedCount)
+        {
+            storedCount = m_diskSubHeader.sessionRecordCount;
+        }
+        m_sampleCount = storedCount < INT_MAX ? (int)storedCount : INT_MAX;
+
+        m_sessionTime = getColumn<double>("SessionTime");
+        return true;
+    }
+
+    void IbtReader::close()
+    {
+        m_file.close();
+        m_header = {};
+        m_diskSubHeader = {};
+        m_varHeaders = nullptr;
+        m_samples = nullptr;
+        m_sampleCount = 0;
+        m_sessionTime = {};
+    }
+
+    bool IbtReader::isOpen() const
+    {
+        return m_file.isOpen();
+    }
+
+    int IbtReader::getSampleCount() const
+    {
+        return m_sampleCount;
+    }
+
+    int IbtReader::getTickRate() const
+    {
+        return m_header.tickRate;
+    }
+
+    const irsdk_diskSubHeader &IbtReader::getDiskSubHeader() const
+    {
+        return m_diskSubHeader;
+    }
+
+    std::string_view IbtReader::getSessionStr() const
+    {
+        if (!isOpen())
+        {
+            return {};
+        }
+
+        // The string usually ends with a null character within its length.
+        std::string_view sessionStr(m_file.getData() + m_header.sessionInfoOffset, m_header.sessionInfoLen);
+        return sessionStr.substr(0, sessionStr.find('\0'));
+    }
+
+    int IbtReader::getVarIdx(const char *name) const
+    {
+        for (int idx = 0; idx < m_header.numVars && name != nullptr; idx++)
+        {
+            if (strncmp(name, m_varHeaders[idx].name, IRSDK_MAX_STRING) == 0)
+            {
+                return idx;
+            }
+        }
+        return -1;
+    }
+
+    const irsdk_varHeader *IbtReader::getVarHeader(int idx) const
+    {
+        return idx >= 0 && idx < m_header.numVars ? &m_varHeaders[idx] : nullptr;
+    }
+
+    const char *IbtReader::getSample(int sample) const
+    {
+        return sample >= 0 && sample < m_sampleCount ? m_samples + (size_t)sample * m_header.bufLen : nullptr;
+    }
+
+    int IbtReader::findSample(double sessionTime) const
+    {
+        if (!m_sessionTime.isValid())
+        {
+            return m_sampleCount;
+        }
+
+        int first = 0;
+        int count = m_sampleCount;
+        while (count > 0)
+        {
+            int step = count / 2;
+            if (m_sessionTime[first + step] < sessionTime)
+            {
+                first += step + 1;
+                count -= step + 1;
+            }
+            else
+            {
+                count = step;
+            }
+        }
+        return first;
+    }
+
+    const char *IbtReader::getEntry(int idx, int entry, int type, size_t size) const
+    {
+        const irsdk_varHeader *varHeader = getVarHeader(idx);
+        if (varHeader == nullptr || entry < 0 || entry >= varHeader->count || m_sampleCount == 0)
+        {
+            return nullptr;
+        }
+
+        bool typeMatches = varHeader->type == type || (type == irsdk_int && varHeader->type == irsdk_bitField);
+        size_t offset = (size_t)varHeader->offset + entry * size;
+        if (!typeMatches || varHeader->offset < 0 || offset + size > (size_t)m_header.bufLen)
+        {
+            return nullptr;
+        }
+        return m_samples + offset;
+    }
+} // namespace iracing
@@ -0,0 +1,147 @@
+//
+// SliProSuperPro
+// A Shift Light Indicator controller
+// Copyright 2025 Fixfactory
+//
+// This file is part of SliProSuperPro.
+//
+// SliProSuperPro is free software: you can redistribute it and/or modify it under
+// the terms of the GNU General Public License as published by the Free
+// Software Foundation, either version 3 of the License, or any later version.
+//
+// SliProSuperPro is distributed in the hope that it will be useful, but WITHOUT
+// ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+// FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+// more details.
+//
+// You should have received a copy of the GNU General Public License along
+// with SliProSuperPro. If not, see <http://www.gnu.org/licenses/>.
+//
+
+#pragma once
+
+#include <cstring>
+#include <string>
+#include <string_view>
+
+#include "MappedFile.h"
+#include "irsdk/irsdk_defines.h"
+
+namespace iracing
+{
+    // Reads iRacing's .ibt telemetry files through a memory mapping instead of irsdkDiskClient's line by line fread().
+    // Samples are the fixed size lines that follow the headers, so any sample can be reached without reading the ones
+    // before it, and a variable can be read across samples as a column without copying the lines.
+    class IbtReader
+    {
+    public:
+        // One entry of a variable in every sample. Reading a sample only touches the bytes of that entry.
+        template <typename T> class Column
+        {
+        public:
+            bool isValid() const
+            {
+                return m_data != nullptr;
+            }
+
+            int size() const
+            {
+                return m_sampleCount;
+            }
+
+            T operator[](int sample) const
+            {
+                // Lines are packed, so values aren't aligned.
+                T value;
+                memcpy(&value, m_data + (size_t)sample * m_stride, sizeof(T));
+                return value;
+            }
+
+        private:
+            friend class IbtReader;
+
+            const char *m_data{ nullptr };
+            size_t m_stride{ 0 };
+            int m_sampleCount{ 0 };
+        };
+
+        bool open(const std::string &path);
+        void close();
+        bool isOpen() const;
+
+        int getSampleCount() const;
+        int getTickRate() const;
+        const irsdk_diskSubHeader &getDiskSubHeader() const;
+        std::string_view getSessionStr() const;
+
+        // Returns -1 if the file has no variable with this name.
+        int getVarIdx(const char *name) const;
+        const irsdk_varHeader *getVarHeader(int idx) const;
+
+        // The column is invalid if the variable doesn't exist or T doesn't match its type.
+        // bool, char, int (also for bit fields), float and double match the irsdk types of the same name.
+        template <typename T> Column<T> getColumn(const char *name, int entry = 0) const
+        {
+            return getColumn<T>(getVarIdx(name), entry);
+        }
+
+        template <typename T> Column<T> getColumn(int idx, int entry = 0) const
+        {
+            Column<T> column;
+            const char *data = getEntry(idx, entry, getType<T>(), sizeof(T));
+            if (data != nullptr)
+            {
+                column.m_data = data;
+                column.m_stride = m_header.bufLen;
+                column.m_sampleCount = m_sampleCount;
+            }
+            return column;
+        }
+
+        // The line of a sample, laid out as described by the variable headers.
+        const char *getSample(int sample) const;
+
+        // Returns the first sample at or after sessionTime, or getSampleCount() if there is none.
+        // Binary searches the SessionTime column, so it expects session time to never go backwards in the file.
+        int findSample(double sessionTime) const;
+
+    private:
+        MappedFile m_file;
+        irsdk_header m_header{};
+        irsdk_diskSubHeader m_diskSubHeader{};
+        const irsdk_varHeader *m_varHeaders{ nullptr };
+        const char *m_samples{ nullptr };
+        int m_sampleCount{ 0 };
+        Column<double> m_sessionTime;
+
+        template <typename T> static int getType();
+
+        // Returns the entry in the first sample, or nullptr if it doesn't exist or doesn't have the type.
+        const char *getEntry(int idx, int entry, int type, size_t size) const;
+    };
+
+    template <> inline int IbtReader::getType<bool>()
+    {
+        return irsdk_bool;
+    }
+
+    template <> inline int IbtReader::getType<char>()
+    {
+        return irsdk_char;
+    }
+
+    template <> inline int IbtReader::getType<int>()
+    {
+        return irsdk_int;
+    }
+
+    template <> inline int IbtReader::getType<float>()
+    {
+        return irsdk_float;
+    }
+
+    template <> inline int IbtReader::getType<double>()
+    {
+        return irsdk_double;
+    }
+} // namespace iracing
@@ -0,0 +1,284 @@
+//
+// SliProSuperPro
+// A Shift Light Indicator controller
+// Copyright 2025 Fixfactory
+//
+// This file is part of SliProSuperPro.
+//
+// SliProSuperPro is free software: you can redistribute it and/or modify it under
+// the terms of the GNU General Public License as published by the Free
+// Software Foundation, either version 3 of the License, or any later version.
+//
+// SliProSuperPro is distributed in the hope that it will be useful, but WITHOUT
+// ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+// FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+// more details.
+//
+// You should have received a copy of the GNU General Public License along
+// with SliProSuperPro. If not, see <http://www.gnu.org/licenses/>.
+//
+
+#include <charconv>
+#include <cstdlib>
+#include <cstring>
+
+#include "SessionIndex.h"
+
+namespace iracing
+{
+    // Whether a line belongs to a scope. The keys of a list item are at the depth of its dash.
+    bool isNested(int depth, bool isItem, int scopeDepth, bool scopeIsItem)
+    {
+        return depth > scopeDepth || (scopeIsItem && depth == scopeDepth && !isItem);
+    }
+
+    SessionIndex::SessionIndex(std::initializer_list<const char *> paths)
+    {
+        for (const char *pathStr : paths)
+        {
+            // Split after every ':', and after every {} selector.
+            Path path;
+            std::string_view remaining(pathStr);
+            while (!remaining.empty())
+            {
+                size_t end = remaining.find(':');
+                if (end == std::string_view::npos)
+                {
+                    break;
+                }
+
+                Component component;
+                component.key = remaining.substr(0, end + 1);
+                remaining.remove_prefix(end + 1);
+
+                if (remaining.substr(0, 2) == "{}")
+                {
+                    component.isSelector = true;
+                    path.hasSelector = true;
+                    remaining.remove_prefix(2);
+                }
+                path.components.push_back(component);
+            }
+            m_paths.push_back(path);
+        }
+    }
+
+    SessionIndex::~SessionIndex()
+    {
+    }
+
+    void SessionIndex::index(const char *sessionStr)
+    {
+        for (Path &path : m_paths)
+        {
+            path.isFound = false;
+            path.value = {};
+            path.values.clear();
+        }
+        m_scopes.clear();
+        m_skippedScope = -1;
+
+        if (sessionStr == nullptr)
+        {
+            return;
+        }
+
+        // Same tokenizing as parseYaml: the depth counts the spaces and dashes before the key, the key ends with the
+        // first ':' and the value is the rest of the line.
+        const char *data = sessionStr;
+        while (*data)
+        {
+            int depth = 0;
+            bool isItem = false;
+            while (*data == ' ' || *data == '-')
+            {
+                isItem |= *data == '-';
+                depth++;
+                data++;
+            }
+
+            // Most of the string, like the session results, is in scopes no path goes through. iRacing ends its lines
+            // with \n, so they can be skipped quickly.
+            if (m_skippedScope >= 0)
+            {
+                const Scope &scope = m_scopes[m_skippedScope];
+                if (isNested(depth, isItem, scope.depth, scope.isItem) || *data == '\n' || *data == '\r')
+                {
+                    const char *lineEnd = strchr(data, '\n');
+                    data = lineEnd != nullptr ? lineEnd + 1 : data + strlen(data);
+                    continue;
+                }
+                m_skippedScope = -1;
+            }
+
+            const char *keyStr = data;
+            while (*data && *data != ':' && *data != '\n' && *data != '\r')
+            {
+                data++;
+            }
+
+            if (*data == ':')
+            {
+                data++;
+                std::string_view key(keyStr, data - keyStr);
+
+                while (*data == ' ')
+                {
+                    data++;
+                }
+
+                const char *valueStr = data;
+                while (*data && *data != '\n' && *data != '\r')
+                {
+                    data++;
+                }
+                std::string_view value(valueStr, data - valueStr);
+
+                // Leave the scopes this line isn't nested in.
+                while (!m_scopes.empty() && !isNested(depth, isItem, m_scopes.back().depth, m_scopes.back().isItem))
+                {
+                    m_scopes.pop_back();
+                }
+
+                matchLine(key, value);
+
+                if (isItem || value.empty())
+                {
+                    m_scopes.push_back({ depth, isItem, key, isItem ? value : std::string_view{} });
+                    if (!isPathPrefix())
+                    {
+                        m_skippedScope = (int)m_scopes.size() - 1;
+                    }
+                }
+            }
+
+            while (*data == '\n' || *data == '\r')
+            {
+                data++;
+            }
+        }
+    }
+
+    bool SessionIndex::getInt(int path, int &outValue) const
+    {
+        std::string_view value = find(path, -1);
+        outValue = value.data() != nullptr ? atoi(value.data()) : 0;
+        return value.data() != nullptr;
+    }
+
+    bool SessionIndex::getFloat(int path, float &outValue) const
+    {
+        std::string_view value = find(path, -1);
+        outValue = value.data() != nullptr ? (float)atof(value.data()) : 0.f;
+        return value.data() != nullptr;
+    }
+
+    bool SessionIndex::getString(int path, std::string &outValue) const
+    {
+        return getString(path, -1, outValue);
+    }
+
+    bool SessionIndex::getString(int path, int selector, std::string &outValue) const
+    {
+        std::string_view value = find(path, selector);
+
+        // Strip quotes.
+        if (!value.empty() && value.front() == '"')
+        {
+            value.remove_prefix(1);
+        }
+        if (!value.empty() && value.back() == '"')
+        {
+            value.remove_suffix(1);
+        }
+
+        outValue = value;
+        return value.data() != nullptr;
+    }
+
+    void SessionIndex::matchLine(std::string_view key, std::string_view value)
+    {
+        for (Path &path : m_paths)
+        {
+            if (path.components.size() != m_scopes.size() + 1 || path.components.back().key != key ||
+                (path.isFound && !path.hasSelector))
+            {
+                continue;
+            }
+
+            // Paths go through list items with selectors, and through keys without.
+            std::string_view selector{};
+            bool matches = true;
+            for (size_t i = 0; i < m_scopes.size() && matches; i++)
+            {
+                const Component &component = path.components[i];
+                const Scope &scope = m_scopes[i];
+                matches = component.key == scope.key && component.isSelector == scope.isItem;
+                if (component.isSelector)
+                {
+                    selector = scope.value;
+                }
+            }
+
+            if (!matches)
+            {
+                continue;
+            }
+
+            if (path.hasSelector)
+            {
+                path.values.push_back({ selector, value });
+            }
+            else
+            {
+                path.isFound = true;
+                path.value = value;
+            }
+        }
+    }
+
+    bool SessionIndex::isPathPrefix() const
+    {
+        for (const Path &path : m_paths)
+        {
+            if (path.components.size() <= m_scopes.size())
+            {
+                continue;
+            }
+
+            bool matches = true;
+            for (size_t i = 0; i < m_scopes.size() && matches; i++)
+            {
+                matches = path.components[i].key == m_scopes[i].key &&
+                          path.components[i].isSelector == m_scopes[i].isItem;
+            }
+
+            if (matches)
+            {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    std::string_view SessionIndex::find(int path, int selector) const
+    {
+        const Path &indexedPath = m_paths[path];
+        if (!indexedPath.hasSelector)
+        {
+            return indexedPath.isFound ? indexedPath.value : std::string_view{};
+        }
+
+        for (const auto &[selectorValue, value] : indexedPath.values)
+        {
+            int itemSelector = 0;
+            auto result = std::from_chars(selectorValue.data(), selectorValue.data() + selectorValue.size(),
+                                          itemSelector);
+            if (result.ec == std::errc() && itemSelector == selector)
+            {
+                return value;
+            }
+        }
+        return {};
+    }
+} // namespace iracing
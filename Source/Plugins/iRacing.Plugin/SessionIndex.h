@@ -0,0 +1,88 @@
+//
+// SliProSuperPro
+// A Shift Light Indicator controller
+// Copyright 2025 Fixfactory
+//
+// This file is part of SliProSuperPro.
+//
+// SliProSuperPro is free software: you can redistribute it and/or modify it under
+// the terms of the GNU General Public License as published by the Free
+// Software Foundation, either version 3 of the License, or any later version.
+//
+// SliProSuperPro is distributed in the hope that it will be useful, but WITHOUT
+// ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+// FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+// more details.
+//
+// You should have received a copy of the GNU General Public License along
+// with SliProSuperPro. If not, see <http://www.gnu.org/licenses/>.
+//
+
+#pragma once
+
+#include <initializer_list>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace iracing
+{
+    // Finds values in iRacing's session string with one pass over it, instead of one pass per value like parseYaml.
+    // Paths use parseYaml's syntax. A list item is selected with {} after its first key, e.g.
+    // "DriverInfo:Drivers:CarIdx:{}CarPath:", and every item's value is indexed so any of them can be looked up.
+    // Values point into the session string, so they are only valid until it changes.
+    class SessionIndex
+    {
+    public:
+        // The paths are identified by their position in paths.
+        SessionIndex(std::initializer_list<const char *> paths);
+        ~SessionIndex();
+
+        void index(const char *sessionStr);
+
+        // Like parseYaml, the value is 0 or empty if the path isn't found.
+        bool getInt(int path, int &outValue) const;
+        bool getFloat(int path, float &outValue) const;
+        bool getString(int path, std::string &outValue) const;
+
+        // For paths with a {} selector, the value in the list item whose first key has the given value.
+        bool getString(int path, int selector, std::string &outValue) const;
+
+    private:
+        struct Component
+        {
+            std::string key{};
+            bool isSelector{ false };
+        };
+
+        struct Path
+        {
+            std::vector<Component> components;
+            bool hasSelector{ false };
+
+            // The first value found, or every (selector, value) pair for paths with a selector.
+            bool isFound{ false };
+            std::string_view value{};
+            std::vector<std::pair<std::string_view, std::string_view>> values;
+        };
+
+        // A key with nested values, or a list item and the value of its first key.
+        struct Scope
+        {
+            int depth{ 0 };
+            bool isItem{ false };
+            std::string_view key{};
+            std::string_view value{};
+        };
+
+        std::vector<Path> m_paths;
+        std::vector<Scope> m_scopes;
+
+        // The outermost scope that no path goes through, or -1.
+        int m_skippedScope{ -1 };
+
+        void matchLine(std::string_view key, std::string_view value);
+        bool isPathPrefix() const;
+        std::string_view find(int path, int selector) const;
+    };
+} // namespace iracing
@@ -0,0 +1,187 @@
+//
+// SliProSuperPro
+// A Shift Light Indicator controller
+// Copyright 2025 Fixfactory
+//
+// This file is part of SliProSuperPro.
+//
+// SliProSuperPro is free software: you can redistribute it and/or modify it under
+// the terms of the GNU General Public License as published by the Free
+// Software Foundation, either version 3 of the License, or any later version.
+//
+// SliProSuperPro is distributed in the hope that it will be useful, but WITHOUT
+// ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+// FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+// more details.
+//
+// You should have received a copy of the GNU General Public License along
+// with SliProSuperPro. If not, see <http://www.gnu.org/licenses/>.
+//
+
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+
+#include "ShiftLightCache.h"
+#include "BinaryFile.h"
+#include "Log.h"
+
+namespace iracing
+{
+    // Each car is a uint16_t path length, the path, and the downshift then upshift RPMs of every gear as floats.
+    const char kFileMagic[4] = { 'S', 'L', 'C', 'H' };
+    const uint32_t kFileVersion = 2;
+    const size_t kFixedRecordSize = sizeof(uint16_t) + 2 * plugin::kMaxGearCount * sizeof(float);
+
+    ShiftLightCache::ShiftLightCache()
+    {
+    }
+
+    ShiftLightCache::~ShiftLightCache()
+    {
+        deinit();
+    }
+
+    void ShiftLightCache::init(const std::string &filePath)
+    {
+        deinit();
+
+        m_filePath = filePath;
+        m_cars.clear();
+        read();
+    }
+
+    void ShiftLightCache::deinit()
+    {
+        m_writeTask.wait();
+        if (m_hasPendingFile)
+        {
+            startWrite();
+            m_writeTask.wait();
+        }
+
+        m_selectedCar = nullptr;
+    }
+
+    void ShiftLightCache::selectCar(const std::string &carPath, float *rpmDownshift, float *rpmUpshift)
+    {
+        m_selectedCar = &m_cars[carPath];
+        int cachedGearCount = 0;
+        for (int i = 0; i < plugin::kMaxGearCount; i++)
+        {
+            if (m_selectedCar->rpmDownshift[i] != 0.f && m_selectedCar->rpmUpshift[i] != 0.f)
+            {
+                rpmDownshift[i] = m_selectedCar->rpmDownshift[i];
+                rpmUpshift[i] = m_selectedCar->rpmUpshift[i];
+                cachedGearCount++;
+            }
+        }
+
+        if (cachedGearCount > 0)
+        {
+            LOG_INFO("Using the cached shift light RPMs of %i gears for %s", cachedGearCount, carPath.c_str());
+        }
+    }
+
+    void ShiftLightCache::setGear(int gear, float rpmDownshift, float rpmUpshift)
+    {
+        if (m_hasPendingFile && m_writeTask.isDone())
+        {
+            startWrite();
+        }
+
+        if (m_selectedCar == nullptr || gear < 0 || gear >= plugin::kMaxGearCount ||
+            (m_selectedCar->rpmDownshift[gear] == rpmDownshift && m_selectedCar->rpmUpshift[gear] == rpmUpshift))
+        {
+            return;
+        }
+
+        m_selectedCar->rpmDownshift[gear] = rpmDownshift;
+        m_selectedCar->rpmUpshift[gear] = rpmUpshift;
+        scheduleWrite();
+    }
+
+    void ShiftLightCache::read()
+    {
+        std::ifstream file(m_filePath, std::ios::binary);
+        if (!file.good())
+        {
+            return;
+        }
+
+        std::vector<char> data((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+        if (!binaryFile::checkHeader(m_filePath, data.data(), data.size(),
+                                     binaryFile::makeHeader(kFileMagic, kFileVersion, kFixedRecordSize)))
+        {
+            return;
+        }
+
+        BinaryFileHeader header{};
+        memcpy(&header, data.data(), sizeof(header));
+        size_t offset = sizeof(header);
+        size_t rpmSize = plugin::kMaxGearCount * sizeof(float);
+        for (uint32_t i = 0; i < header.recordCount; i++)
+        {
+            uint16_t pathLength = 0;
+            if (offset + sizeof(pathLength) > data.size())
+            {
+                break;
+            }
+            memcpy(&pathLength, data.data() + offset, sizeof(pathLength));
+            offset += sizeof(pathLength);
+
+            if (offset + pathLength + 2 * rpmSize > data.size())
+            {
+                break;
+            }
+
+            Car &car = m_cars[std::string(data.data() + offset, pathLength)];
+            offset += pathLength;
+            memcpy(car.rpmDownshift, data.data() + offset, rpmSize);
+            offset += rpmSize;
+            memcpy(car.rpmUpshift, data.data() + offset, rpmSize);
+            offset += rpmSize;
+        }
+
+        LOG_INFO("Read the shift light RPMs of %zu cars from %s", m_cars.size(), m_filePath.c_str());
+    }
+
+    void ShiftLightCache::scheduleWrite()
+    {
+        BinaryFileHeader header = binaryFile::makeHeader(kFileMagic, kFileVersion, kFixedRecordSize);
+        std::vector<char> file(sizeof(header));
+        for (const auto &[carPath, car] : m_cars)
+        {
+            if (carPath.empty() || carPath.size() > UINT16_MAX)
+            {
+                continue;
+            }
+
+            uint16_t pathLength = (uint16_t)carPath.size();
+            const char *pathLengthData = reinterpret_cast<const char *>(&pathLength);
+            file.insert(file.end(), pathLengthData, pathLengthData + sizeof(pathLength));
+            file.insert(file.end(), carPath.begin(), carPath.end());
+            const char *rpmData = reinterpret_cast<const char *>(car.rpmDownshift);
+            file.insert(file.end(), rpmData, rpmData + sizeof(car.rpmDownshift));
+            rpmData = reinterpret_cast<const char *>(car.rpmUpshift);
+            file.insert(file.end(), rpmData, rpmData + sizeof(car.rpmUpshift));
+            header.recordCount++;
+        }
+        memcpy(file.data(), &header, sizeof(header));
+
+        m_pendingFile.swap(file);
+        m_hasPendingFile = true;
+        if (m_writeTask.isDone())
+        {
+            startWrite();
+        }
+    }
+
+    void ShiftLightCache::startWrite()
+    {
+        m_writingFile.swap(m_pendingFile);
+        m_hasPendingFile = false;
+        m_writeTask.start([this]() { binaryFile::write(m_filePath, m_writingFile); });
+    }
+} // namespace iracing
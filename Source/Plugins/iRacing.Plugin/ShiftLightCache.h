@@ -0,0 +1,76 @@
+//
+// SliProSuperPro
+// A Shift Light Indicator controller
+// Copyright 2025 Fixfactory
+//
+// This file is part of SliProSuperPro.
+//
+// SliProSuperPro is free software: you can redistribute it and/or modify it under
+// the terms of the GNU General Public License as published by the Free
+// Software Foundation, either version 3 of the License, or any later version.
+//
+// SliProSuperPro is distributed in the hope that it will be useful, but WITHOUT
+// ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+// FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+// more details.
+//
+// You should have received a copy of the GNU General Public License along
+// with SliProSuperPro. If not, see <http://www.gnu.org/licenses/>.
+//
+
+#pragma once
+
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "PluginInterface.h"
+#include "BackgroundTask.h"
+
+namespace iracing
+{
+    // Remembers the shift light RPMs iRacing reported for each gear of each car.
+    // iRacing only reports them for the current gear, so without the cache they are only known for the gears driven
+    // so far in the session. The cache is a small binary file that is written in the background when it changes.
+    class ShiftLightCache
+    {
+    public:
+        ShiftLightCache();
+        ~ShiftLightCache();
+
+        void init(const std::string &filePath);
+
+        // Waits for the last changes to be written.
+        void deinit();
+
+        // Selects the car the following calls apply to, and copies the RPMs of its cached gears.
+        // Gears that were never reported keep their value.
+        void selectCar(const std::string &carPath, float *rpmDownshift, float *rpmUpshift);
+
+        // Cheap enough to call every frame. The file is only written when a value changes, and changes made while it
+        // was being written are written from here once it is done.
+        void setGear(int gear, float rpmDownshift, float rpmUpshift);
+
+    private:
+        struct Car
+        {
+            float rpmDownshift[plugin::kMaxGearCount]{};
+            float rpmUpshift[plugin::kMaxGearCount]{};
+        };
+
+        std::string m_filePath;
+        std::unordered_map<std::string, Car> m_cars;
+        Car *m_selectedCar{ nullptr };
+
+        // The file being written is only touched by the task while it runs. A file built meanwhile waits for it,
+        // and only the newest one is written.
+        BackgroundTask m_writeTask;
+        std::vector<char> m_writingFile;
+        std::vector<char> m_pendingFile;
+        bool m_hasPendingFile{ false };
+
+        void read();
+        void scheduleWrite();
+        void startWrite();
+    };
+} // namespace iracing
@@ -19,332 +19,222 @@
 //
 
 #include <Windows.h>
-#include <fstream>
+#include <cstdio>
 
 #include "Telemetry.h"
 #include "Log.h"
 
-#include "irsdk/irsdk_client.h"
-#include "irsdk/yaml_parser.h"
+#include "irsdk/irsdk_defines.h"
 
-irsdkCVar g_IsReplayPlaying("IsReplayPlaying");
-irsdkCVar g_Voltage("Voltage");
-irsdkCVar g_Gear("Gear");
-irsdkCVar g_RPM("RPM");
-irsdkCVar g_Speed("Speed");
-irsdkCVar g_SpeedLimiter("dcPitSpeedLimiterToggle");
-irsdkCVar g_OnPitRoad("OnPitRoad");
-irsdkCVar g_PlayerCarSLFirstRPM("PlayerCarSLFirstRPM");
-irsdkCVar g_PlayerCarSLShiftRPM("PlayerCarSLShiftRPM");
-irsdkCVar g_PlayerCarSLLastRPM("PlayerCarSLLastRPM");
-irsdkCVar g_PlayerCarSLBlinkRPM("PlayerCarSLBlinkRPM");
-
-const float kMpsToKph = 3.6f;
-
-bool parseYamlInt(const char *yamlStr, const char *path, int *dest)
+namespace iracing
 {
-    if (dest)
+    // The telemetry variables we read, in the order they are given to the VariableReader.
+    enum Variable
     {
-        (*dest) = 0;
-
-        if (yamlStr && path)
-        {
-            int count;
-            const char *strPtr;
+        kIsReplayPlaying,
+        kVoltage,
+        kGear,
+        kRPM,
+        kSpeed,
+        kSpeedLimiter,
+        kOnPitRoad,
+        kPlayerCarSLFirstRPM,
+        kPlayerCarSLShiftRPM,
+        kPlayerCarSLLastRPM,
+        kPlayerCarSLBlinkRPM,
+    };
 
-            if (parseYaml(yamlStr, path, &strPtr, &count))
-            {
-                (*dest) = atoi(strPtr);
-                return true;
-            }
-        }
-    }
-
-    return false;
-}
-
-bool parseYamlFloat(const char *yamlStr, const char *path, float *dest)
-{
-    if (dest)
+    // The session string values we read, in the order they are given to the SessionIndex.
+    enum SessionValue
     {
-        (*dest) = 0.0f;
+        kDriverCarIdx,
+        kDriverCarPath,
+        kDriverCarGearNumForward,
+        kDriverCarRedLine,
+        kHardcoreLevel,
+        kDriverCarSLFirstRPM,
+        kDriverCarSLShiftRPM,
+        kDriverCarSLLastRPM,
+        kDriverCarSLBlinkRPM,
+    };
 
-        if (yamlStr && path)
-        {
-            int count;
-            const char *strPtr;
+    const float kMpsToKph = 3.6f;
 
-            if (parseYaml(yamlStr, path, &strPtr, &count))
-            {
-                (*dest) = (float)atof(strPtr);
-                return true;
-            }
-        }
+    TelemetryManager &TelemetryManager::getSingleton()
+    {
+        static TelemetryManager s_singleton;
+        return s_singleton;
     }
 
-    return false;
-}
-
-bool parseYamlStr(const char *yamlStr, const char *path, char *dest, int maxCount)
-{
-    if (dest && maxCount > 0)
+    TelemetryManager::TelemetryManager()
+        : m_variables({ "IsReplayPlaying", "Voltage", "Gear", "RPM", "Speed", "dcPitSpeedLimiterToggle", "OnPitRoad",
+                        "PlayerCarSLFirstRPM", "PlayerCarSLShiftRPM", "PlayerCarSLLastRPM", "PlayerCarSLBlinkRPM" }),
+          m_session({ "DriverInfo:DriverCarIdx:", "DriverInfo:Drivers:CarIdx:{}CarPath:",
+                      "DriverInfo:DriverCarGearNumForward:", "DriverInfo:DriverCarRedLine:",
+                      "WeekendInfo:WeekendOptions:HardcoreLevel:", "DriverInfo:DriverCarSLFirstRPM:",
+                      "DriverInfo:DriverCarSLShiftRPM:", "DriverInfo:DriverCarSLLastRPM:",
+                      "DriverInfo:DriverCarSLBlinkRPM:" })
     {
-        dest[0] = '\0';
-
-        if (yamlStr && path)
-        {
-            int count;
-            const char *strPtr;
-
-            if (parseYaml(yamlStr, path, &strPtr, &count))
-            {
-                // strip leading quotes
-                if (*strPtr == '"')
-                {
-                    strPtr++;
-                    count--;
-                }
-
-                int l = min(count, maxCount);
-                strncpy_s(dest, maxCount, strPtr, l);
-                dest[l] = '\0';
-
-                // strip trailing quotes
-                if (l >= 1 && dest[l - 1] == '"')
-                    dest[l - 1] = '\0';
-
-                return true;
-            }
-        }
     }
 
-    return false;
-}
-
-TelemetryManager &TelemetryManager::getSingleton()
-{
-    static TelemetryManager s_singleton;
-    return s_singleton;
-}
-
-TelemetryManager::TelemetryManager()
-{
-}
-
-TelemetryManager::~TelemetryManager()
-{
-}
-
-void TelemetryManager::init()
-{
-    memset(&m_telemetryData, 0, sizeof(m_telemetryData));
-    memset(&m_physicsData, 0, sizeof(m_physicsData));
-    memset(m_rpmDownshiftOverride, 0, sizeof(m_rpmDownshiftOverride));
-    memset(m_rpmUpshiftOverride, 0, sizeof(m_rpmDownshiftOverride));
-
-    m_hasOverride = false;
-    m_hardcoreLevel = 0;
+    TelemetryManager::~TelemetryManager()
+    {
+    }
 
-    readOverrides();
-}
+    void TelemetryManager::init()
+    {
+        memset(&m_telemetryData, 0, sizeof(m_telemetryData));
+        memset(&m_physicsData, 0, sizeof(m_physicsData));
 
-void TelemetryManager::deinit()
-{
-}
+        m_carOverride = nullptr;
+        m_hardcoreLevel = 0;
+        m_lastSessionInfoUpdate = -1;
+        m_variables.reset();
 
-bool TelemetryManager::fetchTelemetryData()
-{
-    // Wait up to 100 ms for start of session or new data
-    // We could put this on a thread if iRacing's rate fluctuates too much and is 
-    // causing issues with the animations.
-    if (!irsdkClient::instance().waitForData(100))
-    {
-        return false;
+        m_shiftLights.init("iRacing.ShiftLights.cache");
+        m_carOverrides.init("iRacing.Overrides.json", overrides::parseShiftLightOverride);
     }
 
-    // Voltage is 0 when out of the car.
-    int voltage = g_Voltage.isValid() ? g_Voltage.getInt() : 0;
-    bool isReplayPlaying = g_IsReplayPlaying.isValid() ? g_IsReplayPlaying.getBool() : true;
-    if (voltage <= 0 || isReplayPlaying)
+    void TelemetryManager::deinit()
     {
-        return false;
+        m_carOverrides.deinit();
+        m_shiftLights.deinit();
+        irsdk_shutdown();
     }
 
-    // Session string is not updated every frame.
-    if (irsdkClient::instance().wasSessionStrUpdated())
+    bool TelemetryManager::fetchTelemetryData()
     {
-        const char *sessionStr = irsdkClient::instance().getSessionStr();
-        if (sessionStr && sessionStr[0])
+        // Wait up to 100 ms for start of session or new data
+        // We could put this on a thread if iRacing's rate fluctuates too much and is
+        // causing issues with the animations.
+        if (!irsdk_waitForDataReady(100, nullptr) ||
+            !m_variables.read(reinterpret_cast<const char *>(irsdk_getHeader())))
         {
-            int driverCarIdx;
-            parseYamlInt(sessionStr, "DriverInfo:DriverCarIdx:", &driverCarIdx);
-
-            char tstr[256];
-            sprintf_s(tstr, "DriverInfo:Drivers:CarIdx:{%d}CarPath:", driverCarIdx);
-            char driverCarPath[256];
-            parseYamlStr(sessionStr, tstr, driverCarPath, sizeof(driverCarPath) - 1);
-            m_carPath = driverCarPath;
-            
-            int gearNumForward;
-            parseYamlInt(sessionStr, "DriverInfo:DriverCarGearNumForward:", &gearNumForward);
-            m_physicsData.gearCount = gearNumForward + 2; // Add reverse and neutral
-
-            float redLineRPM;
-            parseYamlFloat(sessionStr, "DriverInfo:DriverCarRedLine:", &redLineRPM);
-            m_physicsData.rpmLimit = redLineRPM;
-
-            parseYamlInt(sessionStr, "WeekendInfo:WeekendOptions:HardcoreLevel:", &m_hardcoreLevel);
-
-            // This was iRacing's old way of specifying Shift Light RPM. It was specified in Session Data
-            // and each gear had the same RPM values.
-            float firstRPM;
-            float shiftRPM;
-            float lastRPM;
-            float blinkRPM;
-
-            parseYamlFloat(sessionStr, "DriverInfo:DriverCarSLFirstRPM:", &firstRPM);
-            parseYamlFloat(sessionStr, "DriverInfo:DriverCarSLShiftRPM:", &shiftRPM);
-            parseYamlFloat(sessionStr, "DriverInfo:DriverCarSLLastRPM:", &lastRPM);
-            parseYamlFloat(sessionStr, "DriverInfo:DriverCarSLBlinkRPM:", &blinkRPM);
-
-            for (int i = 0; i < plugin::kMaxGearCount; i++)
-            {
-                m_physicsData.rpmDownshift[i] = firstRPM;
-                m_physicsData.rpmUpshift[i] = lastRPM;
-            }
-
-            parseOverrides();
+            return false;
         }
-    }
 
-    m_telemetryData.gear = g_Gear.isValid() ? g_Gear.getInt() + 1 : 0;
-    m_telemetryData.rpm = g_RPM.isValid() ? g_RPM.getFloat() : 0.f;
-    m_telemetryData.speedKph = g_Speed.isValid() ? g_Speed.getFloat() * kMpsToKph : 0.f;
-    bool onPitRoad = g_OnPitRoad.isValid() ? g_OnPitRoad.getBool() : false;
+        // Voltage is 0 when out of the car.
+        int voltage = m_variables.isValid(kVoltage) ? m_variables.getInt(kVoltage) : 0;
+        bool isReplayPlaying = m_variables.isValid(kIsReplayPlaying) ? m_variables.getBool(kIsReplayPlaying) : true;
+        if (voltage <= 0 || isReplayPlaying)
+        {
+            return false;
+        }
 
-    // With Hardcore Level 0 the player has to manually activate the speed limiter.
-    // At Hardcore Level 1 the speed limiter is automatically activated on pit road.
-    if (m_hardcoreLevel > 0 && onPitRoad)
-    {
-        m_telemetryData.speedLimiter = true;
-    }
-    else if (g_SpeedLimiter.isValid())
-    {
-        // Not every car has a speed limiter.
-        m_telemetryData.speedLimiter = g_SpeedLimiter.getBool();
-    }
-    else
-    {
-        m_telemetryData.speedLimiter = false;
-    }
+        // Session string is not updated every frame. Parse it again after a reconnect even if its count is the same.
+        if (irsdk_getSessionInfoStrUpdate() != m_lastSessionInfoUpdate ||
+            m_variables.getResolveCount() != m_lastResolveCount)
+        {
+            m_lastSessionInfoUpdate = irsdk_getSessionInfoStrUpdate();
+            m_lastResolveCount = m_variables.getResolveCount();
 
-    // This is iRacing's new way of specifying Shift Light RPM. It is now specified in Live Telemetry
-    // and each gear can have different RPM values. The values are for the current gear.
-    float gearFirstRPM = g_PlayerCarSLFirstRPM.isValid() ? g_PlayerCarSLFirstRPM.getFloat() : 0.f;
-    float gearShiftRPM = g_PlayerCarSLShiftRPM.isValid() ? g_PlayerCarSLShiftRPM.getFloat() : 0.f;
-    float gearLastRPM = g_PlayerCarSLLastRPM.isValid() ? g_PlayerCarSLLastRPM.getFloat() : 0.f;
-    float gearBlinkRPM = g_PlayerCarSLBlinkRPM.isValid() ? g_PlayerCarSLBlinkRPM.getFloat() : 0.f;
+            const char *sessionStr = irsdk_getSessionInfoStr();
+            if (sessionStr && sessionStr[0])
+            {
+                // One pass over the session string, which is over 100 KB with a full field.
+                m_session.index(sessionStr);
 
-    if (gearFirstRPM != 0.f && gearLastRPM != 0.f && m_telemetryData.gear >= 0 &&
-        m_telemetryData.gear < plugin::kMaxGearCount)
-    {
-        m_physicsData.rpmDownshift[m_telemetryData.gear] = gearFirstRPM;
-        m_physicsData.rpmUpshift[m_telemetryData.gear] = gearLastRPM;
-    }
+                int driverCarIdx;
+                m_session.getInt(kDriverCarIdx, driverCarIdx);
+                m_session.getString(kDriverCarPath, driverCarIdx, m_carPath);
+                snprintf(m_physicsData.carId, sizeof(m_physicsData.carId), "%s", m_carPath.c_str());
 
-    if (m_hasOverride)
-    {
-        memcpy(m_physicsData.rpmDownshift, m_rpmDownshiftOverride, sizeof(m_physicsData.rpmDownshift));
-        memcpy(m_physicsData.rpmUpshift, m_rpmUpshiftOverride, sizeof(m_physicsData.rpmUpshift));
-    }
+                int gearNumForward;
+                m_session.getInt(kDriverCarGearNumForward, gearNumForward);
+                m_physicsData.gearCount = gearNumForward + 2; // Add reverse and neutral
 
-    return true;
-}
+                float redLineRPM;
+                m_session.getFloat(kDriverCarRedLine, redLineRPM);
+                m_physicsData.rpmLimit = redLineRPM;
 
-const plugin::TelemetryData &TelemetryManager::getTelemetryData() const
-{
-    return m_telemetryData;
-}
+                m_session.getInt(kHardcoreLevel, m_hardcoreLevel);
 
-const plugin::PhysicsData &TelemetryManager::getPhysicsData() const
-{
-    return m_physicsData;
-}
+                // This was iRacing's old way of specifying Shift Light RPM. It was specified in Session Data
+                // and each gear had the same RPM values.
+                float firstRPM;
+                float shiftRPM;
+                float lastRPM;
+                float blinkRPM;
 
-void TelemetryManager::readOverrides()
-{
-    std::ifstream file("iRacing.Overrides.json");
-    if (file.good())
-    {
-        LOG_INFO("Reading iRacing.Overrides.json");
-        m_overrides = json::parse(file);
-    }
-}
+                m_session.getFloat(kDriverCarSLFirstRPM, firstRPM);
+                m_session.getFloat(kDriverCarSLShiftRPM, shiftRPM);
+                m_session.getFloat(kDriverCarSLLastRPM, lastRPM);
+                m_session.getFloat(kDriverCarSLBlinkRPM, blinkRPM);
 
-void TelemetryManager::parseOverrides()
-{
-    m_hasOverride = false;
-    memset(m_rpmDownshiftOverride, 0, sizeof(m_rpmDownshiftOverride));
-    memset(m_rpmUpshiftOverride, 0, sizeof(m_rpmDownshiftOverride));
+                for (int i = 0; i < plugin::kMaxGearCount; i++)
+                {
+                    m_physicsData.rpmDownshift[i] = firstRPM;
+                    m_physicsData.rpmUpshift[i] = lastRPM;
+                }
 
-    if (m_carPath.empty() || m_overrides.empty())
-    {
-        return;
-    }
+                // Gears driven in an earlier session don't have to be driven again to get their own RPMs.
+                m_shiftLights.selectCar(m_carPath, m_physicsData.rpmDownshift, m_physicsData.rpmUpshift);
 
-    json overrides = m_overrides["cars"][m_carPath];  
-    if (overrides.empty())
-    {
-        return;
-    }
+                m_carOverride = m_carOverrides.find(m_carPath);
+            }
+        }
 
-    if (!overrides["firstRPM"].empty() && !overrides["lastRPM"].empty())
-    {
-        int firstRPM = overrides["firstRPM"].template get<int>();
-        int lastRPM = overrides["lastRPM"].template get<int>();
+        m_telemetryData.gear = m_variables.isValid(kGear) ? m_variables.getInt(kGear) + 1 : 0;
+        m_telemetryData.rpm = m_variables.isValid(kRPM) ? m_variables.getFloat(kRPM) : 0.f;
+        m_telemetryData.speedKph = m_variables.isValid(kSpeed) ? m_variables.getFloat(kSpeed) * kMpsToKph : 0.f;
+        bool onPitRoad = m_variables.isValid(kOnPitRoad) ? m_variables.getBool(kOnPitRoad) : false;
 
-        for (int i = 0; i < plugin::kMaxGearCount; i++)
+        // With Hardcore Level 0 the player has to manually activate the speed limiter.
+        // At Hardcore Level 1 the speed limiter is automatically activated on pit road.
+        if (m_hardcoreLevel > 0 && onPitRoad)
         {
-            m_rpmDownshiftOverride[i] = (float)firstRPM;
-            m_rpmUpshiftOverride[i] = (float)lastRPM;
+            m_telemetryData.speedLimiter = true;
         }
-    }
-    else
-    {
-        for (auto &gear : overrides["gears"].items())
+        else if (m_variables.isValid(kSpeedLimiter))
         {
-            if (gear.value()["gear"].empty() || gear.value()["firstRPM"].empty() || gear.value()["lastRPM"].empty())
-            {
-                continue;
-            }
+            // Not every car has a speed limiter.
+            m_telemetryData.speedLimiter = m_variables.getBool(kSpeedLimiter);
+        }
+        else
+        {
+            m_telemetryData.speedLimiter = false;
+        }
 
-            std::string gearName = gear.value()["gear"].template get<std::string>();
-            int firstRPM = gear.value()["firstRPM"].template get<int>();
-            int lastRPM = gear.value()["lastRPM"].template get<int>();
+        // This is iRacing's new way of specifying Shift Light RPM. It is now specified in Live Telemetry
+        // and each gear can have different RPM values. The values are for the current gear.
+        float gearFirstRPM =
+            m_variables.isValid(kPlayerCarSLFirstRPM) ? m_variables.getFloat(kPlayerCarSLFirstRPM) : 0.f;
+        float gearShiftRPM =
+            m_variables.isValid(kPlayerCarSLShiftRPM) ? m_variables.getFloat(kPlayerCarSLShiftRPM) : 0.f;
+        float gearLastRPM = m_variables.isValid(kPlayerCarSLLastRPM) ? m_variables.getFloat(kPlayerCarSLLastRPM) : 0.f;
+        float gearBlinkRPM =
+            m_variables.isValid(kPlayerCarSLBlinkRPM) ? m_variables.getFloat(kPlayerCarSLBlinkRPM) : 0.f;
+
+        if (gearFirstRPM != 0.f && gearLastRPM != 0.f && m_telemetryData.gear >= 0 &&
+            m_telemetryData.gear < plugin::kMaxGearCount)
+        {
+            m_physicsData.rpmDownshift[m_telemetryData.gear] = gearFirstRPM;
+            m_physicsData.rpmUpshift[m_telemetryData.gear] = gearLastRPM;
+            m_shiftLights.setGear(m_telemetryData.gear, gearFirstRPM, gearLastRPM);
+        }
 
-            int gearIdx = -1;
-            if (gearName == "R")
-            {
-                gearIdx = 0;
-            }
-            else if (gearName == "N")
-            {
-                gearIdx = 1;
-            }
-            else
-            {
-                gearIdx = atoi(gearName.c_str());
-                gearIdx++; // e.g. gear "1" is at index 2.
-            }
+        // The car being driven gets the values of an edited overrides file.
+        if (m_carOverrides.update())
+        {
+            m_carOverride = m_carOverrides.find(m_carPath);
+        }
 
-            if (gearIdx >= 0 && gearIdx < plugin::kMaxGearCount)
-            {
-                m_rpmDownshiftOverride[gearIdx] = (float)firstRPM;
-                m_rpmUpshiftOverride[gearIdx] = (float)lastRPM;
-            }
+        if (m_carOverride)
+        {
+            memcpy(m_physicsData.rpmDownshift, m_carOverride->rpmDownshift, sizeof(m_physicsData.rpmDownshift));
+            memcpy(m_physicsData.rpmUpshift, m_carOverride->rpmUpshift, sizeof(m_physicsData.rpmUpshift));
         }
+
+        return true;
     }
 
-    m_hasOverride = true;
-}
+    const plugin::TelemetryData &TelemetryManager::getTelemetryData() const
+    {
+        return m_telemetryData;
+    }
 
+    const plugin::PhysicsData &TelemetryManager::getPhysicsData() const
+    {
+        return m_physicsData;
+    }
+} // namespace iracing
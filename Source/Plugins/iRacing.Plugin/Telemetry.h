@@ -21,38 +21,42 @@
 #pragma once
 
 #include "PluginInterface.h"
+#include "SessionIndex.h"
+#include "ShiftLightCache.h"
+#include "VariableReader.h"
+#include "OverrideIndex.h"
 
-#include "json/json.hpp"
-using json = nlohmann::json;
-
-class TelemetryManager
+namespace iracing
 {
-public:
-    static TelemetryManager &getSingleton();
-
-    TelemetryManager();
-    ~TelemetryManager();
-
-    void init();
-    void deinit();
-
-    bool fetchTelemetryData();
-    const plugin::TelemetryData &getTelemetryData() const;
-    const plugin::PhysicsData &getPhysicsData() const;
-
-private:
-    plugin::TelemetryData m_telemetryData{};
-    plugin::PhysicsData m_physicsData{};
-
-    json m_overrides;
-
-    std::string m_carPath;
-    int m_hardcoreLevel{ 0 };
-
-    bool m_hasOverride{ false };
-    float m_rpmDownshiftOverride[plugin::kMaxGearCount]{};
-    float m_rpmUpshiftOverride[plugin::kMaxGearCount]{};
-
-    void readOverrides();
-    void parseOverrides();
-};
+    class TelemetryManager
+    {
+    public:
+        static TelemetryManager &getSingleton();
+
+        TelemetryManager();
+        ~TelemetryManager();
+
+        void init();
+        void deinit();
+
+        bool fetchTelemetryData();
+        const plugin::TelemetryData &getTelemetryData() const;
+        const plugin::PhysicsData &getPhysicsData() const;
+
+    private:
+        plugin::TelemetryData m_telemetryData{};
+        plugin::PhysicsData m_physicsData{};
+
+        VariableReader m_variables;
+        SessionIndex m_session;
+        int m_lastSessionInfoUpdate{ -1 };
+        int m_lastResolveCount{ 0 };
+
+        ShiftLightCache m_shiftLights;
+        overrides::WatchedCarIndex<overrides::CarOverride> m_carOverrides;
+        const overrides::CarOverride *m_carOverride{ nullptr };
+
+        std::string m_carPath;
+        int m_hardcoreLevel{ 0 };
+    };
+} // namespace iracing
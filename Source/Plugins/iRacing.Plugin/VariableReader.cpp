@@ -0,0 +1,175 @@
+//
+// SliProSuperPro
+// A Shift Light Indicator controller
+// Copyright 2025 Fixfactory
+//
+// This file is part of SliProSuperPro.
+//
+// SliProSuperPro is free software: you can redistribute it and/or modify it under
+// the terms of the GNU General Public License as published by the Free
+// Software Foundation, either version 3 of the License, or any later version.
+//
+// SliProSuperPro is distributed in the hope that it will be useful, but WITHOUT
+// ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+// FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+// more details.
+//
+// You should have received a copy of the GNU General Public License along
+// with SliProSuperPro. If not, see <http://www.gnu.org/licenses/>.
+//
+
+#include <atomic>
+#include <cstring>
+
+#include "VariableReader.h"
+#include "Log.h"
+
+#include "irsdk/irsdk_defines.h"
+
+namespace iracing
+{
+    // The sim writes the tick count of a buffer after the buffer itself. It must be loaded from memory every time.
+    int loadTickCount(const irsdk_header *header, int buffer)
+    {
+        int tickCount = *static_cast<const volatile int *>(&header->varBuf[buffer].tickCount);
+        std::atomic_thread_fence(std::memory_order_acquire);
+        return tickCount;
+    }
+
+    VariableReader::VariableReader(std::initializer_list<const char *> names)
+    {
+        for (const char *name : names)
+        {
+            m_names.push_back(name);
+        }
+        m_variables.resize(m_names.size());
+    }
+
+    VariableReader::~VariableReader()
+    {
+    }
+
+    bool VariableReader::read(const char *sharedMem)
+    {
+        const irsdk_header *header = reinterpret_cast<const irsdk_header *>(sharedMem);
+        if (header == nullptr || !(header->status & irsdk_stConnected))
+        {
+            reset();
+            return false;
+        }
+
+        if (!m_isResolved || header->numVars != m_numVars || header->varHeaderOffset != m_varHeaderOffset ||
+            header->bufLen != m_bufLen)
+        {
+            resolve(sharedMem);
+        }
+
+        int latest = 0;
+        for (int i = 1; i < header->numBuf && i < IRSDK_MAX_BUFS; i++)
+        {
+            if (header->varBuf[latest].tickCount < header->varBuf[i].tickCount)
+            {
+                latest = i;
+            }
+        }
+
+        int tickCount = loadTickCount(header, latest);
+        if (tickCount == m_lastTickCount)
+        {
+            return false;
+        }
+
+        if (tickCount < m_lastTickCount && m_lastTickCount != INT_MAX)
+        {
+            // The sim restarted its tick count without us seeing it disconnect. The variables may have moved.
+            resolve(sharedMem);
+        }
+
+        // Try twice to read the variables before the sim rewrites the buffer.
+        for (int attempt = 0; attempt < 2; attempt++)
+        {
+            const char *line = sharedMem + header->varBuf[latest].bufOffset;
+            for (Variable &variable : m_variables)
+            {
+                const char *data = line + variable.offset;
+                switch (variable.type)
+                {
+                case irsdk_char:
+                case irsdk_bool:
+                    variable.intValue = *data;
+                    variable.floatValue = (float)variable.intValue;
+                    break;
+                case irsdk_int:
+                case irsdk_bitField:
+                    memcpy(&variable.intValue, data, sizeof(int));
+                    variable.floatValue = (float)variable.intValue;
+                    break;
+                case irsdk_float:
+                    memcpy(&variable.floatValue, data, sizeof(float));
+                    variable.intValue = (int)variable.floatValue;
+                    break;
+                case irsdk_double:
+                    double value;
+                    memcpy(&value, data, sizeof(double));
+                    variable.floatValue = (float)value;
+                    variable.intValue = (int)value;
+                    break;
+                }
+            }
+
+            int tickCountAfter = loadTickCount(header, latest);
+            if (tickCountAfter == tickCount)
+            {
+                m_lastTickCount = tickCount;
+                return true;
+            }
+            tickCount = tickCountAfter;
+        }
+
+        return false;
+    }
+
+    void VariableReader::reset()
+    {
+        m_isResolved = false;
+        m_lastTickCount = INT_MAX;
+    }
+
+    void VariableReader::resolve(const char *sharedMem)
+    {
+        const irsdk_header *header = reinterpret_cast<const irsdk_header *>(sharedMem);
+        const irsdk_varHeader *varHeaders =
+            reinterpret_cast<const irsdk_varHeader *>(sharedMem + header->varHeaderOffset);
+
+        size_t foundCount = 0;
+        for (size_t i = 0; i < m_variables.size(); i++)
+        {
+            // Variables that weren't found are never read and keep their zero values.
+            Variable &variable = m_variables[i];
+            variable = Variable{};
+
+            for (int index = 0; index < header->numVars; index++)
+            {
+                const irsdk_varHeader &varHeader = varHeaders[index];
+                if (strncmp(m_names[i].c_str(), varHeader.name, IRSDK_MAX_STRING) == 0 && varHeader.type >= 0 &&
+                    varHeader.type < irsdk_ETCount && varHeader.offset >= 0 &&
+                    varHeader.offset + irsdk_VarTypeBytes[varHeader.type] <= header->bufLen)
+                {
+                    variable.offset = varHeader.offset;
+                    variable.type = varHeader.type;
+                    foundCount++;
+                    break;
+                }
+            }
+        }
+
+        m_numVars = header->numVars;
+        m_varHeaderOffset = header->varHeaderOffset;
+        m_bufLen = header->bufLen;
+        m_lastTickCount = INT_MAX;
+        m_isResolved = true;
+        m_resolveCount++;
+
+        LOG_INFO("Found %zu of %zu telemetry variables", foundCount, m_variables.size());
+    }
+} // namespace iracing
@@ -0,0 +1,94 @@
+//
+// SliProSuperPro
+// A Shift Light Indicator controller
+// Copyright 2025 Fixfactory
+//
+// This file is part of SliProSuperPro.
+//
+// SliProSuperPro is free software: you can redistribute it and/or modify it under
+// the terms of the GNU General Public License as published by the Free
+// Software Foundation, either version 3 of the License, or any later version.
+//
+// SliProSuperPro is distributed in the hope that it will be useful, but WITHOUT
+// ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+// FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+// more details.
+//
+// You should have received a copy of the GNU General Public License along
+// with SliProSuperPro. If not, see <http://www.gnu.org/licenses/>.
+//
+
+#pragma once
+
+#include <climits>
+#include <initializer_list>
+#include <string>
+#include <vector>
+
+namespace iracing
+{
+    // Reads a fixed set of telemetry variables straight from iRacing's shared memory.
+    // The offset and type of every variable are resolved once per connection, so reading a frame does not look up
+    // names. Only the requested variables are copied out of the newest buffer, not the whole line. A copy is only
+    // kept if the buffer's tick count is unchanged after it was read.
+    class VariableReader
+    {
+    public:
+        // The variables are identified by their position in names.
+        VariableReader(std::initializer_list<const char *> names);
+        ~VariableReader();
+
+        // Reads the variables from the newest buffer of the shared memory that starts with an irsdk_header.
+        // Returns false if there is no new tick, or if the buffer was rewritten during both read attempts.
+        bool read(const char *sharedMem);
+        void reset();
+
+        // Incremented every time the offset table is rebuilt, which happens when iRacing (re)connects.
+        int getResolveCount() const
+        {
+            return m_resolveCount;
+        }
+
+        bool isValid(int variable) const
+        {
+            return m_variables[variable].offset >= 0;
+        }
+
+        bool getBool(int variable) const
+        {
+            return m_variables[variable].intValue != 0;
+        }
+
+        int getInt(int variable) const
+        {
+            return m_variables[variable].intValue;
+        }
+
+        float getFloat(int variable) const
+        {
+            return m_variables[variable].floatValue;
+        }
+
+    private:
+        // Values are converted when they are read, so the getters don't depend on the variable's type.
+        struct Variable
+        {
+            int offset{ -1 };
+            int type{ -1 };
+            int intValue{ 0 };
+            float floatValue{ 0.f };
+        };
+
+        std::vector<std::string> m_names;
+        std::vector<Variable> m_variables;
+
+        bool m_isResolved{ false };
+        int m_resolveCount{ 0 };
+        int m_numVars{ 0 };
+        int m_varHeaderOffset{ 0 };
+        int m_bufLen{ 0 };
+        int m_lastTickCount{ INT_MAX };
+
+        void resolve(const char *sharedMem);
+    };
+} // namespace iracing
@@ -0,0 +1,50 @@
+//
+// SliProSuperPro
+// A Shift Light Indicator controller
+// Copyright 2025 Fixfactory
+//
+// This file is part of SliProSuperPro.
+//
+// SliProSuperPro is free software: you can redistribute it and/or modify it under
+// the terms of the GNU General Public License as published by the Free
+// Software Foundation, either version 3 of the License, or any later version.
+//
+// SliProSuperPro is distributed in the hope that it will be useful, but WITHOUT
+// ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+// FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+// more details.
+//
+// You should have received a copy of the GNU General Public License along
+// with SliProSuperPro. If not, see <http://www.gnu.org/licenses/>.
+//
+
+#include "BackgroundTask.h"
+
+BackgroundTask::~BackgroundTask()
+{
+    wait();
+}
+
+void BackgroundTask::start(std::function<void()> function)
+{
+    wait();
+
+    m_isDone = false;
+    m_thread = std::thread([this, function = std::move(function)]() {
+        function();
+        m_isDone = true;
+    });
+}
+
+void BackgroundTask::wait()
+{
+    if (m_thread.joinable())
+    {
+        m_thread.join();
+    }
+}
+
+bool BackgroundTask::isDone() const
+{
+    return m_isDone;
+}
@@ -0,0 +1,50 @@
+//
+// SliProSuperPro
+// A Shift Light Indicator controller
+// Copyright 2025 Fixfactory
+//
+// This file is part of SliProSuperPro.
+//
+// SliProSuperPro is free software: you can redistribute it and/or modify it under
+// the terms of the GNU General Public License as published by the Free
+// Software Foundation, either version 3 of the License, or any later version.
+//
+// SliProSuperPro is distributed in the hope that it will be useful, but WITHOUT
+// ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+// FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+// more details.
+//
+// You should have received a copy of the GNU General Public License along
+// with SliProSuperPro. If not, see <http://www.gnu.org/licenses/>.
+//
+
+#pragma once
+
+#include <atomic>
+#include <functional>
+#include <thread>
+
+// Runs a function on a thread of its own, for loading that would otherwise hold up the frame it is started from.
+// The owner polls isDone() from its update and only then touches what the function wrote.
+class BackgroundTask
+{
+public:
+    BackgroundTask() = default;
+
+    // Waits for the function to return.
+    ~BackgroundTask();
+
+    BackgroundTask(const BackgroundTask &) = delete;
+    BackgroundTask &operator=(const BackgroundTask &) = delete;
+
+    // Waits for the previous function first.
+    void start(std::function<void()> function);
+    void wait();
+
+    // True once the function returned, and when none was started.
+    bool isDone() const;
+
+private:
+    std::thread m_thread;
+    std::atomic<bool> m_isDone{ true };
+};
@@ -0,0 +1,99 @@
+//
+// SliProSuperPro
+// A Shift Light Indicator controller
+// Copyright 2025 Fixfactory
+//
+// This file is part of SliProSuperPro.
+//
+// SliProSuperPro is free software: you can redistribute it and/or modify it under
+// the terms of the GNU General Public License as published by the Free
+// Software Foundation, either version 3 of the License, or any later version.
+//
+// SliProSuperPro is distributed in the hope that it will be useful, but WITHOUT
+// ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+// FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+// more details.
+//
+// You should have received a copy of the GNU General Public License along
+// with SliProSuperPro. If not, see <http://www.gnu.org/licenses/>.
+//
+
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+
+#include "BinaryFile.h"
+#include "Log.h"
+
+namespace binaryFile
+{
+    // Reads back differently on a machine with the other byte order.
+    static const uint32_t kByteOrder = 0x01020304;
+
+    uint64_t hash(const void *data, size_t size, uint64_t seed)
+    {
+        uint64_t hash = seed;
+        const unsigned char *bytes = static_cast<const unsigned char *>(data);
+        for (size_t i = 0; i < size; i++)
+        {
+            hash = (hash ^ bytes[i]) * 1099511628211ull;
+        }
+        return hash;
+    }
+
+    BinaryFileHeader makeHeader(const char (&magic)[4], uint32_t version, size_t recordSize, uint32_t recordVersion)
+    {
+        BinaryFileHeader header{};
+        memcpy(header.magic, magic, sizeof(header.magic));
+        header.byteOrder = kByteOrder;
+        header.version = version;
+        header.recordSize = (uint32_t)recordSize;
+        header.recordVersion = recordVersion;
+        return header;
+    }
+
+    bool checkHeader(const std::string &filePath, const char *data, size_t size, const BinaryFileHeader &expected,
+                     size_t headerSize)
+    {
+        BinaryFileHeader header{};
+        if (size < headerSize)
+        {
+            LOG_WARN("Ignoring %s, it is too small", filePath.c_str());
+            return false;
+        }
+
+        memcpy(&header, data, sizeof(header));
+        if (memcmp(header.magic, expected.magic, sizeof(header.magic)) != 0 || header.byteOrder != expected.byteOrder ||
+            header.version != expected.version || header.recordSize != expected.recordSize ||
+            header.recordVersion != expected.recordVersion ||
+            size - headerSize < (uint64_t)header.recordCount * header.recordSize)
+        {
+            LOG_WARN("Ignoring %s, it has an unsupported format", filePath.c_str());
+            return false;
+        }
+        return true;
+    }
+
+    bool write(const std::string &filePath, const std::vector<char> &data)
+    {
+        std::string tempPath = filePath + ".tmp";
+        bool isWritten = false;
+        {
+            std::ofstream stream(tempPath, std::ios::binary | std::ios::trunc);
+            stream.write(data.data(), data.size());
+            isWritten = stream.good();
+        }
+
+        std::error_code error;
+        if (isWritten)
+        {
+            std::filesystem::rename(tempPath, filePath, error);
+        }
+        if (!isWritten || error)
+        {
+            LOG_ERROR("Could not write %s", filePath.c_str());
+            return false;
+        }
+        return true;
+    }
+} // namespace binaryFile
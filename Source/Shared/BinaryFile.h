@@ -0,0 +1,66 @@
+//
+// SliProSuperPro
+// A Shift Light Indicator controller
+// Copyright 2025 Fixfactory
+//
+// This file is part of SliProSuperPro.
+//
+// SliProSuperPro is free software: you can redistribute it and/or modify it under
+// the terms of the GNU General Public License as published by the Free
+// Software Foundation, either version 3 of the License, or any later version.
+//
+// SliProSuperPro is distributed in the hope that it will be useful, but WITHOUT
+// ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+// FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+// more details.
+//
+// You should have received a copy of the GNU General Public License along
+// with SliProSuperPro. If not, see <http://www.gnu.org/licenses/>.
+//
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// The binary files SliProSuperPro and its plugins keep to skip work the next time they start, like caches and compiled
+// overrides files. Each starts with a BinaryFileHeader, followed by recordCount records stored as they are in memory,
+// so a file is only read back by a build with the same magic, version, byte order, record size and record version. Any
+// other file is ignored, and written again.
+struct BinaryFileHeader
+{
+    char magic[4];
+    uint32_t byteOrder;
+    uint32_t version;
+    uint32_t recordCount;
+
+    // The part of each record that has the same size in every record, so a file holds at least recordCount times as
+    // many bytes after its header.
+    uint32_t recordSize;
+
+    // The version of the structs stored in the records, for formats that store structs they don't own, so a struct
+    // whose fields changed without changing its size isn't misread.
+    uint32_t recordVersion;
+};
+
+namespace binaryFile
+{
+    // FNV-1a. Data hashed in parts has the hash of the whole when each part is hashed with the hash of the one before
+    // as its seed.
+    constexpr uint64_t kHashSeed = 14695981039346656037ull;
+    uint64_t hash(const void *data, size_t size, uint64_t seed = kHashSeed);
+
+    BinaryFileHeader makeHeader(const char (&magic)[4], uint32_t version, size_t recordSize,
+                                uint32_t recordVersion = 0);
+
+    // Checks the header at the start of a file's data against the one makeHeader() gives for its format. headerSize is
+    // larger than a BinaryFileHeader for formats that add to it. Logs why a file is ignored.
+    bool checkHeader(const std::string &filePath, const char *data, size_t size, const BinaryFileHeader &expected,
+                     size_t headerSize = sizeof(BinaryFileHeader));
+
+    // Replaces the file in one step, through a temporary file renamed over it, so it is never left half written and
+    // can't be mapped half written. Logs an error.
+    bool write(const std::string &filePath, const std::vector<char> &data);
+} // namespace binaryFile
@@ -1 +1,10 @@
-#define DLL_EXPORT __declspec(dllexport) __stdcall
\ No newline at end of file
+#pragma once
+
+// Calling convention and export decoration of the functions exported by plugin libraries.
+#ifdef _WIN32
+    #define PLUGIN_CALL __stdcall
+    #define DLL_EXPORT __declspec(dllexport) PLUGIN_CALL
+#else
+    #define PLUGIN_CALL
+    #define DLL_EXPORT __attribute__((visibility("default")))
+#endif
\ No newline at end of file
@@ -0,0 +1,111 @@
+//
+// SliProSuperPro
+// A Shift Light Indicator controller
+// Copyright 2025 Fixfactory
+//
+// This file is part of SliProSuperPro.
+//
+// SliProSuperPro is free software: you can redistribute it and/or modify it under
+// the terms of the GNU General Public License as published by the Free
+// Software Foundation, either version 3 of the License, or any later version.
+//
+// SliProSuperPro is distributed in the hope that it will be useful, but WITHOUT
+// ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+// FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+// more details.
+//
+// You should have received a copy of the GNU General Public License along
+// with SliProSuperPro. If not, see <http://www.gnu.org/licenses/>.
+//
+
+#ifdef _WIN32
+    #include <Windows.h>
+    #include <system_error>
+#else
+    #include <dlfcn.h>
+#endif
+
+#include "DynamicLibrary.h"
+
+#ifdef _WIN32
+    #include "StringHelper.h"
+#endif
+
+#ifdef _WIN32
+
+const char *const DynamicLibrary::kExtension = ".dll";
+
+bool DynamicLibrary::open(const std::string &path)
+{
+    close();
+    std::wstring widePath{ string::convertToWide(path) };
+    m_handle = LoadLibrary(widePath.c_str());
+    return m_handle != nullptr;
+}
+
+void DynamicLibrary::close()
+{
+    if (m_handle != nullptr)
+    {
+        FreeLibrary(static_cast<HMODULE>(m_handle));
+        m_handle = nullptr;
+    }
+}
+
+void *DynamicLibrary::getSymbol(const char *name) const
+{
+    if (m_handle == nullptr)
+    {
+        return nullptr;
+    }
+    return reinterpret_cast<void *>(GetProcAddress(static_cast<HMODULE>(m_handle), name));
+}
+
+std::string DynamicLibrary::getLastError()
+{
+    return std::system_category().message(GetLastError());
+}
+
+#else
+
+const char *const DynamicLibrary::kExtension = ".so";
+
+bool DynamicLibrary::open(const std::string &path)
+{
+    close();
+
+    // RTLD_LOCAL keeps each plugin's copy of the shared code, like its log, separate from the others.
+    m_handle = dlopen(path.c_str(), RTLD_NOW | RTLD_LOCAL);
+    return m_handle != nullptr;
+}
+
+void DynamicLibrary::close()
+{
+    if (m_handle != nullptr)
+    {
+        dlclose(m_handle);
+        m_handle = nullptr;
+    }
+}
+
+void *DynamicLibrary::getSymbol(const char *name) const
+{
+    if (m_handle == nullptr)
+    {
+        return nullptr;
+    }
+    return dlsym(m_handle, name);
+}
+
+std::string DynamicLibrary::getLastError()
+{
+    const char *error = dlerror();
+    return error != nullptr ? error : "";
+}
+
+#endif
+
+bool DynamicLibrary::isOpen() const
+{
+    return m_handle != nullptr;
+}
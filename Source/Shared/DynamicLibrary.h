@@ -0,0 +1,50 @@
+//
+// SliProSuperPro
+// A Shift Light Indicator controller
+// Copyright 2025 Fixfactory
+//
+// This file is part of SliProSuperPro.
+//
+// SliProSuperPro is free software: you can redistribute it and/or modify it under
+// the terms of the GNU General Public License as published by the Free
+// Software Foundation, either version 3 of the License, or any later version.
+//
+// SliProSuperPro is distributed in the hope that it will be useful, but WITHOUT
+// ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+// FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+// more details.
+//
+// You should have received a copy of the GNU General Public License along
+// with SliProSuperPro. If not, see <http://www.gnu.org/licenses/>.
+//
+
+#pragma once
+
+#include <string>
+
+// Loads a dynamic library with LoadLibrary() on Windows or dlopen() elsewhere.
+// The handle isn't owned: copies refer to the same library and close() must be called once.
+class DynamicLibrary
+{
+public:
+    // Extension of dynamic libraries on this platform, including the dot.
+    static const char *const kExtension;
+
+    bool open(const std::string &path);
+    void close();
+    bool isOpen() const;
+
+    // Returns nullptr if the library doesn't export the symbol.
+    void *getSymbol(const char *name) const;
+
+    template <typename Function> Function getFunction(const char *name) const
+    {
+        return reinterpret_cast<Function>(getSymbol(name));
+    }
+
+    // Describes why the last call to open() failed.
+    static std::string getLastError();
+
+private:
+    void *m_handle{ nullptr };
+};
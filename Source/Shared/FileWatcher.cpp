@@ -0,0 +1,156 @@
+//
+// SliProSuperPro
+// A Shift Light Indicator controller
+// Copyright 2025 Fixfactory
+//
+// This file is part of SliProSuperPro.
+//
+// SliProSuperPro is free software: you can redistribute it and/or modify it under
+// the terms of the GNU General Public License as published by the Free
+// Software Foundation, either version 3 of the License, or any later version.
+//
+// SliProSuperPro is distributed in the hope that it will be useful, but WITHOUT
+// ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+// FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+// more details.
+//
+// You should have received a copy of the GNU General Public License along
+// with SliProSuperPro. If not, see <http://www.gnu.org/licenses/>.
+//
+
+#ifdef _WIN32
+    #include <Windows.h>
+#else
+    #include <sys/inotify.h>
+    #include <unistd.h>
+#endif
+
+#include "FileWatcher.h"
+
+#ifdef _WIN32
+    #include "StringHelper.h"
+#endif
+
+FileWatcher::~FileWatcher()
+{
+    close();
+}
+
+static std::filesystem::path getFolder(const std::string &filePath)
+{
+    std::filesystem::path folder = std::filesystem::path(filePath).parent_path();
+    return folder.empty() ? std::filesystem::path(".") : folder;
+}
+
+#ifdef _WIN32
+
+bool FileWatcher::open(const std::string &filePath)
+{
+    close();
+    m_filePath = filePath;
+    readStatus();
+
+    std::wstring folder{ string::convertToWide(getFolder(filePath).string()) };
+    HANDLE notification = FindFirstChangeNotificationW(
+        folder.c_str(), FALSE, FILE_NOTIFY_CHANGE_FILE_NAME | FILE_NOTIFY_CHANGE_SIZE | FILE_NOTIFY_CHANGE_LAST_WRITE);
+    if (notification == INVALID_HANDLE_VALUE)
+    {
+        return false;
+    }
+
+    m_notification = notification;
+    return true;
+}
+
+void FileWatcher::close()
+{
+    if (m_notification != nullptr)
+    {
+        FindCloseChangeNotification(m_notification);
+        m_notification = nullptr;
+    }
+}
+
+bool FileWatcher::hasChanged()
+{
+    if (m_notification == nullptr || WaitForSingleObject(m_notification, 0) != WAIT_OBJECT_0)
+    {
+        return false;
+    }
+
+    FindNextChangeNotification(m_notification);
+    return readStatus();
+}
+
+bool FileWatcher::readStatus()
+{
+    std::error_code error;
+    bool exists = std::filesystem::exists(m_filePath, error);
+    std::filesystem::file_time_type writeTime = exists ? std::filesystem::last_write_time(m_filePath, error)
+                                                       : std::filesystem::file_time_type{};
+    uintmax_t size = exists ? std::filesystem::file_size(m_filePath, error) : 0;
+
+    bool hasChanged = exists != m_exists || writeTime != m_writeTime || size != m_size;
+    m_exists = exists;
+    m_writeTime = writeTime;
+    m_size = size;
+    return hasChanged;
+}
+
+#else
+
+bool FileWatcher::open(const std::string &filePath)
+{
+    close();
+    m_filePath = filePath;
+    m_fileName = std::filesystem::path(filePath).filename().string();
+
+    m_inotify = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+    if (m_inotify < 0)
+    {
+        return false;
+    }
+
+    // Only once the file is closed, so it isn't read half written.
+    if (inotify_add_watch(m_inotify, getFolder(filePath).c_str(),
+                          IN_CLOSE_WRITE | IN_MOVED_TO | IN_MOVED_FROM | IN_DELETE) < 0)
+    {
+        close();
+        return false;
+    }
+    return true;
+}
+
+void FileWatcher::close()
+{
+    if (m_inotify >= 0)
+    {
+        ::close(m_inotify);
+        m_inotify = -1;
+    }
+}
+
+bool FileWatcher::hasChanged()
+{
+    if (m_inotify < 0)
+    {
+        return false;
+    }
+
+    // Every event is read, and only those about the file count.
+    alignas(inotify_event) char events[4096];
+    bool hasChanged = false;
+    ssize_t size;
+    while ((size = read(m_inotify, events, sizeof(events))) > 0)
+    {
+        for (ssize_t i = 0; i < size;)
+        {
+            const inotify_event *event = reinterpret_cast<const inotify_event *>(events + i);
+            hasChanged |= event->len > 0 && m_fileName == event->name;
+            i += sizeof(inotify_event) + event->len;
+        }
+    }
+    return hasChanged;
+}
+
+#endif
@@ -0,0 +1,61 @@
+//
+// SliProSuperPro
+// A Shift Light Indicator controller
+// Copyright 2025 Fixfactory
+//
+// This file is part of SliProSuperPro.
+//
+// SliProSuperPro is free software: you can redistribute it and/or modify it under
+// the terms of the GNU General Public License as published by the Free
+// Software Foundation, either version 3 of the License, or any later version.
+//
+// SliProSuperPro is distributed in the hope that it will be useful, but WITHOUT
+// ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+// FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+// more details.
+//
+// You should have received a copy of the GNU General Public License along
+// with SliProSuperPro. If not, see <http://www.gnu.org/licenses/>.
+//
+
+#pragma once
+
+#include <cstdint>
+#include <filesystem>
+#include <string>
+
+// Tells when a file changes, without blocking, so it can be polled every frame. The file's folder is watched, so a file
+// that an editor saves by replacing it is seen too: with inotify, whose events name the file, or with a change
+// notification on Windows, after which the file's size and write time are compared with the ones read before.
+class FileWatcher
+{
+public:
+    FileWatcher() = default;
+    ~FileWatcher();
+
+    FileWatcher(const FileWatcher &) = delete;
+    FileWatcher &operator=(const FileWatcher &) = delete;
+
+    // The file doesn't have to exist yet.
+    bool open(const std::string &filePath);
+    void close();
+
+    // True once after each change of the file, including it being created or deleted.
+    bool hasChanged();
+
+private:
+    std::string m_filePath;
+
+#ifdef _WIN32
+    void *m_notification{ nullptr };
+    std::filesystem::file_time_type m_writeTime{};
+    uintmax_t m_size{ 0 };
+    bool m_exists{ false };
+
+    // True if the file's status differs from the one read before.
+    bool readStatus();
+#else
+    int m_inotify{ -1 };
+    std::string m_fileName;
+#endif
+};
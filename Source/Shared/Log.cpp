@@ -18,7 +18,11 @@
 // with SliProSuperPro. If not, see <http://www.gnu.org/licenses/>.
 //
 
-#include <Windows.h>
+#ifdef _WIN32
+    #include <Windows.h>
+#else
+    #include <dlfcn.h>
+#endif
 #include <string>
 #include <vector>
 #include <chrono>
@@ -27,11 +31,16 @@
 #include <assert.h>
 #include <time.h>
 #include <sstream>
+#include <iomanip>
 
 #include "Log.h"
-#include "StringHelper.h"
+#include "PluginInterface.h"
+
+#ifdef _WIN32
+    #include "StringHelper.h"
 
 EXTERN_C IMAGE_DOS_HEADER __ImageBase;
+#endif
 
 LogManager::LogManager()
 {
@@ -48,12 +57,13 @@ void LogManager::init()
     m_file.open(fileName, std::ios::out | std::ios::trunc);
     if (!m_file.is_open())
     {
-        LOG_ERROR("Failed to open log file %s", fileName);
+        LOG_ERROR("Failed to open log file %s", fileName.c_str());
     }
 }
 
 void LogManager::deinit()
 {
+    std::lock_guard<std::mutex> lock(m_mutex);
     if (m_file.is_open())
     {
         m_file.flush();
@@ -73,12 +83,13 @@ void LogManager::info(const char *format, ...)
     va_start(args1, format);
     va_list args2;
     va_copy(args2, args1);
-    std::vector<char> text((__int64)std::vsnprintf(NULL, 0, format, args1) + 1);
+    std::vector<char> text((size_t)std::vsnprintf(NULL, 0, format, args1) + 1);
     va_end(args1);
     std::vsnprintf(text.data(), text.size(), format, args2);
     va_end(args2);
 
     std::string timestamp = getTimestamp();
+    std::lock_guard<std::mutex> lock(m_mutex);
     std::printf("%s %s\n", timestamp.c_str(), text.data());
     if (m_file.is_open())
     {
@@ -93,12 +104,13 @@ void LogManager::warn(const char *format, ...)
     va_start(args1, format);
     va_list args2;
     va_copy(args2, args1);
-    std::vector<char> text((__int64)std::vsnprintf(NULL, 0, format, args1) + 1);
+    std::vector<char> text((size_t)std::vsnprintf(NULL, 0, format, args1) + 1);
     va_end(args1);
     std::vsnprintf(text.data(), text.size(), format, args2);
     va_end(args2);
 
     std::string timestamp = getTimestamp();
+    std::lock_guard<std::mutex> lock(m_mutex);
     std::printf("%s Warning: %s\n", timestamp.c_str(), text.data());
     if (m_file.is_open())
     {
@@ -113,12 +125,13 @@ void LogManager::error(const char *format, ...)
     va_start(args1, format);
     va_list args2;
     va_copy(args2, args1);
-    std::vector<char> text((__int64)std::vsnprintf(NULL, 0, format, args1) + 1);
+    std::vector<char> text((size_t)std::vsnprintf(NULL, 0, format, args1) + 1);
     va_end(args1);
     std::vsnprintf(text.data(), text.size(), format, args2);
     va_end(args2);
 
     std::string timestamp = getTimestamp();
+    std::lock_guard<std::mutex> lock(m_mutex);
     std::printf("%s Error: %s\n", timestamp.c_str(), text.data());
     if (m_file.is_open())
     {
@@ -143,19 +156,41 @@ std::string LogManager::getTimestamp() const
     auto in_time_t = std::chrono::system_clock::to_time_t(now);
     std::stringstream timestamp;
     struct tm buf;
+#ifdef _WIN32
     localtime_s(&buf, &in_time_t);
+#else
+    localtime_r(&in_time_t, &buf);
+#endif
     timestamp << '[' << std::put_time(&buf, "%T") << ']';
     return timestamp.str();
 }
 
 std::string LogManager::getLogFileName() const
 {
+#ifdef _WIN32
     wchar_t buf[MAX_PATH];
     GetModuleFileName((HINSTANCE)&__ImageBase, buf, MAX_PATH);
     std::string fileName{ string::convertFromWide(buf) };
+    const char separator = '\\';
+#else
+    // The library or executable this copy of the log manager was linked into.
+    Dl_info info{};
+    dladdr(reinterpret_cast<void *>(&LogManager::getSingleton), &info);
+    std::string fileName{ info.dli_fname != nullptr ? info.dli_fname : "SliProSuperPro" };
+    const char separator = '/';
+#endif
+
+    // A plugin loaded from a shadow copy logs next to its original library.
+    std::string shadowDirectory = separator + std::string(plugin::kShadowDirectoryName) + separator;
+    size_t shadowPos = fileName.find(shadowDirectory);
+    if (shadowPos != std::string::npos)
+    {
+        fileName.erase(shadowPos, fileName.rfind(separator) - shadowPos);
+    }
 
+    size_t namePos = fileName.rfind(separator);
     size_t pos = fileName.rfind(".");
-    if (pos != std::string::npos)
+    if (pos != std::string::npos && (namePos == std::string::npos || pos > namePos))
     {
         fileName.erase(pos, fileName.length() - pos);
     }
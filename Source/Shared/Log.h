@@ -21,6 +21,7 @@
 #pragma once
 
 #include <fstream>
+#include <mutex>
 #include <system_error>
 
 #ifdef _DEBUG
@@ -56,5 +57,7 @@ private:
     std::string getTimestamp() const;
     std::string getLogFileName() const;
 
+    // Plugins also log from the threads they load files on.
+    std::mutex m_mutex;
     std::ofstream m_file;
 };
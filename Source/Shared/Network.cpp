@@ -18,16 +18,56 @@
 // with SliProSuperPro. If not, see <http://www.gnu.org/licenses/>.
 //
 
-#define _WINSOCK_DEPRECATED_NO_WARNINGS
-#include <WinSock2.h>
-#include <WS2tcpip.h>
+#ifdef _WIN32
+    #define _WINSOCK_DEPRECATED_NO_WARNINGS
+    #include <WinSock2.h>
+    #include <WS2tcpip.h>
+    #include <mstcpip.h>
+#else
+    #include <sys/socket.h>
+    #include <sys/select.h>
+    #include <arpa/inet.h>
+    #include <unistd.h>
+    #include <netdb.h>
+    #include <fcntl.h>
+    #include <cerrno>
+#endif
 #include <system_error>
 #include <string>
+#include <cstring>
 #include <iostream>
+#include <thread>
+#include <chrono>
 
 #include "Network.h"
 #include "Log.h"
 
+#include "json/json.hpp"
+using json = nlohmann::json;
+
+#ifdef _WIN32
+
+static int getLastSocketError()
+{
+    return WSAGetLastError();
+}
+
+static bool isInProgress(int error)
+{
+    return error == WSAEWOULDBLOCK;
+}
+
+static void setNonBlocking(SOCKET socket)
+{
+    u_long nonBlocking = 1;
+    if (ioctlsocket(socket, FIONBIO, &nonBlocking) != 0)
+    {
+        throw std::system_error(getLastSocketError(), std::system_category(), "ioctlsocket() failed");
+    }
+}
+
+const int kSendFlags = 0;
+
 WSASession::WSASession()
 {
     int ret = WSAStartup(MAKEWORD(2, 2), &m_data);
@@ -42,12 +82,54 @@ WSASession::~WSASession()
     WSACleanup();
 }
 
+#else
+
+constexpr SOCKET INVALID_SOCKET = -1;
+
+static int getLastSocketError()
+{
+    return errno;
+}
+
+static bool isInProgress(int error)
+{
+    return error == EINPROGRESS || error == EWOULDBLOCK || error == EAGAIN;
+}
+
+static void setNonBlocking(SOCKET socket)
+{
+    int flags = fcntl(socket, F_GETFL, 0);
+    if (flags < 0 || fcntl(socket, F_SETFL, flags | O_NONBLOCK) < 0)
+    {
+        throw std::system_error(getLastSocketError(), std::system_category(), "fcntl() failed");
+    }
+}
+
+// A closed connection is reported by send() instead of a SIGPIPE that would end the process.
+const int kSendFlags = MSG_NOSIGNAL;
+
+static int closesocket(SOCKET socket)
+{
+    return close(socket);
+}
+
+// Sockets don't need to be initialized outside of Windows.
+WSASession::WSASession()
+{
+}
+
+WSASession::~WSASession()
+{
+}
+
+#endif
+
 UDPSocket::UDPSocket()
 {
     m_socket = socket(AF_INET, SOCK_DGRAM, IPPROTO_UDP);
     if (m_socket == INVALID_SOCKET)
     {
-        throw std::system_error(WSAGetLastError(), std::system_category(), "socket() failed");
+        throw std::system_error(getLastSocketError(), std::system_category(), "socket() failed");
     }
 }
 
@@ -63,19 +145,19 @@ void UDPSocket::sendTo(const std::string &address, unsigned short port, const ch
     add.sin_addr.s_addr = inet_addr(address.c_str());
     add.sin_port = htons(port);
 
-    int ret = sendto(m_socket, buffer, len, flags, reinterpret_cast<SOCKADDR *>(&add), sizeof(add));
+    int ret = sendto(m_socket, buffer, len, flags, reinterpret_cast<sockaddr *>(&add), sizeof(add));
     if (ret < 0)
     {
-        throw std::system_error(WSAGetLastError(), std::system_category(), "sendto() failed");
+        throw std::system_error(getLastSocketError(), std::system_category(), "sendto() failed");
     }
 }
 
 void UDPSocket::sendTo(sockaddr_in &address, const char *buffer, int len, int flags)
 {
-    int ret = sendto(m_socket, buffer, len, flags, reinterpret_cast<SOCKADDR *>(&address), sizeof(address));
+    int ret = sendto(m_socket, buffer, len, flags, reinterpret_cast<sockaddr *>(&address), sizeof(address));
     if (ret < 0)
     {
-        throw std::system_error(WSAGetLastError(), std::system_category(), "sendto() failed");
+        throw std::system_error(getLastSocketError(), std::system_category(), "sendto() failed");
     }
 }
 
@@ -90,28 +172,239 @@ bool UDPSocket::hasData()
         .tv_sec = 0, .tv_usec = 0
     };
 
-    int ret = select(0, &sockets, NULL, NULL, &timeout);
+    int ret = select((int)m_socket + 1, &sockets, NULL, NULL, &timeout);
     if (ret < 0)
     {
-        throw std::system_error(WSAGetLastError(), std::system_category(), "select() failed");
+        throw std::system_error(getLastSocketError(), std::system_category(), "select() failed");
     }
     return ret > 0;
 }
 
 void UDPSocket::recvData(std::vector<char> &outData, sockaddr_in &outFromAddr)
 {
-    int fromLen = sizeof(outFromAddr);
+    socklen_t fromLen = sizeof(outFromAddr);
     int flags = 0;
 
-    int ret = recvfrom(m_socket, outData.data(), (int)outData.size(), flags, reinterpret_cast<SOCKADDR *>(&outFromAddr),
+    int ret = recvfrom(m_socket, outData.data(), (int)outData.size(), flags, reinterpret_cast<sockaddr *>(&outFromAddr),
                        &fromLen);
     if (ret < 0)
     {
-        throw std::system_error(WSAGetLastError(), std::system_category(), "recvfrom() failed");
+        throw std::system_error(getLastSocketError(), std::system_category(), "recvfrom() failed");
     }
     outData.resize(ret);
 }
 
+#ifdef __linux__
+// Sends every datagram to every destination, with as few sendmmsg() calls as possible. Relaying is best effort, as
+// a destination that can't be reached must not stop the telemetry.
+static void relayDatagrams(SOCKET socket, std::vector<sockaddr_in> &destinations, iovec *datagrams, int count)
+{
+    const int kBatchSize = 64;
+    mmsghdr messages[kBatchSize]{};
+    int messageCount = 0;
+
+    auto sendMessages = [&]() {
+        for (int sent = 0; sent < messageCount;)
+        {
+            int ret = sendmmsg(socket, messages + sent, messageCount - sent, MSG_DONTWAIT);
+            if (ret <= 0)
+            {
+                break;
+            }
+            sent += ret;
+        }
+        messageCount = 0;
+    };
+
+    for (int i = 0; i < count; i++)
+    {
+        for (auto &destination : destinations)
+        {
+            msghdr &header = messages[messageCount++].msg_hdr;
+            header.msg_name = &destination;
+            header.msg_namelen = sizeof(destination);
+            header.msg_iov = &datagrams[i];
+            header.msg_iovlen = 1;
+            if (messageCount == kBatchSize)
+            {
+                sendMessages();
+            }
+        }
+    }
+    sendMessages();
+}
+#endif
+
+bool UDPSocket::recvLatest(char *buffer, int len, int &outCount, int &outMalformedCount)
+{
+    outCount = 0;
+    outMalformedCount = 0;
+    bool hasData = false;
+    const int slotLen = len + 1;
+
+#ifdef __linux__
+    // One recvmmsg() call receives a whole batch, where select() and recvfrom() took two calls per datagram.
+    const int kBatchSize = 32;
+    m_batchBuffer.resize(kBatchSize * slotLen);
+
+    mmsghdr messages[kBatchSize]{};
+    iovec vectors[kBatchSize];
+    for (int i = 0; i < kBatchSize; i++)
+    {
+        vectors[i].iov_base = &m_batchBuffer[i * slotLen];
+        vectors[i].iov_len = slotLen;
+        messages[i].msg_hdr.msg_iov = &vectors[i];
+        messages[i].msg_hdr.msg_iovlen = 1;
+    }
+
+    int ret;
+    do
+    {
+        ret = recvmmsg(m_socket, messages, kBatchSize, MSG_DONTWAIT, nullptr);
+        if (ret < 0)
+        {
+            if (isInProgress(getLastSocketError()))
+            {
+                break;
+            }
+            throw std::system_error(getLastSocketError(), std::system_category(), "recvmmsg() failed");
+        }
+
+        if (!m_relayDestinations.empty())
+        {
+            // Datagrams longer than the slots were truncated, so can't be relayed unchanged.
+            iovec datagrams[kBatchSize];
+            int datagramCount = 0;
+            for (int i = 0; i < ret; i++)
+            {
+                if ((int)messages[i].msg_len <= len)
+                {
+                    datagrams[datagramCount].iov_base = vectors[i].iov_base;
+                    datagrams[datagramCount].iov_len = messages[i].msg_len;
+                    datagramCount++;
+                }
+            }
+            relayDatagrams(m_socket, m_relayDestinations, datagrams, datagramCount);
+        }
+
+        // Only the newest valid datagram of the batch is copied.
+        outCount += ret;
+        bool isNewestFound = false;
+        for (int i = ret - 1; i >= 0; i--)
+        {
+            if ((int)messages[i].msg_len != len)
+            {
+                outMalformedCount++;
+            }
+            else if (!isNewestFound)
+            {
+                memcpy(buffer, vectors[i].iov_base, len);
+                isNewestFound = true;
+                hasData = true;
+            }
+        }
+    } while (ret == kBatchSize);
+#else
+    #ifdef _WIN32
+    // Windows has no flag to make a single recv() non-blocking.
+    if (!m_isNonBlocking)
+    {
+        setNonBlocking(m_socket);
+        m_isNonBlocking = true;
+    }
+    const int kRecvFlags = 0;
+    #else
+    const int kRecvFlags = MSG_DONTWAIT;
+    #endif
+
+    m_batchBuffer.resize(slotLen);
+    for (;;)
+    {
+        int ret = recv(m_socket, m_batchBuffer.data(), slotLen, kRecvFlags);
+        if (ret < 0)
+        {
+            int error = getLastSocketError();
+            if (isInProgress(error))
+            {
+                break;
+            }
+    #ifdef _WIN32
+            if (error == WSAEMSGSIZE)
+            {
+                outCount++;
+                outMalformedCount++;
+                continue;
+            }
+    #endif
+            throw std::system_error(error, std::system_category(), "recv() failed");
+        }
+
+        outCount++;
+        if (ret <= len)
+        {
+            for (const auto &destination : m_relayDestinations)
+            {
+                sendto(m_socket, m_batchBuffer.data(), ret, 0, reinterpret_cast<const sockaddr *>(&destination),
+                       sizeof(destination));
+            }
+        }
+
+        if (ret != len)
+        {
+            outMalformedCount++;
+            continue;
+        }
+
+        memcpy(buffer, m_batchBuffer.data(), len);
+        hasData = true;
+    }
+#endif
+
+    return hasData;
+}
+
+std::vector<RelayDestination> readRelayDestinations(const json &config)
+{
+    std::vector<RelayDestination> destinations;
+    auto relay = config.find("relay");
+    if (relay == config.end())
+    {
+        return destinations;
+    }
+
+    for (const auto &destination : *relay)
+    {
+        if (!destination.contains("hostname") || !destination.contains("port"))
+        {
+            LOG_ERROR("Missing hostname or port of relay destination in config file");
+            continue;
+        }
+
+        destinations.emplace_back(destination["hostname"].get<std::string>(), destination["port"].get<int>());
+    }
+    return destinations;
+}
+
+void UDPSocket::addRelayDestination(const std::string &address, unsigned short port)
+{
+    sockaddr_in add{};
+    add.sin_family = AF_INET;
+    add.sin_port = htons(port);
+    if (inet_pton(AF_INET, address.c_str(), &add.sin_addr) != 1)
+    {
+        throw std::system_error(std::make_error_code(std::errc::invalid_argument), "Invalid relay address " + address);
+    }
+
+#ifdef _WIN32
+    // Otherwise, when nothing listens at a destination, the next receive fails with WSAECONNRESET.
+    BOOL reportReset = FALSE;
+    DWORD bytesReturned = 0;
+    WSAIoctl(m_socket, SIO_UDP_CONNRESET, &reportReset, sizeof(reportReset), NULL, 0, &bytesReturned, NULL, NULL);
+#endif
+
+    m_relayDestinations.push_back(add);
+}
+
 void UDPSocket::bindTo(unsigned short port)
 {
     sockaddr_in add;
@@ -119,10 +412,10 @@ void UDPSocket::bindTo(unsigned short port)
     add.sin_addr.s_addr = htonl(INADDR_ANY);
     add.sin_port = htons(port);
 
-    int ret = bind(m_socket, reinterpret_cast<SOCKADDR *>(&add), sizeof(add));
+    int ret = bind(m_socket, reinterpret_cast<sockaddr *>(&add), sizeof(add));
     if (ret < 0)
     {
-        throw std::system_error(WSAGetLastError(), std::system_category(), "bind() failed");
+        throw std::system_error(getLastSocketError(), std::system_category(), "bind() failed");
     }
     m_port = port;
 }
@@ -136,9 +429,7 @@ void UDPSocket::sleep(float sleepTime)
 
     if (m_socket == INVALID_SOCKET)
     {
-        // std::this_thread::sleep_for(fsec{ seconds });
-        DWORD msec = (DWORD)(sleepTime * 1000);
-        SleepEx(msec, 0);
+        std::this_thread::sleep_for(std::chrono::duration<float>(sleepTime));
         return;
     }
 
@@ -151,9 +442,137 @@ void UDPSocket::sleep(float sleepTime)
         .tv_sec = (long)sleepTime, .tv_usec = ((long)(sleepTime * 1000) % 1000) * 1000
     };
 
-    int ret = select(0, &sockets, NULL, NULL, &timeout);
+    int ret = select((int)m_socket + 1, &sockets, NULL, NULL, &timeout);
+    if (ret < 0)
+    {
+        throw std::system_error(getLastSocketError(), std::system_category(), "select() failed");
+    }
+}
+
+TCPSocket::TCPSocket()
+{
+    m_socket = socket(AF_INET, SOCK_STREAM, IPPROTO_TCP);
+    if (m_socket == INVALID_SOCKET)
+    {
+        throw std::system_error(getLastSocketError(), std::system_category(), "socket() failed");
+    }
+
+    try
+    {
+        setNonBlocking(m_socket);
+    }
+    catch (...)
+    {
+        closesocket(m_socket);
+        throw;
+    }
+}
+
+TCPSocket::~TCPSocket()
+{
+    closesocket(m_socket);
+}
+
+void TCPSocket::connectTo(const std::string &hostname, unsigned short port)
+{
+    sockaddr_in add{};
+    add.sin_family = AF_INET;
+    add.sin_port = htons(port);
+    if (inet_pton(AF_INET, hostname.c_str(), &add.sin_addr) != 1)
+    {
+        addrinfo hints{};
+        hints.ai_family = AF_INET;
+        hints.ai_socktype = SOCK_STREAM;
+        addrinfo *result = nullptr;
+        int ret = getaddrinfo(hostname.c_str(), nullptr, &hints, &result);
+        if (ret != 0 || result == nullptr)
+        {
+            throw std::system_error(std::make_error_code(std::errc::host_unreachable), "getaddrinfo() failed");
+        }
+        add.sin_addr = reinterpret_cast<sockaddr_in *>(result->ai_addr)->sin_addr;
+        freeaddrinfo(result);
+    }
+
+    int ret = connect(m_socket, reinterpret_cast<sockaddr *>(&add), sizeof(add));
+    if (ret < 0 && !isInProgress(getLastSocketError()))
+    {
+        throw std::system_error(getLastSocketError(), std::system_category(), "connect() failed");
+    }
+    m_isConnected = ret == 0;
+}
+
+bool TCPSocket::isConnected()
+{
+    if (m_isConnected)
+    {
+        return true;
+    }
+
+    // The socket becomes writable when connect() succeeds. Windows reports a failure as an exception instead.
+    fd_set writeSockets;
+    fd_set exceptSockets;
+    FD_ZERO(&writeSockets);
+    FD_ZERO(&exceptSockets);
+    FD_SET(m_socket, &writeSockets);
+    FD_SET(m_socket, &exceptSockets);
+
+    struct timeval timeout
+    {
+        .tv_sec = 0, .tv_usec = 0
+    };
+
+    int ret = select((int)m_socket + 1, NULL, &writeSockets, &exceptSockets, &timeout);
+    if (ret < 0)
+    {
+        throw std::system_error(getLastSocketError(), std::system_category(), "select() failed");
+    }
+    if (ret == 0)
+    {
+        return false;
+    }
+
+    int error = 0;
+    socklen_t errorLen = sizeof(error);
+    if (getsockopt(m_socket, SOL_SOCKET, SO_ERROR, reinterpret_cast<char *>(&error), &errorLen) < 0)
+    {
+        throw std::system_error(getLastSocketError(), std::system_category(), "getsockopt() failed");
+    }
+    if (error != 0)
+    {
+        throw std::system_error(error, std::system_category(), "connect() failed");
+    }
+
+    m_isConnected = true;
+    return true;
+}
+
+void TCPSocket::sendData(const char *buffer, int len)
+{
+    int ret = send(m_socket, buffer, len, kSendFlags);
+    if (ret < 0)
+    {
+        throw std::system_error(getLastSocketError(), std::system_category(), "send() failed");
+    }
+    if (ret < len)
+    {
+        throw std::system_error(std::make_error_code(std::errc::no_buffer_space), "send() was partial");
+    }
+}
+
+int TCPSocket::recvData(char *buffer, int len)
+{
+    int ret = recv(m_socket, buffer, len, 0);
+    if (ret == 0)
+    {
+        throw std::system_error(std::make_error_code(std::errc::connection_reset), "Connection closed");
+    }
     if (ret < 0)
     {
-        throw std::system_error(WSAGetLastError(), std::system_category(), "select() failed");
+        if (isInProgress(getLastSocketError()))
+        {
+            return 0;
+        }
+        throw std::system_error(getLastSocketError(), std::system_category(), "recv() failed");
     }
+    return ret;
 }
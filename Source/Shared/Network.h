@@ -20,9 +20,25 @@
 
 #pragma once
 
-#include <WinSock2.h>
+#ifdef _WIN32
+    #include <WinSock2.h>
+#else
+    #include <netinet/in.h>
+typedef int SOCKET;
+#endif
 #include <string>
 #include <vector>
+#include <utility>
+
+#include "json/json_fwd.hpp"
+
+// A hostname and port to relay datagrams to, as read from a plugin's config file. Plugin headers that only declare
+// UDPSocket spell it out as std::pair<std::string, int>.
+using RelayDestination = std::pair<std::string, int>;
+
+// Reads the "relay" array of a config file section, whose entries each have a "hostname" and a "port". Entries missing
+// either are logged and skipped.
+std::vector<RelayDestination> readRelayDestinations(const nlohmann::json &config);
 
 class WSASession
 {
@@ -31,7 +47,9 @@ public:
     ~WSASession();
 
 private:
+#ifdef _WIN32
     WSAData m_data;
+#endif
 };
 
 class UDPSocket
@@ -44,6 +62,15 @@ public:
     void sendTo(sockaddr_in &address, const char *buffer, int len, int flags = 0);
     bool hasData();
     void recvData(std::vector<char> &outData, sockaddr_in &outFromAddr);
+
+    // Receives every datagram waiting, without blocking, and keeps the newest one that is exactly len bytes long in
+    // buffer. For telemetry, where only the latest packet matters. Returns true if one was kept.
+    // outCount is the number of datagrams received, outMalformedCount the number of them of another size.
+    bool recvLatest(char *buffer, int len, int &outCount, int &outMalformedCount);
+
+    // Every datagram recvLatest receives is also sent, unchanged, to these destinations. Lets other apps get telemetry
+    // from games that only send it to one address. The address must be an IP address.
+    void addRelayDestination(const std::string &address, unsigned short port);
     void bindTo(unsigned short port);
     bool isBound()
     {
@@ -60,4 +87,35 @@ public:
 private:
     SOCKET m_socket;
     unsigned short m_port = 0;
+
+    // Slots for recvLatest, one byte longer than the expected size so longer datagrams can be told apart.
+    std::vector<char> m_batchBuffer;
+    std::vector<sockaddr_in> m_relayDestinations;
+#ifdef _WIN32
+    bool m_isNonBlocking{ false };
+#endif
+};
+
+// A TCP connection that never blocks: connecting, sending and receiving all return immediately.
+class TCPSocket
+{
+public:
+    TCPSocket();
+    ~TCPSocket();
+
+    // Starts connecting. The hostname should be an IP address, as resolving a name can block.
+    void connectTo(const std::string &hostname, unsigned short port);
+
+    // Returns true once the connection is established, and throws if it failed.
+    bool isConnected();
+
+    // Throws if the data doesn't fit in the socket's send buffer, which small packets always do on a live connection.
+    void sendData(const char *buffer, int len);
+
+    // Returns the number of bytes received, 0 if none are waiting. Throws if the connection was closed or failed.
+    int recvData(char *buffer, int len);
+
+private:
+    SOCKET m_socket;
+    bool m_isConnected{ false };
 };
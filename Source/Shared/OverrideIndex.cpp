@@ -0,0 +1,202 @@
+//
+// SliProSuperPro
+// A Shift Light Indicator controller
+// Copyright 2025 Fixfactory
+//
+// This file is part of SliProSuperPro.
+//
+// SliProSuperPro is free software: you can redistribute it and/or modify it under
+// the terms of the GNU General Public License as published by the Free
+// Software Foundation, either version 3 of the License, or any later version.
+//
+// SliProSuperPro is distributed in the hope that it will be useful, but WITHOUT
+// ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+// FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+// more details.
+//
+// You should have received a copy of the GNU General Public License along
+// with SliProSuperPro. If not, see <http://www.gnu.org/licenses/>.
+//
+
+#include <charconv>
+#include <filesystem>
+
+#include "OverrideIndex.h"
+
+namespace overrides
+{
+    static const char kFileMagic[4] = { 'S', 'P', 'C', 'D' };
+    static const uint32_t kFileVersion = 2;
+
+    // Over the whole file, so a compiled file is still used after its overrides file is copied.
+    static uint64_t hashFile(const MappedFile &file)
+    {
+        return binaryFile::hash(file.getData(), file.getSize());
+    }
+
+    int parseGearName(std::string_view gearName)
+    {
+        if (gearName == "R")
+        {
+            return 0;
+        }
+        if (gearName == "N")
+        {
+            return 1;
+        }
+
+        // Gear "1" is at index 2.
+        int gear = 0;
+        auto result = std::from_chars(gearName.data(), gearName.data() + gearName.size(), gear);
+        if (result.ec != std::errc() || result.ptr != gearName.data() + gearName.size() || gear < 1 ||
+            gear + 1 >= plugin::kMaxGearCount)
+        {
+            return -1;
+        }
+        return gear + 1;
+    }
+
+    int readGearRpms(const json &car, const char *downshiftKey, const char *upshiftKey, float *outRpmDownshift,
+                     float *outRpmUpshift)
+    {
+        auto rpmDownshift = car.find(downshiftKey);
+        auto rpmUpshift = car.find(upshiftKey);
+        if (rpmDownshift != car.end() && rpmUpshift != car.end() && rpmDownshift->is_number() &&
+            rpmUpshift->is_number())
+        {
+            for (int i = 0; i < plugin::kMaxGearCount; i++)
+            {
+                outRpmDownshift[i] = rpmDownshift->get<float>();
+                outRpmUpshift[i] = rpmUpshift->get<float>();
+            }
+            return plugin::kMaxGearCount;
+        }
+
+        int gearCount = 0;
+        auto gears = car.find("gears");
+        if (gears == car.end() || !gears->is_array())
+        {
+            return gearCount;
+        }
+
+        for (const json &gear : *gears)
+        {
+            auto name = gear.find("gear");
+            auto gearRpmDownshift = gear.find(downshiftKey);
+            auto gearRpmUpshift = gear.find(upshiftKey);
+            if (name == gear.end() || !name->is_string() || gearRpmDownshift == gear.end() ||
+                !gearRpmDownshift->is_number() || gearRpmUpshift == gear.end() || !gearRpmUpshift->is_number())
+            {
+                continue;
+            }
+
+            int gearIdx = parseGearName(name->get_ref<const std::string &>());
+            if (gearIdx >= 0)
+            {
+                outRpmDownshift[gearIdx] = gearRpmDownshift->get<float>();
+                outRpmUpshift[gearIdx] = gearRpmUpshift->get<float>();
+                gearCount++;
+            }
+        }
+        return gearCount;
+    }
+
+    void parseCarOverride(const json &car, CarOverride &outOverride)
+    {
+        auto gearCount = car.find("gearCount");
+        if (gearCount != car.end() && gearCount->is_number_integer())
+        {
+            outOverride.gearCount = gearCount->get<int>() + 2; // Add reverse and neutral
+        }
+
+        readGearRpms(car, "rpmDownshift", "rpmUpshift", outOverride.rpmDownshift, outOverride.rpmUpshift);
+    }
+
+    void parseShiftLightOverride(const json &car, CarOverride &outOverride)
+    {
+        readGearRpms(car, "firstRPM", "lastRPM", outOverride.rpmDownshift, outOverride.rpmUpshift);
+    }
+
+    std::string getCompiledFilePath(const std::string &filePath)
+    {
+        return std::filesystem::path(filePath).replace_extension(".bin").string();
+    }
+
+    bool CompiledFile::open(const std::string &filePath, const std::string &sourceFilePath, size_t recordSize,
+                            uint32_t recordVersion)
+    {
+        close();
+        if (!std::filesystem::exists(filePath) || !m_file.open(filePath))
+        {
+            return false;
+        }
+
+        CompiledFileHeader header{};
+        MappedFile sourceFile;
+        bool isValid =
+            binaryFile::checkHeader(filePath, m_file.getData(), m_file.getSize(),
+                                    binaryFile::makeHeader(kFileMagic, kFileVersion, recordSize, recordVersion),
+                                    sizeof(header));
+        if (isValid)
+        {
+            memcpy(&header, m_file.getData(), sizeof(header));
+            if (!sourceFile.open(sourceFilePath) || sourceFile.getSize() != header.sourceSize ||
+                hashFile(sourceFile) != header.sourceHash)
+            {
+                LOG_WARN("Ignoring %s, %s changed since it was compiled", filePath.c_str(), sourceFilePath.c_str());
+                isValid = false;
+            }
+        }
+
+        if (!isValid)
+        {
+            m_file.close();
+            return false;
+        }
+
+        m_records = m_file.getData() + sizeof(header);
+        m_recordCount = header.binaryHeader.recordCount;
+        LOG_INFO("Mapped %zu cars from %s", m_recordCount, filePath.c_str());
+        return true;
+    }
+
+    void CompiledFile::close()
+    {
+        m_records = nullptr;
+        m_recordCount = 0;
+        m_file.close();
+    }
+
+    const char *CompiledFile::getRecords() const
+    {
+        return m_records;
+    }
+
+    size_t CompiledFile::getRecordCount() const
+    {
+        return m_recordCount;
+    }
+
+    bool CompiledFile::write(const std::string &filePath, const std::string &sourceFilePath, size_t recordSize,
+                             uint32_t recordVersion, const std::vector<char> &records)
+    {
+        MappedFile sourceFile;
+        if (!sourceFile.open(sourceFilePath))
+        {
+            LOG_ERROR("Could not read %s", sourceFilePath.c_str());
+            return false;
+        }
+
+        CompiledFileHeader header{};
+        header.binaryHeader = binaryFile::makeHeader(kFileMagic, kFileVersion, recordSize, recordVersion);
+        header.binaryHeader.recordCount = (uint32_t)(records.size() / recordSize);
+        header.sourceSize = sourceFile.getSize();
+        header.sourceHash = hashFile(sourceFile);
+
+        // A plugin never maps it half written.
+        std::vector<char> file(sizeof(header));
+        memcpy(file.data(), &header, sizeof(header));
+        file.insert(file.end(), records.begin(), records.end());
+        return binaryFile::write(filePath, file);
+    }
+} // namespace overrides
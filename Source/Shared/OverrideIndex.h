@@ -0,0 +1,375 @@
+//
+// SliProSuperPro
+// A Shift Light Indicator controller
+// Copyright 2025 Fixfactory
+//
+// This file is part of SliProSuperPro.
+//
+// SliProSuperPro is free software: you can redistribute it and/or modify it under
+// the terms of the GNU General Public License as published by the Free
+// Software Foundation, either version 3 of the License, or any later version.
+//
+// SliProSuperPro is distributed in the hope that it will be useful, but WITHOUT
+// ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+// FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+// more details.
+//
+// You should have received a copy of the GNU General Public License along
+// with SliProSuperPro. If not, see <http://www.gnu.org/licenses/>.
+//
+
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <functional>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <unordered_map>
+#include <vector>
+
+#include "PluginInterface.h"
+#include "BackgroundTask.h"
+#include "BinaryFile.h"
+#include "FileWatcher.h"
+#include "MappedFile.h"
+#include "Log.h"
+
+#include "json/json.hpp"
+using json = nlohmann::json;
+
+// Reading the overrides files plugins give per car, like iRacing.Overrides.json or LiveForSpeed.CarData.json.
+namespace overrides
+{
+    // The index in plugin::PhysicsData's gear arrays of a gear named "R", "N", "1", "2"... in an overrides file,
+    // or -1 if the name isn't one or the gear is out of range.
+    int parseGearName(std::string_view gearName);
+
+    // Reads a car's RPMs into arrays indexed like plugin::PhysicsData's. They are either the same for every gear, given
+    // by downshiftKey and upshiftKey in the car itself, or given per gear in its "gears" list of
+    // { "gear": "1", downshiftKey: ..., upshiftKey: ... } objects. Returns the number of gears set.
+    int readGearRpms(const json &car, const char *downshiftKey, const char *upshiftKey, float *outRpmDownshift,
+                     float *outRpmUpshift);
+
+    // What most overrides files give for a car.
+    struct CarOverride
+    {
+        // Changes whenever the fields do, so compiled files of the old ones are parsed again.
+        static constexpr uint32_t kCompiledVersion = 1;
+
+        // Including reverse and neutral, or 0 when the file doesn't give it.
+        int gearCount{ 0 };
+        float rpmDownshift[plugin::kMaxGearCount]{};
+        float rpmUpshift[plugin::kMaxGearCount]{};
+    };
+
+    // "rpmDownshift" and "rpmUpshift", and the number of forward gears in "gearCount", like in ACR.Overrides.json.
+    void parseCarOverride(const json &car, CarOverride &outOverride);
+
+    // iRacing.Overrides.json names the RPMs "firstRPM" and "lastRPM", after the game's shift lights.
+    void parseShiftLightOverride(const json &car, CarOverride &outOverride);
+
+    // Where CarDataCompiler writes the compiled file of an overrides file, like iRacing.Overrides.bin for
+    // iRacing.Overrides.json.
+    std::string getCompiledFilePath(const std::string &filePath);
+
+    // A compiled file starts with a CompiledFileHeader, followed by recordCount records of recordSize bytes sorted by
+    // car id. The records are the plugin's car struct as is, so a file is only used by a build with the same struct
+    // size, struct version and byte order, and only while its overrides file is the one it was compiled from.
+    // Otherwise the overrides file, which is the one that is edited, is parsed instead.
+    struct CompiledFileHeader
+    {
+        BinaryFileHeader binaryHeader;
+        uint64_t sourceSize;
+        uint64_t sourceHash;
+    };
+
+    class CompiledFile
+    {
+    public:
+        // False if the file doesn't exist, is out of date, or doesn't hold records of recordSize bytes and
+        // recordVersion.
+        bool open(const std::string &filePath, const std::string &sourceFilePath, size_t recordSize,
+                  uint32_t recordVersion);
+        void close();
+
+        const char *getRecords() const;
+        size_t getRecordCount() const;
+
+        // records holds the sorted records, recordSize bytes each.
+        static bool write(const std::string &filePath, const std::string &sourceFilePath, size_t recordSize,
+                          uint32_t recordVersion, const std::vector<char> &records);
+
+    private:
+        MappedFile m_file;
+        const char *m_records{ nullptr };
+        size_t m_recordCount{ 0 };
+    };
+
+    // Every car of an overrides file, by car id. The file's "cars" object is parsed once with the plugin's function
+    // into an index that doesn't change until the next read, so a car change is a lookup that doesn't allocate, and
+    // pointers to cars stay valid. Cars may also be grouped in a "mods" object inside "cars", like in Live For Speed's
+    // car data, and a car in both is the one outside of it.
+    // When the file was compiled, its compiled file is mapped instead and cars are found in it with a binary search.
+    // Car has a static constexpr uint32_t kCompiledVersion that changes whenever its fields do.
+    template <typename Car> class CarIndex
+    {
+        static_assert(std::is_trivially_copyable_v<Car>, "Cars are stored as is in compiled files");
+        static_assert(std::is_same_v<decltype(Car::kCompiledVersion), const uint32_t>,
+                      "Compiled files are dropped when the fields of cars change");
+
+    public:
+        using ParseCar = void (*)(const json &car, Car &outCar);
+
+        // Replaces the cars read before, from the compiled file when it is up to date. Errors are logged. Returns false
+        // if the file couldn't be read.
+        bool read(const std::string &filePath, ParseCar parseCar)
+        {
+            clear();
+            if (m_compiledFile.open(getCompiledFilePath(filePath), filePath, sizeof(CompiledCar),
+                                    Car::kCompiledVersion))
+            {
+                m_compiledCars = reinterpret_cast<const CompiledCar *>(m_compiledFile.getRecords());
+                m_compiledCarCount = m_compiledFile.getRecordCount();
+                return true;
+            }
+            return parse(filePath, parseCar);
+        }
+
+        // Same, without looking for a compiled file.
+        bool parse(const std::string &filePath, ParseCar parseCar)
+        {
+            clear();
+            std::ifstream file(filePath);
+            if (!file.good())
+            {
+                return false;
+            }
+
+            LOG_INFO("Reading %s", filePath.c_str());
+            try
+            {
+                json root = json::parse(file);
+                auto cars = root.find("cars");
+                if (cars == root.end() || !cars->is_object())
+                {
+                    return true;
+                }
+
+                addCars(*cars, parseCar);
+                auto mods = cars->find("mods");
+                if (mods != cars->end() && mods->is_object())
+                {
+                    addCars(*mods, parseCar);
+                }
+            }
+            catch (const json::exception &exception)
+            {
+                LOG_ERROR("Could not read %s: %s", filePath.c_str(), exception.what());
+                m_cars.clear();
+                return false;
+            }
+            return true;
+        }
+
+        // Writes the cars parsed from sourceFilePath to a compiled file.
+        bool compile(const std::string &sourceFilePath, const std::string &compiledFilePath) const
+        {
+            std::vector<const std::string *> carIds;
+            for (const auto &car : m_cars)
+            {
+                if (car.first.size() >= plugin::kMaxCarIdLength)
+                {
+                    LOG_ERROR("Car id %s is too long to be compiled", car.first.c_str());
+                    return false;
+                }
+                carIds.push_back(&car.first);
+            }
+            std::sort(carIds.begin(), carIds.end(),
+                      [](const std::string *carId, const std::string *otherCarId) { return *carId < *otherCarId; });
+
+            std::vector<char> records(carIds.size() * sizeof(CompiledCar));
+            for (size_t i = 0; i < carIds.size(); i++)
+            {
+                CompiledCar record{};
+                memcpy(record.carId, carIds[i]->c_str(), carIds[i]->size());
+                record.car = m_cars.find(*carIds[i])->second;
+                memcpy(records.data() + i * sizeof(record), &record, sizeof(record));
+            }
+            return CompiledFile::write(compiledFilePath, sourceFilePath, sizeof(CompiledCar), Car::kCompiledVersion,
+                                       records);
+        }
+
+        void clear()
+        {
+            m_cars.clear();
+            m_compiledCars = nullptr;
+            m_compiledCarCount = 0;
+            m_compiledFile.close();
+        }
+
+        // nullptr if the car isn't in the file.
+        const Car *find(std::string_view carId) const
+        {
+            if (m_compiledCars)
+            {
+                const CompiledCar *end = m_compiledCars + m_compiledCarCount;
+                const CompiledCar *car = std::lower_bound(
+                    m_compiledCars, end, carId,
+                    [](const CompiledCar &car, std::string_view carId) { return std::string_view(car.carId) < carId; });
+                return car != end && std::string_view(car->carId) == carId ? &car->car : nullptr;
+            }
+
+            auto car = m_cars.find(carId);
+            return car != m_cars.end() ? &car->second : nullptr;
+        }
+
+        size_t getCarCount() const
+        {
+            return m_compiledCars ? m_compiledCarCount : m_cars.size();
+        }
+
+        bool isCompiled() const
+        {
+            return m_compiledCars != nullptr;
+        }
+
+    private:
+        // Lets find() take a string_view without making a string of it.
+        struct StringHash
+        {
+            using is_transparent = void;
+
+            size_t operator()(std::string_view str) const
+            {
+                return std::hash<std::string_view>{}(str);
+            }
+        };
+
+        std::unordered_map<std::string, Car, StringHash, std::equal_to<>> m_cars;
+
+        // The car id is always null-terminated.
+        struct CompiledCar
+        {
+            char carId[plugin::kMaxCarIdLength];
+            Car car;
+        };
+
+        // Mappings are page aligned, and the header keeps the records aligned after it.
+        static_assert(sizeof(CompiledFileHeader) % alignof(CompiledCar) == 0);
+
+        CompiledFile m_compiledFile;
+        const CompiledCar *m_compiledCars{ nullptr };
+        size_t m_compiledCarCount{ 0 };
+
+        void addCars(const json &cars, ParseCar parseCar)
+        {
+            for (const auto &car : cars.items())
+            {
+                if (car.key() != "mods" && car.value().is_object() && !car.value().empty() &&
+                    m_cars.find(car.key()) == m_cars.end())
+                {
+                    parseCar(car.value(), m_cars[car.key()]);
+                }
+            }
+        }
+    };
+
+    // A CarIndex read in the background, and read again when its file changes, so edits made while the game runs are
+    // used without restarting it. The new cars replace the old ones between frames, in update(), and only when the
+    // file could be read: a file saved with an error keeps the cars read before.
+    template <typename Car> class WatchedCarIndex
+    {
+    public:
+        using ParseCar = typename CarIndex<Car>::ParseCar;
+
+        void init(const std::string &filePath, ParseCar parseCar)
+        {
+            deinit();
+            m_filePath = filePath;
+            m_parseCar = parseCar;
+            m_isLoaded = false;
+            m_watcher.open(filePath);
+            startReading();
+        }
+
+        void deinit()
+        {
+            m_task.wait();
+            m_watcher.close();
+            m_cars.reset();
+            m_newCars.reset();
+        }
+
+        // Call every frame. True when new cars replaced the old ones, which makes the cars found before invalid.
+        bool update()
+        {
+            if (!m_task.isDone())
+            {
+                return false;
+            }
+
+            bool isReplaced = false;
+            if (m_newCars)
+            {
+                if (m_isNewCarsRead)
+                {
+                    m_cars = std::move(m_newCars);
+                    isReplaced = true;
+                }
+                else if (m_cars)
+                {
+                    LOG_WARN("Keeping the cars read before from %s", m_filePath.c_str());
+                }
+                m_newCars.reset();
+                m_isLoaded = true;
+            }
+
+            if (m_watcher.hasChanged())
+            {
+                startReading();
+            }
+            return isReplaced;
+        }
+
+        // False until the file was first read, or found missing.
+        bool isLoaded() const
+        {
+            return m_isLoaded;
+        }
+
+        // nullptr if the car isn't in the file. Valid until update() replaces the cars.
+        const Car *find(std::string_view carId) const
+        {
+            return m_cars ? m_cars->find(carId) : nullptr;
+        }
+
+        size_t getCarCount() const
+        {
+            return m_cars ? m_cars->getCarCount() : 0;
+        }
+
+    private:
+        std::string m_filePath;
+        ParseCar m_parseCar{ nullptr };
+        FileWatcher m_watcher;
+
+        std::unique_ptr<CarIndex<Car>> m_cars;
+        bool m_isLoaded{ false };
+
+        // Only touched by the task while it runs.
+        std::unique_ptr<CarIndex<Car>> m_newCars;
+        bool m_isNewCarsRead{ false };
+        BackgroundTask m_task;
+
+        void startReading()
+        {
+            m_newCars = std::make_unique<CarIndex<Car>>();
+            m_task.start([this]() { m_isNewCarsRead = m_newCars->read(m_filePath, m_parseCar); });
+        }
+    };
+} // namespace overrides
@@ -0,0 +1,229 @@
+//
+// SliProSuperPro
+// A Shift Light Indicator controller
+// Copyright 2025 Fixfactory
+//
+// This file is part of SliProSuperPro.
+//
+// SliProSuperPro is free software: you can redistribute it and/or modify it under
+// the terms of the GNU General Public License as published by the Free
+// Software Foundation, either version 3 of the License, or any later version.
+//
+// SliProSuperPro is distributed in the hope that it will be useful, but WITHOUT
+// ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+// FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+// more details.
+//
+// You should have received a copy of the GNU General Public License along
+// with SliProSuperPro. If not, see <http://www.gnu.org/licenses/>.
+//
+
+#pragma once
+
+#include <atomic>
+#include <string>
+#include <type_traits>
+
+#include "PluginInterface.h"
+
+// Layout of the shared memory used by SliProSuperPro.PluginHost.exe to stream frames to SliProSuperPro.exe.
+// The host is the single producer and the controller is the single consumer of the frame ring.
+namespace pluginHost
+{
+    constexpr int kProtocolVersion = 5;
+
+    // Must be a power of two.
+    constexpr unsigned int kFrameCount = 8;
+
+    const std::string kExecFileName("SliProSuperPro.PluginHost.exe");
+
+    enum class HostState : int
+    {
+        kStarting,
+        kRunning,
+        kStopRequested,
+        kStopped
+    };
+
+    struct Frame
+    {
+        // steady_clock time taken by the host right before calling into the plugin.
+        long long fetchTimeNs;
+        bool hasTelemetryData;
+        bool hasPhysicsData;
+        plugin::TelemetryData telemetryData;
+        plugin::PhysicsData physicsData;
+    };
+
+    struct Ring
+    {
+        int protocolVersion;
+        std::atomic<int> state;
+        std::atomic<unsigned int> heartbeat;
+        std::atomic<bool> physicsDataEveryFrame;
+
+        // Only ever incremented. The slot of a frame is its index modulo kFrameCount.
+        std::atomic<unsigned int> writeIndex;
+        std::atomic<unsigned int> readIndex;
+
+        Frame frames[kFrameCount];
+    };
+
+    static_assert((kFrameCount & (kFrameCount - 1)) == 0);
+    static_assert(std::atomic<unsigned int>::is_always_lock_free);
+    static_assert(std::is_trivially_copyable_v<Frame>);
+
+    // Called by the host. When the controller isn't keeping up, the oldest frame is dropped so the newest one is always
+    // published. The physics data of a dropped frame moves to the new frame, unless a newer frame has some or the
+    // plugin changed its physics generation since.
+    inline void publishFrame(Ring &ring, Frame frame)
+    {
+        unsigned int writeIndex = ring.writeIndex.load(std::memory_order_relaxed);
+        unsigned int readIndex = ring.readIndex.load(std::memory_order_acquire);
+        while (writeIndex - readIndex >= kFrameCount)
+        {
+            // Fails if the controller read frames meanwhile, in which case there may be room now.
+            if (!ring.readIndex.compare_exchange_weak(readIndex, readIndex + 1, std::memory_order_acq_rel))
+            {
+                continue;
+            }
+
+            const Frame &dropped = ring.frames[readIndex & (kFrameCount - 1)];
+            bool hasNewerPhysicsData = frame.hasPhysicsData;
+            for (unsigned int index = readIndex + 1; index != writeIndex && !hasNewerPhysicsData; ++index)
+            {
+                hasNewerPhysicsData = ring.frames[index & (kFrameCount - 1)].hasPhysicsData;
+            }
+            if (dropped.hasPhysicsData && !hasNewerPhysicsData &&
+                dropped.telemetryData.physicsGeneration == frame.telemetryData.physicsGeneration)
+            {
+                frame.hasPhysicsData = true;
+                frame.physicsData = dropped.physicsData;
+            }
+            readIndex++;
+        }
+
+        ring.frames[writeIndex & (kFrameCount - 1)] = frame;
+        ring.writeIndex.store(writeIndex + 1, std::memory_order_release);
+    }
+
+    // Called by the controller. Calls onFrame(const Frame &) with a copy of each frame published since the last call,
+    // oldest first, and returns how many there were. A frame the host dropped while it was copied may have been
+    // partly overwritten, so it is skipped.
+    template <typename OnFrame> int readFrames(Ring &ring, OnFrame onFrame)
+    {
+        unsigned int readIndex = ring.readIndex.load(std::memory_order_acquire);
+        unsigned int writeIndex = ring.writeIndex.load(std::memory_order_acquire);
+        int frameCount = 0;
+        while ((int)(writeIndex - readIndex) > 0)
+        {
+            Frame frame = ring.frames[readIndex & (kFrameCount - 1)];
+            std::atomic_thread_fence(std::memory_order_acquire);
+            unsigned int oldestIndex = ring.readIndex.load(std::memory_order_relaxed);
+            if ((int)(oldestIndex - readIndex) > 0)
+            {
+                readIndex = oldestIndex;
+                continue;
+            }
+
+            onFrame(frame);
+            frameCount++;
+            readIndex++;
+        }
+
+        // The host may have moved past us by dropping frames, and must not be moved back.
+        unsigned int oldestIndex = ring.readIndex.load(std::memory_order_relaxed);
+        while ((int)(readIndex - oldestIndex) > 0 &&
+               !ring.readIndex.compare_exchange_weak(oldestIndex, readIndex, std::memory_order_acq_rel))
+        {
+        }
+        return frameCount;
+    }
+
+    // Called by the host for plugins that don't return physics data every frame. Asks for it with the same rules as the
+    // controller's PhysicsManager, so plugins behave as if they were loaded in-process: when telemetry starts, when the
+    // plugin changes its physics generation, and every frame after that until the plugin has it.
+    class PhysicsDataRequest
+    {
+    public:
+        // Returns true if the plugin should be asked for its physics data this frame.
+        bool update(bool hasTelemetryData, const plugin::TelemetryData &telemetryData)
+        {
+            bool hasChanged = !m_wasReceivingTelemetry || telemetryData.physicsGeneration != m_physicsGeneration;
+            m_isPending = hasTelemetryData && (m_isPending || hasChanged);
+            m_wasReceivingTelemetry = hasTelemetryData;
+            if (hasTelemetryData)
+            {
+                m_physicsGeneration = telemetryData.physicsGeneration;
+            }
+            return m_isPending;
+        }
+
+        void setReceived(bool hasPhysicsData)
+        {
+            m_isPending = !hasPhysicsData;
+        }
+
+    private:
+        bool m_wasReceivingTelemetry{ false };
+        bool m_isPending{ false };
+        int m_physicsGeneration{ 0 };
+    };
+
+    // Called by the controller with each frame read. Keeps the newest physics data until the host fetches it again,
+    // when telemetry restarts or the plugin changes its physics generation, possibly a few frames later if the plugin
+    // is still loading it. Until then there is none, so PhysicsManager keeps asking and keeps the values it has.
+    class ReceivedPhysicsData
+    {
+    public:
+        void add(const Frame &frame, bool isPhysicsDataEveryFrame)
+        {
+            bool isStale = !frame.hasTelemetryData || frame.telemetryData.physicsGeneration != m_physicsGeneration;
+            if (frame.hasTelemetryData)
+            {
+                m_physicsGeneration = frame.telemetryData.physicsGeneration;
+            }
+
+            if (frame.hasPhysicsData)
+            {
+                m_hasPhysicsData = true;
+                m_physicsData = frame.physicsData;
+            }
+            else if (isStale && !isPhysicsDataEveryFrame)
+            {
+                m_hasPhysicsData = false;
+            }
+        }
+
+        void clear()
+        {
+            m_hasPhysicsData = false;
+        }
+
+        bool hasPhysicsData() const
+        {
+            return m_hasPhysicsData;
+        }
+
+        const plugin::PhysicsData &getPhysicsData() const
+        {
+            return m_physicsData;
+        }
+
+    private:
+        bool m_hasPhysicsData{ false };
+        int m_physicsGeneration{ 0 };
+        plugin::PhysicsData m_physicsData{};
+    };
+
+    // Names of the shared memory and of the event signaled after each frame is published.
+    inline std::string getRingName(unsigned long controllerPid)
+    {
+        return "SPSP.PluginHost." + std::to_string(controllerPid) + ".Ring";
+    }
+
+    inline std::string getEventName(unsigned long controllerPid)
+    {
+        return "SPSP.PluginHost." + std::to_string(controllerPid) + ".Event";
+    }
+} // namespace pluginHost
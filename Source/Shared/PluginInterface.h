@@ -22,7 +22,15 @@
 
 namespace plugin
 {
-    constexpr int kInterfaceVersion = 1;
+    // Changes whenever TelemetryData or PhysicsData do. Plugins only fill in a struct that is at most as large as their
+    // own, so a plugin built for an older version would return no data.
+    // Version 2 added gearRatio, torqueCurvePointCount, torqueCurveRpm and torqueCurveTorque to PhysicsData.
+    // Version 3 added carId to PhysicsData.
+    // Version 4 added physicsGeneration to TelemetryData.
+    constexpr int kInterfaceVersion = 4;
+
+    // Plugin libraries are loaded from copies in this directory so the originals can be replaced while running.
+    constexpr const char *kShadowDirectoryName = "Plugins.Shadow";
 
     struct TelemetryData
     {
@@ -30,9 +38,15 @@ namespace plugin
         float rpm;
         float speedKph;
         bool speedLimiter;
+
+        // Plugins that don't return physics data every frame change it whenever their physics data changes during a
+        // session, for example when an edited overrides file is read. SliProSuperPro then asks for it again.
+        int physicsGeneration;
     };
 
     constexpr int kMaxGearCount = 20;
+    constexpr int kMaxTorqueCurvePointCount = 64;
+    constexpr int kMaxCarIdLength = 64;
 
     struct PhysicsData
     {
@@ -41,5 +55,16 @@ namespace plugin
         float rpmIdle;
         float rpmDownshift[kMaxGearCount];
         float rpmUpshift[kMaxGearCount];
+
+        // Optional, left at 0 when unknown. When a plugin knows the gearbox ratios, indexed like the shift points, and
+        // the engine's torque curve, SliProSuperPro computes the shift points of the forward gears from them.
+        // The torque is only compared between gears, so any unit works.
+        float gearRatio[kMaxGearCount];
+        int torqueCurvePointCount;
+        float torqueCurveRpm[kMaxTorqueCurvePointCount];
+        float torqueCurveTorque[kMaxTorqueCurvePointCount];
+
+        // Optional. Identifies the car, so SliProSuperPro can remember what it learns about the car while it is driven.
+        char carId[kMaxCarIdLength];
     };
 } // namespace plugin
\ No newline at end of file
@@ -0,0 +1,120 @@
+//
+// SliProSuperPro
+// A Shift Light Indicator controller
+// Copyright 2025 Fixfactory
+//
+// This file is part of SliProSuperPro.
+//
+// SliProSuperPro is free software: you can redistribute it and/or modify it under
+// the terms of the GNU General Public License as published by the Free
+// Software Foundation, either version 3 of the License, or any later version.
+//
+// SliProSuperPro is distributed in the hope that it will be useful, but WITHOUT
+// ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+// FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+// more details.
+//
+// You should have received a copy of the GNU General Public License along
+// with SliProSuperPro. If not, see <http://www.gnu.org/licenses/>.
+//
+
+#include "PluginLibrary.h"
+#include "Log.h"
+
+bool PluginLibrary::load(const std::string &path)
+{
+    if (library.isOpen())
+    {
+        return true;
+    }
+
+    if (!library.open(path))
+    {
+        LOG_ERROR("Could not load the library %s: %s", path.c_str(), DynamicLibrary::getLastError().c_str());
+        return false;
+    }
+
+    auto getPluginInterfaceVersion = library.getFunction<GetPluginInterfaceVersion>("getPluginInterfaceVersion");
+    if (!getPluginInterfaceVersion)
+    {
+        LOG_ERROR("Could not locate the function getPluginInterfaceVersion()");
+        unload();
+        return false;
+    }
+
+    interfaceVersion = getPluginInterfaceVersion();
+    LOG_DEBUG("Plugin interface version: %i", interfaceVersion);
+
+    auto supportsInterfaceVersion = library.getFunction<SupportsInterfaceVersion>("supportsInterfaceVersion");
+    if (!supportsInterfaceVersion)
+    {
+        LOG_ERROR("Could not locate the function supportsInterfaceVersion()");
+        unload();
+        return false;
+    }
+
+    if (!supportsInterfaceVersion(plugin::kInterfaceVersion))
+    {
+        LOG_ERROR("Plugin does not support our interface version %i", plugin::kInterfaceVersion);
+        unload();
+        return false;
+    }
+
+    auto getGameExecFileName = library.getFunction<GetGameExecFileName>("getGameExecFileName");
+    if (!getGameExecFileName)
+    {
+        LOG_ERROR("Could not locate the function getGameExecFileName()");
+        unload();
+        return false;
+    }
+
+    getGameExecFileName(gameExecFileName);
+
+    setGameIsRunning = library.getFunction<SetGameIsRunning>("setGameIsRunning");
+    if (!setGameIsRunning)
+    {
+        LOG_ERROR("Could not locate the function setGameIsRunning()");
+        unload();
+        return false;
+    }
+
+    getTelemetryData = library.getFunction<GetTelemetryData>("getTelemetryData");
+    if (!getTelemetryData)
+    {
+        LOG_ERROR("Could not locate the function getTelemetryData()");
+        unload();
+        return false;
+    }
+
+    getPhysicsData = library.getFunction<GetPhysicsData>("getPhysicsData");
+    if (!getPhysicsData)
+    {
+        LOG_ERROR("Could not locate the function getPhysicsData()");
+        unload();
+        return false;
+    }
+
+    getPhysicsDataEveryFrame = library.getFunction<GetPhysicsDataEveryFrame>("getPhysicsDataEveryFrame");
+    if (!getPhysicsDataEveryFrame)
+    {
+        LOG_ERROR("Could not locate the function getPhysicsDataEveryFrame()");
+        unload();
+        return false;
+    }
+
+    return true;
+}
+
+void PluginLibrary::unload()
+{
+    library.close();
+    setGameIsRunning = nullptr;
+    getTelemetryData = nullptr;
+    getPhysicsData = nullptr;
+    getPhysicsDataEveryFrame = nullptr;
+}
+
+bool PluginLibrary::isLoaded() const
+{
+    return library.isOpen();
+}
@@ -0,0 +1,52 @@
+//
+// SliProSuperPro
+// A Shift Light Indicator controller
+// Copyright 2025 Fixfactory
+//
+// This file is part of SliProSuperPro.
+//
+// SliProSuperPro is free software: you can redistribute it and/or modify it under
+// the terms of the GNU General Public License as published by the Free
+// Software Foundation, either version 3 of the License, or any later version.
+//
+// SliProSuperPro is distributed in the hope that it will be useful, but WITHOUT
+// ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+// FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+// more details.
+//
+// You should have received a copy of the GNU General Public License along
+// with SliProSuperPro. If not, see <http://www.gnu.org/licenses/>.
+//
+
+#pragma once
+
+#include <string>
+
+#include "Defines.h"
+#include "DynamicLibrary.h"
+#include "PluginInterface.h"
+
+typedef int(PLUGIN_CALL *GetPluginInterfaceVersion)();
+typedef bool(PLUGIN_CALL *SupportsInterfaceVersion)(int);
+typedef void(PLUGIN_CALL *GetGameExecFileName)(std::string &);
+typedef void(PLUGIN_CALL *SetGameIsRunning)(bool, std::string);
+typedef bool(PLUGIN_CALL *GetTelemetryData)(plugin::TelemetryData *, size_t);
+typedef bool(PLUGIN_CALL *GetPhysicsData)(plugin::PhysicsData *, size_t);
+typedef bool(PLUGIN_CALL *GetPhysicsDataEveryFrame)();
+
+// A plugin library and the functions it exports. Shared by everything that loads plugins.
+struct PluginLibrary
+{
+    DynamicLibrary library{};
+    int interfaceVersion{ 0 };
+    std::string gameExecFileName{};
+    SetGameIsRunning setGameIsRunning{ nullptr };
+    GetTelemetryData getTelemetryData{ nullptr };
+    GetPhysicsData getPhysicsData{ nullptr };
+    GetPhysicsDataEveryFrame getPhysicsDataEveryFrame{ nullptr };
+
+    // Loads the library and checks that it implements our plugin interface. Errors are logged.
+    bool load(const std::string &path);
+    void unload();
+    bool isLoaded() const;
+};
@@ -38,6 +38,17 @@ namespace cmdLine
         LOG_INFO("   --brightness [value]");
         LOG_INFO("      Specify the the brightness level between 0-100.");
         LOG_INFO("      Default: 75");
+        LOG_INFO("");
+        LOG_INFO("   --isolatePlugins");
+        LOG_INFO("      Run game plugins in a separate process that is restarted if it fails.");
+        LOG_INFO("");
+        LOG_INFO("   --pluginShiftPoints");
+        LOG_INFO("      Use the shift points reported by the game plugin rather than computing them from the engine's");
+        LOG_INFO("      torque curve and gear ratios, for the games that report them, or from the RPMs learned while");
+        LOG_INFO("      driving each car.");
+        LOG_INFO("");
+        LOG_INFO("Options can also be set by their name without -- in SliProSuperPro.Config.json, which is read");
+        LOG_INFO("again when it is saved. Options given on the command line win over the ones in the file.");
     }
 
     std::string_view getOption(const std::vector<std::string_view> &args, const std::string_view &optionName)
@@ -96,12 +107,22 @@ namespace cmdLine
                 printHelp();
                 return false;
             }
-            config::brightness = std::clamp<unsigned int>(std::stoi(option), 0, 100);
+            config::brightness.set(config::Layer::kCommandLine, std::clamp<unsigned int>(std::stoi(option), 0, 100));
         }
 
         if (hasOption(args, "--debugTiming"))
         {
-            config::debugTiming = true;
+            config::debugTiming.set(config::Layer::kCommandLine, true);
+        }
+
+        if (hasOption(args, "--isolatePlugins"))
+        {
+            config::isolatePlugins.set(config::Layer::kCommandLine, true);
+        }
+
+        if (hasOption(args, "--pluginShiftPoints"))
+        {
+            config::pluginShiftPoints.set(config::Layer::kCommandLine, true);
         }
 
         return true;
@@ -18,10 +18,160 @@
 // with SliProSuperPro. If not, see <http://www.gnu.org/licenses/>.
 //
 
+#include <fstream>
+#include <string>
+
 #include "Config.h"
+#include "FileWatcher.h"
+#include "Log.h"
+
+using json = nlohmann::json;
+
+namespace
+{
+    // Function-local, so the settings can register themselves during static initialization.
+    std::vector<config::SettingBase *> &getSettings()
+    {
+        static std::vector<config::SettingBase *> s_settings;
+        return s_settings;
+    }
+
+    std::string s_filePath;
+    FileWatcher s_fileWatcher;
+} // namespace
 
 namespace config
 {
-    unsigned int brightness{ 75 };
-    bool debugTiming{ false };
+    Setting<unsigned int> brightness{ "brightness", 75, [](const unsigned int &value) { return value <= 100; } };
+    Setting<bool> debugTiming{ "debugTiming", false };
+    Setting<bool> isolatePlugins{ "isolatePlugins", false };
+    Setting<bool> pluginShiftPoints{ "pluginShiftPoints", false };
+
+    const char *getLayerName(Layer layer)
+    {
+        switch (layer)
+        {
+        case Layer::kDefault:
+            return "default";
+        case Layer::kFile:
+            return "config file";
+        case Layer::kCommandLine:
+            return "command line";
+        case Layer::kRuntime:
+            return "runtime";
+        default:
+            return "unknown";
+        }
+    }
+
+    SettingBase::SettingBase(const char *name) : m_name(name)
+    {
+        getSettings().push_back(this);
+    }
+
+    SettingBase::~SettingBase()
+    {
+        std::erase(getSettings(), this);
+    }
+
+    const char *SettingBase::getName() const
+    {
+        return m_name;
+    }
+
+    Layer SettingBase::getLayer() const
+    {
+        return m_layer;
+    }
+
+    void SettingBase::logChange(const json &value) const
+    {
+        LOG_INFO("Setting %s to %s (%s)", m_name, value.dump().c_str(), getLayerName(m_layer));
+    }
+
+    SettingBase *findSetting(std::string_view name)
+    {
+        for (SettingBase *setting : getSettings())
+        {
+            if (name == setting->getName())
+            {
+                return setting;
+            }
+        }
+
+        return nullptr;
+    }
+
+    bool readFile(const char *filePath)
+    {
+        json file;
+        std::ifstream stream(filePath);
+        if (!stream.good())
+        {
+            LOG_WARN("Could not open %s, using the default settings", filePath);
+        }
+        else
+        {
+            try
+            {
+                file = json::parse(stream);
+            }
+            catch (const json::exception &exception)
+            {
+                LOG_ERROR("Could not read %s: %s", filePath, exception.what());
+                return false;
+            }
+
+            if (!file.is_object())
+            {
+                LOG_ERROR("Could not read %s: the settings must be in an object", filePath);
+                return false;
+            }
+        }
+
+        for (auto it = file.begin(), end = file.end(); it != end; ++it)
+        {
+            if (findSetting(it.key()) == nullptr)
+            {
+                LOG_WARN("Unknown setting %s in %s", it.key().c_str(), filePath);
+            }
+        }
+
+        for (SettingBase *setting : getSettings())
+        {
+            auto value = file.find(setting->getName());
+            if (value == file.end())
+            {
+                setting->reset(Layer::kFile);
+            }
+            else if (!setting->setFromJson(Layer::kFile, *value))
+            {
+                LOG_ERROR("Invalid value %s for %s in %s", value->dump().c_str(), setting->getName(), filePath);
+            }
+        }
+
+        return true;
+    }
+
+    void init(const char *filePath)
+    {
+        s_filePath = filePath;
+        readFile(filePath);
+        s_fileWatcher.open(s_filePath);
+    }
+
+    void deinit()
+    {
+        s_fileWatcher.close();
+        s_filePath.clear();
+    }
+
+    void update()
+    {
+        if (s_fileWatcher.hasChanged())
+        {
+            LOG_INFO("Reading %s again", s_filePath.c_str());
+            readFile(s_filePath.c_str());
+        }
+    }
 } // namespace config
@@ -20,11 +20,211 @@
 
 #pragma once
 
+#include <functional>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "json/json.hpp"
+
 namespace config
 {
+    // Where the value of a setting comes from. The value of a later layer wins over the values of the earlier ones.
+    enum class Layer
+    {
+        kDefault,
+        kFile,
+        kCommandLine,
+        kRuntime,
+        kCount
+    };
+
+    const char *getLayerName(Layer layer);
+
+    using SubscriptionId = int;
+
+    // A setting known by its name, so the config file can set it without knowing its type. Settings are read and
+    // changed on the main thread.
+    class SettingBase
+    {
+    public:
+        SettingBase(const SettingBase &) = delete;
+        SettingBase &operator=(const SettingBase &) = delete;
+
+        const char *getName() const;
+
+        // The layer whose value is used.
+        Layer getLayer() const;
+
+        // Returns false, leaving the layer as it was, if the value has the wrong type or is out of range.
+        virtual bool setFromJson(Layer layer, const nlohmann::json &value) = 0;
+
+        // Removes the value of a layer, so the value of an earlier layer is used. The default can't be removed.
+        virtual void reset(Layer layer) = 0;
+
+    protected:
+        explicit SettingBase(const char *name);
+        ~SettingBase();
+
+        void logChange(const nlohmann::json &value) const;
+
+        const char *m_name;
+        Layer m_layer{ Layer::kDefault };
+    };
+
+    template <typename T> class Setting : public SettingBase
+    {
+    public:
+        using Callback = std::function<void(const T &value)>;
+        using Validate = bool (*)(const T &value);
+
+        Setting(const char *name, T defaultValue, Validate validate = nullptr)
+            : SettingBase(name), m_value(defaultValue), m_validate(validate)
+        {
+            m_values[static_cast<size_t>(Layer::kDefault)] = std::move(defaultValue);
+        }
+
+        // The value used is kept up to date when a layer changes, so reading it costs the same as reading a global.
+        const T &get() const
+        {
+            return m_value;
+        }
+
+        operator const T &() const
+        {
+            return m_value;
+        }
+
+        bool set(Layer layer, T value)
+        {
+            if (m_validate != nullptr && !m_validate(value))
+            {
+                return false;
+            }
+
+            m_values[static_cast<size_t>(layer)] = std::move(value);
+            update();
+            return true;
+        }
+
+        bool setFromJson(Layer layer, const nlohmann::json &value) override
+        {
+            if constexpr (std::is_same_v<T, bool>)
+            {
+                if (!value.is_boolean())
+                {
+                    return false;
+                }
+            }
+            else if constexpr (std::is_unsigned_v<T>)
+            {
+                if (!value.is_number_unsigned())
+                {
+                    return false;
+                }
+            }
+            else if constexpr (std::is_arithmetic_v<T>)
+            {
+                if (!value.is_number())
+                {
+                    return false;
+                }
+            }
+            else if constexpr (std::is_same_v<T, std::string>)
+            {
+                if (!value.is_string())
+                {
+                    return false;
+                }
+            }
+
+            return set(layer, value.template get<T>());
+        }
+
+        void reset(Layer layer) override
+        {
+            if (layer != Layer::kDefault)
+            {
+                m_values[static_cast<size_t>(layer)].reset();
+                update();
+            }
+        }
+
+        // The callback is called each time the value used changes, not when it is set to the same value again.
+        SubscriptionId subscribe(Callback callback)
+        {
+            m_subscribers.emplace_back(m_nextSubscriptionId, std::move(callback));
+            return m_nextSubscriptionId++;
+        }
+
+        void unsubscribe(SubscriptionId id)
+        {
+            std::erase_if(m_subscribers, [id](const auto &subscriber) { return subscriber.first == id; });
+        }
+
+    private:
+        void update()
+        {
+            for (size_t layer = static_cast<size_t>(Layer::kCount); layer-- > 0;)
+            {
+                if (m_values[layer].has_value())
+                {
+                    m_layer = static_cast<Layer>(layer);
+                    break;
+                }
+            }
+
+            const T &value = *m_values[static_cast<size_t>(m_layer)];
+            if (value == m_value)
+            {
+                return;
+            }
+
+            m_value = value;
+            logChange(m_value);
+
+            // Copied, so a callback can subscribe or unsubscribe.
+            auto subscribers = m_subscribers;
+            for (const auto &subscriber : subscribers)
+            {
+                subscriber.second(m_value);
+            }
+        }
+
+        T m_value;
+        std::optional<T> m_values[static_cast<size_t>(Layer::kCount)];
+        Validate m_validate;
+        std::vector<std::pair<SubscriptionId, Callback>> m_subscribers;
+        SubscriptionId m_nextSubscriptionId{ 1 };
+    };
+
+    // Null if there is no setting with this name.
+    SettingBase *findSetting(std::string_view name);
+
+    // Sets the file layer of the settings from a JSON object of setting names and values. The settings the file
+    // doesn't have, or all of them if there is no file, go back to the values of their other layers. Returns false,
+    // leaving the settings as they were, if the file isn't a valid JSON object.
+    bool readFile(const char *filePath);
+
+    // Reads the file and reads it again each time update() sees it was saved.
+    void init(const char *filePath);
+    void deinit();
+    void update();
+
     // SLI-Pro brightness percentage [0 - 100].
-    extern unsigned int brightness;
+    extern Setting<unsigned int> brightness;
 
     // Output high-frequency timing log.
-    extern bool debugTiming;
+    extern Setting<bool> debugTiming;
+
+    // Run plugins in SliProSuperPro.PluginHost.exe rather than in our own process. Used from the next start when
+    // changed while running.
+    extern Setting<bool> isolatePlugins;
+
+    // Use the shift points plugins report as they are, even when they also report the engine's torque curve or RPMs
+    // were learned from driving the car.
+    extern Setting<bool> pluginShiftPoints;
 } // namespace config
@@ -55,11 +55,20 @@ void DeviceManager::init()
 
     m_sliPro = new SLIProDevice();
     m_sliPro->init();
+
+    // The brightness is set when the device opens, and again when it is changed while it is open.
+    m_brightnessSubscription = config::brightness.subscribe([this](unsigned int brightness) {
+        if (m_sliPro->isOpen())
+        {
+            m_sliPro->setBrightness(brightness);
+        }
+    });
 }
 
 void DeviceManager::deinit()
 {
     TimingManager::getSingleton().unregisterUpdateable(this);
+    config::brightness.unsubscribe(m_brightnessSubscription);
 
     if (m_sliPro->isOpen())
     {
@@ -57,4 +57,5 @@ private:
     SLIProDevice *m_sliPro = nullptr;
     time_point m_openedTime = {};
     State m_state = State::kIdle;
+    int m_brightnessSubscription = 0;
 };
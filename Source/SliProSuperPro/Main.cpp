@@ -35,6 +35,7 @@
 
 std::atomic<bool> g_programShouldExit = false;
 constexpr DWORD kProgramCloseTimeoutMs = 2000;
+const char *kConfigFileName = "SliProSuperPro.Config.json";
 
 BOOL consoleCtrlHandler(DWORD ctrlType)
 {
@@ -73,6 +74,7 @@ int main(int argc, char *argv[])
         return EXIT_FAILURE;
     }
 
+    config::init(kConfigFileName);
     TimingManager::getSingleton().init();
     PluginManager::getSingleton().init();
     ProcessManager::getSingleton().init();
@@ -82,6 +84,7 @@ int main(int argc, char *argv[])
 
     while (!g_programShouldExit.load())
     {
+        config::update();
         TimingManager::getSingleton().run();
     }
 
@@ -93,6 +96,7 @@ int main(int argc, char *argv[])
     ProcessManager::getSingleton().deinit();
     PluginManager::getSingleton().deinit();
     TimingManager::getSingleton().deinit();
+    config::deinit();
     LogManager::getSingleton().deinit();
 
     return EXIT_SUCCESS;
@@ -18,9 +18,17 @@
 // with SliProSuperPro. If not, see <http://www.gnu.org/licenses/>.
 //
 
+#include <cstring>
+#include <string>
+
 #include "Physics.h"
 #include "Telemetry.h"
 #include "Plugin.h"
+#include "Config.h"
+#include "Log.h"
+
+const char *kCalibrationFileName = "SliProSuperPro.Calibration.json";
+const char *kPhysicsCacheFileName = "SliProSuperPro.Physics.cache";
 
 PhysicsManager &PhysicsManager::getSingleton()
 {
@@ -39,13 +47,26 @@ PhysicsManager::~PhysicsManager()
 void PhysicsManager::init()
 {
     memset(&m_physicsData, 0, sizeof(m_physicsData));
+    memset(m_calibratedCarId, 0, sizeof(m_calibratedCarId));
+    m_physicsCache.init(kPhysicsCacheFileName);
+    m_rpmCalibrator.init(kCalibrationFileName);
     TimingManager::getSingleton().registerUpdateable(this);
+
+    // The physics data is adjusted in place, so it is fetched again to be adjusted with the new setting. Plugins that
+    // report it every frame have it fetched again anyway.
+    m_pluginShiftPointsSubscription = config::pluginShiftPoints.subscribe([this](bool) {
+        m_isPhysicsDataPending = m_hasPhysicsData;
+    });
 }
 
 void PhysicsManager::deinit()
 {
     TimingManager::getSingleton().unregisterUpdateable(this);
+    config::pluginShiftPoints.unsubscribe(m_pluginShiftPointsSubscription);
+    m_rpmCalibrator.deinit();
+    m_physicsCache.deinit();
     m_hasPhysicsData = false;
+    m_isPhysicsDataCached = false;
 }
 
 void PhysicsManager::update(timing::seconds deltaTimeSecs)
@@ -56,22 +77,104 @@ void PhysicsManager::update(timing::seconds deltaTimeSecs)
         return;
     }
 
-    if (activePlugin->getPhysicsDataEveryFrame())
+    PluginManager &pluginManager = PluginManager::getSingleton();
+
+    // The last values belong to another game.
+    if (activePlugin != m_plugin)
+    {
+        m_plugin = activePlugin;
+        m_hasPhysicsData = false;
+        m_isPhysicsDataCached = false;
+        m_wasReceivingTelemetry = false;
+    }
+
+    // A reloaded plugin may compute different physics data. Fetch it again once telemetry is received.
+    if (pluginManager.getReloadCount() != m_reloadCount)
+    {
+        m_reloadCount = pluginManager.getReloadCount();
+        m_wasReceivingTelemetry = false;
+    }
+
+    if (pluginManager.getPhysicsDataEveryFrame())
     {
-        m_hasPhysicsData = activePlugin->getPhysicsData(&m_physicsData, sizeof(m_physicsData));
+        m_hasPhysicsData = pluginManager.getPhysicsData(&m_physicsData, sizeof(m_physicsData));
+        adjustPhysicsData();
     }
     else
     {
-        if (!m_wasReceivingTelemetry && TelemetryManager::getSingleton().isReceivingTelemetry())
+        bool isReceivingTelemetry = TelemetryManager::getSingleton().isReceivingTelemetry();
+        if (!m_wasReceivingTelemetry && isReceivingTelemetry)
+        {
+            m_isPhysicsDataPending = true;
+        }
+        m_wasReceivingTelemetry = isReceivingTelemetry;
+
+        // The plugin's physics data changed while telemetry was received.
+        int physicsGeneration = TelemetryManager::getSingleton().getTelemetryData().physicsGeneration;
+        if (isReceivingTelemetry && physicsGeneration != m_physicsGeneration)
         {
-            m_wasReceivingTelemetry = true;
-            m_hasPhysicsData = activePlugin->getPhysicsData(&m_physicsData, sizeof(m_physicsData));
+            m_physicsGeneration = physicsGeneration;
+            m_isPhysicsDataPending = true;
         }
-        else if (!TelemetryManager::getSingleton().isReceivingTelemetry())
+
+        // Asked again every frame until the plugin has it, which is a cheap check in plugins that are still loading.
+        if (m_isPhysicsDataPending && isReceivingTelemetry)
         {
-            m_wasReceivingTelemetry = false;
+            plugin::PhysicsData physicsData{};
+            if (pluginManager.getPhysicsData(&physicsData, sizeof(physicsData)))
+            {
+                m_physicsData = physicsData;
+                m_hasPhysicsData = true;
+                m_isPhysicsDataPending = false;
+                m_isPhysicsDataCached = false;
+                m_physicsCache.store(activePlugin->gameExecFileName, physicsData);
+                adjustPhysicsData();
+            }
+            else if (!m_hasPhysicsData)
+            {
+                const std::string &game = activePlugin->gameExecFileName;
+                const plugin::PhysicsData *cachedPhysicsData = m_physicsCache.findLastCar(game);
+                if (cachedPhysicsData != nullptr)
+                {
+                    LOG_INFO("Using the cached physics data of %.*s until %s has its own", plugin::kMaxCarIdLength,
+                             cachedPhysicsData->carId, game.c_str());
+                    m_physicsData = *cachedPhysicsData;
+                    m_hasPhysicsData = true;
+                    m_isPhysicsDataCached = true;
+                    adjustPhysicsData();
+                }
+            }
         }
-    }    
+    }
+
+    // The car driven may not be the cached one.
+    if (m_hasPhysicsData && !m_isPhysicsDataCached && TelemetryManager::getSingleton().isReceivingTelemetry())
+    {
+        m_rpmCalibrator.addSample(TelemetryManager::getSingleton().getTelemetryData(), deltaTimeSecs.count());
+    }
+}
+
+void PhysicsManager::adjustPhysicsData()
+{
+    if (!m_hasPhysicsData)
+    {
+        return;
+    }
+
+    // Cars are still learned when the plugin's values are used, so they are known if that changes.
+    if (strncmp(m_calibratedCarId, m_physicsData.carId, plugin::kMaxCarIdLength) != 0)
+    {
+        memcpy(m_calibratedCarId, m_physicsData.carId, sizeof(m_calibratedCarId));
+        m_rpmCalibrator.selectCar(std::string(m_calibratedCarId, strnlen(m_calibratedCarId, plugin::kMaxCarIdLength)));
+    }
+    if (config::pluginShiftPoints)
+    {
+        return;
+    }
+
+    // The solver uses the learned RPM limit, and its upshifts win over the learned ones when there is a torque curve.
+    m_rpmCalibrator.apply(m_physicsData);
+    m_shiftPointSolver.apply(m_physicsData);
 }
 
 bool PhysicsManager::hasPhysicsData() const
@@ -22,6 +22,11 @@
 
 #include "Timing.h"
 #include "PluginInterface.h"
+#include "ShiftPointSolver.h"
+#include "RpmCalibrator.h"
+#include "PhysicsCache.h"
+
+struct Plugin;
 
 class PhysicsManager : public Updateable
 {
@@ -40,7 +45,24 @@ public:
     const plugin::PhysicsData &getPhysicsData() const;
 
 private:
+    void adjustPhysicsData();
+
     bool m_hasPhysicsData = false;
     bool m_wasReceivingTelemetry = false;
+
+    // Plugins that load physics in the background return none until it is loaded. The last values are kept meanwhile,
+    // or the cached ones of the car last driven in the game when there are none yet.
+    bool m_isPhysicsDataPending = false;
+    bool m_isPhysicsDataCached = false;
+    const Plugin *m_plugin = nullptr;
+    unsigned int m_reloadCount = 0;
+    int m_physicsGeneration = 0;
+    int m_pluginShiftPointsSubscription = 0;
     plugin::PhysicsData m_physicsData{};
+    PhysicsCache m_physicsCache;
+    RpmCalibrator m_rpmCalibrator;
+
+    // The car selected in m_rpmCalibrator, compared without making a string of the car id every frame.
+    char m_calibratedCarId[plugin::kMaxCarIdLength]{};
+    ShiftPointSolver m_shiftPointSolver;
 };
\ No newline at end of file
@@ -0,0 +1,203 @@
+//
+// SliProSuperPro
+// A Shift Light Indicator controller
+// Copyright 2025 Fixfactory
+//
+// This file is part of SliProSuperPro.
+//
+// SliProSuperPro is free software: you can redistribute it and/or modify it under
+// the terms of the GNU General Public License as published by the Free
+// Software Foundation, either version 3 of the License, or any later version.
+//
+// SliProSuperPro is distributed in the hope that it will be useful, but WITHOUT
+// ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+// FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+// more details.
+//
+// You should have received a copy of the GNU General Public License along
+// with SliProSuperPro. If not, see <http://www.gnu.org/licenses/>.
+//
+
+#include <cstring>
+#include <filesystem>
+
+#include "PhysicsCache.h"
+#include "BinaryFile.h"
+#include "Log.h"
+
+static const char kFileMagic[4] = { 'S', 'P', 'P', 'C' };
+static const uint32_t kFileVersion = 2;
+
+// PhysicsData changes with the plugin interface, even when its size doesn't.
+static const uint32_t kRecordVersion = plugin::kInterfaceVersion;
+
+// Over the whole physics data. PhysicsData has no padding, and plugins clear it before filling it in.
+static uint64_t hashPhysics(const plugin::PhysicsData &physicsData)
+{
+    return binaryFile::hash(&physicsData, sizeof(physicsData));
+}
+
+PhysicsCache::PhysicsCache()
+{
+}
+
+PhysicsCache::~PhysicsCache()
+{
+}
+
+void PhysicsCache::init(const std::string &filePath)
+{
+    m_filePath = filePath;
+    m_fileRecords = nullptr;
+    m_fileRecordCount = 0;
+    m_newRecords.clear();
+
+    if (!std::filesystem::exists(m_filePath) || !m_file.open(m_filePath))
+    {
+        return;
+    }
+
+    if (!binaryFile::checkHeader(m_filePath, m_file.getData(), m_file.getSize(),
+                                 binaryFile::makeHeader(kFileMagic, kFileVersion, sizeof(Record), kRecordVersion)))
+    {
+        m_file.close();
+        return;
+    }
+
+    BinaryFileHeader header{};
+    memcpy(&header, m_file.getData(), sizeof(header));
+
+    // Mappings are page aligned, and the header keeps the records 8-byte aligned after it.
+    static_assert(sizeof(BinaryFileHeader) % alignof(Record) == 0);
+    m_fileRecords = reinterpret_cast<const Record *>(m_file.getData() + sizeof(header));
+    m_fileRecordCount = header.recordCount;
+    LOG_INFO("Mapped the physics data of %zu cars from %s", m_fileRecordCount, m_filePath.c_str());
+}
+
+void PhysicsCache::deinit()
+{
+    if (!m_newRecords.empty())
+    {
+        write();
+    }
+
+    m_fileRecords = nullptr;
+    m_fileRecordCount = 0;
+    m_file.close();
+    m_newRecords.clear();
+}
+
+const plugin::PhysicsData *PhysicsCache::findLastCar(const std::string &gameExecFileName) const
+{
+    const Record *record = findLastRecord(gameExecFileName);
+    return record ? &record->physicsData : nullptr;
+}
+
+void PhysicsCache::store(const std::string &gameExecFileName, const plugin::PhysicsData &physicsData)
+{
+    if (physicsData.carId[0] == '\0' || gameExecFileName.empty() || gameExecFileName.size() >= kMaxGameNameLength)
+    {
+        return;
+    }
+
+    uint64_t hash = hashPhysics(physicsData);
+    const Record *lastRecord = findLastRecord(gameExecFileName);
+    if (lastRecord && lastRecord->hash == hash &&
+        strncmp(lastRecord->physicsData.carId, physicsData.carId, plugin::kMaxCarIdLength) == 0)
+    {
+        return;
+    }
+
+    Record record;
+    memset(&record, 0, sizeof(record));
+    memcpy(record.gameExecFileName, gameExecFileName.c_str(), gameExecFileName.size());
+    record.hash = hash;
+    record.physicsData = physicsData;
+
+    // Only the newest record of a car is kept.
+    std::erase_if(m_newRecords, [&record](const Record &newRecord) { return isSameCar(newRecord, record); });
+    m_newRecords.push_back(record);
+}
+
+size_t PhysicsCache::getCarCount() const
+{
+    size_t carCount = m_newRecords.size();
+    for (size_t i = 0; i < m_fileRecordCount; i++)
+    {
+        carCount += isReplaced(m_fileRecords[i]) ? 0 : 1;
+    }
+    return carCount;
+}
+
+bool PhysicsCache::isSameCar(const Record &record, const Record &otherRecord)
+{
+    return strncmp(record.gameExecFileName, otherRecord.gameExecFileName, kMaxGameNameLength) == 0 &&
+           strncmp(record.physicsData.carId, otherRecord.physicsData.carId, plugin::kMaxCarIdLength) == 0;
+}
+
+bool PhysicsCache::isReplaced(const Record &fileRecord) const
+{
+    for (const Record &newRecord : m_newRecords)
+    {
+        if (isSameCar(fileRecord, newRecord))
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+const PhysicsCache::Record *PhysicsCache::findLastRecord(const std::string &gameExecFileName) const
+{
+    for (auto it = m_newRecords.rbegin(); it != m_newRecords.rend(); ++it)
+    {
+        if (strncmp(it->gameExecFileName, gameExecFileName.c_str(), kMaxGameNameLength) == 0)
+        {
+            return &*it;
+        }
+    }
+
+    for (size_t i = m_fileRecordCount; i > 0; i--)
+    {
+        const Record &record = m_fileRecords[i - 1];
+        if (strncmp(record.gameExecFileName, gameExecFileName.c_str(), kMaxGameNameLength) == 0)
+        {
+            return &record;
+        }
+    }
+    return nullptr;
+}
+
+void PhysicsCache::write()
+{
+    BinaryFileHeader header = binaryFile::makeHeader(kFileMagic, kFileVersion, sizeof(Record), kRecordVersion);
+
+    // The records of the old file that weren't stored again come first, so each game's last car stays last.
+    std::vector<char> file(sizeof(header));
+    auto append = [&file, &header](const Record &record) {
+        const char *data = reinterpret_cast<const char *>(&record);
+        file.insert(file.end(), data, data + sizeof(record));
+        header.recordCount++;
+    };
+
+    for (size_t i = 0; i < m_fileRecordCount; i++)
+    {
+        if (!isReplaced(m_fileRecords[i]))
+        {
+            append(m_fileRecords[i]);
+        }
+    }
+
+    for (const Record &newRecord : m_newRecords)
+    {
+        append(newRecord);
+    }
+    memcpy(file.data(), &header, sizeof(header));
+
+    // The old file can't be replaced while it is mapped.
+    m_fileRecords = nullptr;
+    m_fileRecordCount = 0;
+    m_file.close();
+
+    binaryFile::write(m_filePath, file);
+}
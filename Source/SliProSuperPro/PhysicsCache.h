@@ -0,0 +1,76 @@
+//
+// SliProSuperPro
+// A Shift Light Indicator controller
+// Copyright 2025 Fixfactory
+//
+// This file is part of SliProSuperPro.
+//
+// SliProSuperPro is free software: you can redistribute it and/or modify it under
+// the terms of the GNU General Public License as published by the Free
+// Software Foundation, either version 3 of the License, or any later version.
+//
+// SliProSuperPro is distributed in the hope that it will be useful, but WITHOUT
+// ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+// FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+// more details.
+//
+// You should have received a copy of the GNU General Public License along
+// with SliProSuperPro. If not, see <http://www.gnu.org/licenses/>.
+//
+
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "PluginInterface.h"
+#include "MappedFile.h"
+
+// Remembers the physics data plugins reported for each car, by game and car id, so the car last driven in a game has
+// its values as soon as its telemetry arrives, while the plugin is still loading its own.
+// The file is memory-mapped when SliProSuperPro starts and its records are only ever read in place. Cars reported
+// since are kept in memory, and the file is written again on exit when one of them is new or changed.
+class PhysicsCache
+{
+public:
+    PhysicsCache();
+    ~PhysicsCache();
+
+    void init(const std::string &filePath);
+
+    // Writes the file if needed.
+    void deinit();
+
+    // The physics data last stored for a game, or nullptr. Valid until the next call to store().
+    const plugin::PhysicsData *findLastCar(const std::string &gameExecFileName) const;
+
+    // Cheap when the car is already the game's last one with the same values. Cars without an id aren't stored.
+    void store(const std::string &gameExecFileName, const plugin::PhysicsData &physicsData);
+
+    size_t getCarCount() const;
+
+private:
+    static constexpr size_t kMaxGameNameLength = 64;
+
+    // Stored as is in the file, which is dropped when the plugin interface version changes.
+    struct Record
+    {
+        char gameExecFileName[kMaxGameNameLength];
+        uint64_t hash;
+        plugin::PhysicsData physicsData;
+    };
+
+    std::string m_filePath;
+    MappedFile m_file;
+    const Record *m_fileRecords{ nullptr };
+    size_t m_fileRecordCount{ 0 };
+
+    // In the order they were stored, like in the file. The last record of a game is its last car.
+    std::vector<Record> m_newRecords;
+
+    static bool isSameCar(const Record &record, const Record &otherRecord);
+    bool isReplaced(const Record &fileRecord) const;
+    const Record *findLastRecord(const std::string &gameExecFileName) const;
+    void write();
+};
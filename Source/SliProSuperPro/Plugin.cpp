@@ -21,11 +21,24 @@
 #include <Windows.h>
 #include <string>
 #include <filesystem>
+#include <fstream>
+#include <algorithm>
 
 #include "Plugin.h"
+#include "StaticPlugins.h"
+#include "Config.h"
 #include "Log.h"
 #include "StringHelper.h"
 
+// Caches what we learned from each plugin library so they don't all have to be loaded at startup.
+const char *kManifestFileName = "SliProSuperPro.Plugins.json";
+constexpr int kManifestVersion = 1;
+
+const timing::seconds kLatencyReportInterval{ 5.f };
+
+// Libraries are usually written in several steps. Give the copy time to complete before reloading.
+const timing::seconds kReloadDelay{ 1.f };
+
 PluginManager &PluginManager::getSingleton()
 {
     static PluginManager s_singleton;
@@ -42,18 +55,56 @@ PluginManager::~PluginManager()
 
 void PluginManager::init()
 {
+    // Plugins can't move in or out of the plugin host while they run.
+    m_isolatePlugins = config::isolatePlugins;
+    m_isolatePluginsSubscription = config::isolatePlugins.subscribe([](bool) {
+        LOG_WARN("isolatePlugins is used the next time SliProSuperPro starts");
+    });
+
     TimingManager::getSingleton().registerUpdateable(this);
     loadPlugins();
+
+    // Watch the plugin directory so updated libraries can be reloaded without restarting.
+    std::wstring path{ string::convertToWide(m_execPath.c_str()) };
+    m_changeNotification = FindFirstChangeNotification(
+        path.c_str(), FALSE, FILE_NOTIFY_CHANGE_FILE_NAME | FILE_NOTIFY_CHANGE_SIZE | FILE_NOTIFY_CHANGE_LAST_WRITE);
+    if (m_changeNotification == INVALID_HANDLE_VALUE)
+    {
+        LOG_WARN("Could not watch %s for plugin updates", m_execPath.c_str());
+    }
 }
 
 void PluginManager::deinit()
 {
+    config::isolatePlugins.unsubscribe(m_isolatePluginsSubscription);
+
+    if (m_changeNotification != INVALID_HANDLE_VALUE)
+    {
+        FindCloseChangeNotification(m_changeNotification);
+        m_changeNotification = INVALID_HANDLE_VALUE;
+    }
+
     unloadPlugins();
+
+    std::error_code error;
+    std::filesystem::remove_all(std::filesystem::path(m_execPath) / plugin::kShadowDirectoryName, error);
+
     TimingManager::getSingleton().unregisterUpdateable(this);
 }
 
 void PluginManager::update(timing::seconds deltaTimeSecs)
 {
+    watchPlugins();
+
+    if (m_activePlugin != nullptr && isIsolated(m_activePlugin))
+    {
+        m_pluginHost.update();
+    }
+
+    if (config::debugTiming)
+    {
+        reportLatency();
+    }
 }
 
 const PluginManager::PluginList &PluginManager::getPluginList()
@@ -61,9 +112,74 @@ const PluginManager::PluginList &PluginManager::getPluginList()
     return m_plugins;
 }
 
-void PluginManager::setActivePlugin(const Plugin *plugin)
+bool PluginManager::activatePlugin(Plugin *plugin, const std::string &gamePath)
 {
+    if (m_activePlugin != nullptr)
+    {
+        deactivatePlugin();
+    }
+
+    if (plugin->staticIndex >= 0)
+    {
+        StaticPlugins::setGameIsRunning(plugin->staticIndex, true, gamePath);
+        m_activePlugin = plugin;
+        m_activeGamePath = gamePath;
+        return true;
+    }
+
+    if (!createShadowCopy(plugin))
+    {
+        return false;
+    }
+
+    if (m_isolatePlugins)
+    {
+        if (!m_pluginHost.start(plugin->shadowPath, gamePath))
+        {
+            deleteShadowCopy(plugin);
+            return false;
+        }
+    }
+    else
+    {
+        if (!loadLibrary(plugin))
+        {
+            deleteShadowCopy(plugin);
+            return false;
+        }
+
+        plugin->setGameIsRunning(true, gamePath);
+    }
+
     m_activePlugin = plugin;
+    m_activeGamePath = gamePath;
+    return true;
+}
+
+void PluginManager::deactivatePlugin()
+{
+    if (m_activePlugin == nullptr)
+    {
+        return;
+    }
+
+    if (m_activePlugin->staticIndex >= 0)
+    {
+        StaticPlugins::setGameIsRunning(m_activePlugin->staticIndex, false, "");
+    }
+    else if (m_isolatePlugins)
+    {
+        m_pluginHost.stop();
+    }
+    else
+    {
+        m_activePlugin->setGameIsRunning(false, "");
+        unloadLibrary(m_activePlugin);
+    }
+
+    deleteShadowCopy(m_activePlugin);
+    m_activePlugin = nullptr;
+    m_activeGamePath.clear();
 }
 
 const Plugin *PluginManager::getActivePlugin() const
@@ -71,141 +187,553 @@ const Plugin *PluginManager::getActivePlugin() const
     return m_activePlugin;
 }
 
+unsigned int PluginManager::getReloadCount() const
+{
+    return m_reloadCount;
+}
+
+bool PluginManager::getTelemetryData(plugin::TelemetryData *outTelemetryData, size_t telemetryDataSize)
+{
+    if (m_activePlugin == nullptr)
+    {
+        return false;
+    }
+
+    if (isIsolated(m_activePlugin))
+    {
+        bool result = m_pluginHost.getTelemetryData(outTelemetryData, telemetryDataSize);
+        if (result && config::debugTiming)
+        {
+            timing::seconds latency = m_pluginHost.getLastFrameLatency();
+            m_latencySum += latency;
+            m_latencyMax = std::max<timing::seconds>(m_latencyMax, latency);
+            m_latencyFrameCount++;
+        }
+        return result;
+    }
+
+    auto before = std::chrono::steady_clock::now();
+    int staticIndex = m_activePlugin->staticIndex;
+    bool result = staticIndex >= 0 ? StaticPlugins::getTelemetryData(staticIndex, outTelemetryData, telemetryDataSize)
+                                   : m_activePlugin->getTelemetryData(outTelemetryData, telemetryDataSize);
+    if (result && config::debugTiming)
+    {
+        timing::seconds latency = std::chrono::steady_clock::now() - before;
+        m_latencySum += latency;
+        m_latencyMax = std::max<timing::seconds>(m_latencyMax, latency);
+        m_latencyFrameCount++;
+    }
+    return result;
+}
+
+bool PluginManager::getPhysicsData(plugin::PhysicsData *outPhysicsData, size_t physicsDataSize)
+{
+    if (m_activePlugin == nullptr)
+    {
+        return false;
+    }
+
+    if (m_activePlugin->staticIndex >= 0)
+    {
+        return StaticPlugins::getPhysicsData(m_activePlugin->staticIndex, outPhysicsData, physicsDataSize);
+    }
+
+    if (isIsolated(m_activePlugin))
+    {
+        return m_pluginHost.getPhysicsData(outPhysicsData, physicsDataSize);
+    }
+
+    return m_activePlugin->getPhysicsData(outPhysicsData, physicsDataSize);
+}
+
+bool PluginManager::getPhysicsDataEveryFrame()
+{
+    if (m_activePlugin == nullptr)
+    {
+        return false;
+    }
+
+    if (m_activePlugin->staticIndex >= 0)
+    {
+        return StaticPlugins::getPhysicsDataEveryFrame(m_activePlugin->staticIndex);
+    }
+
+    if (isIsolated(m_activePlugin))
+    {
+        return m_pluginHost.getPhysicsDataEveryFrame();
+    }
+
+    return m_activePlugin->getPhysicsDataEveryFrame();
+}
+
+bool PluginManager::isIsolated(const Plugin *plugin) const
+{
+    // Plugins linked into the executable always run in-process.
+    return m_isolatePlugins && plugin->staticIndex < 0;
+}
+
+void PluginManager::reportLatency()
+{
+    // Compares the cost of fetching telemetry in-process with the added latency of the plugin host.
+    auto time = std::chrono::steady_clock::now();
+    if (time - m_lastLatencyReportTime < kLatencyReportInterval)
+    {
+        return;
+    }
+
+    if (m_latencyFrameCount > 0)
+    {
+        LOG_INFO("Plugin latency (%s): avg %.3f ms, max %.3f ms over %i frames",
+                 m_isolatePlugins ? "plugin host" : "in-process",
+                 m_latencySum.count() * 1000.f / m_latencyFrameCount, m_latencyMax.count() * 1000.f,
+                 m_latencyFrameCount);
+    }
+
+    m_lastLatencyReportTime = time;
+    m_latencySum = timing::seconds{ 0.f };
+    m_latencyMax = timing::seconds{ 0.f };
+    m_latencyFrameCount = 0;
+}
+
 void PluginManager::loadPlugins()
 {
     // Get the path of our executable. We'll search for plugin DLLs in the same directory.
     wchar_t buf[MAX_PATH];
     GetModuleFileName(nullptr, buf, MAX_PATH);
-    std::string execPath{ string::convertFromWide(buf) };
+    m_execPath = string::convertFromWide(buf);
 
-    size_t pos = execPath.rfind("\\");
+    size_t pos = m_execPath.rfind("\\");
     if (pos != std::string::npos)
     {
-        execPath.erase(pos, execPath.length() - pos);
+        m_execPath.erase(pos, m_execPath.length() - pos);
     }
 
+    // Remove shadow copies left behind if we didn't exit cleanly.
+    std::error_code error;
+    std::filesystem::remove_all(std::filesystem::path(m_execPath) / plugin::kShadowDirectoryName, error);
+
+    readManifest();
+
     // Iterate over all DLLs matching our naming convention for plugins.
-    for (const auto &entry : std::filesystem::directory_iterator(execPath))
+    for (const auto &entry : std::filesystem::directory_iterator(m_execPath))
     {
         if (!entry.is_regular_file())
             continue;
 
-        size_t pos = entry.path().string().rfind(".Plugin.dll");
+        size_t pos = entry.path().string().rfind(std::string(".Plugin") + DynamicLibrary::kExtension);
         if (pos == std::string::npos)
             continue;
 
         Plugin *plugin = new Plugin();
         plugin->libraryPath = entry.path().string();
+        plugin->libraryWriteTime = entry.last_write_time().time_since_epoch().count();
+        plugin->librarySize = entry.file_size();
 
-        std::wstring path{ string::convertToWide(entry.path().string().c_str()) };
-        plugin->library = LoadLibrary(path.c_str());
-        if (!plugin->library)
+        if (findInManifest(plugin))
         {
-            LOG_ERROR("Could not load the library %s", entry.path().filename().string().c_str());
-            delete plugin;
+            LOG_INFO("Found plugin %s for %s", entry.path().filename().string().c_str(),
+                     plugin->gameExecFileName.c_str());
+            m_plugins.push_back(plugin);
             continue;
         }
 
-        GetPluginInterfaceVersion getPluginInterfaceVersion =
-            (GetPluginInterfaceVersion)GetProcAddress(plugin->library, "getPluginInterfaceVersion");
-
-        if (!getPluginInterfaceVersion)
+        // The library is new or has changed since it was last seen.
+        if (!probePlugin(plugin))
         {
-            LOG_ERROR("Could not locate the function getPluginInterfaceVersion()");
-            FreeLibrary(plugin->library);
+            LOG_ERROR("Could not load the plugin %s", entry.path().filename().string().c_str());
             delete plugin;
             continue;
         }
 
-        plugin->interfaceVersion = getPluginInterfaceVersion();
-        LOG_INFO("Plugin interface version: %i", plugin->interfaceVersion);
+        LOG_INFO("Found plugin %s for %s", entry.path().filename().string().c_str(),
+                 plugin->gameExecFileName.c_str());
+        m_plugins.push_back(plugin);
+    }
 
-        SupportsInterfaceVersion supportsInterfaceVersion =
-            (SupportsInterfaceVersion)GetProcAddress(plugin->library, "supportsInterfaceVersion");
+    writeManifest();
+    loadStaticPlugins();
+}
 
-        if (!supportsInterfaceVersion)
+void PluginManager::loadStaticPlugins()
+{
+    for (int i = 0; i < StaticPlugins::kCount; i++)
+    {
+        std::string name = StaticPlugins::getName(i);
+
+        // A library with the same name replaces the plugin linked into the executable.
+        std::string fileName = name + DynamicLibrary::kExtension;
+        bool replaced = std::find_if(m_plugins.begin(), m_plugins.end(), [&fileName](const Plugin *plugin) {
+                            return std::filesystem::path(plugin->libraryPath).filename().string() == fileName;
+                        }) != m_plugins.end();
+        if (replaced)
         {
-            LOG_ERROR("Could not locate the function supportsInterfaceVersion()");
-            FreeLibrary(plugin->library);
-            delete plugin;
+            LOG_INFO("Using %s instead of the built-in plugin", fileName.c_str());
             continue;
         }
 
-        if (!supportsInterfaceVersion(plugin::kInterfaceVersion))
+        if (!StaticPlugins::supportsInterfaceVersion(i, plugin::kInterfaceVersion))
         {
-            LOG_ERROR("Plugin does not support our interface version %i", plugin::kInterfaceVersion);
-            FreeLibrary(plugin->library);
-            delete plugin;
+            LOG_ERROR("Built-in plugin %s does not support our interface version %i", name.c_str(),
+                      plugin::kInterfaceVersion);
             continue;
         }
 
-        GetGameExecFileName getGameExecFileName =
-            (GetGameExecFileName)GetProcAddress(plugin->library, "getGameExecFileName");
+        Plugin *plugin = new Plugin();
+        plugin->staticIndex = i;
+        plugin->libraryPath = name;
+        plugin->interfaceVersion = StaticPlugins::getPluginInterfaceVersion(i);
+        StaticPlugins::getGameExecFileName(i, plugin->gameExecFileName);
+
+        LOG_INFO("Found built-in plugin %s for %s", name.c_str(), plugin->gameExecFileName.c_str());
+        m_plugins.push_back(plugin);
+    }
+}
+
+void PluginManager::unloadPlugins()
+{
+    for (auto &plugin : m_plugins)
+    {
+        unloadLibrary(plugin);
+        deleteShadowCopy(plugin);
+        delete plugin;
+    }
+    m_plugins.clear();
+}
+
+bool PluginManager::probePlugin(Plugin *plugin)
+{
+    // Load the library once to validate it and find out which game it supports, then unload it until that game is
+    // running.
+    if (!createShadowCopy(plugin))
+    {
+        return false;
+    }
+
+    bool loaded = loadLibrary(plugin);
+    unloadLibrary(plugin);
+    deleteShadowCopy(plugin);
+
+    if (!loaded)
+    {
+        return false;
+    }
+
+    addToManifest(plugin);
+    return true;
+}
+
+bool PluginManager::loadLibrary(Plugin *plugin)
+{
+    const std::string &loadPath = plugin->shadowPath.empty() ? plugin->libraryPath : plugin->shadowPath;
+    return plugin->load(loadPath);
+}
+
+void PluginManager::unloadLibrary(Plugin *plugin)
+{
+    plugin->unload();
+}
+
+bool PluginManager::createShadowCopy(Plugin *plugin)
+{
+    // Each copy gets its own directory so a new version can be loaded while the previous one is still in use.
+    std::filesystem::path libraryPath(plugin->libraryPath);
+    std::filesystem::path directory =
+        std::filesystem::path(m_execPath) / plugin::kShadowDirectoryName / std::to_string(++m_shadowCount);
+    std::filesystem::path shadowPath = directory / libraryPath.filename();
+
+    std::error_code error;
+    std::filesystem::create_directories(directory, error);
+    if (!error)
+    {
+        std::filesystem::copy_file(libraryPath, shadowPath, std::filesystem::copy_options::overwrite_existing, error);
+    }
+
+    if (error)
+    {
+        LOG_ERROR("Could not copy %s to %s: %s", plugin->libraryPath.c_str(), shadowPath.string().c_str(),
+                  error.message().c_str());
+        return false;
+    }
+
+    plugin->shadowPath = shadowPath.string();
+    return true;
+}
+
+void PluginManager::deleteShadowCopy(Plugin *plugin)
+{
+    if (plugin->shadowPath.empty())
+    {
+        return;
+    }
+
+    // Failures are ignored. Whatever remains is removed on exit.
+    std::error_code error;
+    std::filesystem::remove_all(std::filesystem::path(plugin->shadowPath).parent_path(), error);
+    plugin->shadowPath.clear();
+}
+
+void PluginManager::watchPlugins()
+{
+    if (m_changeNotification == INVALID_HANDLE_VALUE)
+    {
+        return;
+    }
+
+    auto time = std::chrono::steady_clock::now();
+    if (WaitForSingleObject(m_changeNotification, 0) == WAIT_OBJECT_0)
+    {
+        if (!m_reloadPending)
+        {
+            m_reloadPending = true;
+            m_changeTime = time;
+        }
+        FindNextChangeNotification(m_changeNotification);
+    }
+
+    if (m_reloadPending && time - m_changeTime >= kReloadDelay)
+    {
+        m_reloadPending = false;
+        reloadChangedPlugins();
+    }
+}
 
-        if (!getGameExecFileName)
+void PluginManager::reloadChangedPlugins()
+{
+    try
+    {
+        for (const auto &entry : std::filesystem::directory_iterator(m_execPath))
         {
-            LOG_ERROR("Could not locate the function getGameExecFileName()");
-            FreeLibrary(plugin->library);
-            delete plugin;
-            continue;
+            if (!entry.is_regular_file())
+                continue;
+
+            size_t pos = entry.path().string().rfind(std::string(".Plugin") + DynamicLibrary::kExtension);
+            if (pos == std::string::npos)
+                continue;
+
+            std::string libraryPath = entry.path().string();
+            long long writeTime = entry.last_write_time().time_since_epoch().count();
+            unsigned long long size = entry.file_size();
+
+            auto it = std::find_if(m_plugins.begin(), m_plugins.end(), [&libraryPath](const Plugin *plugin) {
+                return plugin->libraryPath == libraryPath;
+            });
+
+            if (it == m_plugins.end())
+            {
+                Plugin *plugin = new Plugin();
+                plugin->libraryPath = libraryPath;
+                plugin->libraryWriteTime = writeTime;
+                plugin->librarySize = size;
+
+                // A library that fails to load may still be being written. It is tried again on the next change.
+                if (!probePlugin(plugin))
+                {
+                    delete plugin;
+                    continue;
+                }
+
+                LOG_INFO("Found plugin %s for %s", entry.path().filename().string().c_str(),
+                         plugin->gameExecFileName.c_str());
+                m_plugins.push_back(plugin);
+            }
+            else if ((*it)->libraryWriteTime != writeTime || (*it)->librarySize != size)
+            {
+                if (reloadPlugin(*it, writeTime, size))
+                {
+                    LOG_INFO("Reloaded plugin %s", entry.path().filename().string().c_str());
+                }
+            }
         }
+    }
+    catch (const std::exception &exception)
+    {
+        LOG_ERROR(exception);
+    }
 
-        getGameExecFileName(plugin->gameExecFileName);
+    writeManifest();
+}
 
-        plugin->setGameIsRunning = (SetGameIsRunning)GetProcAddress(plugin->library, "setGameIsRunning");
+bool PluginManager::reloadPlugin(Plugin *plugin, long long writeTime, unsigned long long size)
+{
+    Plugin reloaded;
+    reloaded.libraryPath = plugin->libraryPath;
+    reloaded.libraryWriteTime = writeTime;
+    reloaded.librarySize = size;
 
-        if (!plugin->setGameIsRunning)
+    if (plugin != m_activePlugin)
+    {
+        if (!probePlugin(&reloaded))
         {
-            LOG_ERROR("Could not locate the function setGameIsRunning()");
-            FreeLibrary(plugin->library);
-            delete plugin;
-            continue;
+            return false;
         }
 
-        plugin->getTelemetryData = (GetTelemetryData)GetProcAddress(plugin->library, "getTelemetryData");
+        *plugin = reloaded;
+        return true;
+    }
+
+    // Load the new version next to the one in use, then swap them. This runs between frames so the other managers
+    // only ever see one version. The new version is told the game is running so it picks up where the other left off.
+    if (!createShadowCopy(&reloaded))
+    {
+        return false;
+    }
+
+    if (!loadLibrary(&reloaded))
+    {
+        deleteShadowCopy(&reloaded);
+        return false;
+    }
+
+    if (m_isolatePlugins)
+    {
+        // The library was only loaded to validate it. The plugin host loads it in its own process.
+        unloadLibrary(&reloaded);
+        m_pluginHost.stop();
+    }
+    else
+    {
+        plugin->setGameIsRunning(false, "");
+        unloadLibrary(plugin);
+    }
+
+    deleteShadowCopy(plugin);
+    *plugin = reloaded;
+    addToManifest(plugin);
+    m_reloadCount++;
 
-        if (!plugin->getTelemetryData)
+    if (m_isolatePlugins)
+    {
+        if (!m_pluginHost.start(plugin->shadowPath, m_activeGamePath))
         {
-            LOG_ERROR("Could not locate the function getTelemetryData()");
-            FreeLibrary(plugin->library);
-            delete plugin;
-            continue;
+            LOG_ERROR("Could not restart the plugin host for %s", plugin->libraryPath.c_str());
+            deactivatePlugin();
+            return false;
         }
+    }
+    else
+    {
+        plugin->setGameIsRunning(true, m_activeGamePath);
+    }
 
-        plugin->getPhysicsData = (GetPhysicsData)GetProcAddress(plugin->library, "getPhysicsData");
+    return true;
+}
+
+void PluginManager::readManifest()
+{
+    m_manifest = json::object();
+    m_manifestChanged = false;
 
-        if (!plugin->getPhysicsData)
+    std::ifstream file(m_execPath + "\\" + kManifestFileName);
+    if (file.good())
+    {
+        try
         {
-            LOG_ERROR("Could not locate the function getPhysicsData()");
-            FreeLibrary(plugin->library);
-            delete plugin;
-            continue;
+            m_manifest = json::parse(file);
+
+            // Discard the cache if it was written for another version of the manifest or of the plugin interface.
+            if (!m_manifest.is_object() || m_manifest.value("version", 0) != kManifestVersion ||
+                m_manifest.value("interfaceVersion", 0) != plugin::kInterfaceVersion ||
+                !m_manifest["plugins"].is_object())
+            {
+                m_manifest = json::object();
+            }
+        }
+        catch (const std::exception &exception)
+        {
+            LOG_WARN("Ignoring invalid %s", kManifestFileName);
+            LOG_ERROR(exception);
+            m_manifest = json::object();
         }
+    }
 
-        plugin->getPhysicsDataEveryFrame = (GetPhysicsDataEveryFrame)GetProcAddress(plugin->library, "getPhysicsDataEveryFrame");
+    if (m_manifest.empty())
+    {
+        m_manifest["version"] = kManifestVersion;
+        m_manifest["interfaceVersion"] = plugin::kInterfaceVersion;
+        m_manifest["plugins"] = json::object();
+        m_manifestChanged = true;
+    }
+}
 
-        if (!plugin->getPhysicsDataEveryFrame)
+void PluginManager::writeManifest()
+{
+    // Forget about libraries that were deleted since the manifest was written.
+    auto &plugins = m_manifest["plugins"];
+    for (auto it = plugins.begin(); it != plugins.end();)
+    {
+        bool found = std::find_if(m_plugins.begin(), m_plugins.end(), [&it](const Plugin *plugin) {
+                         return plugin->libraryPath == it.key();
+                     }) != m_plugins.end();
+        if (found)
         {
-            LOG_ERROR("Could not locate the function getPhysicsDataEveryFrame()");
-            FreeLibrary(plugin->library);
-            delete plugin;
-            continue;
+            ++it;
+        }
+        else
+        {
+            it = plugins.erase(it);
+            m_manifestChanged = true;
         }
+    }
 
-        m_plugins.push_back(plugin);
+    if (!m_manifestChanged)
+    {
+        return;
     }
+
+    std::ofstream file(m_execPath + "\\" + kManifestFileName, std::ios::out | std::ios::trunc);
+    if (!file.good())
+    {
+        LOG_WARN("Could not write %s", kManifestFileName);
+        return;
+    }
+
+    file << m_manifest.dump(4);
+    m_manifestChanged = false;
 }
 
-void PluginManager::unloadPlugins()
+void PluginManager::addToManifest(const Plugin *plugin)
 {
-    for (auto &plugin : m_plugins)
+    json manifestEntry;
+    manifestEntry["path"] = plugin->libraryPath;
+    manifestEntry["writeTime"] = plugin->libraryWriteTime;
+    manifestEntry["size"] = plugin->librarySize;
+    manifestEntry["interfaceVersion"] = plugin->interfaceVersion;
+    manifestEntry["gameExecFileName"] = plugin->gameExecFileName;
+    m_manifest["plugins"][plugin->libraryPath] = manifestEntry;
+    m_manifestChanged = true;
+}
+
+bool PluginManager::findInManifest(Plugin *plugin) const
+{
+    const auto &plugins = m_manifest.at("plugins");
+    auto it = plugins.find(plugin->libraryPath);
+    if (it == plugins.end() || !it->is_object())
     {
-        if (plugin->library != nullptr)
+        return false;
+    }
+
+    try
+    {
+        // The entry is only valid if the library wasn't modified since it was cached.
+        if (it->value("writeTime", 0LL) != plugin->libraryWriteTime || it->value("size", 0ULL) != plugin->librarySize)
         {
-            FreeLibrary(plugin->library);
+            return false;
         }
 
-        delete plugin;
+        std::string gameExecFileName = it->value("gameExecFileName", "");
+        if (gameExecFileName.empty())
+        {
+            return false;
+        }
+
+        plugin->interfaceVersion = it->value("interfaceVersion", 0);
+        plugin->gameExecFileName = gameExecFileName;
+        return true;
     }
-    m_plugins.clear();
+    catch (const std::exception &exception)
+    {
+        LOG_ERROR(exception);
+    }
+
+    return false;
 }
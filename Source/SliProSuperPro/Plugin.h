@@ -25,26 +25,20 @@
 #include <vector>
 
 #include "Timing.h"
-#include "PluginInterface.h"
+#include "PluginLibrary.h"
+#include "PluginHost.h"
 
-typedef int(__stdcall *GetPluginInterfaceVersion)();
-typedef bool(__stdcall *SupportsInterfaceVersion)(int);
-typedef void(__stdcall *GetGameExecFileName)(std::string &);
-typedef void(__stdcall *SetGameIsRunning)(bool, std::string);
-typedef bool(__stdcall *GetTelemetryData)(plugin::TelemetryData *, size_t);
-typedef bool(__stdcall *GetPhysicsData)(plugin::PhysicsData *, size_t);
-typedef bool(__stdcall *GetPhysicsDataEveryFrame)();
+#include "json/json.hpp"
+using json = nlohmann::json;
 
-struct Plugin
+struct Plugin : PluginLibrary
 {
-    HINSTANCE library{ nullptr };
+    // Index in StaticPlugins for a plugin linked into the executable, or -1 for a plugin library.
+    int staticIndex{ -1 };
     std::string libraryPath{};
-    int interfaceVersion{ 0 };
-    std::string gameExecFileName{};
-    SetGameIsRunning setGameIsRunning{ nullptr };
-    GetTelemetryData getTelemetryData{ nullptr };
-    GetPhysicsData getPhysicsData{ nullptr };
-    GetPhysicsDataEveryFrame getPhysicsDataEveryFrame{ nullptr };
+    std::string shadowPath{};
+    long long libraryWriteTime{ 0 };
+    unsigned long long librarySize{ 0 };
 };
 
 class PluginManager : public Updateable
@@ -63,13 +57,66 @@ public:
     using PluginList = std::vector<Plugin *>;
     const PluginList &getPluginList();
 
-    void setActivePlugin(const Plugin *plugin);
+    // Loads the plugin library and notifies the plugin that its game is running.
+    bool activatePlugin(Plugin *plugin, const std::string &gamePath);
+
+    // Notifies the active plugin that its game closed and unloads its library.
+    void deactivatePlugin();
+
     const Plugin *getActivePlugin() const;
 
+    // Incremented every time the active plugin is replaced by a newer version of its library.
+    unsigned int getReloadCount() const;
+
+    // Calls into the active plugin, either in-process or through the plugin host.
+    bool getTelemetryData(plugin::TelemetryData *outTelemetryData, size_t telemetryDataSize);
+    bool getPhysicsData(plugin::PhysicsData *outPhysicsData, size_t physicsDataSize);
+    bool getPhysicsDataEveryFrame();
+
 private:
     void loadPlugins();
+    void loadStaticPlugins();
     void unloadPlugins();
+    bool probePlugin(Plugin *plugin);
+
+    bool loadLibrary(Plugin *plugin);
+    void unloadLibrary(Plugin *plugin);
+
+    bool createShadowCopy(Plugin *plugin);
+    void deleteShadowCopy(Plugin *plugin);
+
+    void watchPlugins();
+    void reloadChangedPlugins();
+    bool reloadPlugin(Plugin *plugin, long long writeTime, unsigned long long size);
+
+    void readManifest();
+    void writeManifest();
+    bool findInManifest(Plugin *plugin) const;
+    void addToManifest(const Plugin *plugin);
+
+    std::string m_execPath;
+    json m_manifest;
+    bool m_manifestChanged{ false };
+
+    bool isIsolated(const Plugin *plugin) const;
+    void reportLatency();
 
     PluginList m_plugins;
-    const Plugin *m_activePlugin{ nullptr };
+    Plugin *m_activePlugin{ nullptr };
+    std::string m_activeGamePath;
+    PluginHostClient m_pluginHost;
+    bool m_isolatePlugins{ false };
+    int m_isolatePluginsSubscription{ 0 };
+
+    using time_point = std::chrono::steady_clock::time_point;
+    HANDLE m_changeNotification{ INVALID_HANDLE_VALUE };
+    bool m_reloadPending{ false };
+    time_point m_changeTime{};
+    unsigned int m_shadowCount{ 0 };
+    unsigned int m_reloadCount{ 0 };
+
+    time_point m_lastLatencyReportTime{};
+    timing::seconds m_latencySum{ 0.f };
+    timing::seconds m_latencyMax{ 0.f };
+    int m_latencyFrameCount{ 0 };
 };
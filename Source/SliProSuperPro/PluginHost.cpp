@@ -0,0 +1,278 @@
+//
+// SliProSuperPro
+// A Shift Light Indicator controller
+// Copyright 2025 Fixfactory
+//
+// This file is part of SliProSuperPro.
+//
+// SliProSuperPro is free software: you can redistribute it and/or modify it under
+// the terms of the GNU General Public License as published by the Free
+// Software Foundation, either version 3 of the License, or any later version.
+//
+// SliProSuperPro is distributed in the hope that it will be useful, but WITHOUT
+// ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+// FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+// more details.
+//
+// You should have received a copy of the GNU General Public License along
+// with SliProSuperPro. If not, see <http://www.gnu.org/licenses/>.
+//
+
+#include <Windows.h>
+#include <string>
+#include <sstream>
+
+#include "PluginHost.h"
+#include "Log.h"
+#include "StringHelper.h"
+
+const std::chrono::duration<float> kHostTimeout{ 3.f };
+const std::chrono::duration<float> kRestartInterval{ 2.f };
+constexpr DWORD kStopTimeoutMs = 1000;
+constexpr DWORD kFrameWaitMs = 1;
+
+PluginHostClient::PluginHostClient()
+{
+}
+
+PluginHostClient::~PluginHostClient()
+{
+    stop();
+}
+
+bool PluginHostClient::start(const std::string &libraryPath, const std::string &gamePath)
+{
+    if (m_started)
+    {
+        stop();
+    }
+
+    DWORD pid = GetCurrentProcessId();
+    if (!m_sharedMemory.open(pluginHost::getRingName(pid), sizeof(pluginHost::Ring)))
+    {
+        LOG_ERROR("Could not create the plugin host shared memory");
+        return false;
+    }
+    m_ring = reinterpret_cast<pluginHost::Ring *>(m_sharedMemory.getBuffer());
+
+    // Auto-reset event signaled by the host every time it publishes a frame.
+    m_event = CreateEventA(nullptr, FALSE, FALSE, pluginHost::getEventName(pid).c_str());
+    if (m_event == nullptr)
+    {
+        LOG_ERROR("Could not create the plugin host event");
+        m_sharedMemory.close();
+        m_ring = nullptr;
+        return false;
+    }
+
+    m_libraryPath = libraryPath;
+    m_gamePath = gamePath;
+
+    if (!startProcess())
+    {
+        stop();
+        return false;
+    }
+
+    m_started = true;
+    return true;
+}
+
+void PluginHostClient::stop()
+{
+    m_started = false;
+    stopProcess(true);
+
+    if (m_event != nullptr)
+    {
+        CloseHandle(m_event);
+        m_event = nullptr;
+    }
+
+    m_sharedMemory.close();
+    m_ring = nullptr;
+}
+
+void PluginHostClient::update()
+{
+    if (!m_started)
+    {
+        return;
+    }
+
+    auto time = std::chrono::steady_clock::now();
+    if (m_processInfo.hProcess == nullptr)
+    {
+        // The host failed and is waiting to be restarted.
+        if (time - m_lastStartTime > kRestartInterval)
+        {
+            startProcess();
+        }
+        return;
+    }
+
+    DWORD exitCode = 0;
+    if (GetExitCodeProcess(m_processInfo.hProcess, &exitCode) && exitCode != STILL_ACTIVE)
+    {
+        LOG_ERROR("Plugin host exited unexpectedly (exit code: %lu)", exitCode);
+        stopProcess(false);
+        return;
+    }
+
+    unsigned int heartbeat = m_ring->heartbeat.load();
+    if (heartbeat != m_lastHeartbeat)
+    {
+        m_lastHeartbeat = heartbeat;
+        m_lastHeartbeatTime = time;
+    }
+    else if (time - m_lastHeartbeatTime > kHostTimeout)
+    {
+        LOG_ERROR("Plugin host stopped responding");
+        stopProcess(false);
+    }
+}
+
+bool PluginHostClient::getTelemetryData(plugin::TelemetryData *outTelemetryData, size_t telemetryDataSize)
+{
+    if (m_ring == nullptr || m_processInfo.hProcess == nullptr)
+    {
+        return false;
+    }
+
+    if (!readFrames())
+    {
+        // Nothing new yet. Give the host a brief chance to publish this frame.
+        if (WaitForSingleObject(m_event, kFrameWaitMs) == WAIT_OBJECT_0)
+        {
+            readFrames();
+        }
+    }
+
+    if (m_hasTelemetryData && sizeof(m_telemetryData) >= telemetryDataSize)
+    {
+        memcpy(outTelemetryData, &m_telemetryData, telemetryDataSize);
+        return true;
+    }
+    return false;
+}
+
+bool PluginHostClient::getPhysicsData(plugin::PhysicsData *outPhysicsData, size_t physicsDataSize)
+{
+    if (m_ring == nullptr || m_processInfo.hProcess == nullptr)
+    {
+        return false;
+    }
+
+    readFrames();
+
+    if (m_physicsData.hasPhysicsData() && sizeof(plugin::PhysicsData) >= physicsDataSize)
+    {
+        memcpy(outPhysicsData, &m_physicsData.getPhysicsData(), physicsDataSize);
+        return true;
+    }
+    return false;
+}
+
+bool PluginHostClient::getPhysicsDataEveryFrame() const
+{
+    // Frames from the host already carry physics data whenever it changes.
+    return m_ring != nullptr && m_ring->physicsDataEveryFrame.load();
+}
+
+std::chrono::nanoseconds PluginHostClient::getLastFrameLatency() const
+{
+    return m_lastFrameLatency;
+}
+
+bool PluginHostClient::startProcess()
+{
+    m_ring->protocolVersion = pluginHost::kProtocolVersion;
+    m_ring->state.store((int)pluginHost::HostState::kStarting);
+    m_ring->heartbeat.store(0);
+    m_ring->physicsDataEveryFrame.store(false);
+    m_ring->readIndex.store(0);
+    m_ring->writeIndex.store(0);
+    ResetEvent(m_event);
+
+    m_hasTelemetryData = false;
+    m_physicsData.clear();
+    m_lastHeartbeat = 0;
+    m_lastStartTime = std::chrono::steady_clock::now();
+    m_lastHeartbeatTime = m_lastStartTime;
+
+    // The host executable is next to ours.
+    wchar_t buf[MAX_PATH];
+    GetModuleFileName(nullptr, buf, MAX_PATH);
+    std::string hostPath{ string::convertFromWide(buf) };
+    size_t pos = hostPath.rfind("\\");
+    if (pos != std::string::npos)
+    {
+        hostPath.erase(pos + 1, hostPath.length() - pos - 1);
+    }
+    hostPath += pluginHost::kExecFileName;
+
+    std::stringstream commandLine;
+    commandLine << '"' << hostPath << "\" --plugin \"" << m_libraryPath << "\" --controllerPid "
+                << GetCurrentProcessId() << " --gamePath \"" << m_gamePath << '"';
+    std::wstring wideCommandLine{ string::convertToWide(commandLine.str()) };
+
+    STARTUPINFOW startupInfo{};
+    startupInfo.cb = sizeof(startupInfo);
+    if (!CreateProcessW(nullptr, wideCommandLine.data(), nullptr, nullptr, FALSE, CREATE_NO_WINDOW, nullptr, nullptr,
+                        &startupInfo, &m_processInfo))
+    {
+        LOG_ERROR("Could not start %s (error: %lu)", hostPath.c_str(), GetLastError());
+        m_processInfo = {};
+        return false;
+    }
+
+    LOG_INFO("Started plugin host for %s (pid: %lu)", m_libraryPath.c_str(), m_processInfo.dwProcessId);
+    return true;
+}
+
+void PluginHostClient::stopProcess(bool graceful)
+{
+    if (m_processInfo.hProcess == nullptr)
+    {
+        return;
+    }
+
+    // Let the host notify the plugin that the game stopped, unless it already failed.
+    if (graceful)
+    {
+        m_ring->state.store((int)pluginHost::HostState::kStopRequested);
+    }
+
+    if (!graceful || WaitForSingleObject(m_processInfo.hProcess, kStopTimeoutMs) != WAIT_OBJECT_0)
+    {
+        TerminateProcess(m_processInfo.hProcess, EXIT_FAILURE);
+    }
+
+    CloseHandle(m_processInfo.hThread);
+    CloseHandle(m_processInfo.hProcess);
+    m_processInfo = {};
+
+    m_hasTelemetryData = false;
+    m_physicsData.clear();
+}
+
+bool PluginHostClient::readFrames()
+{
+    // Telemetry comes from the newest frame, but physics data may be in any of them.
+    long long fetchTimeNs = 0;
+    bool isPhysicsDataEveryFrame = m_ring->physicsDataEveryFrame.load();
+    int frameCount = pluginHost::readFrames(*m_ring, [&](const pluginHost::Frame &frame) {
+        m_hasTelemetryData = frame.hasTelemetryData;
+        m_telemetryData = frame.telemetryData;
+        m_physicsData.add(frame, isPhysicsDataEveryFrame);
+        fetchTimeNs = frame.fetchTimeNs;
+    });
+    if (frameCount == 0)
+    {
+        return false;
+    }
+
+    auto now = std::chrono::steady_clock::now().time_since_epoch();
+    m_lastFrameLatency = std::chrono::duration_cast<std::chrono::nanoseconds>(now) - std::chrono::nanoseconds(fetchTimeNs);
+    return true;
+}
@@ -0,0 +1,75 @@
+//
+// SliProSuperPro
+// A Shift Light Indicator controller
+// Copyright 2025 Fixfactory
+//
+// This file is part of SliProSuperPro.
+//
+// SliProSuperPro is free software: you can redistribute it and/or modify it under
+// the terms of the GNU General Public License as published by the Free
+// Software Foundation, either version 3 of the License, or any later version.
+//
+// SliProSuperPro is distributed in the hope that it will be useful, but WITHOUT
+// ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+// FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+// more details.
+//
+// You should have received a copy of the GNU General Public License along
+// with SliProSuperPro. If not, see <http://www.gnu.org/licenses/>.
+//
+
+#pragma once
+
+#include <Windows.h>
+#include <string>
+#include <chrono>
+
+#include "SharedMemory.h"
+#include "PluginHostProtocol.h"
+
+// Runs the active plugin in SliProSuperPro.PluginHost.exe so a plugin that hangs or crashes can't take the controller
+// down with it. The host process is restarted when it exits or stops responding.
+class PluginHostClient
+{
+public:
+    PluginHostClient();
+    ~PluginHostClient();
+
+    bool start(const std::string &libraryPath, const std::string &gamePath);
+    void stop();
+
+    // Supervises the host process. Called once per frame.
+    void update();
+
+    bool getTelemetryData(plugin::TelemetryData *outTelemetryData, size_t telemetryDataSize);
+    bool getPhysicsData(plugin::PhysicsData *outPhysicsData, size_t physicsDataSize);
+    bool getPhysicsDataEveryFrame() const;
+
+    // Time elapsed between the host calling into the plugin and the controller receiving the newest frame.
+    std::chrono::nanoseconds getLastFrameLatency() const;
+
+private:
+    using time_point = std::chrono::steady_clock::time_point;
+
+    bool startProcess();
+    void stopProcess(bool graceful);
+    bool readFrames();
+
+    std::string m_libraryPath;
+    std::string m_gamePath;
+    bool m_started{ false };
+
+    SharedMemory m_sharedMemory;
+    pluginHost::Ring *m_ring{ nullptr };
+    HANDLE m_event{ nullptr };
+    PROCESS_INFORMATION m_processInfo{};
+
+    unsigned int m_lastHeartbeat{ 0 };
+    time_point m_lastHeartbeatTime{};
+    time_point m_lastStartTime{};
+
+    bool m_hasTelemetryData{ false };
+    plugin::TelemetryData m_telemetryData{};
+    pluginHost::ReceivedPhysicsData m_physicsData;
+    std::chrono::nanoseconds m_lastFrameLatency{ 0 };
+};
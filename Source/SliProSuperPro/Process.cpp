@@ -54,7 +54,7 @@ void ProcessManager::init()
 void ProcessManager::deinit()
 {
     m_gamePath.clear();
-    PluginManager::getSingleton().setActivePlugin(nullptr);
+    PluginManager::getSingleton().deactivatePlugin();
     TimingManager::getSingleton().unregisterUpdateable(this);
 }
 
@@ -81,9 +81,7 @@ void ProcessManager::update(timing::seconds deltaTimeSecs)
         else
         {
             LOG_INFO("Game closed");
-            activePlugin->setGameIsRunning(false, "");
-            activePlugin = nullptr;
-            PluginManager::getSingleton().setActivePlugin(nullptr);
+            PluginManager::getSingleton().deactivatePlugin();
             m_gamePath.clear();
         }
     }
@@ -91,18 +89,19 @@ void ProcessManager::update(timing::seconds deltaTimeSecs)
     // Check if any of the supported games is running.
     auto &plugins = PluginManager::getSingleton().getPluginList();
     DWORD pid = 0;
+    Plugin *runningPlugin = nullptr;
     for (auto &plugin : plugins)
     {
         pid = findProcessId(plugin->gameExecFileName);
         if (pid != 0)
         {
             LOG_INFO("Game running: %s (pid: %lu)", plugin->gameExecFileName.c_str(), pid);
-            activePlugin = plugin;
+            runningPlugin = plugin;
             break;
         }
     }
 
-    if (activePlugin == nullptr)
+    if (runningPlugin == nullptr)
     {
         // None of the supported games is running.
         return;
@@ -117,8 +116,11 @@ void ProcessManager::update(timing::seconds deltaTimeSecs)
     }
 
     LOG_INFO("Game path: %s", m_gamePath.c_str());
-    activePlugin->setGameIsRunning(true, m_gamePath);
-    PluginManager::getSingleton().setActivePlugin(activePlugin);
+    if (!PluginManager::getSingleton().activatePlugin(runningPlugin, m_gamePath))
+    {
+        LOG_ERROR("Could not activate the plugin %s", runningPlugin->libraryPath.c_str());
+        m_gamePath.clear();
+    }
 }
 
 const std::string &ProcessManager::getGamePath() const
@@ -0,0 +1,307 @@
+//
+// SliProSuperPro
+// A Shift Light Indicator controller
+// Copyright 2025 Fixfactory
+//
+// This file is part of SliProSuperPro.
+//
+// SliProSuperPro is free software: you can redistribute it and/or modify it under
+// the terms of the GNU General Public License as published by the Free
+// Software Foundation, either version 3 of the License, or any later version.
+//
+// SliProSuperPro is distributed in the hope that it will be useful, but WITHOUT
+// ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+// FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+// more details.
+//
+// You should have received a copy of the GNU General Public License along
+// with SliProSuperPro. If not, see <http://www.gnu.org/licenses/>.
+//
+
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+
+#include "RpmCalibrator.h"
+#include "Log.h"
+
+#include "json/json.hpp"
+using json = nlohmann::json;
+
+// Samples only count once the gear has been engaged this long, to skip the clutch slipping after a shift.
+static const float kMinGearTime = 0.5f;
+
+// Below this speed the clutch may be slipping.
+static const float kMinSpeedKph = 15.f;
+
+// Limiter peaks are at most this far apart in time and RPM. It takes this many of them in a row to be sure.
+static const float kMaxBounceInterval = 0.5f;
+static const float kBounceTolerance = 0.03f;
+static const int kMinBounceCount = 3;
+
+// What it takes for a learned value to replace the plugin's.
+static const int kMinLimiterPeakCount = 5;
+static const int kMinGearSampleCount = 60;
+
+// The limiter cuts the engine, so shifting right at it is too late.
+static const float kLimiterShiftFraction = 0.97f;
+
+// Older samples keep this much weight, so cars whose setup changed are learned again.
+static const int kMaxSampleCount = 10000;
+
+void RpmCalibrator::RunningMean::add(double value)
+{
+    count = std::min<int>(count + 1, kMaxSampleCount);
+    mean += (value - mean) / count;
+}
+
+RpmCalibrator::RpmCalibrator()
+{
+}
+
+RpmCalibrator::~RpmCalibrator()
+{
+}
+
+void RpmCalibrator::init(const std::string &filePath)
+{
+    m_writeTask.wait();
+    m_filePath = filePath;
+    m_cars.clear();
+    m_carId.clear();
+    m_car = nullptr;
+    m_hasProposal = false;
+    m_hasChanged = false;
+    read();
+}
+
+void RpmCalibrator::deinit()
+{
+    m_writeTask.wait();
+    if (m_hasChanged)
+    {
+        write();
+    }
+    m_writeTask.wait();
+    m_car = nullptr;
+    m_carId.clear();
+    m_hasProposal = false;
+}
+
+void RpmCalibrator::selectCar(const std::string &carId)
+{
+    if (carId == m_carId)
+    {
+        return;
+    }
+
+    // Saved here rather than while driving. A car changed while the last save is still being written is saved with
+    // the next one.
+    if (m_hasChanged && m_writeTask.isDone())
+    {
+        write();
+    }
+
+    m_carId = carId;
+    m_car = carId.empty() ? nullptr : &m_cars[carId];
+    resetSamples();
+    makeProposal();
+}
+
+void RpmCalibrator::addSample(const plugin::TelemetryData &telemetryData, float deltaTimeSecs)
+{
+    if (m_car == nullptr || deltaTimeSecs <= 0.f)
+    {
+        return;
+    }
+
+    float rpm = telemetryData.rpm;
+    int gear = telemetryData.gear;
+    if (gear != m_gear || gear < 2 || gear >= plugin::kMaxGearCount || rpm <= 0.f)
+    {
+        resetSamples();
+        m_gear = gear;
+        return;
+    }
+
+    m_gearTime += deltaTimeSecs;
+    m_timeSincePeak += deltaTimeSecs;
+    if (m_gearTime < kMinGearTime)
+    {
+        m_previousRpm = rpm;
+        return;
+    }
+    m_hasChanged = true;
+
+    if (telemetryData.speedKph >= kMinSpeedKph)
+    {
+        m_car->rpmPerKph[gear].add(rpm / telemetryData.speedKph);
+    }
+
+    // A peak is where the RPM stops rising. Peaks close together at about the same RPM are the limiter.
+    if (rpm < m_previousRpm && m_isRising)
+    {
+        float peakRpm = m_previousRpm;
+        bool isBounce = m_timeSincePeak <= kMaxBounceInterval &&
+                        std::abs(peakRpm - m_lastPeakRpm) <= m_lastPeakRpm * kBounceTolerance;
+        m_bounceCount = isBounce ? m_bounceCount + 1 : 0;
+        if (m_bounceCount >= kMinBounceCount)
+        {
+            m_car->limiterRpm.add(peakRpm);
+        }
+        m_lastPeakRpm = peakRpm;
+        m_timeSincePeak = 0.f;
+    }
+    if (rpm != m_previousRpm)
+    {
+        m_isRising = rpm > m_previousRpm;
+    }
+    m_previousRpm = rpm;
+}
+
+bool RpmCalibrator::apply(plugin::PhysicsData &physicsData) const
+{
+    if (!m_hasProposal)
+    {
+        return false;
+    }
+
+    // Without the limiter, the plugin's upshift RPMs are all there is to go by.
+    int gearCount = std::min<int>(physicsData.gearCount, plugin::kMaxGearCount);
+    if (m_proposal.rpmLimit > 0.f)
+    {
+        physicsData.rpmLimit = m_proposal.rpmLimit;
+        float maxUpshift = m_proposal.rpmLimit * kLimiterShiftFraction;
+        for (int gear = 2; gear < gearCount; gear++)
+        {
+            if (physicsData.rpmUpshift[gear] <= 0.f || physicsData.rpmUpshift[gear] > maxUpshift)
+            {
+                physicsData.rpmUpshift[gear] = maxUpshift;
+            }
+        }
+    }
+
+    for (int gear = 3; gear < gearCount; gear++)
+    {
+        if (m_proposal.upshiftDrop[gear] > 0.f)
+        {
+            physicsData.rpmDownshift[gear] = physicsData.rpmUpshift[gear - 1] * m_proposal.upshiftDrop[gear];
+        }
+    }
+    return true;
+}
+
+void RpmCalibrator::resetSamples()
+{
+    m_gear = 0;
+    m_gearTime = 0.f;
+    m_previousRpm = 0.f;
+    m_isRising = false;
+    m_lastPeakRpm = 0.f;
+    m_timeSincePeak = 0.f;
+    m_bounceCount = 0;
+}
+
+void RpmCalibrator::makeProposal()
+{
+    m_proposal = Proposal();
+    m_hasProposal = false;
+    if (m_car == nullptr)
+    {
+        return;
+    }
+
+    if (m_car->limiterRpm.count >= kMinLimiterPeakCount)
+    {
+        m_proposal.rpmLimit = (float)m_car->limiterRpm.mean;
+        m_hasProposal = true;
+    }
+
+    for (int gear = 3; gear < plugin::kMaxGearCount; gear++)
+    {
+        const RunningMean &previous = m_car->rpmPerKph[gear - 1];
+        const RunningMean &current = m_car->rpmPerKph[gear];
+        if (previous.count >= kMinGearSampleCount && current.count >= kMinGearSampleCount && previous.mean > 0.0 &&
+            current.mean < previous.mean)
+        {
+            m_proposal.upshiftDrop[gear] = (float)(current.mean / previous.mean);
+            m_hasProposal = true;
+        }
+    }
+
+    if (m_proposal.rpmLimit > 0.f)
+    {
+        LOG_INFO("Using the RPMs learned for %s, limit %.0f", m_carId.c_str(), m_proposal.rpmLimit);
+    }
+    else if (m_hasProposal)
+    {
+        LOG_INFO("Using the RPMs learned for %s, its limiter wasn't reached yet", m_carId.c_str());
+    }
+}
+
+void RpmCalibrator::read()
+{
+    std::ifstream file(m_filePath);
+    if (!file.good())
+    {
+        return;
+    }
+
+    json calibration = json::parse(file, nullptr, false);
+    if (calibration.is_discarded() || !calibration["cars"].is_object())
+    {
+        LOG_WARN("Ignoring %s, it is not valid", m_filePath.c_str());
+        return;
+    }
+
+    for (auto &[carId, carJson] : calibration["cars"].items())
+    {
+        Car &car = m_cars[carId];
+        car.limiterRpm.mean = carJson.value("limiterRpm", 0.0);
+        car.limiterRpm.count = carJson.value("limiterPeakCount", 0);
+
+        int gear = 0;
+        for (auto &gearJson : carJson["gears"])
+        {
+            if (gear < plugin::kMaxGearCount && gearJson.is_object())
+            {
+                car.rpmPerKph[gear].mean = gearJson.value("rpmPerKph", 0.0);
+                car.rpmPerKph[gear].count = gearJson.value("sampleCount", 0);
+            }
+            gear++;
+        }
+    }
+
+    LOG_INFO("Read the RPMs learned for %zu cars from %s", m_cars.size(), m_filePath.c_str());
+}
+
+void RpmCalibrator::write()
+{
+    json calibration;
+    calibration["cars"] = json::object();
+    for (const auto &[carId, car] : m_cars)
+    {
+        json carJson;
+        carJson["limiterRpm"] = car.limiterRpm.mean;
+        carJson["limiterPeakCount"] = car.limiterRpm.count;
+
+        // Gears are indexed like in plugin::PhysicsData: reverse is 0, neutral 1 and first gear 2.
+        carJson["gears"] = json::array();
+        for (const RunningMean &rpmPerKph : car.rpmPerKph)
+        {
+            carJson["gears"].push_back({ { "rpmPerKph", rpmPerKph.mean }, { "sampleCount", rpmPerKph.count } });
+        }
+        calibration["cars"][carId] = carJson;
+    }
+
+    m_writingFile = calibration.dump(4);
+    m_hasChanged = false;
+    m_writeTask.start([this]() {
+        std::ofstream file(m_filePath, std::ios::out | std::ios::trunc);
+        file << m_writingFile;
+        if (!file.good())
+        {
+            LOG_WARN("Could not write %s", m_filePath.c_str());
+        }
+    });
+}
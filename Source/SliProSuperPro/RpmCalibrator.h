@@ -0,0 +1,109 @@
+//
+// SliProSuperPro
+// A Shift Light Indicator controller
+// Copyright 2025 Fixfactory
+//
+// This file is part of SliProSuperPro.
+//
+// SliProSuperPro is free software: you can redistribute it and/or modify it under
+// the terms of the GNU General Public License as published by the Free
+// Software Foundation, either version 3 of the License, or any later version.
+//
+// SliProSuperPro is distributed in the hope that it will be useful, but WITHOUT
+// ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+// FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+// more details.
+//
+// You should have received a copy of the GNU General Public License along
+// with SliProSuperPro. If not, see <http://www.gnu.org/licenses/>.
+//
+
+#pragma once
+
+#include <string>
+#include <unordered_map>
+
+#include "PluginInterface.h"
+#include "BackgroundTask.h"
+
+// Learns two things about each car from the telemetry while it is driven, for the games that report wrong RPM values
+// or none: the rev limiter, from where the RPM bounces, and how far the RPM drops on each upshift, from the ratios
+// between gears. The highest RPM reached isn't taken as a limit, since drivers often shift well below it. Everything is
+// kept as running statistics, so the memory used per car is constant however long it is driven. What is learned is
+// saved in a JSON file and applied when the car is next selected, so the shift lights don't change while driving.
+class RpmCalibrator
+{
+public:
+    RpmCalibrator();
+    ~RpmCalibrator();
+
+    void init(const std::string &filePath);
+
+    // Saves what was learned, and waits for it to be written.
+    void deinit();
+
+    // Selects the car the following samples belong to, and what was learned about it so far for apply().
+    // Cheap when the car didn't change. An empty id selects no car.
+    void selectCar(const std::string &carId);
+
+    void addSample(const plugin::TelemetryData &telemetryData, float deltaTimeSecs);
+
+    // Replaces the RPM limit with the limiter learned, and the start of each gear's lights with the RPM the engine drops
+    // to when shifting up into it. Upshift RPMs the limiter wouldn't let the engine reach are lowered below it.
+    // Returns false if nothing is known about the car yet.
+    bool apply(plugin::PhysicsData &physicsData) const;
+
+private:
+    struct RunningMean
+    {
+        double mean{ 0.0 };
+        int count{ 0 };
+
+        void add(double value);
+    };
+
+    struct Car
+    {
+        // The peaks of the RPM bouncing off the limiter.
+        RunningMean limiterRpm;
+
+        // Constant in a gear while the clutch is engaged, so it gives the ratios between gears.
+        RunningMean rpmPerKph[plugin::kMaxGearCount];
+    };
+
+    struct Proposal
+    {
+        // 0 until the limiter has been seen often enough.
+        float rpmLimit{ 0.f };
+
+        // The RPM the engine drops to from rpmPerKph[gear] when shifting up from the previous gear, as a fraction.
+        float upshiftDrop[plugin::kMaxGearCount]{};
+    };
+
+    std::string m_filePath;
+    bool m_hasChanged{ false };
+    std::unordered_map<std::string, Car> m_cars;
+
+    // The file is written in the background, and only touched by the task while it runs.
+    BackgroundTask m_writeTask;
+    std::string m_writingFile;
+
+    std::string m_carId;
+    Car *m_car{ nullptr };
+    Proposal m_proposal;
+    bool m_hasProposal{ false };
+
+    // Follows the samples of the selected car.
+    int m_gear{ 0 };
+    float m_gearTime{ 0.f };
+    float m_previousRpm{ 0.f };
+    bool m_isRising{ false };
+    float m_lastPeakRpm{ 0.f };
+    float m_timeSincePeak{ 0.f };
+    int m_bounceCount{ 0 };
+
+    void read();
+    void write();
+    void resetSamples();
+    void makeProposal();
+};
@@ -0,0 +1,199 @@
+//
+// SliProSuperPro
+// A Shift Light Indicator controller
+// Copyright 2025 Fixfactory
+//
+// This file is part of SliProSuperPro.
+//
+// SliProSuperPro is free software: you can redistribute it and/or modify it under
+// the terms of the GNU General Public License as published by the Free
+// Software Foundation, either version 3 of the License, or any later version.
+//
+// SliProSuperPro is distributed in the hope that it will be useful, but WITHOUT
+// ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+// FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+// more details.
+//
+// You should have received a copy of the GNU General Public License along
+// with SliProSuperPro. If not, see <http://www.gnu.org/licenses/>.
+//
+
+#include <algorithm>
+#include <cstring>
+#include <string>
+
+#include "ShiftPointSolver.h"
+#include "BinaryFile.h"
+#include "Log.h"
+
+// The crossing is searched in steps of this size, then narrowed down by bisection.
+static const float kSearchStepRpm = 25.f;
+static const int kBisectionCount = 16;
+
+// Over the values the shift points are computed from.
+static uint64_t hashPhysics(const plugin::PhysicsData &physicsData)
+{
+    int pointCount = std::clamp<int>(physicsData.torqueCurvePointCount, 0, plugin::kMaxTorqueCurvePointCount);
+    uint64_t hash = binaryFile::hash(&physicsData.gearCount, sizeof(physicsData.gearCount));
+    hash = binaryFile::hash(&physicsData.rpmLimit, sizeof(physicsData.rpmLimit), hash);
+    hash = binaryFile::hash(physicsData.gearRatio, sizeof(physicsData.gearRatio), hash);
+    hash = binaryFile::hash(&pointCount, sizeof(pointCount), hash);
+    hash = binaryFile::hash(physicsData.torqueCurveRpm, pointCount * sizeof(float), hash);
+    return binaryFile::hash(physicsData.torqueCurveTorque, pointCount * sizeof(float), hash);
+}
+
+// Linear between the points, and flat beyond the ends.
+static float getTorque(const plugin::PhysicsData &physicsData, float rpm)
+{
+    const float *curveRpm = physicsData.torqueCurveRpm;
+    const float *curveTorque = physicsData.torqueCurveTorque;
+    int pointCount = physicsData.torqueCurvePointCount;
+
+    if (rpm <= curveRpm[0])
+    {
+        return curveTorque[0];
+    }
+    if (rpm >= curveRpm[pointCount - 1])
+    {
+        return curveTorque[pointCount - 1];
+    }
+
+    int i = (int)(std::upper_bound(curveRpm, curveRpm + pointCount, rpm) - curveRpm);
+    float t = (rpm - curveRpm[i - 1]) / (curveRpm[i] - curveRpm[i - 1]);
+    return curveTorque[i - 1] + t * (curveTorque[i] - curveTorque[i - 1]);
+}
+
+ShiftPointSolver::ShiftPointSolver()
+{
+}
+
+ShiftPointSolver::~ShiftPointSolver()
+{
+}
+
+bool ShiftPointSolver::apply(plugin::PhysicsData &physicsData)
+{
+    if (physicsData.torqueCurvePointCount < 2)
+    {
+        return false;
+    }
+
+    uint64_t hash = hashPhysics(physicsData);
+    auto it = m_cache.find(hash);
+    if (it == m_cache.end())
+    {
+        ShiftPoints shiftPoints{};
+        shiftPoints.isValid = solve(physicsData, shiftPoints.rpmDownshift, shiftPoints.rpmUpshift);
+        it = m_cache.emplace(hash, shiftPoints).first;
+
+        if (shiftPoints.isValid)
+        {
+            std::string upshifts;
+            for (int i = 2; i < plugin::kMaxGearCount; i++)
+            {
+                if (shiftPoints.rpmUpshift[i] > 0.f)
+                {
+                    upshifts += " " + std::to_string((int)shiftPoints.rpmUpshift[i]);
+                }
+            }
+            LOG_INFO("Computed the upshift RPMs from the torque curve:%s", upshifts.c_str());
+        }
+        else
+        {
+            LOG_WARN("Could not compute the shift points from the torque curve and gear ratios");
+        }
+    }
+
+    const ShiftPoints &shiftPoints = it->second;
+    if (!shiftPoints.isValid)
+    {
+        return false;
+    }
+
+    for (int i = 0; i < plugin::kMaxGearCount; i++)
+    {
+        if (shiftPoints.rpmDownshift[i] > 0.f)
+        {
+            physicsData.rpmDownshift[i] = shiftPoints.rpmDownshift[i];
+        }
+        if (shiftPoints.rpmUpshift[i] > 0.f)
+        {
+            physicsData.rpmUpshift[i] = shiftPoints.rpmUpshift[i];
+        }
+    }
+    return true;
+}
+
+bool ShiftPointSolver::solve(const plugin::PhysicsData &physicsData, float *outRpmDownshift, float *outRpmUpshift)
+{
+    memset(outRpmDownshift, 0, plugin::kMaxGearCount * sizeof(float));
+    memset(outRpmUpshift, 0, plugin::kMaxGearCount * sizeof(float));
+
+    int pointCount = physicsData.torqueCurvePointCount;
+    if (pointCount < 2 || pointCount > plugin::kMaxTorqueCurvePointCount)
+    {
+        return false;
+    }
+    for (int i = 1; i < pointCount; i++)
+    {
+        if (physicsData.torqueCurveRpm[i] <= physicsData.torqueCurveRpm[i - 1])
+        {
+            return false;
+        }
+    }
+
+    // Nothing is gained by shifting up below the torque peak, or above the rev limiter.
+    int peak = (int)(std::max_element(physicsData.torqueCurveTorque, physicsData.torqueCurveTorque + pointCount) -
+                     physicsData.torqueCurveTorque);
+    float minRpm = physicsData.torqueCurveRpm[peak];
+    float maxRpm =
+        physicsData.rpmLimit > 0.f ? physicsData.rpmLimit : physicsData.torqueCurveRpm[pointCount - 1];
+    if (maxRpm <= minRpm)
+    {
+        return false;
+    }
+
+    // Gear 0 is reverse and gear 1 neutral. The top gear has nothing to shift to.
+    int gearCount = std::min<int>(physicsData.gearCount, plugin::kMaxGearCount);
+    int solvedCount = 0;
+    for (int gear = 2; gear + 1 < gearCount; gear++)
+    {
+        float ratio = physicsData.gearRatio[gear];
+        float nextRatio = physicsData.gearRatio[gear + 1];
+        if (ratio <= 0.f || nextRatio <= 0.f || nextRatio >= ratio)
+        {
+            continue;
+        }
+
+        // Wheel torque is engine torque times the ratio, and the engine turns nextRatio / ratio as fast after the
+        // shift. The final drive is the same in both gears, so it cancels out.
+        float drop = nextRatio / ratio;
+        auto gain = [&](float rpm) {
+            return getTorque(physicsData, rpm * drop) * nextRatio - getTorque(physicsData, rpm) * ratio;
+        };
+
+        float rpmUpshift = maxRpm;
+        float low = minRpm;
+        for (float rpm = minRpm + kSearchStepRpm; low < maxRpm; rpm += kSearchStepRpm)
+        {
+            float high = std::min<float>(rpm, maxRpm);
+            if (gain(high) >= 0.f)
+            {
+                for (int i = 0; i < kBisectionCount; i++)
+                {
+                    float middle = (low + high) * 0.5f;
+                    (gain(middle) >= 0.f ? high : low) = middle;
+                }
+                rpmUpshift = high;
+                break;
+            }
+            low = high;
+        }
+
+        outRpmUpshift[gear] = rpmUpshift;
+        outRpmDownshift[gear + 1] = rpmUpshift * drop;
+        solvedCount++;
+    }
+
+    return solvedCount > 0;
+}
@@ -0,0 +1,54 @@
+//
+// SliProSuperPro
+// A Shift Light Indicator controller
+// Copyright 2025 Fixfactory
+//
+// This file is part of SliProSuperPro.
+//
+// SliProSuperPro is free software: you can redistribute it and/or modify it under
+// the terms of the GNU General Public License as published by the Free
+// Software Foundation, either version 3 of the License, or any later version.
+//
+// SliProSuperPro is distributed in the hope that it will be useful, but WITHOUT
+// ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+// FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+// more details.
+//
+// You should have received a copy of the GNU General Public License along
+// with SliProSuperPro. If not, see <http://www.gnu.org/licenses/>.
+//
+
+#pragma once
+
+#include <cstdint>
+#include <unordered_map>
+
+#include "PluginInterface.h"
+
+// Computes the shift points of the forward gears from the engine's torque curve and the gearbox ratios.
+// Shifting up is best at the RPM where the wheel torque in the next gear, at the RPM the engine drops to, overtakes the
+// wheel torque in the current gear. The next gear's lights then start at the RPM the engine drops to.
+class ShiftPointSolver
+{
+public:
+    ShiftPointSolver();
+    ~ShiftPointSolver();
+
+    // Replaces the shift points of the gears the ratios and torque curve cover. Returns false and leaves the data as
+    // it is if the plugin didn't provide them. The results are cached by car, i.e. by ratios and torque curve, so
+    // this is cheap enough for plugins that provide physics data every frame.
+    bool apply(plugin::PhysicsData &physicsData);
+
+    // Shift points of gears that can't be computed are left at 0. Doesn't log.
+    static bool solve(const plugin::PhysicsData &physicsData, float *outRpmDownshift, float *outRpmUpshift);
+
+private:
+    struct ShiftPoints
+    {
+        bool isValid;
+        float rpmDownshift[plugin::kMaxGearCount];
+        float rpmUpshift[plugin::kMaxGearCount];
+    };
+
+    std::unordered_map<uint64_t, ShiftPoints> m_cache;
+};
@@ -0,0 +1,113 @@
+//
+// SliProSuperPro
+// A Shift Light Indicator controller
+// Copyright 2025 Fixfactory
+//
+// This file is part of SliProSuperPro.
+//
+// SliProSuperPro is free software: you can redistribute it and/or modify it under
+// the terms of the GNU General Public License as published by the Free
+// Software Foundation, either version 3 of the License, or any later version.
+//
+// SliProSuperPro is distributed in the hope that it will be useful, but WITHOUT
+// ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+// FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+// more details.
+//
+// You should have received a copy of the GNU General Public License along
+// with SliProSuperPro. If not, see <http://www.gnu.org/licenses/>.
+//
+
+#pragma once
+
+#include <string>
+#include <type_traits>
+
+#include "PluginInterface.h"
+
+#ifdef SPSP_STATIC_PLUGINS
+    #include "iRacing.Plugin/Exports.h"
+    #include "LiveForSpeed.Plugin/Exports.h"
+    #include "RBR-NGP.Plugin/Exports.h"
+    #include "ATS.Plugin/Exports.h"
+    #include "ACC.Plugin/Exports.h"
+    #include "ACR.Plugin/Exports.h"
+#endif
+
+// Plugins linked into the executable, known at compile time. Calls are dispatched on the plugin's index in the list,
+// so each plugin's functions are called directly rather than through function pointers and can be inlined.
+template <typename... Plugins> struct StaticPluginList
+{
+    static constexpr int kCount = sizeof...(Plugins);
+
+    static const char *getName(int index)
+    {
+        const char *name = nullptr;
+        visit(index, [&](auto plugin) { name = decltype(plugin)::type::kName; });
+        return name;
+    }
+
+    static int getPluginInterfaceVersion(int index)
+    {
+        int version = 0;
+        visit(index, [&](auto plugin) { version = decltype(plugin)::type::getPluginInterfaceVersion(); });
+        return version;
+    }
+
+    static bool supportsInterfaceVersion(int index, int interfaceVersion)
+    {
+        bool result = false;
+        visit(index, [&](auto plugin) { result = decltype(plugin)::type::supportsInterfaceVersion(interfaceVersion); });
+        return result;
+    }
+
+    static void getGameExecFileName(int index, std::string &outExecFileName)
+    {
+        visit(index, [&](auto plugin) { decltype(plugin)::type::getGameExecFileName(outExecFileName); });
+    }
+
+    static void setGameIsRunning(int index, bool isRunning, const std::string &execPath)
+    {
+        visit(index, [&](auto plugin) { decltype(plugin)::type::setGameIsRunning(isRunning, execPath); });
+    }
+
+    static bool getTelemetryData(int index, plugin::TelemetryData *outTelemetryData, size_t telemetryDataSize)
+    {
+        bool result = false;
+        visit(index, [&](auto plugin) {
+            result = decltype(plugin)::type::getTelemetryData(outTelemetryData, telemetryDataSize);
+        });
+        return result;
+    }
+
+    static bool getPhysicsData(int index, plugin::PhysicsData *outPhysicsData, size_t physicsDataSize)
+    {
+        bool result = false;
+        visit(index, [&](auto plugin) {
+            result = decltype(plugin)::type::getPhysicsData(outPhysicsData, physicsDataSize);
+        });
+        return result;
+    }
+
+    static bool getPhysicsDataEveryFrame(int index)
+    {
+        bool result = false;
+        visit(index, [&](auto plugin) { result = decltype(plugin)::type::getPhysicsDataEveryFrame(); });
+        return result;
+    }
+
+private:
+    // Calls function with the std::type_identity of the plugin at index.
+    template <typename Function> static void visit(int index, Function &&function)
+    {
+        [[maybe_unused]] int i = 0;
+        ((i++ == index ? (function(std::type_identity<Plugins>{}), true) : false) || ...);
+    }
+};
+
+#ifdef SPSP_STATIC_PLUGINS
+using StaticPlugins = StaticPluginList<iracing::PluginExports, lfs::PluginExports, rbrNgp::PluginExports,
+                                       ats::PluginExports, acc::PluginExports, acr::PluginExports>;
+#else
+using StaticPlugins = StaticPluginList<>;
+#endif
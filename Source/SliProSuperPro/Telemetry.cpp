@@ -56,7 +56,8 @@ void TelemetryManager::update(timing::seconds deltaTimeSecs)
         return;
     }
 
-    m_receivingTelemetry = activePlugin->getTelemetryData(&m_telemetryData, sizeof(m_telemetryData));
+    m_receivingTelemetry =
+        PluginManager::getSingleton().getTelemetryData(&m_telemetryData, sizeof(m_telemetryData));
 }
 
 bool TelemetryManager::isReceivingTelemetry() const
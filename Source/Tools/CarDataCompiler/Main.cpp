@@ -0,0 +1,78 @@
+//
+// SliProSuperPro
+// A Shift Light Indicator controller
+// Copyright 2025 Fixfactory
+//
+// This file is part of SliProSuperPro.
+//
+// SliProSuperPro is free software: you can redistribute it and/or modify it under
+// the terms of the GNU General Public License as published by the Free
+// Software Foundation, either version 3 of the License, or any later version.
+//
+// SliProSuperPro is distributed in the hope that it will be useful, but WITHOUT
+// ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+// FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+// more details.
+//
+// You should have received a copy of the GNU General Public License along
+// with SliProSuperPro. If not, see <http://www.gnu.org/licenses/>.
+//
+
+#include <string>
+#include <vector>
+#include <string_view>
+#include <filesystem>
+#include <cstdio>
+#include <cstdlib>
+
+#include "Log.h"
+#include "CommandLine.h"
+#include "OverrideIndex.h"
+#include "CarData.h"
+
+// Returns false if the file exists and couldn't be compiled.
+template <typename Car>
+bool compile(const std::filesystem::path &dir, const char *fileName,
+             typename overrides::CarIndex<Car>::ParseCar parseCar)
+{
+    std::string filePath = (dir / fileName).string();
+    if (!std::filesystem::exists(filePath))
+    {
+        return true;
+    }
+
+    overrides::CarIndex<Car> cars;
+    std::string compiledFilePath = overrides::getCompiledFilePath(filePath);
+    if (!cars.parse(filePath, parseCar) || !cars.compile(filePath, compiledFilePath))
+    {
+        return false;
+    }
+
+    LOG_INFO("Compiled %zu cars into %s", cars.getCarCount(), compiledFilePath.c_str());
+    return true;
+}
+
+// Usage: CarDataCompiler [--dir [path]]
+// Compiles the overrides files found in a folder, the current one by default, into the .bin files the plugins map
+// instead of parsing them. A plugin parses its overrides file again as soon as it changes, so compile the files again
+// after editing them.
+int main(int argc, char *argv[])
+{
+    LogManager::getSingleton().init();
+
+    const std::vector<std::string_view> args(argv + 1, argv + argc);
+    std::filesystem::path dir(cmdLine::getOption(args, "--dir"));
+    if (dir.empty())
+    {
+        dir = ".";
+    }
+
+    bool isCompiled = true;
+    isCompiled &= compile<overrides::CarOverride>(dir, "ACC.Overrides.json", overrides::parseCarOverride);
+    isCompiled &= compile<overrides::CarOverride>(dir, "ACR.Overrides.json", overrides::parseCarOverride);
+    isCompiled &= compile<overrides::CarOverride>(dir, "iRacing.Overrides.json", overrides::parseShiftLightOverride);
+    isCompiled &= compile<lfs::Car>(dir, "LiveForSpeed.CarData.json", lfs::parseCar);
+
+    LogManager::getSingleton().deinit();
+    return isCompiled ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,222 @@
+//
+// SliProSuperPro
+// A Shift Light Indicator controller
+// Copyright 2025 Fixfactory
+//
+// This file is part of SliProSuperPro.
+//
+// SliProSuperPro is free software: you can redistribute it and/or modify it under
+// the terms of the GNU General Public License as published by the Free
+// Software Foundation, either version 3 of the License, or any later version.
+//
+// SliProSuperPro is distributed in the hope that it will be useful, but WITHOUT
+// ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+// FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+// more details.
+//
+// You should have received a copy of the GNU General Public License along
+// with SliProSuperPro. If not, see <http://www.gnu.org/licenses/>.
+//
+
+#include <string>
+#include <vector>
+#include <string_view>
+#include <fstream>
+#include <filesystem>
+#include <chrono>
+#include <thread>
+#include <cstdlib>
+
+#include "Log.h"
+#include "CommandLine.h"
+#include "Config.h"
+
+// Read like a setting, to compare the two.
+unsigned int g_plainBrightness = 75;
+
+void writeFile(const std::string &filePath, const char *contents)
+{
+    // Replaced in one step like editors do, so the file is never read half written.
+    std::string tempPath = filePath + ".tmp";
+    {
+        std::ofstream file(tempPath, std::ios::trunc);
+        file << contents;
+    }
+    std::filesystem::rename(tempPath, filePath);
+}
+
+double elapsedNs(std::chrono::steady_clock::time_point start)
+{
+    return std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+}
+
+int check(bool condition, const char *description)
+{
+    if (!condition)
+    {
+        LOG_ERROR("%s", description);
+        return 1;
+    }
+    return 0;
+}
+
+// Sets and resets each layer of a setting, and checks the value used and the notifications sent.
+int checkLayers()
+{
+    int errorCount = 0;
+    config::Setting<unsigned int> setting{ "setting", 10, [](const unsigned int &value) { return value <= 100; } };
+    std::vector<unsigned int> notifications;
+    config::SubscriptionId id = setting.subscribe([&notifications](unsigned int value) {
+        notifications.push_back(value);
+    });
+
+    errorCount += check(setting == 10u && setting.getLayer() == config::Layer::kDefault, "The default isn't used");
+
+    setting.set(config::Layer::kCommandLine, 30);
+    setting.set(config::Layer::kFile, 20);
+    errorCount += check(setting == 30u && setting.getLayer() == config::Layer::kCommandLine,
+                        "The file wins over the command line");
+
+    setting.set(config::Layer::kRuntime, 40);
+    errorCount += check(setting == 40u, "The runtime value isn't used");
+
+    errorCount += check(!setting.set(config::Layer::kRuntime, 101) && setting == 40u, "An invalid value was used");
+
+    setting.set(config::Layer::kRuntime, 40);
+    setting.reset(config::Layer::kRuntime);
+    setting.reset(config::Layer::kCommandLine);
+    errorCount += check(setting == 20u && setting.getLayer() == config::Layer::kFile,
+                        "Resetting layers doesn't go back to the file");
+
+    setting.reset(config::Layer::kDefault);
+    setting.reset(config::Layer::kFile);
+    errorCount += check(setting == 10u, "The default can be reset");
+
+    errorCount += check(notifications == std::vector<unsigned int>{ 30, 40, 30, 20, 10 },
+                        "Subscribers should be notified once per change");
+
+    setting.unsubscribe(id);
+    setting.set(config::Layer::kRuntime, 50);
+    errorCount += check(notifications.size() == 5, "An unsubscribed callback was called");
+    return errorCount;
+}
+
+// Calls update() every frame for up to a second, like the application. Returns true when the brightness changes.
+bool waitForBrightness(unsigned int brightness)
+{
+    for (int frame = 0; frame < 1000; frame++)
+    {
+        config::update();
+        if (config::brightness == brightness)
+        {
+            return true;
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    return false;
+}
+
+// Reads a config file with the command line options, then edits it while it is watched.
+int checkFile(const std::string &filePath, int iterationCount)
+{
+    int errorCount = 0;
+    writeFile(filePath, R"({ "brightness": 60, "pluginShiftPoints": true, "unknown": 1 })");
+
+    int brightnessNotificationCount = 0;
+    config::SubscriptionId id = config::brightness.subscribe([&](unsigned int) { brightnessNotificationCount++; });
+
+    char program[] = "ConfigSettings";
+    char option[] = "--isolatePlugins";
+    char *argv[] = { program, option };
+    errorCount += check(cmdLine::parseOptions(2, argv), "The command line options weren't parsed");
+
+    config::init(filePath.c_str());
+    errorCount += check(config::brightness == 60u && config::pluginShiftPoints && config::isolatePlugins &&
+                            !config::debugTiming,
+                        "The file wasn't read");
+    errorCount += check(config::readFile(filePath.c_str()), "Reading a valid file failed");
+
+    // Called every frame while the file is watched.
+    int frameCount = iterationCount / 100;
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < frameCount; i++)
+    {
+        config::update();
+    }
+    LOG_INFO("%-32s %8.1f ns", "config::update", elapsedNs(start) / frameCount);
+
+    writeFile(filePath, R"({ "brightness": 90, "isolatePlugins": false })");
+    errorCount += check(waitForBrightness(90), "The edited file wasn't read again");
+    errorCount += check(!config::pluginShiftPoints, "A setting removed from the file is still used");
+    errorCount += check(config::isolatePlugins, "The file wins over the command line");
+
+    config::brightness.set(config::Layer::kRuntime, 30);
+    errorCount += check(config::brightness == 30u, "The runtime value isn't used");
+
+    writeFile(filePath, R"({ "brightness": 101 })");
+    errorCount += check(!waitForBrightness(50) && config::brightness == 30u &&
+                            config::brightness.getLayer() == config::Layer::kRuntime,
+                        "An invalid value in the file was used");
+
+    writeFile(filePath, R"({ "brightness": )");
+    config::brightness.reset(config::Layer::kRuntime);
+    errorCount += check(!waitForBrightness(75) && config::brightness == 90u,
+                        "The settings of an invalid file were used");
+    errorCount += check(!config::readFile(filePath.c_str()), "Reading an invalid file succeeded");
+
+    errorCount += check(brightnessNotificationCount == 4, "The brightness subscriber should be notified 4 times");
+
+    config::brightness.unsubscribe(id);
+    config::deinit();
+    std::error_code error;
+    std::filesystem::remove(filePath, error);
+    return errorCount;
+}
+
+// Reading a setting goes through an inline accessor, so it should cost what reading a global does.
+void measureReads(int iterationCount)
+{
+    volatile unsigned int sink = 0;
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < iterationCount; i++)
+    {
+        sink = sink + g_plainBrightness;
+    }
+    double plainNs = elapsedNs(start) / iterationCount;
+
+    start = std::chrono::steady_clock::now();
+    for (int i = 0; i < iterationCount; i++)
+    {
+        sink = sink + config::brightness;
+    }
+    double settingNs = elapsedNs(start) / iterationCount;
+
+    LOG_INFO("%-32s %8.2f ns", "Global read", plainNs);
+    LOG_INFO("%-32s %8.2f ns", "Setting read", settingNs);
+}
+
+// Usage: ConfigSettings [--file [path]] [--iterations [value]]
+// Checks how the layers of a setting override each other and notify subscribers, then reads a config file with
+// command line options, edits it while it is watched and checks the settings. Also measures polling the file every
+// frame, and reading a setting against reading a global.
+int main(int argc, char *argv[])
+{
+    LogManager::getSingleton().init();
+
+    const std::vector<std::string_view> args(argv + 1, argv + argc);
+    std::string filePath(cmdLine::getOption(args, "--file"));
+    if (filePath.empty())
+    {
+        filePath = "ConfigSettings.Config.json";
+    }
+    std::string iterationsStr(cmdLine::getOption(args, "--iterations"));
+    int iterationCount = iterationsStr.empty() ? 10000000 : std::stoi(iterationsStr);
+
+    int errorCount = 0;
+    errorCount += checkLayers();
+    errorCount += checkFile(filePath, iterationCount);
+    measureReads(iterationCount);
+
+    LogManager::getSingleton().deinit();
+    return errorCount == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,687 @@
+//
+// SliProSuperPro
+// A Shift Light Indicator controller
+// Copyright 2025 Fixfactory
+//
+// This file is part of SliProSuperPro.
+//
+// SliProSuperPro is free software: you can redistribute it and/or modify it under
+// the terms of the GNU General Public License as published by the Free
+// Software Foundation, either version 3 of the License, or any later version.
+//
+// SliProSuperPro is distributed in the hope that it will be useful, but WITHOUT
+// ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+// FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+// more details.
+//
+// You should have received a copy of the GNU General Public License along
+// with SliProSuperPro. If not, see <http://www.gnu.org/licenses/>.
+//
+
+#include <string>
+#include <vector>
+#include <string_view>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <memory>
+#include <random>
+
+#ifdef _WIN32
+    #include <Windows.h>
+    #include "irsdk/irsdk_client.h"
+#endif
+
+#include "Log.h"
+#include "CommandLine.h"
+#include "IbtReader.h"
+#include "SessionIndex.h"
+#include "VariableReader.h"
+#include "irsdk/irsdk_defines.h"
+#include "irsdk/irsdk_diskclient.h"
+#include "irsdk/yaml_parser.h"
+
+struct BenchmarkVariable
+{
+    const char *name;
+    int type;
+};
+
+// The variables read by the iRacing plugin, with the types iRacing gives them.
+const BenchmarkVariable kVariables[] = {
+    { "IsReplayPlaying", irsdk_bool },
+    { "Voltage", irsdk_float },
+    { "Gear", irsdk_int },
+    { "RPM", irsdk_float },
+    { "Speed", irsdk_float },
+    { "dcPitSpeedLimiterToggle", irsdk_bool },
+    { "OnPitRoad", irsdk_bool },
+    { "PlayerCarSLFirstRPM", irsdk_float },
+    { "PlayerCarSLShiftRPM", irsdk_float },
+    { "PlayerCarSLLastRPM", irsdk_float },
+    { "PlayerCarSLBlinkRPM", irsdk_float },
+};
+const int kVariableCount = sizeof(kVariables) / sizeof(kVariables[0]);
+
+// iRacing publishes around 300 variables, many of them per-wheel arrays, in lines of several kilobytes.
+const int kFillerCount = 290;
+const int kFillerArraySize = 6;
+const int kNumVars = kVariableCount + kFillerCount;
+const int kBufferCount = 3;
+const int kVarHeaderOffset = 256;
+const int kBufOffset = kVarHeaderOffset + kNumVars * sizeof(irsdk_varHeader);
+const size_t kMemorySize = 1024 * 1024;
+
+// Writes the header and variable descriptions the way the sim does when it connects. The variables the plugin reads
+// are spread among the filler variables.
+int layoutSharedMemory(char *sharedMem, int offsets[kVariableCount])
+{
+    memset(sharedMem, 0, kMemorySize);
+    irsdk_header *header = reinterpret_cast<irsdk_header *>(sharedMem);
+    irsdk_varHeader *varHeaders = reinterpret_cast<irsdk_varHeader *>(sharedMem + kVarHeaderOffset);
+
+    int lineOffset = 0;
+    int variable = 0;
+    int filler = 0;
+    for (int index = 0; index < kNumVars; index++)
+    {
+        irsdk_varHeader &varHeader = varHeaders[index];
+        if (variable < kVariableCount && index % (kNumVars / kVariableCount) == kNumVars / kVariableCount / 2)
+        {
+            varHeader.type = kVariables[variable].type;
+            varHeader.count = 1;
+            snprintf(varHeader.name, sizeof(varHeader.name), "%s", kVariables[variable].name);
+            offsets[variable++] = lineOffset;
+        }
+        else
+        {
+            varHeader.type = irsdk_float;
+            varHeader.count = kFillerArraySize;
+            snprintf(varHeader.name, sizeof(varHeader.name), "Filler%03i", filler++);
+        }
+
+        // Lines are packed, so 4 byte values can follow 1 byte ones.
+        varHeader.offset = lineOffset;
+        lineOffset += irsdk_VarTypeBytes[varHeader.type] * varHeader.count;
+    }
+
+    header->ver = IRSDK_VER;
+    header->status = irsdk_stConnected;
+    header->tickRate = 60;
+    header->numVars = kNumVars;
+    header->varHeaderOffset = kVarHeaderOffset;
+    header->numBuf = kBufferCount;
+    header->bufLen = lineOffset;
+    for (int i = 0; i < kBufferCount; i++)
+    {
+        header->varBuf[i].bufOffset = kBufOffset + i * lineOffset;
+        header->varBuf[i].tickCount = -1;
+    }
+    return lineOffset;
+}
+
+float expectedValue(int variable, int tick)
+{
+    switch (kVariables[variable].type)
+    {
+    case irsdk_bool:
+        return (float)((tick + variable) % 2);
+    case irsdk_int:
+        return (float)(tick % 8);
+    default:
+        return (float)(tick % 1000) + variable * 1000.f;
+    }
+}
+
+// Writes the next line like the sim: the oldest buffer is rewritten, then its tick count is updated.
+void writeTick(char *sharedMem, const int offsets[kVariableCount], int tick)
+{
+    irsdk_header *header = reinterpret_cast<irsdk_header *>(sharedMem);
+    irsdk_varBuf &varBuf = header->varBuf[tick % kBufferCount];
+    char *line = sharedMem + varBuf.bufOffset;
+
+    for (int i = 0; i < kVariableCount; i++)
+    {
+        float value = expectedValue(i, tick);
+        if (kVariables[i].type == irsdk_bool)
+        {
+            bool boolValue = value != 0.f;
+            memcpy(line + offsets[i], &boolValue, sizeof(boolValue));
+        }
+        else if (kVariables[i].type == irsdk_int)
+        {
+            int intValue = (int)value;
+            memcpy(line + offsets[i], &intValue, sizeof(intValue));
+        }
+        else
+        {
+            memcpy(line + offsets[i], &value, sizeof(value));
+        }
+    }
+    varBuf.tickCount = tick;
+}
+
+struct Result
+{
+    double nsPerFrame{ 0.0 };
+    int frameCount{ 0 };
+    int errorCount{ 0 };
+};
+
+template <typename ReadFunction>
+Result runBenchmark(char *sharedMem, const int offsets[kVariableCount], int iterations, ReadFunction readFunction)
+{
+    Result result;
+    float values[kVariableCount]{};
+
+    // The first ticks let both readers connect and resolve their variables.
+    int tick = 0;
+    for (; tick < 4; tick++)
+    {
+        writeTick(sharedMem, offsets, tick);
+        readFunction(values);
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < iterations; i++, tick++)
+    {
+        writeTick(sharedMem, offsets, tick);
+        if (!readFunction(values))
+        {
+            result.errorCount++;
+            continue;
+        }
+
+        result.frameCount++;
+        for (int variable = 0; variable < kVariableCount; variable++)
+        {
+            if (values[variable] != expectedValue(variable, tick))
+            {
+                result.errorCount++;
+                break;
+            }
+        }
+    }
+    auto duration = std::chrono::steady_clock::now() - start;
+
+    // Remove the cost of simulating the sim.
+    start = std::chrono::steady_clock::now();
+    for (int i = 0; i < iterations; i++, tick++)
+    {
+        writeTick(sharedMem, offsets, tick);
+    }
+    duration -= std::chrono::steady_clock::now() - start;
+
+    result.nsPerFrame = std::chrono::duration<double, std::nano>(duration).count() / iterations;
+    return result;
+}
+
+bool reportResult(const char *name, const Result &result, int iterations)
+{
+    LOG_INFO("%-32s %8.1f ns/frame, %i frames, %i errors", name, result.nsPerFrame, result.frameCount,
+             result.errorCount);
+    return result.errorCount == 0 && result.frameCount == iterations;
+}
+
+// The session string values read by the iRacing plugin. {} is replaced by DriverCarIdx for parseYaml.
+const char *const kSessionPaths[] = {
+    "DriverInfo:DriverCarIdx:",
+    "DriverInfo:Drivers:CarIdx:{}CarPath:",
+    "DriverInfo:DriverCarGearNumForward:",
+    "DriverInfo:DriverCarRedLine:",
+    "WeekendInfo:WeekendOptions:HardcoreLevel:",
+    "DriverInfo:DriverCarSLFirstRPM:",
+    "DriverInfo:DriverCarSLShiftRPM:",
+    "DriverInfo:DriverCarSLLastRPM:",
+    "DriverInfo:DriverCarSLBlinkRPM:",
+};
+const int kSessionPathCount = sizeof(kSessionPaths) / sizeof(kSessionPaths[0]);
+const int kDriverCount = 64;
+
+// A session string laid out like iRacing's in a full field, with the driver info after the session results.
+std::string makeSessionString(int driverCarIdx)
+{
+    std::string yaml = "---\nWeekendInfo:\n TrackName: spa up\n TrackID: 163\n TrackLength: 6.93 km\n";
+    yaml += " WeekendOptions:\n  NumStarters: 64\n  StartingGrid: 2x2 inline pole on left\n  HardcoreLevel: 1\n";
+    yaml += " TelemetryOptions:\n  TelemetryDiskFile: \"\"\n\nSessionInfo:\n Sessions:\n";
+    for (int session = 0; session < 3; session++)
+    {
+        yaml += " - SessionNum: " + std::to_string(session) + "\n   SessionLaps: unlimited\n";
+        yaml += "   SessionType: Practice\n   ResultsPositions:\n";
+        for (int position = 0; position < kDriverCount; position++)
+        {
+            yaml += "   - Position: " + std::to_string(position + 1) + "\n     ClassPosition: " +
+                    std::to_string(position) + "\n     CarIdx: " + std::to_string(kDriverCount - position) +
+                    "\n     Lap: 12\n     Time: 1234.5678\n     FastestLap: 7\n     FastestTime: 137.1234\n"
+                    "     LastTime: 138.4321\n     LapsLed: 0\n     LapsComplete: 12\n     JokerLapsComplete: 0\n"
+                    "     LapsDriven: 12.345\n     Incidents: 4\n     ReasonOutId: 0\n     ReasonOutStr: Running\n";
+        }
+    }
+
+    yaml += "\nDriverInfo:\n DriverCarIdx: " + std::to_string(driverCarIdx) + "\n DriverUserID: 123456\n";
+    yaml += " DriverCarRedLine: 7500.000\n DriverCarGearNumForward: 6\n DriverCarSLFirstRPM: 6100.000\n";
+    yaml += " DriverCarSLShiftRPM: 7000.000\n DriverCarSLLastRPM: 7200.000\n DriverCarSLBlinkRPM: 7400.000\n";
+    yaml += " Drivers:\n";
+    for (int carIdx = 0; carIdx < kDriverCount; carIdx++)
+    {
+        std::string idx = std::to_string(carIdx);
+        yaml += " - CarIdx: " + idx + "\n   UserName: Driver " + idx + "\n   AbbrevName: D, " + idx +
+                "\n   Initials: DD\n   UserID: " + idx + "00\n   TeamID: 0\n   TeamName: Team " + idx +
+                "\n   CarNumber: \"" + idx + "\"\n   CarNumberRaw: " + idx + "\n   CarPath: car" + idx +
+                "\n   CarClassID: 0\n   CarID: 132\n   CarIsPaceCar: 0\n   CarIsAI: 0\n"
+                "   CarScreenName: Car " + idx + "\n   CarScreenNameShort: Car\n   CarClassShortName: \n"
+                "   CarClassRelSpeed: 0\n   CarClassLicenseLevel: 0\n   CarClassMaxFuelPct: 1.000 %\n"
+                "   CarClassWeightPenalty: 0.000 kg\n   CarClassPowerAdjust: 0.000 %\n"
+                "   CarClassDryTireSetLimit: 0 %\n   CarClassColor: 0xffffff\n   CarClassEstLapTime: 137.0000\n"
+                "   IRating: 1350\n   LicLevel: 12\n   LicSubLevel: 299\n   LicString: D 2.99\n"
+                "   LicColor: 0xfc8a27\n   IsSpectator: 0\n   CarDesignStr: 0,ffffff,000000,ff0000\n"
+                "   HelmetDesignStr: 0,ffffff,000000,ff0000\n   SuitDesignStr: 0,ffffff,000000,ff0000\n"
+                "   CarNumberDesignStr: 0,0,ffffff,777777,000000\n   CarSponsor_1: 0\n   CarSponsor_2: 0\n"
+                "   CurDriverIncidentCount: 4\n   TeamIncidentCount: 4\n";
+    }
+    yaml += "\nSplitTimeInfo:\n Sectors:\n - SectorNum: 0\n   SectorStartPct: 0.000000\n...\n";
+    return yaml;
+}
+
+// Reads the plugin's session values with parseYaml, one pass over the session string per value.
+void readSessionWithParseYaml(const char *sessionStr, std::string values[kSessionPathCount])
+{
+    int driverCarIdx = 0;
+    for (int i = 0; i < kSessionPathCount; i++)
+    {
+        std::string path = kSessionPaths[i];
+        size_t selector = path.find("{}");
+        if (selector != std::string::npos)
+        {
+            path.insert(selector + 1, std::to_string(driverCarIdx));
+        }
+
+        const char *value = nullptr;
+        int length = 0;
+        parseYaml(sessionStr, path.c_str(), &value, &length);
+        values[i] = value != nullptr ? std::string(value, length) : std::string();
+        if (i == 0)
+        {
+            driverCarIdx = atoi(values[i].c_str());
+        }
+    }
+}
+
+void readSessionWithIndex(iracing::SessionIndex &session, const char *sessionStr, std::string values[kSessionPathCount])
+{
+    session.index(sessionStr);
+    int driverCarIdx = 0;
+    for (int i = 0; i < kSessionPathCount; i++)
+    {
+        if (i == 1)
+        {
+            session.getString(i, driverCarIdx, values[i]);
+        }
+        else
+        {
+            session.getString(i, values[i]);
+        }
+        if (i == 0)
+        {
+            driverCarIdx = atoi(values[i].c_str());
+        }
+    }
+}
+
+bool runSessionBenchmark(int iterations)
+{
+    iracing::SessionIndex session({ kSessionPaths[0], kSessionPaths[1], kSessionPaths[2], kSessionPaths[3],
+                                    kSessionPaths[4], kSessionPaths[5], kSessionPaths[6], kSessionPaths[7],
+                                    kSessionPaths[8] });
+
+    // The driver's car is last in the list, where parseYaml has the most to scan.
+    std::string sessionStr = makeSessionString(kDriverCount - 1);
+    LOG_INFO("%i byte session string, %i iterations", (int)sessionStr.size(), iterations);
+
+    std::string expected[kSessionPathCount];
+    std::string values[kSessionPathCount];
+    readSessionWithParseYaml(sessionStr.c_str(), expected);
+
+    int errorCount = 0;
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < iterations; i++)
+    {
+        readSessionWithParseYaml(sessionStr.c_str(), values);
+    }
+    double parseYamlUs = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count();
+
+    start = std::chrono::steady_clock::now();
+    for (int i = 0; i < iterations; i++)
+    {
+        readSessionWithIndex(session, sessionStr.c_str(), values);
+    }
+    double indexUs = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count();
+
+    for (int i = 0; i < kSessionPathCount; i++)
+    {
+        // SessionIndex strips quotes like the plugin did after parseYaml.
+        if (values[i] != expected[i] || expected[i].empty())
+        {
+            LOG_ERROR("%s: expected \"%s\", read \"%s\"", kSessionPaths[i], expected[i].c_str(), values[i].c_str());
+            errorCount++;
+        }
+    }
+
+    LOG_INFO("%-32s %8.1f us/update", "parseYaml", parseYamlUs / iterations);
+    LOG_INFO("%-32s %8.1f us/update, %i errors", "SessionIndex", indexUs / iterations, errorCount);
+    return errorCount == 0;
+}
+
+// iRacing records fewer variables to disk than it publishes, and most of them aren't arrays, so lines are around a
+// kilobyte. Gear and RPM are spread among them like in a real file.
+const int kDiskFillerCount = 250;
+const int kDiskTickRate = 60;
+
+int expectedGear(int sample)
+{
+    return sample % 8 - 1;
+}
+
+float expectedRPM(int sample)
+{
+    return (float)(sample % 1000) * 7.f;
+}
+
+double sampleTime(int sample)
+{
+    return (double)sample / kDiskTickRate;
+}
+
+// Writes an .ibt file of sampleCount samples with irsdkDiskWriter.
+bool writeIbtFile(const std::string &path, int sampleCount)
+{
+    // Over a megabyte of buffers.
+    auto writer = std::make_unique<irsdkDiskWriter>();
+    if (!writer->openFile(path.c_str()))
+    {
+        return false;
+    }
+
+    int sessionTimeIdx = writer->addNewVariable("SessionTime", "Seconds since session start", "s", irsdk_double);
+    int gearIdx = -1;
+    int rpmIdx = -1;
+    for (int i = 0; i < kDiskFillerCount; i++)
+    {
+        if (i == kDiskFillerCount / 3)
+        {
+            gearIdx = writer->addNewVariable("Gear", "-1=reverse  0=neutral  1..n=current gear", "", irsdk_int);
+        }
+        else if (i == kDiskFillerCount * 2 / 3)
+        {
+            rpmIdx = writer->addNewVariable("RPM", "Engine rpm", "revs/min", irsdk_float);
+        }
+
+        std::string name = "Filler" + std::to_string(i);
+        writer->addNewVariable(name.c_str(), "", "", i % 5 == 0 ? irsdk_bool : irsdk_float);
+    }
+    writer->finalizeHeader();
+
+    for (int sample = 0; sample < sampleCount; sample++)
+    {
+        writer->setVar(sampleTime(sample), sessionTimeIdx);
+        writer->setVar(expectedGear(sample), gearIdx);
+        writer->setVar(expectedRPM(sample), rpmIdx);
+        writer->writeLine();
+    }
+    writer->closeFile();
+    return true;
+}
+
+struct ScanResult
+{
+    double ms{ 0.0 };
+    int sampleCount{ 0 };
+    int errorCount{ 0 };
+    long long gearSum{ 0 };
+    double rpmSum{ 0.0 };
+};
+
+void scanSample(ScanResult &result, int gear, float rpm, bool verify)
+{
+    if (verify && (gear != expectedGear(result.sampleCount) || rpm != expectedRPM(result.sampleCount)))
+    {
+        result.errorCount++;
+    }
+    result.gearSum += gear;
+    result.rpmSum += rpm;
+    result.sampleCount++;
+}
+
+void reportScan(const char *name, const ScanResult &result, double megabytes)
+{
+    LOG_INFO("%-32s %8.1f ms, %8.0f MB/s, %i samples, %i errors", name, result.ms, megabytes / result.ms * 1000.0,
+             result.sampleCount, result.errorCount);
+}
+
+// Scans Gear and RPM with irsdkDiskClient, which reads the file line by line, and with IbtReader. Then seeks to
+// random session times. Generated files are also checked against the values written.
+bool runIbtBenchmark(const std::string &path, bool verify, int seekIterations)
+{
+    auto start = std::chrono::steady_clock::now();
+    irsdkDiskClient client;
+    if (!client.openFile(path.c_str()))
+    {
+        LOG_ERROR("Could not open %s", path.c_str());
+        return false;
+    }
+
+    ScanResult clientResult;
+    int gearIdx = client.getVarIdx("Gear");
+    int rpmIdx = client.getVarIdx("RPM");
+    while (client.getNextData())
+    {
+        scanSample(clientResult, client.getVarInt(gearIdx), client.getVarFloat(rpmIdx), verify);
+    }
+    client.closeFile();
+    clientResult.ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+    start = std::chrono::steady_clock::now();
+    iracing::IbtReader reader;
+    if (!reader.open(path))
+    {
+        LOG_ERROR("Could not map %s", path.c_str());
+        return false;
+    }
+
+    ScanResult readerResult;
+    iracing::IbtReader::Column<int> gear = reader.getColumn<int>("Gear");
+    iracing::IbtReader::Column<float> rpm = reader.getColumn<float>("RPM");
+    if (!gear.isValid() || !rpm.isValid())
+    {
+        LOG_ERROR("%s has no Gear or RPM", path.c_str());
+        return false;
+    }
+    for (int sample = 0; sample < reader.getSampleCount(); sample++)
+    {
+        scanSample(readerResult, gear[sample], rpm[sample], verify);
+    }
+    readerResult.ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+    double megabytes = (double)std::filesystem::file_size(path) / (1024.0 * 1024.0);
+    LOG_INFO("%.0f MB .ibt file, %i samples, %.2f hours", megabytes, reader.getSampleCount(),
+             (double)reader.getSampleCount() / std::max<int>(reader.getTickRate(), 1) / 3600.0);
+    reportScan("irsdkDiskClient", clientResult, megabytes);
+    reportScan("IbtReader", readerResult, megabytes);
+
+    bool succeeded = clientResult.errorCount == 0 && readerResult.errorCount == 0;
+    if (clientResult.sampleCount != readerResult.sampleCount || clientResult.gearSum != readerResult.gearSum ||
+        clientResult.rpmSum != readerResult.rpmSum)
+    {
+        LOG_ERROR("irsdkDiskClient and IbtReader read different values");
+        succeeded = false;
+    }
+
+    // Seeks by session time, then reads the sample found.
+    iracing::IbtReader::Column<double> sessionTime = reader.getColumn<double>("SessionTime");
+    if (sessionTime.isValid() && reader.getSampleCount() > 0)
+    {
+        std::mt19937 random(1234);
+        std::uniform_int_distribution<int> samples(0, reader.getSampleCount() - 1);
+        int errorCount = 0;
+        start = std::chrono::steady_clock::now();
+        for (int i = 0; i < seekIterations; i++)
+        {
+            int expected = samples(random);
+            int sample = reader.findSample(sessionTime[expected]);
+            if (sample >= reader.getSampleCount() || sessionTime[sample] != sessionTime[expected] ||
+                (verify && sample != expected))
+            {
+                errorCount++;
+            }
+        }
+        double seekNs = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+        LOG_INFO("%-32s %8.1f ns/seek, %i seeks, %i errors", "IbtReader::findSample", seekNs / seekIterations,
+                 seekIterations, errorCount);
+        succeeded &= errorCount == 0;
+    }
+
+    return succeeded;
+}
+
+// Usage: IRacingBenchmark [--iterations [value]] [--sessionIterations [value]] [--ibtMinutes [value]] [--ibt [path]]
+// Compares reading the iRacing plugin's variables with irsdkCVar, which copies the whole line every tick, against the
+// plugin's VariableReader. The sim is simulated in shared memory and checked against what each path reads.
+// On Windows the shared memory is published under iRacing's name, so iRacing must not be running. Elsewhere only the
+// VariableReader is measured, along with the full line copy irsdk_getNewData makes.
+// Then compares reading the session string values with parseYaml against the plugin's SessionIndex.
+// Last, scans an .ibt file with irsdkDiskClient and IbtReader. Unless a file is given with --ibt, one of ibtMinutes
+// of telemetry is written to the temporary directory first, and removed afterwards.
+int main(int argc, char *argv[])
+{
+    LogManager::getSingleton().init();
+
+    const std::vector<std::string_view> args(argv + 1, argv + argc);
+    std::string iterationsOption(cmdLine::getOption(args, "--iterations"));
+    int iterations = iterationsOption.empty() ? 1000000 : std::stoi(iterationsOption);
+    std::string sessionIterationsOption(cmdLine::getOption(args, "--sessionIterations"));
+    int sessionIterations = sessionIterationsOption.empty() ? 1000 : std::stoi(sessionIterationsOption);
+    std::string ibtMinutesOption(cmdLine::getOption(args, "--ibtMinutes"));
+    int ibtMinutes = ibtMinutesOption.empty() ? 180 : std::stoi(ibtMinutesOption);
+    std::string ibtPath(cmdLine::getOption(args, "--ibt"));
+
+#ifdef _WIN32
+    HANDLE memMapFile =
+        CreateFileMapping(INVALID_HANDLE_VALUE, nullptr, PAGE_READWRITE, 0, (DWORD)kMemorySize, IRSDK_MEMMAPFILENAME);
+    if (memMapFile == nullptr || GetLastError() == ERROR_ALREADY_EXISTS)
+    {
+        LOG_ERROR("Could not create the iRacing shared memory. Is iRacing running?");
+        LogManager::getSingleton().deinit();
+        return EXIT_FAILURE;
+    }
+    HANDLE dataValidEvent = CreateEvent(nullptr, FALSE, FALSE, IRSDK_DATAVALIDEVENTNAME);
+    char *sharedMem = (char *)MapViewOfFile(memMapFile, FILE_MAP_ALL_ACCESS, 0, 0, 0);
+#else
+    std::vector<char> memory(kMemorySize);
+    char *sharedMem = memory.data();
+#endif
+
+    int offsets[kVariableCount]{};
+    int bufLen = layoutSharedMemory(sharedMem, offsets);
+    LOG_INFO("%i variables, %i byte lines, %i iterations", kNumVars, bufLen, iterations);
+
+    bool succeeded = true;
+
+    std::vector<char> lineCopy(bufLen);
+    Result copyResult = runBenchmark(sharedMem, offsets, iterations, [&](float *values) {
+        // What irsdk_getNewData does before any variable is read.
+        const irsdk_header *header = reinterpret_cast<const irsdk_header *>(sharedMem);
+        int latest = 0;
+        for (int i = 1; i < header->numBuf; i++)
+        {
+            if (header->varBuf[latest].tickCount < header->varBuf[i].tickCount)
+            {
+                latest = i;
+            }
+        }
+        memcpy(lineCopy.data(), sharedMem + header->varBuf[latest].bufOffset, header->bufLen);
+        for (int i = 0; i < kVariableCount; i++)
+        {
+            values[i] = expectedValue(i, header->varBuf[latest].tickCount);
+        }
+        return true;
+    });
+    reportResult("Line copy only", copyResult, iterations);
+
+#ifdef _WIN32
+    irsdkCVar cvars[kVariableCount];
+    for (int i = 0; i < kVariableCount; i++)
+    {
+        cvars[i].setVarName(kVariables[i].name);
+    }
+
+    Result cvarResult = runBenchmark(sharedMem, offsets, iterations, [&](float *values) {
+        if (!irsdkClient::instance().waitForData(0))
+        {
+            return false;
+        }
+        for (int i = 0; i < kVariableCount; i++)
+        {
+            values[i] = cvars[i].isValid() ? cvars[i].getFloat() : 0.f;
+        }
+        return true;
+    });
+    succeeded &= reportResult("irsdkCVar", cvarResult, iterations);
+#endif
+
+    iracing::VariableReader reader({ kVariables[0].name, kVariables[1].name, kVariables[2].name, kVariables[3].name,
+                                     kVariables[4].name, kVariables[5].name, kVariables[6].name, kVariables[7].name,
+                                     kVariables[8].name, kVariables[9].name, kVariables[10].name });
+
+    Result readerResult = runBenchmark(sharedMem, offsets, iterations, [&](float *values) {
+#ifdef _WIN32
+        if (!irsdk_waitForDataReady(0, nullptr))
+        {
+            return false;
+        }
+#endif
+        if (!reader.read(sharedMem))
+        {
+            return false;
+        }
+        for (int i = 0; i < kVariableCount; i++)
+        {
+            values[i] = reader.isValid(i) ? reader.getFloat(i) : 0.f;
+        }
+        return true;
+    });
+    succeeded &= reportResult("VariableReader", readerResult, iterations);
+
+#ifdef _WIN32
+    irsdk_shutdown();
+    UnmapViewOfFile(sharedMem);
+    CloseHandle(dataValidEvent);
+    CloseHandle(memMapFile);
+#endif
+
+    succeeded &= runSessionBenchmark(sessionIterations);
+
+    const int kSeekIterations = 100000;
+    if (!ibtPath.empty())
+    {
+        succeeded &= runIbtBenchmark(ibtPath, false, kSeekIterations);
+    }
+    else if (ibtMinutes > 0)
+    {
+        ibtPath = (std::filesystem::temp_directory_path() / "IRacingBenchmark.ibt").string();
+        if (writeIbtFile(ibtPath, ibtMinutes * 60 * kDiskTickRate))
+        {
+            succeeded &= runIbtBenchmark(ibtPath, true, kSeekIterations);
+        }
+        else
+        {
+            LOG_ERROR("Could not write %s", ibtPath.c_str());
+            succeeded = false;
+        }
+        std::error_code error;
+        std::filesystem::remove(ibtPath, error);
+    }
+
+    LogManager::getSingleton().deinit();
+    return succeeded ? EXIT_SUCCESS : EXIT_FAILURE;
+}
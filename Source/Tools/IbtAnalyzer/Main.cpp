@@ -0,0 +1,247 @@
+//
+// SliProSuperPro
+// A Shift Light Indicator controller
+// Copyright 2025 Fixfactory
+//
+// This file is part of SliProSuperPro.
+//
+// SliProSuperPro is free software: you can redistribute it and/or modify it under
+// the terms of the GNU General Public License as published by the Free
+// Software Foundation, either version 3 of the License, or any later version.
+//
+// SliProSuperPro is distributed in the hope that it will be useful, but WITHOUT
+// ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+// FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+// more details.
+//
+// You should have received a copy of the GNU General Public License along
+// with SliProSuperPro. If not, see <http://www.gnu.org/licenses/>.
+//
+
+#include <string>
+#include <vector>
+#include <string_view>
+#include <map>
+#include <atomic>
+#include <thread>
+#include <fstream>
+#include <filesystem>
+#include <algorithm>
+#include <cstdlib>
+
+#include "Log.h"
+#include "CommandLine.h"
+#include "ShiftAnalyzer.h"
+
+#include "json/json.hpp"
+// Keeps the cars of a merged file in their order.
+using json = nlohmann::ordered_json;
+
+struct FileResult
+{
+    std::string path;
+    bool succeeded{ false };
+    std::string error;
+    CarStats stats;
+};
+
+std::vector<std::string> findIbtFiles(const std::string &directory)
+{
+    std::vector<std::string> paths;
+    std::error_code error;
+    for (const auto &entry : std::filesystem::recursive_directory_iterator(directory, error))
+    {
+        std::string extension = entry.path().extension().string();
+        std::transform(extension.begin(), extension.end(), extension.begin(), ::tolower);
+        if (entry.is_regular_file() && extension == ".ibt")
+        {
+            paths.push_back(entry.path().string());
+        }
+    }
+    std::sort(paths.begin(), paths.end());
+    return paths;
+}
+
+// Each thread takes the next file until there are none left. Files differ a lot in length, so this balances better
+// than giving every thread the same number of files.
+void analyzeFiles(std::vector<FileResult> &results, unsigned int threadCount)
+{
+    std::atomic<size_t> nextFile{ 0 };
+    auto analyze = [&]() {
+        for (size_t i = nextFile++; i < results.size(); i = nextFile++)
+        {
+            results[i].succeeded = analyzeFile(results[i].path, results[i].stats, results[i].error);
+        }
+    };
+
+    std::vector<std::thread> threads;
+    for (unsigned int i = 1; i < threadCount; i++)
+    {
+        threads.emplace_back(analyze);
+    }
+    analyze();
+    for (std::thread &thread : threads)
+    {
+        thread.join();
+    }
+}
+
+std::string getGearName(int gear)
+{
+    if (gear == -1)
+    {
+        return "R";
+    }
+    return gear == 0 ? "N" : std::to_string(gear);
+}
+
+// Uses the format of hand written overrides: the same RPMs for every gear if they all match, or a list of gears
+// starting with reverse and neutral. Gears without enough data, like the top gear, use the RPMs of the gear below.
+// Reverse and neutral use the RPMs of the lowest gear.
+json makeOverride(const std::vector<ShiftPoint> &shiftPoints, int forwardGearCount)
+{
+    json carOverride = json::object();
+    bool isSameForEveryGear = std::all_of(shiftPoints.begin(), shiftPoints.end(), [&](const ShiftPoint &shiftPoint) {
+        return shiftPoint.firstRPM == shiftPoints[0].firstRPM && shiftPoint.lastRPM == shiftPoints[0].lastRPM;
+    });
+    if (isSameForEveryGear)
+    {
+        carOverride["firstRPM"] = (int)shiftPoints[0].firstRPM;
+        carOverride["lastRPM"] = (int)shiftPoints[0].lastRPM;
+        return carOverride;
+    }
+
+    json gears = json::array();
+    const ShiftPoint *shiftPoint = &shiftPoints[0];
+    for (int gear = -1; gear <= std::max<int>(shiftPoints.back().gear, forwardGearCount); gear++)
+    {
+        for (const ShiftPoint &gearShiftPoint : shiftPoints)
+        {
+            if (gearShiftPoint.gear == gear)
+            {
+                shiftPoint = &gearShiftPoint;
+            }
+        }
+
+        gears.push_back({ { "gear", getGearName(gear) },
+                          { "firstRPM", (int)shiftPoint->firstRPM },
+                          { "lastRPM", (int)shiftPoint->lastRPM } });
+    }
+    carOverride["gears"] = gears;
+    return carOverride;
+}
+
+// Usage: IbtAnalyzer --dir [path] [--output [path]] [--merge] [--threads [value]]
+// Derives the shift light RPMs of every car driven in the .ibt telemetry files found in a directory and its
+// subdirectories, and writes them as iRacing overrides. Files are read in parallel and grouped by CarPath.
+// With --merge, the cars are added to or replaced in an existing overrides file and its other cars are kept.
+int main(int argc, char *argv[])
+{
+    LogManager::getSingleton().init();
+
+    const std::vector<std::string_view> args(argv + 1, argv + argc);
+    std::string directory(cmdLine::getOption(args, "--dir"));
+    std::string outputPath(cmdLine::getOption(args, "--output"));
+    std::string threadsOption(cmdLine::getOption(args, "--threads"));
+    bool merge = cmdLine::hasOption(args, "--merge");
+
+    if (directory.empty())
+    {
+        LOG_ERROR("Missing --dir [path]");
+        LogManager::getSingleton().deinit();
+        return EXIT_FAILURE;
+    }
+    if (outputPath.empty())
+    {
+        outputPath = "iRacing.Overrides.json";
+    }
+
+    std::vector<std::string> paths = findIbtFiles(directory);
+    if (paths.empty())
+    {
+        LOG_ERROR("No .ibt files in %s", directory.c_str());
+        LogManager::getSingleton().deinit();
+        return EXIT_FAILURE;
+    }
+
+    unsigned int threadCount = threadsOption.empty() ? std::thread::hardware_concurrency() : std::stoi(threadsOption);
+    threadCount = std::clamp<unsigned int>(threadCount, 1, (unsigned int)paths.size());
+    LOG_INFO("Analyzing %zu .ibt files with %u threads", paths.size(), threadCount);
+
+    // The threads don't log, so results are reported once they are done.
+    std::vector<FileResult> results(paths.size());
+    for (size_t i = 0; i < paths.size(); i++)
+    {
+        results[i].path = paths[i];
+    }
+    analyzeFiles(results, threadCount);
+
+    std::map<std::string, CarStats> cars;
+    for (const FileResult &result : results)
+    {
+        if (!result.succeeded)
+        {
+            LOG_WARN("Skipping %s: %s", result.path.c_str(), result.error.c_str());
+            continue;
+        }
+
+        auto car = cars.find(result.stats.carPath);
+        if (car == cars.end())
+        {
+            cars.emplace(result.stats.carPath, result.stats);
+        }
+        else
+        {
+            car->second.merge(result.stats);
+        }
+    }
+
+    json overrides;
+    if (merge)
+    {
+        std::ifstream file(outputPath);
+        if (file.good())
+        {
+            LOG_INFO("Merging into %s", outputPath.c_str());
+            overrides = json::parse(file);
+        }
+    }
+    if (!overrides.contains("cars"))
+    {
+        overrides["cars"] = json::object();
+    }
+
+    int carCount = 0;
+    for (const auto &[carPath, stats] : cars)
+    {
+        std::vector<ShiftPoint> shiftPoints = computeShiftPoints(stats);
+        if (shiftPoints.empty())
+        {
+            LOG_WARN("%s: not enough full throttle driving in %i files", carPath.c_str(), stats.fileCount);
+            continue;
+        }
+
+        LOG_INFO("%s: %i files, %i samples", carPath.c_str(), stats.fileCount, stats.sampleCount);
+        for (const ShiftPoint &shiftPoint : shiftPoints)
+        {
+            LOG_INFO("    gear %i: firstRPM %.0f, lastRPM %.0f (%s)", shiftPoint.gear, shiftPoint.firstRPM,
+                     shiftPoint.lastRPM, shiftPoint.isFromAcceleration ? "acceleration" : "driver's shifts");
+        }
+
+        overrides["cars"][carPath] = makeOverride(shiftPoints, stats.forwardGearCount);
+        carCount++;
+    }
+
+    std::ofstream file(outputPath);
+    file << overrides.dump(4) << std::endl;
+    if (!file.good())
+    {
+        LOG_ERROR("Could not write %s", outputPath.c_str());
+        LogManager::getSingleton().deinit();
+        return EXIT_FAILURE;
+    }
+
+    LOG_INFO("Wrote %i cars to %s", carCount, outputPath.c_str());
+    LogManager::getSingleton().deinit();
+    return carCount > 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,295 @@
+//
+// SliProSuperPro
+// A Shift Light Indicator controller
+// Copyright 2025 Fixfactory
+//
+// This file is part of SliProSuperPro.
+//
+// SliProSuperPro is free software: you can redistribute it and/or modify it under
+// the terms of the GNU General Public License as published by the Free
+// Software Foundation, either version 3 of the License, or any later version.
+//
+// SliProSuperPro is distributed in the hope that it will be useful, but WITHOUT
+// ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+// FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+// more details.
+//
+// You should have received a copy of the GNU General Public License along
+// with SliProSuperPro. If not, see <http://www.gnu.org/licenses/>.
+//
+
+#include <algorithm>
+#include <cmath>
+
+#include "ShiftAnalyzer.h"
+#include "IbtReader.h"
+#include "SessionIndex.h"
+
+// Below this the acceleration depends more on traction than on the engine.
+const float kMinSpeed = 5.f;
+const float kMinRPM = 500.f;
+const float kFullThrottle = 0.95f;
+
+// An RPM bin is only compared with the next gear once it has enough samples to average out the noise.
+const int kMinBinSamples = 10;
+
+enum SessionValue
+{
+    kDriverCarIdx,
+    kDriverCarPath,
+    kDriverCarGearNumForward,
+    kDriverCarRedLine,
+};
+
+void GearStats::merge(const GearStats &other)
+{
+    for (int bin = 0; bin < kRPMBinCount; bin++)
+    {
+        accelerationSum[bin] += other.accelerationSum[bin];
+        accelerationCount[bin] += other.accelerationCount[bin];
+    }
+    speedPerRPMSum += other.speedPerRPMSum;
+    speedPerRPMCount += other.speedPerRPMCount;
+    upshiftRPM.insert(upshiftRPM.end(), other.upshiftRPM.begin(), other.upshiftRPM.end());
+    upshiftDrop.insert(upshiftDrop.end(), other.upshiftDrop.begin(), other.upshiftDrop.end());
+}
+
+void CarStats::merge(const CarStats &other)
+{
+    fileCount += other.fileCount;
+    sampleCount += other.sampleCount;
+    forwardGearCount = std::max<int>(forwardGearCount, other.forwardGearCount);
+    redLineRPM = std::max<float>(redLineRPM, other.redLineRPM);
+    for (int i = 0; i < plugin::kMaxGearCount; i++)
+    {
+        gears[i].merge(other.gears[i]);
+    }
+}
+
+bool analyzeFile(const std::string &path, CarStats &outStats, std::string &outError)
+{
+    iracing::IbtReader reader;
+    if (!reader.open(path))
+    {
+        outError = "not a readable .ibt file";
+        return false;
+    }
+
+    // The session string is null terminated in the file, but nothing guarantees it.
+    std::string sessionStr(reader.getSessionStr());
+    iracing::SessionIndex session({ "DriverInfo:DriverCarIdx:", "DriverInfo:Drivers:CarIdx:{}CarPath:",
+                                    "DriverInfo:DriverCarGearNumForward:", "DriverInfo:DriverCarRedLine:" });
+    session.index(sessionStr.c_str());
+
+    int driverCarIdx = 0;
+    session.getInt(kDriverCarIdx, driverCarIdx);
+    session.getString(kDriverCarPath, driverCarIdx, outStats.carPath);
+    session.getInt(kDriverCarGearNumForward, outStats.forwardGearCount);
+    session.getFloat(kDriverCarRedLine, outStats.redLineRPM);
+    if (outStats.carPath.empty())
+    {
+        outError = "no CarPath in the session string";
+        return false;
+    }
+
+    iracing::IbtReader::Column<int> gear = reader.getColumn<int>("Gear");
+    iracing::IbtReader::Column<float> rpm = reader.getColumn<float>("RPM");
+    iracing::IbtReader::Column<float> speed = reader.getColumn<float>("Speed");
+    if (!gear.isValid() || !rpm.isValid() || !speed.isValid())
+    {
+        outError = "no Gear, RPM or Speed variable";
+        return false;
+    }
+
+    // Files recorded without these are assumed to be at full throttle on track.
+    iracing::IbtReader::Column<float> throttle = reader.getColumn<float>("Throttle");
+    iracing::IbtReader::Column<bool> isOnTrack = reader.getColumn<bool>("IsOnTrack");
+    auto isFullThrottle = [&](int sample) { return !throttle.isValid() || throttle[sample] >= kFullThrottle; };
+
+    int tickRate = reader.getTickRate() > 0 ? reader.getTickRate() : 60;
+    int sampleCount = reader.getSampleCount();
+    outStats.fileCount = 1;
+    outStats.sampleCount = sampleCount;
+
+    // Acceleration is the change of speed over 100 ms around each sample.
+    int window = std::max<int>(tickRate / 20, 1);
+    for (int sample = window; sample < sampleCount - window; sample++)
+    {
+        int sampleGear = gear[sample];
+        int gearIdx = sampleGear + 1;
+        if (sampleGear < 1 || gearIdx >= plugin::kMaxGearCount || gear[sample - window] != sampleGear ||
+            gear[sample + window] != sampleGear || !isFullThrottle(sample - window) || !isFullThrottle(sample) ||
+            (isOnTrack.isValid() && !isOnTrack[sample]))
+        {
+            continue;
+        }
+
+        float sampleRPM = rpm[sample];
+        float sampleSpeed = speed[sample];
+        int bin = (int)(sampleRPM / kRPMBinSize);
+        if (sampleRPM < kMinRPM || sampleSpeed < kMinSpeed || bin >= kRPMBinCount)
+        {
+            continue;
+        }
+
+        GearStats &stats = outStats.gears[gearIdx];
+        stats.accelerationSum[bin] += (speed[sample + window] - speed[sample - window]) * tickRate / (2.0 * window);
+        stats.accelerationCount[bin]++;
+        stats.speedPerRPMSum += sampleSpeed / sampleRPM;
+        stats.speedPerRPMCount++;
+    }
+
+    // Only upshifts made at full throttle show where the driver wanted to shift. The engine speed settles in the new
+    // gear within half a second.
+    int lookBack = std::max<int>(tickRate / 4, 1);
+    int lookAhead = std::max<int>(tickRate / 2, 1);
+    for (int sample = lookBack; sample < sampleCount; sample++)
+    {
+        int fromGear = gear[sample - 1];
+        int fromGearIdx = fromGear + 1;
+        if (fromGear < 1 || gear[sample] != fromGear + 1 || fromGearIdx + 1 >= plugin::kMaxGearCount ||
+            gear[sample - lookBack] != fromGear || !isFullThrottle(sample - lookBack))
+        {
+            continue;
+        }
+
+        float beforeRPM = 0.f;
+        for (int before = sample - lookBack; before < sample; before++)
+        {
+            beforeRPM = std::max<float>(beforeRPM, rpm[before]);
+        }
+
+        float afterRPM = beforeRPM;
+        for (int after = sample; after < std::min<int>(sample + lookAhead, sampleCount) && gear[after] == fromGear + 1;
+             after++)
+        {
+            afterRPM = std::min<float>(afterRPM, rpm[after]);
+        }
+
+        if (beforeRPM >= kMinRPM && afterRPM > 0.f && afterRPM < beforeRPM)
+        {
+            outStats.gears[fromGearIdx].upshiftRPM.push_back(beforeRPM);
+            outStats.gears[fromGearIdx].upshiftDrop.push_back(afterRPM / beforeRPM);
+        }
+    }
+
+    return true;
+}
+
+static float median(std::vector<float> values)
+{
+    if (values.empty())
+    {
+        return 0.f;
+    }
+    std::nth_element(values.begin(), values.begin() + values.size() / 2, values.end());
+    return values[values.size() / 2];
+}
+
+static bool getAcceleration(const GearStats &stats, float rpm, double &outAcceleration)
+{
+    int bin = (int)(rpm / kRPMBinSize);
+    if (rpm < 0.f || bin >= kRPMBinCount || stats.accelerationCount[bin] < kMinBinSamples)
+    {
+        return false;
+    }
+    outAcceleration = stats.accelerationSum[bin] / stats.accelerationCount[bin];
+    return true;
+}
+
+// Returns the lowest RPM at which the next gear accelerates harder at the same speed, or 0 if there is none.
+static float findAccelerationCrossing(const GearStats &gear, const GearStats &nextGear)
+{
+    if (gear.speedPerRPMCount == 0 || nextGear.speedPerRPMCount == 0)
+    {
+        return 0.f;
+    }
+
+    // The RPM in the next gear at the same speed.
+    double drop = (gear.speedPerRPMSum / gear.speedPerRPMCount) / (nextGear.speedPerRPMSum / nextGear.speedPerRPMCount);
+
+    // Only a crossing seen in the data counts. If the next gear is already better at the lowest RPM both gears have
+    // data for, the crossing is somewhere below and unknown.
+    bool isGearBetter = false;
+    for (int bin = 0; bin < kRPMBinCount; bin++)
+    {
+        float rpm = (bin + 0.5f) * kRPMBinSize;
+        double acceleration = 0.0;
+        double nextAcceleration = 0.0;
+        if (!getAcceleration(gear, rpm, acceleration) ||
+            !getAcceleration(nextGear, (float)(rpm * drop), nextAcceleration))
+        {
+            continue;
+        }
+
+        if (nextAcceleration <= acceleration)
+        {
+            isGearBetter = true;
+        }
+        else if (isGearBetter)
+        {
+            return bin * (float)kRPMBinSize;
+        }
+    }
+    return 0.f;
+}
+
+static float roundRPM(float rpm)
+{
+    // Like the overrides written by hand.
+    return std::round(rpm / 50.f) * 50.f;
+}
+
+std::vector<ShiftPoint> computeShiftPoints(const CarStats &stats)
+{
+    std::vector<ShiftPoint> shiftPoints;
+
+    // Older files may not have the number of gears in their session string.
+    int topGearIdx = std::min<int>(stats.forwardGearCount + 1, plugin::kMaxGearCount - 1);
+    for (int gearIdx = topGearIdx + 1; gearIdx < plugin::kMaxGearCount; gearIdx++)
+    {
+        if (stats.gears[gearIdx].speedPerRPMCount > 0)
+        {
+            topGearIdx = gearIdx;
+        }
+    }
+    for (int gearIdx = 2; gearIdx < topGearIdx; gearIdx++)
+    {
+        const GearStats &gear = stats.gears[gearIdx];
+        const GearStats &nextGear = stats.gears[gearIdx + 1];
+
+        ShiftPoint shiftPoint;
+        shiftPoint.gear = gearIdx - 1;
+        shiftPoint.lastRPM = findAccelerationCrossing(gear, nextGear);
+        shiftPoint.isFromAcceleration = shiftPoint.lastRPM > 0.f;
+        if (shiftPoint.lastRPM == 0.f)
+        {
+            shiftPoint.lastRPM = median(gear.upshiftRPM);
+        }
+        if (shiftPoint.lastRPM == 0.f)
+        {
+            continue;
+        }
+        if (stats.redLineRPM > 0.f)
+        {
+            shiftPoint.lastRPM = std::min<float>(shiftPoint.lastRPM, stats.redLineRPM);
+        }
+
+        float drop = median(gear.upshiftDrop);
+        if (drop == 0.f && gear.speedPerRPMCount > 0 && nextGear.speedPerRPMCount > 0)
+        {
+            drop = (float)((gear.speedPerRPMSum / gear.speedPerRPMCount) /
+                           (nextGear.speedPerRPMSum / nextGear.speedPerRPMCount));
+        }
+        if (drop <= 0.f || drop >= 1.f)
+        {
+            continue;
+        }
+
+        shiftPoint.firstRPM = roundRPM(shiftPoint.lastRPM * drop);
+        shiftPoint.lastRPM = roundRPM(shiftPoint.lastRPM);
+        shiftPoints.push_back(shiftPoint);
+    }
+
+    return shiftPoints;
+}
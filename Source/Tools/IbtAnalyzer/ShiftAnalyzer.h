@@ -0,0 +1,79 @@
+//
+// SliProSuperPro
+// A Shift Light Indicator controller
+// Copyright 2025 Fixfactory
+//
+// This file is part of SliProSuperPro.
+//
+// SliProSuperPro is free software: you can redistribute it and/or modify it under
+// the terms of the GNU General Public License as published by the Free
+// Software Foundation, either version 3 of the License, or any later version.
+//
+// SliProSuperPro is distributed in the hope that it will be useful, but WITHOUT
+// ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+// FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+// more details.
+//
+// You should have received a copy of the GNU General Public License along
+// with SliProSuperPro. If not, see <http://www.gnu.org/licenses/>.
+//
+
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include "PluginInterface.h"
+
+// Acceleration is averaged in RPM bins of this size.
+const int kRPMBinSize = 100;
+const int kRPMBinCount = 200;
+
+// What one or more .ibt files recorded in one gear at full throttle.
+struct GearStats
+{
+    double accelerationSum[kRPMBinCount]{};
+    int accelerationCount[kRPMBinCount]{};
+
+    // Speed divided by RPM is the same at any speed in a gear, so it gives the ratios between gears.
+    double speedPerRPMSum{ 0.0 };
+    int speedPerRPMCount{ 0 };
+
+    // The RPM just before each upshift out of this gear, and the RPM after it divided by the RPM before it.
+    std::vector<float> upshiftRPM;
+    std::vector<float> upshiftDrop;
+
+    void merge(const GearStats &other);
+};
+
+// Gears are indexed like in plugin::PhysicsData: reverse is 0, neutral 1 and first gear 2.
+struct CarStats
+{
+    std::string carPath;
+    int fileCount{ 0 };
+    int sampleCount{ 0 };
+    int forwardGearCount{ 0 };
+    float redLineRPM{ 0.f };
+    GearStats gears[plugin::kMaxGearCount];
+
+    void merge(const CarStats &other);
+};
+
+struct ShiftPoint
+{
+    int gear{ 0 };
+    float firstRPM{ 0.f };
+    float lastRPM{ 0.f };
+
+    // True if lastRPM is where the next gear starts to accelerate harder, false if it is where the driver shifted.
+    bool isFromAcceleration{ false };
+};
+
+// Reads one .ibt file into stats. Doesn't log, so it can be called from several threads at once.
+bool analyzeFile(const std::string &path, CarStats &outStats, std::string &outError);
+
+// The shift lights of each forward gear that was driven enough, in gear order. The top gear has nothing to shift to, so
+// it is never included.
+// lastRPM is the RPM at which shifting up gives more acceleration, or the RPM the driver usually shifted at if there
+// isn't enough data in the next gear. firstRPM is the RPM the engine drops to after shifting up at lastRPM.
+std::vector<ShiftPoint> computeShiftPoints(const CarStats &stats);
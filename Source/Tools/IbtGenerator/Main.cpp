@@ -0,0 +1,289 @@
+//
+// SliProSuperPro
+// A Shift Light Indicator controller
+// Copyright 2025 Fixfactory
+//
+// This file is part of SliProSuperPro.
+//
+// SliProSuperPro is free software: you can redistribute it and/or modify it under
+// the terms of the GNU General Public License as published by the Free
+// Software Foundation, either version 3 of the License, or any later version.
+//
+// SliProSuperPro is distributed in the hope that it will be useful, but WITHOUT
+// ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+// FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+// more details.
+//
+// You should have received a copy of the GNU General Public License along
+// with SliProSuperPro. If not, see <http://www.gnu.org/licenses/>.
+//
+
+#include <string>
+#include <vector>
+#include <memory>
+#include <string_view>
+#include <filesystem>
+#include <fstream>
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <cstdlib>
+
+#include "Log.h"
+#include "CommandLine.h"
+#include "irsdk/irsdk_defines.h"
+#include "irsdk/irsdk_diskclient.h"
+
+#include "json/json.hpp"
+using json = nlohmann::json;
+
+// A car with a torque curve steep enough that each upshift gives more acceleration below the red line, driven at full
+// throttle by a driver who shifts late.
+const char *kCarPath = "synthetic_gt";
+const char *kOtherCarPath = "other_car";
+const int kTickRate = 60;
+const int kForwardGearCount = 6;
+const float kGearRatios[kForwardGearCount + 1] = { 0.f, 3.2f, 2.3f, 1.8f, 1.45f, 1.2f, 1.f };
+const float kFinalDrive = 3.5f;
+const float kWheelRadius = 0.33f;
+const float kMass = 1300.f;
+const float kRedLineRPM = 7500.f;
+const float kIdleRPM = 1500.f;
+
+// The analyzer averages acceleration in 100 RPM bins and rounds its RPMs to 50.
+const float kRPMTolerance = 100.f;
+
+// Gives access to the session string, which irsdkDiskWriter has no setter for.
+class IbtWriter : public irsdkDiskWriter
+{
+public:
+    void setSessionStr(const std::string &sessionStr)
+    {
+        snprintf(m_sessionInfoString, sizeof(m_sessionInfoString), "%s", sessionStr.c_str());
+    }
+};
+
+float getTorque(float rpm)
+{
+    return 420.f - 0.00003f * (rpm - 4500.f) * (rpm - 4500.f);
+}
+
+// Engine RPM per m/s of speed.
+float getRPMPerSpeed(int gear)
+{
+    return kGearRatios[gear] * kFinalDrive / kWheelRadius * 60.f / (2.f * 3.14159265f);
+}
+
+// The lowest RPM at which the next gear pulls harder than this one at the same speed, which is where the analyzer
+// should put the last shift light.
+float getAccelerationCrossing(int gear)
+{
+    for (float rpm = kIdleRPM; rpm < kRedLineRPM; rpm += 10.f)
+    {
+        float nextRPM = rpm * kGearRatios[gear + 1] / kGearRatios[gear];
+        if (getTorque(nextRPM) * kGearRatios[gear + 1] > getTorque(rpm) * kGearRatios[gear])
+        {
+            return rpm;
+        }
+    }
+    return kRedLineRPM;
+}
+
+// Accelerates at full throttle, shifting up at shiftRPM, and brakes instead of a second upshift. Each run starts in the next gear,
+// so every gear is driven over most of its RPM range.
+bool writeIbtFile(const std::string &path, float shiftRPM, int minutes)
+{
+    auto writer = std::make_unique<IbtWriter>();
+    if (!writer->openFile(path.c_str()))
+    {
+        return false;
+    }
+
+    char sessionStr[512];
+    snprintf(sessionStr, sizeof(sessionStr),
+             "---\nDriverInfo:\n DriverCarIdx: 1\n DriverCarRedLine: %.3f\n DriverCarGearNumForward: %i\n Drivers:\n"
+             " - CarIdx: 0\n   CarPath: %s\n - CarIdx: 1\n   CarPath: %s\n...\n",
+             kRedLineRPM, kForwardGearCount, kOtherCarPath, kCarPath);
+    writer->setSessionStr(sessionStr);
+
+    int sessionTimeIdx = writer->addNewVariable("SessionTime", "Seconds since session start", "s", irsdk_double);
+    int gearIdx = writer->addNewVariable("Gear", "-1=reverse  0=neutral  1..n=current gear", "", irsdk_int);
+    int rpmIdx = writer->addNewVariable("RPM", "Engine rpm", "revs/min", irsdk_float);
+    int speedIdx = writer->addNewVariable("Speed", "GPS vehicle speed", "m/s", irsdk_float);
+    int throttleIdx = writer->addNewVariable("Throttle", "0=off throttle to 1=full throttle", "%", irsdk_float);
+    int isOnTrackIdx = writer->addNewVariable("IsOnTrack", "1=Car on track physics running", "", irsdk_bool);
+    writer->finalizeHeader();
+
+    double speed = 0.0;
+    int gear = 1;
+    bool isBraking = false;
+    int shiftTicks = 0;
+    int runTicks = 0;
+    int runGear = 1;
+    int restartGear = 2;
+    int sampleCount = minutes * 60 * kTickRate;
+    for (int sample = 0; sample < sampleCount; sample++, runTicks++)
+    {
+        float rpm = std::max<float>((float)speed * getRPMPerSpeed(gear), kIdleRPM);
+        float throttle = (isBraking || shiftTicks > 0) ? 0.f : 1.f;
+        shiftTicks = std::max<int>(shiftTicks - 1, 0);
+
+        double acceleration = -8.0;
+        if (!isBraking)
+        {
+            // Drag and rolling resistance are the same in every gear at the same speed.
+            double force = throttle * getTorque(std::min<float>(rpm, kRedLineRPM)) * getRPMPerSpeed(gear) /
+                           (60.f / (2.f * 3.14159265f));
+            acceleration = force / kMass - 0.0004 * speed * speed - 0.15;
+            if (rpm >= kRedLineRPM)
+            {
+                acceleration = std::min<double>(acceleration, 0.0);
+            }
+        }
+        speed = std::max<double>(speed + acceleration / kTickRate, 0.0);
+
+        bool isShiftRPM = !isBraking && rpm >= shiftRPM;
+        if (isShiftRPM && gear <= runGear && gear < kForwardGearCount)
+        {
+            gear++;
+            shiftTicks = 3;
+        }
+        else if (isShiftRPM || (!isBraking && (speed > 70.0 || runTicks > 40 * kTickRate)))
+        {
+            isBraking = true;
+            runTicks = 0;
+        }
+        else if (isBraking && speed < 3000.f / getRPMPerSpeed(restartGear))
+        {
+            // Back on the throttle low in the rev range, in a different gear each run, so that each gear is also driven
+            // below the RPM it is shifted into.
+            isBraking = false;
+            runTicks = 0;
+            gear = restartGear;
+            runGear = restartGear;
+            restartGear = restartGear % kForwardGearCount + 1;
+        }
+        if (isBraking && gear > 2 && rpm < 3500.f)
+        {
+            gear--;
+        }
+
+        // A little noise, like real speed data.
+        float noise = (float)((sample * 7919) % 101 - 50) / 5000.f;
+        writer->setVar((double)sample / kTickRate, sessionTimeIdx);
+        writer->setVar(gear, gearIdx);
+        writer->setVar(rpm, rpmIdx);
+        writer->setVar((float)speed + noise, speedIdx);
+        writer->setVar(throttle, throttleIdx);
+        writer->setVar(true, isOnTrackIdx);
+        writer->writeLine();
+    }
+
+    writer->closeFile();
+    return true;
+}
+
+// Writes two .ibt files of the same car driven with different shift points, and an overrides file to merge into that
+// has another car, and old RPMs for the car driven.
+bool writeFiles(const std::filesystem::path &directory)
+{
+    std::error_code error;
+    std::filesystem::create_directories(directory, error);
+    if (!writeIbtFile((directory / "synthetic_gt_1.ibt").string(), 7200.f, 6) ||
+        !writeIbtFile((directory / "synthetic_gt_2.ibt").string(), 7300.f, 6))
+    {
+        LOG_ERROR("Could not write the .ibt files in %s", directory.string().c_str());
+        return false;
+    }
+
+    json overrides;
+    overrides["cars"][kOtherCarPath] = { { "firstRPM", 5000 }, { "lastRPM", 6000 } };
+    overrides["cars"][kCarPath] = { { "firstRPM", 1000 }, { "lastRPM", 2000 } };
+    std::ofstream file(directory / "iRacing.Overrides.json");
+    file << overrides.dump(4) << std::endl;
+    return file.good();
+}
+
+// Checks the overrides IbtAnalyzer merged into the file against the car's gearing and torque curve.
+int checkOverrides(const std::filesystem::path &directory)
+{
+    std::ifstream file(directory / "iRacing.Overrides.json");
+    json overrides = json::parse(file, nullptr, false);
+    if (overrides.is_discarded() || !overrides.contains("cars"))
+    {
+        LOG_ERROR("Could not read the overrides in %s", directory.string().c_str());
+        return 1;
+    }
+
+    int errorCount = 0;
+    const json &cars = overrides["cars"];
+    if (!cars.contains(kOtherCarPath) || cars[kOtherCarPath].value("lastRPM", 0) != 6000)
+    {
+        LOG_ERROR("The car already in the file wasn't kept");
+        errorCount++;
+    }
+
+    if (!cars.contains(kCarPath) || !cars[kCarPath].contains("gears"))
+    {
+        LOG_ERROR("No RPMs for each gear of %s", kCarPath);
+        return errorCount + 1;
+    }
+
+    // Reverse, neutral, then every forward gear. The top gear has nothing to shift to and uses the gear below.
+    const json &gears = cars[kCarPath]["gears"];
+    if (gears.size() != kForwardGearCount + 2)
+    {
+        LOG_ERROR("%s should have %i gears, not %zu", kCarPath, kForwardGearCount + 2, gears.size());
+        return errorCount + 1;
+    }
+
+    for (int gear = 1; gear <= kForwardGearCount; gear++)
+    {
+        int shiftGear = std::min<int>(gear, kForwardGearCount - 1);
+        float lastRPM = getAccelerationCrossing(shiftGear);
+        float firstRPM = lastRPM * kGearRatios[shiftGear + 1] / kGearRatios[shiftGear];
+
+        const json &values = gears[gear + 1];
+        float readFirstRPM = values.value("firstRPM", 0.f);
+        float readLastRPM = values.value("lastRPM", 0.f);
+        LOG_INFO("Gear %i: firstRPM %.0f, lastRPM %.0f, expected %.0f, %.0f", gear, readFirstRPM, readLastRPM, firstRPM,
+                 lastRPM);
+        if (values.value("gear", "") != std::to_string(gear) || std::abs(readLastRPM - lastRPM) > kRPMTolerance ||
+            std::abs(readFirstRPM - firstRPM) > kRPMTolerance)
+        {
+            LOG_ERROR("Wrong RPMs for gear %i", gear);
+            errorCount++;
+        }
+    }
+
+    if (gears[0] != json({ { "gear", "R" }, { "firstRPM", gears[2]["firstRPM"] }, { "lastRPM", gears[2]["lastRPM"] } }))
+    {
+        LOG_ERROR("Reverse should use the RPMs of first gear");
+        errorCount++;
+    }
+
+    return errorCount;
+}
+
+// Usage: IbtGenerator --dir [path] [--check]
+// Writes .ibt files of a simulated car, whose shift points are known from its gearing and torque curve, and an
+// overrides file for IbtAnalyzer to merge them into. With --check, checks the overrides IbtAnalyzer wrote.
+int main(int argc, char *argv[])
+{
+    LogManager::getSingleton().init();
+
+    const std::vector<std::string_view> args(argv + 1, argv + argc);
+    std::string directory(cmdLine::getOption(args, "--dir"));
+    if (directory.empty())
+    {
+        LOG_ERROR("Missing --dir [path]");
+        LogManager::getSingleton().deinit();
+        return EXIT_FAILURE;
+    }
+
+    bool succeeded = cmdLine::hasOption(args, "--check") ? checkOverrides(directory) == 0 : writeFiles(directory);
+
+    LogManager::getSingleton().deinit();
+    return succeeded ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,430 @@
+//
+// SliProSuperPro
+// A Shift Light Indicator controller
+// Copyright 2025 Fixfactory
+//
+// This file is part of SliProSuperPro.
+//
+// SliProSuperPro is free software: you can redistribute it and/or modify it under
+// the terms of the GNU General Public License as published by the Free
+// Software Foundation, either version 3 of the License, or any later version.
+//
+// SliProSuperPro is distributed in the hope that it will be useful, but WITHOUT
+// ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+// FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+// more details.
+//
+// You should have received a copy of the GNU General Public License along
+// with SliProSuperPro. If not, see <http://www.gnu.org/licenses/>.
+//
+
+#include "cinsim/CInsim.h" // Must include before Windows.h to avoid redefines
+
+#ifdef _WIN32
+    #include <WinSock2.h>
+    #include <WS2tcpip.h>
+#else
+    #include <sys/socket.h>
+    #include <sys/select.h>
+    #include <netinet/in.h>
+    #include <arpa/inet.h>
+    #include <unistd.h>
+#endif
+#include <string>
+#include <vector>
+#include <string_view>
+#include <atomic>
+#include <thread>
+#include <chrono>
+#include <cstring>
+#include <cstdlib>
+#include <cmath>
+
+#include "Log.h"
+#include "Network.h"
+#include "CommandLine.h"
+#include "PluginLibrary.h"
+
+// Match Data/LiveForSpeed.Config.json and Data/LiveForSpeed.CarData.json.
+const unsigned short kInSimPort = 29999;
+const unsigned short kOutGaugePort = 30000;
+const unsigned short kOutSimPort = 30001;
+const char *kPlayerCar = "FZ5";
+const float kPlayerCarRpmLimit = 7950.f;
+const char *kAICar = "XRT";
+
+// OutSim is sent more often than OutGauge, so the plugin should report its engine data.
+const int kOutGaugeGear = 2;
+const float kOutGaugeRpm = 3000.f;
+const int kOutSimGear = 3;
+const float kOutSimRpm = 6000.f;
+
+// OutSimPack2 with the time and drive options the config asks for (OutSim Opts 24).
+struct OutSimDrivePack
+{
+    unsigned Time;
+    byte Gear;
+    byte Sp1;
+    byte Sp2;
+    byte Sp3;
+    float EngineAngVel;
+    float MaxTorqueAtVel;
+};
+
+const std::chrono::milliseconds kFrameInterval{ 10 };
+const std::chrono::milliseconds kMaxCallDuration{ 50 };
+const std::chrono::seconds kStepTimeout{ 10 };
+
+// Written by the server thread, which can't log. Read by the main thread.
+std::atomic<const char *> g_failure{ nullptr };
+std::atomic<bool> g_isServerDone{ false };
+std::atomic<bool> g_sendOutGauge{ false };
+std::atomic<bool> g_isCarDetected{ false };
+
+#ifdef _WIN32
+static void closeSocket(SOCKET socket)
+{
+    closesocket(socket);
+}
+#else
+static void closeSocket(SOCKET socket)
+{
+    close(socket);
+}
+constexpr SOCKET INVALID_SOCKET = -1;
+#endif
+
+static bool waitForSocket(SOCKET socket)
+{
+    fd_set readSockets;
+    FD_ZERO(&readSockets);
+    FD_SET(socket, &readSockets);
+    struct timeval timeout
+    {
+        .tv_sec = (long)kStepTimeout.count(), .tv_usec = 0
+    };
+    return select((int)socket + 1, &readSockets, NULL, NULL, &timeout) > 0;
+}
+
+static SOCKET acceptClient(SOCKET listenSocket)
+{
+    if (!waitForSocket(listenSocket))
+    {
+        return INVALID_SOCKET;
+    }
+    return accept(listenSocket, NULL, NULL);
+}
+
+static bool recvAll(SOCKET socket, unsigned char *buffer, int len)
+{
+    while (len > 0)
+    {
+        if (!waitForSocket(socket))
+        {
+            return false;
+        }
+        int ret = recv(socket, reinterpret_cast<char *>(buffer), len, 0);
+        if (ret <= 0)
+        {
+            return false;
+        }
+        buffer += ret;
+        len -= ret;
+    }
+    return true;
+}
+
+// Reads one InSim packet into buffer, which must hold 1020 bytes.
+static bool recvPacket(SOCKET socket, unsigned char *buffer)
+{
+    if (!recvAll(socket, buffer, 4) || buffer[0] == 0)
+    {
+        return false;
+    }
+    return recvAll(socket, buffer + 4, buffer[0] * 4 - 4);
+}
+
+static void sendSlowly(SOCKET socket, const std::vector<unsigned char> &data, size_t splitAt)
+{
+    send(socket, reinterpret_cast<const char *>(data.data()), (int)splitAt, 0);
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    send(socket, reinterpret_cast<const char *>(data.data() + splitAt), (int)(data.size() - splitAt), 0);
+}
+
+template <typename T> static void append(std::vector<unsigned char> &data, const T &packet)
+{
+    auto bytes = reinterpret_cast<const unsigned char *>(&packet);
+    data.insert(data.end(), bytes, bytes + sizeof(packet));
+    data[data.size() - sizeof(packet)] = (unsigned char)(sizeof(packet) / 4);
+}
+
+static IS_NPL makeNpl(const char *car, bool isAI)
+{
+    IS_NPL npl{};
+    npl.Type = ISP_NPL;
+    npl.UCID = 0;
+    npl.PType = isAI ? 2 : 0;
+    memcpy(npl.CName, car, strlen(car));
+    return npl;
+}
+
+static bool fail(const char *failure)
+{
+    g_failure = failure;
+    return false;
+}
+
+static bool expectInit(SOCKET client)
+{
+    unsigned char packet[1020];
+    if (!recvPacket(client, packet))
+    {
+        return fail("No IS_ISI received");
+    }
+
+    auto isi = reinterpret_cast<const IS_ISI *>(packet);
+    if (isi->Size != sizeof(IS_ISI) / 4 || isi->Type != ISP_ISI || isi->InSimVer != INSIM_VERSION || isi->ReqI == 0)
+    {
+        return fail("Malformed IS_ISI");
+    }
+    return true;
+}
+
+// Plays LFS's side of an InSim session, feeding the plugin packets split and joined like TCP may deliver them.
+static void runServer(SOCKET listenSocket)
+{
+    unsigned char packet[1020];
+
+    SOCKET client = acceptClient(listenSocket);
+    if (client == INVALID_SOCKET)
+    {
+        fail("The plugin didn't connect");
+        g_isServerDone = true;
+        return;
+    }
+
+    bool succeeded = expectInit(client);
+    if (succeeded)
+    {
+        IS_VER version{};
+        version.Type = ISP_VER;
+        version.ReqI = 1;
+        version.InSimVer = INSIM_VERSION;
+        std::vector<unsigned char> data;
+        append(data, version);
+        sendSlowly(client, data, 3);
+
+        auto tiny = reinterpret_cast<const IS_TINY *>(packet);
+        succeeded = recvPacket(client, packet) && tiny->Type == ISP_TINY && tiny->SubT == TINY_NPL;
+        if (!succeeded)
+        {
+            fail("No TINY_NPL request after IS_VER");
+        }
+    }
+
+    if (succeeded)
+    {
+        // More AI players than the plugin's ring holds, then the player and a keep-alive split across writes.
+        std::vector<unsigned char> data;
+        for (int i = 0; i < 60; i++)
+        {
+            append(data, makeNpl(kAICar, true));
+        }
+        size_t splitAt = data.size() + 10;
+        append(data, makeNpl(kPlayerCar, false));
+        IS_TINY keepAlive{};
+        keepAlive.Type = ISP_TINY;
+        keepAlive.SubT = TINY_NONE;
+        append(data, keepAlive);
+        append(data, makeNpl(kAICar, true));
+        sendSlowly(client, data, splitAt);
+
+        auto tiny = reinterpret_cast<const IS_TINY *>(packet);
+        succeeded = recvPacket(client, packet) && tiny->Type == ISP_TINY && tiny->SubT == TINY_NONE;
+        if (!succeeded)
+        {
+            fail("No reply to the keep-alive");
+        }
+    }
+
+    if (succeeded)
+    {
+        g_sendOutGauge = true;
+        auto endTime = std::chrono::steady_clock::now() + kStepTimeout;
+        while (!g_isCarDetected && std::chrono::steady_clock::now() < endTime)
+        {
+            std::this_thread::sleep_for(kFrameInterval);
+        }
+        succeeded = g_isCarDetected || fail("The player's car or engine data wasn't received");
+    }
+
+    // LFS closing InSim, which the plugin should recover from.
+    closeSocket(client);
+    if (succeeded)
+    {
+        client = acceptClient(listenSocket);
+        if (client != INVALID_SOCKET)
+        {
+            expectInit(client);
+            closeSocket(client);
+        }
+        else
+        {
+            fail("The plugin didn't reconnect");
+        }
+    }
+
+    g_isServerDone = true;
+}
+
+// Usage: InSimStandIn --plugin [path] [--outSim] [--relayPort [value]]
+// Stands in for Live For Speed on the loopback interface: runs an InSim session with the plugin and sends it OutGauge
+// data, checking that it detects the player's car and that polling it never blocks. Run from the Data directory.
+// With --outSim, also sends newer OutSim data, and checks the plugin reports its engine data instead. OutSim must be
+// enabled in the config. With --relayPort, checks that the plugin relays the packets to that port unchanged.
+int main(int argc, char *argv[])
+{
+    LogManager::getSingleton().init();
+
+    const std::vector<std::string_view> args(argv + 1, argv + argc);
+    std::string libraryPath(cmdLine::getOption(args, "--plugin"));
+    bool useOutSim = cmdLine::hasOption(args, "--outSim");
+    std::string relayPort(cmdLine::getOption(args, "--relayPort"));
+    if (libraryPath.empty())
+    {
+        LOG_ERROR("Missing --plugin [path]");
+        LogManager::getSingleton().deinit();
+        return EXIT_FAILURE;
+    }
+
+    WSASession session;
+    SOCKET listenSocket = socket(AF_INET, SOCK_STREAM, IPPROTO_TCP);
+    int reuse = 1;
+    setsockopt(listenSocket, SOL_SOCKET, SO_REUSEADDR, reinterpret_cast<const char *>(&reuse), sizeof(reuse));
+    sockaddr_in address{};
+    address.sin_family = AF_INET;
+    address.sin_port = htons(kInSimPort);
+    inet_pton(AF_INET, "127.0.0.1", &address.sin_addr);
+    if (bind(listenSocket, reinterpret_cast<sockaddr *>(&address), sizeof(address)) != 0 ||
+        listen(listenSocket, 1) != 0)
+    {
+        LOG_ERROR("Could not listen on port %i", kInSimPort);
+        closeSocket(listenSocket);
+        LogManager::getSingleton().deinit();
+        return EXIT_FAILURE;
+    }
+
+    PluginLibrary plugin;
+    if (!plugin.load(libraryPath))
+    {
+        closeSocket(listenSocket);
+        LogManager::getSingleton().deinit();
+        return EXIT_FAILURE;
+    }
+
+    std::thread server(runServer, listenSocket);
+    plugin.setGameIsRunning(true, "");
+
+    UDPSocket outGaugeSocket;
+    OutGaugePack outGaugePack{};
+    outGaugePack.Gear = kOutGaugeGear;
+    outGaugePack.RPM = kOutGaugeRpm;
+
+    OutSimDrivePack outSimPack{};
+    outSimPack.Gear = kOutSimGear;
+    outSimPack.EngineAngVel = kOutSimRpm * 2.f * 3.14159265f / 60.f;
+    UDPSocket relaySocket;
+    if (!relayPort.empty())
+    {
+        relaySocket.bindTo((unsigned short)std::stoi(relayPort));
+    }
+    std::vector<char> relayBuf;
+    int relayedOutGaugeCount = 0;
+    int relayedOutSimCount = 0;
+
+    const int expectedGear = useOutSim ? kOutSimGear : kOutGaugeGear;
+    const float expectedRpm = useOutSim ? kOutSimRpm : kOutGaugeRpm;
+
+    auto maxCallDuration = std::chrono::steady_clock::duration::zero();
+    while (!g_isServerDone)
+    {
+        if (g_sendOutGauge)
+        {
+            // Without a car name, so the car can only come from InSim.
+            outGaugePack.Time += 10;
+            outGaugeSocket.sendTo("127.0.0.1", kOutGaugePort, reinterpret_cast<const char *>(&outGaugePack),
+                                  sizeof(outGaugePack) - sizeof(outGaugePack.ID));
+
+            if (useOutSim)
+            {
+                outSimPack.Time = outGaugePack.Time + 5;
+                outGaugeSocket.sendTo("127.0.0.1", kOutSimPort, reinterpret_cast<const char *>(&outSimPack),
+                                      sizeof(outSimPack));
+            }
+        }
+
+        auto startTime = std::chrono::steady_clock::now();
+        plugin::TelemetryData telemetryData{};
+        plugin.getTelemetryData(&telemetryData, sizeof(telemetryData));
+        plugin::PhysicsData physicsData{};
+        bool hasPhysicsData = plugin.getPhysicsData(&physicsData, sizeof(physicsData));
+        maxCallDuration = std::max(maxCallDuration, std::chrono::steady_clock::now() - startTime);
+
+        // The plugin relays what it receives when polled, so this frame's packets are expected.
+        while (relaySocket.isBound() && relaySocket.hasData())
+        {
+            sockaddr_in fromAddr;
+            relayBuf.resize(sizeof(outGaugePack));
+            relaySocket.recvData(relayBuf, fromAddr);
+            const size_t kOutGaugeSize = sizeof(outGaugePack) - sizeof(outGaugePack.ID);
+            if (relayBuf.size() == kOutGaugeSize && memcmp(relayBuf.data(), &outGaugePack, kOutGaugeSize) == 0)
+            {
+                relayedOutGaugeCount++;
+            }
+            else if (relayBuf.size() == sizeof(outSimPack) &&
+                     memcmp(relayBuf.data(), &outSimPack, sizeof(outSimPack)) == 0)
+            {
+                relayedOutSimCount++;
+            }
+        }
+
+        if (hasPhysicsData && physicsData.rpmLimit == kPlayerCarRpmLimit && telemetryData.gear == expectedGear &&
+            std::fabs(telemetryData.rpm - expectedRpm) < 1.f)
+        {
+            g_isCarDetected = true;
+        }
+
+        std::this_thread::sleep_for(kFrameInterval);
+    }
+
+    server.join();
+    plugin.setGameIsRunning(false, "");
+    plugin.unload();
+    closeSocket(listenSocket);
+
+    float maxCallMilliseconds = std::chrono::duration<float, std::milli>(maxCallDuration).count();
+    LOG_INFO("Longest plugin call: %.2f ms", maxCallMilliseconds);
+
+    bool succeeded = g_failure == nullptr;
+    if (!succeeded)
+    {
+        LOG_ERROR("%s", g_failure.load());
+    }
+    if (maxCallDuration > kMaxCallDuration)
+    {
+        LOG_ERROR("Polling the plugin blocked for more than %lli ms", (long long)kMaxCallDuration.count());
+        succeeded = false;
+    }
+    if (!relayPort.empty() && (relayedOutGaugeCount == 0 || (useOutSim && relayedOutSimCount == 0)))
+    {
+        LOG_ERROR("Packets not relayed (%i OutGauge, %i OutSim)", relayedOutGaugeCount, relayedOutSimCount);
+        succeeded = false;
+    }
+    if (succeeded)
+    {
+        LOG_INFO("InSim session completed");
+    }
+
+    LogManager::getSingleton().deinit();
+    return succeeded ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,398 @@
+//
+// SliProSuperPro
+// A Shift Light Indicator controller
+// Copyright 2025 Fixfactory
+//
+// This file is part of SliProSuperPro.
+//
+// SliProSuperPro is free software: you can redistribute it and/or modify it under
+// the terms of the GNU General Public License as published by the Free
+// Software Foundation, either version 3 of the License, or any later version.
+//
+// SliProSuperPro is distributed in the hope that it will be useful, but WITHOUT
+// ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+// FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+// more details.
+//
+// You should have received a copy of the GNU General Public License along
+// with SliProSuperPro. If not, see <http://www.gnu.org/licenses/>.
+//
+
+#include <string>
+#include <vector>
+#include <string_view>
+#include <fstream>
+#include <sstream>
+#include <filesystem>
+#include <chrono>
+#include <algorithm>
+#include <limits>
+#include <thread>
+#include <cstring>
+#include <cstdlib>
+
+#include "Log.h"
+#include "CommandLine.h"
+#include "MappedFile.h"
+#include "NGP.h"
+#include "LspParser.h"
+#include "PhysicsIndex.h"
+
+using rbrNgp::ngp::CarPhysics;
+
+// Generated cars have as many lines as a typical NGP common.lsp, most of them for values the plugin doesn't use.
+const int kFillerLineCount = 1500;
+const int kTorqueCurvePointCount = 20;
+
+// The 8 original NGP cars, followed by cars in folders of their own like RSF installs them.
+const int kGeneratedCarCount = 48;
+
+// The car slot Cars.ini installs a car from its own folder in, and that car. The folder's case doesn't match.
+const int kInstalledSlot = 3;
+const int kInstalledCar = 18;
+
+std::string carFolder(int car)
+{
+    return car < (int)rbrNgp::ngp::kFolderNameCount ? rbrNgp::ngp::kFolderNames[car] : "rsf_" + std::to_string(car);
+}
+
+// Forward gears, which come after reverse and neutral in the LSP files and in CarPhysics.
+const int kMaxForwardGearCount = 6;
+static_assert(kMaxForwardGearCount + 2 <= (int)rbrNgp::ngp::kGearCount, "Generated cars have more gears than CarPhysics");
+
+int expectedGearCount(int car)
+{
+    return kMaxForwardGearCount - 1 + car % 2;
+}
+
+float expectedRatio(int car, int gear)
+{
+    return gear == 0 ? -3.5f : (gear == 1 ? 0.f : 3.8f - (float)(gear - 2) * 0.45f + (float)car * 0.01f);
+}
+
+float expectedShift(int car, int gear, bool upshift)
+{
+    return gear < 2 ? 0.f : (upshift ? 7000.f + (float)(car * 10 + gear) : 3000.f + (float)(car * 10 + gear));
+}
+
+float expectedRpmLimit(int car)
+{
+    return 7500.f + (float)car * 100.f;
+}
+
+float expectedTorque(int car, int point)
+{
+    return 150.f + (float)point * 7.5f - (float)car;
+}
+
+void writeCommon(const std::filesystem::path &path, int car)
+{
+    std::ofstream file(path);
+    file.precision(std::numeric_limits<float>::max_digits10);
+    file << "; " << carFolder(car) << " physics, generated by LspBenchmark\n";
+    file << "(\"Car\"\n  Name \"" << carFolder(car) << "\"\n";
+
+    int filler = 0;
+    auto writeFiller = [&](int count) {
+        for (int i = 0; i < count; i++, filler++)
+        {
+            file << "  Value" << filler << " " << (float)filler * 0.125f << " ; unused\n";
+        }
+    };
+
+    writeFiller(kFillerLineCount / 3);
+    file << ")\nDrive\n(\n  Type \"FWD\"\n  NumberOfGears " << expectedGearCount(car) << "\n";
+    for (int gear = 0; gear < expectedGearCount(car) + 2; gear++)
+    {
+        file << "  Gear" << gear << "Ratio " << expectedRatio(car, gear) << "\n";
+    }
+    writeFiller(kFillerLineCount / 3);
+    file << ")\nEngine\n(\n  TorqueCurve\n  (\n";
+    for (int point = 0; point < kTorqueCurvePointCount; point++)
+    {
+        file << "    (" << 1000 + point * 400 << " " << expectedTorque(car, point) << ")\n";
+    }
+    file << "  )\n";
+    writeFiller(kFillerLineCount / 3);
+    file << ")\nControlUnit\n(\n  RPMLimit " << expectedRpmLimit(car) << "\n";
+    for (int gear = 0; gear < expectedGearCount(car) + 2; gear++)
+    {
+        file << "  Gear" << gear << "Upshift " << expectedShift(car, gear, true) << "\n";
+        file << "  Gear" << gear << "Downshift " << expectedShift(car, gear, false) << "\n";
+    }
+    file << ")\n";
+}
+
+// Slots keep their original folder unless they hold a car that has physics of its own.
+void writeCarList(const std::filesystem::path &path)
+{
+    std::ofstream file(path);
+    for (int slot = 0; slot < (int)rbrNgp::ngp::kFolderNameCount; slot++)
+    {
+        std::string folder =
+            slot == kInstalledSlot ? "RSF_" + std::to_string(kInstalledCar) : "Car" + std::to_string(slot);
+        file << "[Car0" << slot << "]\nCarName=Car " << slot << "\nFileName=Cars\\" << folder << "\\car.sgc\n\n";
+    }
+}
+
+bool checkGenerated(const CarPhysics &carPhysics, int car)
+{
+    bool isValid = carPhysics.drive.numberOfGears == expectedGearCount(car) &&
+                   carPhysics.controlUnit.rpmLimit == expectedRpmLimit(car) &&
+                   carPhysics.engine.torqueCurvePointCount == kTorqueCurvePointCount;
+    for (int gear = 0; gear < expectedGearCount(car) + 2; gear++)
+    {
+        isValid &= carPhysics.drive.gearRatio[gear] == expectedRatio(car, gear);
+        isValid &= carPhysics.controlUnit.gearUpShift[gear] == expectedShift(car, gear, true);
+        isValid &= carPhysics.controlUnit.gearDownShift[gear] == expectedShift(car, gear, false);
+    }
+    for (int point = 0; point < carPhysics.engine.torqueCurvePointCount && isValid; point++)
+    {
+        isValid &= carPhysics.engine.torqueCurveRpm[point] == (float)(1000 + point * 400);
+        isValid &= carPhysics.engine.torqueCurveTorque[point] == expectedTorque(car, point);
+    }
+    return isValid;
+}
+
+// What NgpManager::readCommon did before the LspParser: a stream per line, and substring searches per key.
+bool readCommonGetline(const std::filesystem::path &path, CarPhysics &outCarPhysics)
+{
+    std::ifstream file(path);
+    if (!file.is_open())
+    {
+        return false;
+    }
+
+    std::string line;
+    while (std::getline(file, line))
+    {
+        std::istringstream stream(line);
+        std::string name;
+        float value;
+        if (stream >> name >> value)
+        {
+            if (name.find("NumberOfGears") != std::string::npos)
+            {
+                outCarPhysics.drive.numberOfGears = (int)value;
+            }
+            else if (name.find("Gear") != std::string::npos)
+            {
+                int gear = atoi(&name[4]);
+                if (gear < 0 || gear >= (int)rbrNgp::ngp::kGearCount)
+                {
+                    continue;
+                }
+                if (name.find("Upshift") != std::string::npos)
+                {
+                    outCarPhysics.controlUnit.gearUpShift[gear] = value;
+                }
+                else if (name.find("Downshift") != std::string::npos)
+                {
+                    outCarPhysics.controlUnit.gearDownShift[gear] = value;
+                }
+            }
+            else if (name.find("RPMLimit") != std::string::npos)
+            {
+                outCarPhysics.controlUnit.rpmLimit = value;
+            }
+        }
+    }
+    return true;
+}
+
+bool readCommonMapped(const std::filesystem::path &path, CarPhysics &outCarPhysics)
+{
+    MappedFile file;
+    if (!file.open(path.string()))
+    {
+        return false;
+    }
+    rbrNgp::ngp::parseCommon(file.getData(), file.getSize(), outCarPhysics);
+    return true;
+}
+
+// Only the values both read.
+bool isSameControlUnit(const CarPhysics &a, const CarPhysics &b)
+{
+    return a.drive.numberOfGears == b.drive.numberOfGears &&
+           memcmp(&a.controlUnit, &b.controlUnit, sizeof(a.controlUnit)) == 0;
+}
+
+using ReadFunction = bool (*)(const std::filesystem::path &path, CarPhysics &outCarPhysics);
+
+double measure(ReadFunction readFunction, const std::vector<std::filesystem::path> &paths, int iterations)
+{
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < iterations; i++)
+    {
+        for (const auto &path : paths)
+        {
+            CarPhysics carPhysics{};
+            readFunction(path, carPhysics);
+        }
+    }
+    double us = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count();
+    return us / ((double)iterations * (double)paths.size());
+}
+
+// Reads the physics of each car slot from the index, and checks them against the generated cars.
+int checkSlots(const rbrNgp::PhysicsIndex &physicsIndex, int firstSlotCar)
+{
+    int errorCount = 0;
+    for (int slot = 0; slot < (int)rbrNgp::ngp::kFolderNameCount; slot++)
+    {
+        int car = slot == kInstalledSlot ? kInstalledCar : (slot == 0 ? firstSlotCar : slot);
+        const CarPhysics *carPhysics = physicsIndex.findCar(slot);
+        if (!carPhysics || !checkGenerated(*carPhysics, car))
+        {
+            LOG_ERROR("Wrong physics indexed for car slot %i", slot);
+            errorCount++;
+        }
+    }
+    return errorCount;
+}
+
+double measureIndex(rbrNgp::PhysicsIndex &physicsIndex, const std::string &cachePath, const std::string &gamePath)
+{
+    auto start = std::chrono::steady_clock::now();
+    physicsIndex.init(cachePath, gamePath);
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+// Usage: LspBenchmark [--physics [path]] [--iterations [value]]
+// Compares reading every car's common.lsp in RBR's Physics folder with the RBR plugin's old getline parser and its
+// memory-mapped LspParser, and checks they agree. Then measures scanning the folder into the plugin's PhysicsIndex,
+// without and with its cache file, and how long starting the plugin's background scan holds up the caller.
+// Without --physics, a folder of generated cars and a Cars.ini are written to the temporary directory first and
+// removed afterwards, and the values read are also checked against them.
+int main(int argc, char *argv[])
+{
+    LogManager::getSingleton().init();
+
+    const std::vector<std::string_view> args(argv + 1, argv + argc);
+    std::string physicsPath(cmdLine::getOption(args, "--physics"));
+    std::string iterationsStr(cmdLine::getOption(args, "--iterations"));
+    int iterations = iterationsStr.empty() ? 100 : std::stoi(iterationsStr);
+
+    bool isGenerated = physicsPath.empty();
+    std::filesystem::path tempDir = std::filesystem::temp_directory_path() / "LspBenchmark";
+    std::filesystem::path physicsDir = isGenerated ? tempDir / "Physics" : std::filesystem::path(physicsPath);
+    std::filesystem::create_directories(tempDir);
+    if (isGenerated)
+    {
+        for (int car = 0; car < kGeneratedCarCount; car++)
+        {
+            std::filesystem::create_directories(physicsDir / carFolder(car));
+            writeCommon(physicsDir / carFolder(car) / "common.lsp", car);
+        }
+        std::filesystem::create_directories(tempDir / "Cars");
+        writeCarList(tempDir / "Cars" / "Cars.ini");
+    }
+
+    std::vector<std::filesystem::path> paths;
+    std::error_code error;
+    for (const auto &entry : std::filesystem::directory_iterator(physicsDir, error))
+    {
+        auto path = entry.path() / "common.lsp";
+        if (entry.is_directory() && std::filesystem::exists(path))
+        {
+            paths.push_back(path);
+        }
+    }
+    std::sort(paths.begin(), paths.end());
+
+    int errorCount = 0;
+    for (const auto &path : paths)
+    {
+        CarPhysics oldPhysics{};
+        CarPhysics newPhysics{};
+        if (!readCommonGetline(path, oldPhysics) || !readCommonMapped(path, newPhysics) ||
+            !isSameControlUnit(oldPhysics, newPhysics))
+        {
+            LOG_ERROR("Parsers disagree on %s", path.string().c_str());
+            errorCount++;
+            continue;
+        }
+
+        std::string folder = path.parent_path().filename().string();
+        for (int car = 0; isGenerated && car < kGeneratedCarCount; car++)
+        {
+            if (folder == carFolder(car) && !checkGenerated(newPhysics, car))
+            {
+                LOG_ERROR("Wrong values read from %s", path.string().c_str());
+                errorCount++;
+            }
+        }
+
+        if (!isGenerated)
+        {
+            LOG_INFO("%-24s %i gears, rpm limit %.0f, %i torque curve points", folder.c_str(),
+                     newPhysics.drive.numberOfGears, newPhysics.controlUnit.rpmLimit,
+                     newPhysics.engine.torqueCurvePointCount);
+        }
+    }
+
+    if (paths.empty())
+    {
+        LOG_ERROR("No common.lsp found in %s", physicsDir.string().c_str());
+        errorCount++;
+    }
+    else
+    {
+        LOG_INFO("%-32s %8.1f us/file, %i files, %i iterations", "getline + istringstream",
+                 measure(readCommonGetline, paths, iterations), (int)paths.size(), iterations);
+        LOG_INFO("%-32s %8.1f us/file, %i files, %i iterations", "MappedFile + LspParser",
+                 measure(readCommonMapped, paths, iterations), (int)paths.size(), iterations);
+
+        std::string cachePath = (tempDir / "RBR-NGP.Physics.cache").string();
+        std::string gamePath = physicsDir.parent_path().string();
+        std::filesystem::remove(cachePath, error);
+
+        rbrNgp::PhysicsIndex physicsIndex;
+        double coldMs = measureIndex(physicsIndex, cachePath, gamePath);
+        double warmMs = measureIndex(physicsIndex, cachePath, gamePath);
+        LOG_INFO("%-32s %8.2f ms, %zu cars", "PhysicsIndex without cache", coldMs, physicsIndex.getCarCount());
+        LOG_INFO("%-32s %8.2f ms, %zu cars", "PhysicsIndex with cache", warmMs, physicsIndex.getCarCount());
+
+        if (physicsIndex.getCarCount() != paths.size())
+        {
+            LOG_ERROR("Indexed %zu cars instead of %zu", physicsIndex.getCarCount(), paths.size());
+            errorCount++;
+        }
+
+        if (isGenerated)
+        {
+            errorCount += checkSlots(physicsIndex, 0);
+
+            // A changed car must be read again on the next scan.
+            writeCommon(physicsDir / carFolder(0) / "common.lsp", 1);
+            physicsIndex.init(cachePath, gamePath);
+            errorCount += checkSlots(physicsIndex, 1);
+        }
+        physicsIndex.deinit();
+        std::filesystem::remove(cachePath, error);
+
+        // The plugin scans in the background, and writes its cache in the working directory.
+        std::filesystem::path workingDir = std::filesystem::current_path();
+        std::filesystem::current_path(tempDir);
+        auto start = std::chrono::steady_clock::now();
+        rbrNgp::NgpManager::getSingleton().init(gamePath);
+        double initMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+        while (!rbrNgp::NgpManager::getSingleton().isPhysicsIndexLoaded())
+        {
+            std::this_thread::sleep_for(std::chrono::microseconds(100));
+        }
+        double loadMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+        rbrNgp::NgpManager::getSingleton().deinit();
+        std::filesystem::current_path(workingDir);
+        LOG_INFO("%-32s %8.2f ms, index loaded after %.2f ms", "NgpManager::init without cache", initMs, loadMs);
+    }
+
+    if (isGenerated)
+    {
+        std::filesystem::remove_all(tempDir, error);
+    }
+
+    LogManager::getSingleton().deinit();
+    return errorCount == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
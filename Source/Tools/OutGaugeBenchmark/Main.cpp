@@ -0,0 +1,234 @@
+//
+// SliProSuperPro
+// A Shift Light Indicator controller
+// Copyright 2025 Fixfactory
+//
+// This file is part of SliProSuperPro.
+//
+// SliProSuperPro is free software: you can redistribute it and/or modify it under
+// the terms of the GNU General Public License as published by the Free
+// Software Foundation, either version 3 of the License, or any later version.
+//
+// SliProSuperPro is distributed in the hope that it will be useful, but WITHOUT
+// ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+// FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+// more details.
+//
+// You should have received a copy of the GNU General Public License along
+// with SliProSuperPro. If not, see <http://www.gnu.org/licenses/>.
+//
+
+#include "cinsim/CInsim.h" // Must include before Windows.h to avoid redefines
+
+#include "Network.h"
+#ifdef _WIN32
+    #include <Windows.h>
+#else
+    #include <time.h>
+#endif
+#include <string>
+#include <vector>
+#include <string_view>
+#include <atomic>
+#include <thread>
+#include <chrono>
+#include <cstring>
+#include <cstdlib>
+
+#include "Log.h"
+#include "CommandLine.h"
+
+// Because when no ID is specified, the ID field is omitted.
+const int kOutGaugePackSizeNoId = sizeof(OutGaugePack) - sizeof(int);
+
+// How often SliProSuperPro polls plugins.
+const std::chrono::milliseconds kFrameInterval{ 10 };
+
+// LFS sends OutGauge at up to 100 Hz. The higher rates show how receiving scales when packets pile up.
+const int kRates[] = { 100, 1000, 10000, 100000 };
+
+struct Result
+{
+    int sentCount{ 0 };
+    int receivedCount{ 0 };
+    int pollCount{ 0 };
+    double cpuNs{ 0.0 };
+    int errorCount{ 0 };
+};
+
+// The receive functions return true if they got a packet, and the Time of the one they kept.
+using ReceiveFunction = bool (*)(UDPSocket &socket, std::vector<char> &recvBuf, unsigned &outTime, int &outCount);
+
+// What the Live For Speed plugin did before UDPSocket::recvLatest: one select() and recvfrom() per packet, and a copy
+// of each one.
+bool receiveEach(UDPSocket &socket, std::vector<char> &recvBuf, unsigned &outTime, int &outCount)
+{
+    sockaddr_in fromAddr;
+    bool gotData = false;
+    while (socket.hasData())
+    {
+        recvBuf.resize(kOutGaugePackSizeNoId);
+        socket.recvData(recvBuf, fromAddr);
+        outCount++;
+        if (recvBuf.size() != kOutGaugePackSizeNoId)
+        {
+            continue;
+        }
+
+        OutGaugePack outGaugePack;
+        memcpy(&outGaugePack, recvBuf.data(), kOutGaugePackSizeNoId);
+        outTime = outGaugePack.Time;
+        gotData = true;
+    }
+    return gotData;
+}
+
+bool receiveLatest(UDPSocket &socket, std::vector<char> &recvBuf, unsigned &outTime, int &outCount)
+{
+    int malformedCount = 0;
+    recvBuf.resize(kOutGaugePackSizeNoId);
+    if (!socket.recvLatest(recvBuf.data(), kOutGaugePackSizeNoId, outCount, malformedCount))
+    {
+        return false;
+    }
+
+    outTime = reinterpret_cast<const OutGaugePack *>(recvBuf.data())->Time;
+    return true;
+}
+
+// CPU time of the calling thread, so time spent waiting or in the sending thread isn't counted.
+double getThreadCpuNs()
+{
+#ifdef _WIN32
+    FILETIME creationTime, exitTime, kernelTime, userTime;
+    GetThreadTimes(GetCurrentThread(), &creationTime, &exitTime, &kernelTime, &userTime);
+    auto toNs = [](const FILETIME &time) {
+        return (double)(((unsigned long long)time.dwHighDateTime << 32) | time.dwLowDateTime) * 100.0;
+    };
+    return toNs(kernelTime) + toNs(userTime);
+#else
+    timespec time;
+    clock_gettime(CLOCK_THREAD_CPUTIME_ID, &time);
+    return (double)time.tv_sec * 1e9 + (double)time.tv_nsec;
+#endif
+}
+
+// Sends numbered packets at the given rate, then once more after a pause, when the receiver should have caught up.
+void sendPackets(unsigned short port, int rate, std::chrono::duration<float> duration, std::atomic<int> &outSentCount)
+{
+    UDPSocket socket;
+    OutGaugePack outGaugePack{};
+    memcpy(outGaugePack.Car, "FZ5", 3);
+    outGaugePack.Gear = 3;
+    outGaugePack.RPM = 5000.f;
+
+    int sentCount = 0;
+    auto start = std::chrono::steady_clock::now();
+    for (auto elapsed = std::chrono::steady_clock::duration::zero(); elapsed < duration;
+         elapsed = std::chrono::steady_clock::now() - start)
+    {
+        int targetCount = (int)(std::chrono::duration<double>(elapsed).count() * rate);
+        for (; sentCount < targetCount; sentCount++)
+        {
+            outGaugePack.Time = sentCount + 1;
+            socket.sendTo("127.0.0.1", port, reinterpret_cast<const char *>(&outGaugePack), kOutGaugePackSizeNoId);
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+
+    std::this_thread::sleep_for(kFrameInterval * 3);
+    outGaugePack.Time = ++sentCount;
+    socket.sendTo("127.0.0.1", port, reinterpret_cast<const char *>(&outGaugePack), kOutGaugePackSizeNoId);
+    outSentCount = sentCount;
+}
+
+Result runBenchmark(ReceiveFunction receiveFunction, unsigned short port, int rate,
+                    std::chrono::duration<float> duration)
+{
+    Result result;
+    UDPSocket socket;
+    socket.bindTo(port);
+
+    std::atomic<int> sentCount{ 0 };
+    std::thread sender(sendPackets, port, rate, duration, std::ref(sentCount));
+
+    // Polls like the plugin does, until the last packet arrived or it clearly won't.
+    std::vector<char> recvBuf;
+    unsigned lastTime = 0;
+    auto endTime = std::chrono::steady_clock::now() + duration + kFrameInterval * 50;
+    while (std::chrono::steady_clock::now() < endTime && (sentCount == 0 || lastTime != (unsigned)sentCount))
+    {
+        unsigned time = 0;
+        int count = 0;
+        double startNs = getThreadCpuNs();
+        bool gotData = receiveFunction(socket, recvBuf, time, count);
+        result.cpuNs += getThreadCpuNs() - startNs;
+        result.pollCount++;
+        result.receivedCount += count;
+
+        // The packet kept must be the newest one.
+        if (gotData)
+        {
+            if (time <= lastTime)
+            {
+                result.errorCount++;
+            }
+            lastTime = time;
+        }
+
+        std::this_thread::sleep_for(kFrameInterval);
+    }
+
+    sender.join();
+    result.sentCount = sentCount;
+    if (lastTime != (unsigned)sentCount)
+    {
+        result.errorCount++;
+    }
+    return result;
+}
+
+bool reportResult(const char *name, int rate, const Result &result)
+{
+    LOG_INFO("%-24s %6i packets/s %8.0f ns/packet %8.2f us/poll, %i of %i packets, %i errors", name, rate,
+             result.receivedCount > 0 ? result.cpuNs / result.receivedCount : 0.0,
+             result.cpuNs / result.pollCount / 1000.0, result.receivedCount, result.sentCount, result.errorCount);
+    return result.errorCount == 0;
+}
+
+// Usage: OutGaugeBenchmark [--seconds [value]] [--port [value]]
+// Floods a loopback port with OutGauge packets at several rates, and measures the CPU time the receiving thread spends
+// per packet, receiving them one at a time like the Live For Speed plugin used to and with UDPSocket::recvLatest.
+// Also checks that the newest packet is always the one kept. Packets dropped by a full socket buffer are not
+// received, so aren't counted.
+int main(int argc, char *argv[])
+{
+    LogManager::getSingleton().init();
+
+    const std::vector<std::string_view> args(argv + 1, argv + argc);
+    std::string seconds(cmdLine::getOption(args, "--seconds"));
+    std::string port(cmdLine::getOption(args, "--port"));
+    auto duration = std::chrono::duration<float>(seconds.empty() ? 2.f : std::stof(seconds));
+    unsigned short udpPort = (unsigned short)(port.empty() ? 30100 : std::stoi(port));
+
+    bool succeeded = true;
+    try
+    {
+        WSASession session;
+        for (int rate : kRates)
+        {
+            Result result = runBenchmark(receiveEach, udpPort, rate, duration);
+            succeeded &= reportResult("select + recvfrom", rate, result);
+            result = runBenchmark(receiveLatest, udpPort, rate, duration);
+            succeeded &= reportResult("UDPSocket::recvLatest", rate, result);
+        }
+    }
+    catch (const std::system_error &error)
+    {
+        LOG_ERROR(error);
+        succeeded = false;
+    }
+
+    LogManager::getSingleton().deinit();
+    return succeeded ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,412 @@
+//
+// SliProSuperPro
+// A Shift Light Indicator controller
+// Copyright 2025 Fixfactory
+//
+// This file is part of SliProSuperPro.
+//
+// SliProSuperPro is free software: you can redistribute it and/or modify it under
+// the terms of the GNU General Public License as published by the Free
+// Software Foundation, either version 3 of the License, or any later version.
+//
+// SliProSuperPro is distributed in the hope that it will be useful, but WITHOUT
+// ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+// FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+// more details.
+//
+// You should have received a copy of the GNU General Public License along
+// with SliProSuperPro. If not, see <http://www.gnu.org/licenses/>.
+//
+
+#include <string>
+#include <vector>
+#include <string_view>
+#include <fstream>
+#include <filesystem>
+#include <chrono>
+#include <thread>
+#include <new>
+#include <cstdio>
+#include <cstring>
+#include <cstdlib>
+
+#include "Log.h"
+#include "CommandLine.h"
+#include "OverrideIndex.h"
+#include "CarData.h"
+
+struct OverridesFile
+{
+    const char *fileName;
+    const char *downshiftKey;
+    const char *upshiftKey;
+    overrides::CarIndex<overrides::CarOverride>::ParseCar parseOverride;
+};
+
+const OverridesFile kFiles[] = {
+    { "iRacing.Overrides.json", "firstRPM", "lastRPM", overrides::parseShiftLightOverride },
+    { "ACR.Overrides.json", "rpmDownshift", "rpmUpshift", overrides::parseCarOverride },
+    { "LiveForSpeed.CarData.json", "rpmDownshift", "rpmUpshift", overrides::parseCarOverride },
+};
+
+const OverridesFile *g_file = nullptr;
+
+// The heap memory in use, to compare what parsing a file keeps with mapping its compiled file.
+size_t g_heapSize = 0;
+
+void *operator new(size_t size)
+{
+    // The size is kept in front of the block, so it can be taken off when the block is freed.
+    size_t *block = static_cast<size_t *>(malloc(size + sizeof(std::max_align_t)));
+    if (block == nullptr)
+    {
+        throw std::bad_alloc();
+    }
+    *block = size;
+    g_heapSize += size;
+    return reinterpret_cast<char *>(block) + sizeof(std::max_align_t);
+}
+
+void operator delete(void *data) noexcept
+{
+    if (data != nullptr)
+    {
+        size_t *block = reinterpret_cast<size_t *>(static_cast<char *>(data) - sizeof(std::max_align_t));
+        g_heapSize -= *block;
+        free(block);
+    }
+}
+
+void operator delete(void *data, size_t) noexcept
+{
+    operator delete(data);
+}
+
+// How the plugins read a car before they shared the index: the car is copied out of the file's document when it is
+// entered, and its gears are found by name.
+void parseOverrideFromDocument(json &root, const std::string &carId, overrides::CarOverride &outOverride)
+{
+    json car = root["cars"][carId];
+    if (car.empty())
+    {
+        car = root["cars"]["mods"][carId];
+    }
+
+    if (!car[g_file->downshiftKey].empty() && !car[g_file->upshiftKey].empty())
+    {
+        for (int i = 0; i < plugin::kMaxGearCount; i++)
+        {
+            outOverride.rpmDownshift[i] = car[g_file->downshiftKey].get<float>();
+            outOverride.rpmUpshift[i] = car[g_file->upshiftKey].get<float>();
+        }
+        return;
+    }
+
+    for (auto &gear : car["gears"].items())
+    {
+        std::string gearName = gear.value()["gear"].get<std::string>();
+        int gearIdx = gearName == "R" ? 0 : gearName == "N" ? 1 : atoi(gearName.c_str()) + 1;
+        outOverride.rpmDownshift[gearIdx] = gear.value()[g_file->downshiftKey].get<float>();
+        outOverride.rpmUpshift[gearIdx] = gear.value()[g_file->upshiftKey].get<float>();
+    }
+}
+
+int checkGearName(std::string_view gearName, int expected)
+{
+    int gearIdx = overrides::parseGearName(gearName);
+    if (gearIdx != expected)
+    {
+        LOG_ERROR("Gear \"%.*s\" should be at index %i, found %i", (int)gearName.size(), gearName.data(), expected,
+                  gearIdx);
+        return 1;
+    }
+    return 0;
+}
+
+double elapsedNs(std::chrono::steady_clock::time_point start)
+{
+    return std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+}
+
+// Compiles a copy of the file in tempDir, then checks that every car mapped from the compiled file is the one parsed
+// from the file, and measures reading the file each way.
+template <typename Car>
+int checkCompiledFile(const char *fileName, typename overrides::CarIndex<Car>::ParseCar parseCar,
+                      const std::filesystem::path &tempDir)
+{
+    std::string filePath = (tempDir / fileName).string();
+    std::string compiledFilePath = overrides::getCompiledFilePath(filePath);
+    std::filesystem::copy_file(fileName, filePath, std::filesystem::copy_options::overwrite_existing);
+
+    overrides::CarIndex<Car> parsedCars;
+    parsedCars.parse(filePath, parseCar);
+    if (!parsedCars.compile(filePath, compiledFilePath))
+    {
+        return 1;
+    }
+
+    int errorCount = 0;
+    overrides::CarIndex<Car> compiledCars;
+    size_t heapSize = g_heapSize;
+    auto start = std::chrono::steady_clock::now();
+    compiledCars.read(filePath, parseCar);
+    double compiledUs = elapsedNs(start) / 1000.0;
+    size_t compiledHeapSize = g_heapSize - heapSize;
+
+    overrides::CarIndex<Car> cars;
+    heapSize = g_heapSize;
+    start = std::chrono::steady_clock::now();
+    cars.parse(filePath, parseCar);
+    double parsedUs = elapsedNs(start) / 1000.0;
+    size_t parsedHeapSize = g_heapSize - heapSize;
+
+    if (!compiledCars.isCompiled() || compiledCars.getCarCount() != parsedCars.getCarCount())
+    {
+        LOG_ERROR("The compiled %s should have %zu cars", fileName, parsedCars.getCarCount());
+        errorCount++;
+    }
+
+    std::ifstream stream(fileName);
+    json root = json::parse(stream);
+    for (auto &car : root["cars"].items())
+    {
+        const Car *parsedCar = parsedCars.find(car.key());
+        const Car *compiledCar = compiledCars.find(car.key());
+        if (parsedCar && (compiledCar == nullptr || memcmp(parsedCar, compiledCar, sizeof(Car)) != 0))
+        {
+            LOG_ERROR("Car %s of the compiled %s doesn't match the file", car.key().c_str(), fileName);
+            errorCount++;
+        }
+    }
+
+    LOG_INFO("%-26s parsed %8.1f us, %7zu heap bytes; compiled %6.1f us, %7zu heap bytes, %7ju mapped bytes",
+             fileName, parsedUs, parsedHeapSize, compiledUs, compiledHeapSize,
+             (uintmax_t)std::filesystem::file_size(compiledFilePath));
+
+    // A file compiled from other fields of the same size is parsed again rather than misread.
+    overrides::CompiledFile compiledFile;
+    size_t recordSize = (std::filesystem::file_size(compiledFilePath) - sizeof(overrides::CompiledFileHeader)) /
+                        std::max<size_t>(compiledCars.getCarCount(), 1);
+    if (!compiledFile.open(compiledFilePath, filePath, recordSize, Car::kCompiledVersion))
+    {
+        LOG_ERROR("The compiled %s should have records of %zu bytes", fileName, recordSize);
+        return errorCount + 1;
+    }
+
+    std::vector<char> records(compiledFile.getRecords(),
+                              compiledFile.getRecords() + compiledFile.getRecordCount() * recordSize);
+    compiledFile.close();
+    overrides::CompiledFile::write(compiledFilePath, filePath, recordSize, Car::kCompiledVersion + 1, records);
+    compiledCars.read(filePath, parseCar);
+    if (compiledCars.isCompiled())
+    {
+        LOG_ERROR("The compiled %s was used after the fields of its cars changed", fileName);
+        errorCount++;
+    }
+
+    // A changed file is parsed again rather than using what was compiled from it.
+    parsedCars.compile(filePath, compiledFilePath);
+    {
+        std::ofstream file(filePath, std::ios::app);
+        file << "\n";
+    }
+    compiledCars.read(filePath, parseCar);
+    if (compiledCars.isCompiled())
+    {
+        LOG_ERROR("The compiled %s was used after the file changed", fileName);
+        errorCount++;
+    }
+
+    std::error_code error;
+    std::filesystem::remove(filePath, error);
+    std::filesystem::remove(compiledFilePath, error);
+    return errorCount;
+}
+
+void writeFile(const std::string &filePath, const char *contents)
+{
+    // Replaced in one step like editors do, so the index never reads it half written.
+    std::string tempPath = filePath + ".tmp";
+    {
+        std::ofstream file(tempPath, std::ios::trunc);
+        file << contents;
+    }
+    std::filesystem::rename(tempPath, filePath);
+}
+
+// Calls update() every frame for up to a second, like a plugin. Returns true if the cars were replaced.
+template <typename Car> bool waitForUpdate(overrides::WatchedCarIndex<Car> &cars)
+{
+    for (int frame = 0; frame < 1000; frame++)
+    {
+        if (cars.update())
+        {
+            return true;
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    return false;
+}
+
+// Edits an overrides file while it is watched, and checks that a valid edit replaces the cars and an invalid one keeps
+// them. Also measures the update() plugins call every frame.
+int checkReload(const std::filesystem::path &tempDir, int iterationCount)
+{
+    int errorCount = 0;
+    std::string filePath = (tempDir / "Reload.Overrides.json").string();
+    writeFile(filePath, R"({ "cars": { "car": { "rpmDownshift": 4000, "rpmUpshift": 6000 } } })");
+
+    overrides::WatchedCarIndex<overrides::CarOverride> cars;
+    cars.init(filePath, overrides::parseCarOverride);
+    auto rpmUpshift = [&cars]() {
+        const overrides::CarOverride *car = cars.find("car");
+        return car ? car->rpmUpshift[2] : 0.f;
+    };
+
+    if (!waitForUpdate(cars) || rpmUpshift() != 6000.f)
+    {
+        LOG_ERROR("The watched file wasn't read");
+        errorCount++;
+    }
+
+    size_t frameCount = (size_t)iterationCount * 100;
+    auto start = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < frameCount; i++)
+    {
+        cars.update();
+    }
+    double updateNs = elapsedNs(start) / (double)frameCount;
+
+    writeFile(filePath, R"({ "cars": { "car": { "rpmDownshift": 4000, "rpmUpshift": 6500 } } })");
+    if (!waitForUpdate(cars) || rpmUpshift() != 6500.f)
+    {
+        LOG_ERROR("The edited file wasn't read again");
+        errorCount++;
+    }
+
+    writeFile(filePath, R"({ "cars": { "car": { "rpmDownshift": 4000, "rpmUpshift": )");
+    if (waitForUpdate(cars) || rpmUpshift() != 6500.f)
+    {
+        LOG_ERROR("The cars were replaced by those of an invalid file");
+        errorCount++;
+    }
+
+    LOG_INFO("%-32s %8.1f ns", "WatchedCarIndex::update", updateNs);
+
+    cars.deinit();
+    std::error_code error;
+    std::filesystem::remove(filePath, error);
+    return errorCount;
+}
+
+// Usage: OverrideIndex [--iterations [value]]
+// Run from the Data folder. Reads the overrides files of iRacing, Assetto Corsa Rally and Live For Speed into the
+// index the plugins share, and checks the RPMs of every car against the file's document. Also measures finding a car
+// in the index, against copying it out of the document like the plugins used to when a car was entered.
+// Then compiles each file like CarDataCompiler, checks the compiled cars against the parsed ones, and compares the
+// time and memory it takes to read the file either way. Last, checks that a watched file is read again when edited.
+int main(int argc, char *argv[])
+{
+    LogManager::getSingleton().init();
+
+    const std::vector<std::string_view> args(argv + 1, argv + argc);
+    std::string iterationsStr(cmdLine::getOption(args, "--iterations"));
+    int iterationCount = iterationsStr.empty() ? 1000 : std::stoi(iterationsStr);
+
+    int errorCount = 0;
+    errorCount += checkGearName("R", 0);
+    errorCount += checkGearName("N", 1);
+    errorCount += checkGearName("1", 2);
+    errorCount += checkGearName("18", 19);
+    errorCount += checkGearName("19", -1);
+    errorCount += checkGearName("0", -1);
+    errorCount += checkGearName("-1", -1);
+    errorCount += checkGearName("2nd", -1);
+    errorCount += checkGearName("", -1);
+
+    for (const OverridesFile &file : kFiles)
+    {
+        g_file = &file;
+        overrides::CarIndex<overrides::CarOverride> carIndex;
+        if (!carIndex.parse(file.fileName, file.parseOverride) || carIndex.getCarCount() == 0)
+        {
+            LOG_ERROR("Could not read any car from %s", file.fileName);
+            errorCount++;
+            continue;
+        }
+
+        std::ifstream stream(file.fileName);
+        json root = json::parse(stream);
+        std::vector<std::string> carIds;
+        for (auto &car : root["cars"].items())
+        {
+            if (car.key() != "mods")
+            {
+                carIds.push_back(car.key());
+            }
+        }
+        for (auto &car : root["cars"]["mods"].items())
+        {
+            carIds.push_back(car.key());
+        }
+
+        for (const std::string &carId : carIds)
+        {
+            overrides::CarOverride expected;
+            parseOverrideFromDocument(root, carId, expected);
+            const overrides::CarOverride *carOverride = carIndex.find(carId);
+            if (carOverride == nullptr ||
+                memcmp(carOverride->rpmDownshift, expected.rpmDownshift, sizeof(expected.rpmDownshift)) != 0 ||
+                memcmp(carOverride->rpmUpshift, expected.rpmUpshift, sizeof(expected.rpmUpshift)) != 0)
+            {
+                LOG_ERROR("The RPMs of %s in %s don't match the file", carId.c_str(), file.fileName);
+                errorCount++;
+            }
+        }
+
+        if (carIndex.find("not_a_car") != nullptr)
+        {
+            LOG_ERROR("Found a car that isn't in %s", file.fileName);
+            errorCount++;
+        }
+
+        // What a plugin has when a car is entered: the id as it comes from the game.
+        std::vector<std::string_view> carIdViews(carIds.begin(), carIds.end());
+        size_t foundCount = 0;
+        auto start = std::chrono::steady_clock::now();
+        for (int i = 0; i < iterationCount; i++)
+        {
+            for (std::string_view carId : carIdViews)
+            {
+                foundCount += carIndex.find(carId) != nullptr;
+            }
+        }
+        double findNs = elapsedNs(start) / ((double)iterationCount * carIds.size());
+
+        float rpmSum = 0.f;
+        start = std::chrono::steady_clock::now();
+        for (int i = 0; i < iterationCount; i++)
+        {
+            for (const std::string &carId : carIds)
+            {
+                overrides::CarOverride carOverride;
+                parseOverrideFromDocument(root, carId, carOverride);
+                rpmSum += carOverride.rpmUpshift[2];
+            }
+        }
+        double documentNs = elapsedNs(start) / ((double)iterationCount * carIds.size());
+
+        LOG_INFO("%-26s %3zu cars: CarIndex::find %6.1f ns, from the document %8.1f ns (%zu, %.0f)", file.fileName,
+                 carIndex.getCarCount(), findNs, documentNs, foundCount, rpmSum);
+    }
+
+    std::filesystem::path tempDir = std::filesystem::temp_directory_path() / "OverrideIndex";
+    std::filesystem::create_directories(tempDir);
+    errorCount += checkCompiledFile<overrides::CarOverride>(kFiles[0].fileName, kFiles[0].parseOverride, tempDir);
+    errorCount += checkCompiledFile<overrides::CarOverride>(kFiles[1].fileName, kFiles[1].parseOverride, tempDir);
+    errorCount += checkCompiledFile<lfs::Car>(kFiles[2].fileName, lfs::parseCar, tempDir);
+    errorCount += checkReload(tempDir, iterationCount);
+
+    LogManager::getSingleton().deinit();
+    return errorCount == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,144 @@
+//
+// SliProSuperPro
+// A Shift Light Indicator controller
+// Copyright 2025 Fixfactory
+//
+// This file is part of SliProSuperPro.
+//
+// SliProSuperPro is free software: you can redistribute it and/or modify it under
+// the terms of the GNU General Public License as published by the Free
+// Software Foundation, either version 3 of the License, or any later version.
+//
+// SliProSuperPro is distributed in the hope that it will be useful, but WITHOUT
+// ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+// FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+// more details.
+//
+// You should have received a copy of the GNU General Public License along
+// with SliProSuperPro. If not, see <http://www.gnu.org/licenses/>.
+//
+
+#include <string>
+#include <vector>
+#include <string_view>
+#include <filesystem>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <cstdlib>
+
+#include "Log.h"
+#include "CommandLine.h"
+#include "PhysicsCache.h"
+
+const char *kGames[] = { "RichardBurnsRally_SSE.exe", "acr.exe" };
+
+plugin::PhysicsData makeCar(int game, int car)
+{
+    plugin::PhysicsData physicsData{};
+    physicsData.gearCount = 6 + car % 3;
+    physicsData.rpmLimit = 6000.f + (float)(car * 10 + game);
+    physicsData.rpmIdle = 900.f;
+    for (int i = 0; i < plugin::kMaxGearCount; i++)
+    {
+        physicsData.rpmDownshift[i] = physicsData.rpmLimit * 0.6f;
+        physicsData.rpmUpshift[i] = physicsData.rpmLimit * 0.95f;
+    }
+    snprintf(physicsData.carId, sizeof(physicsData.carId), "car_%i", car);
+    return physicsData;
+}
+
+int checkLastCar(const PhysicsCache &physicsCache, int game, int car)
+{
+    plugin::PhysicsData expected = makeCar(game, car);
+    const plugin::PhysicsData *physicsData = physicsCache.findLastCar(kGames[game]);
+    if (physicsData == nullptr || memcmp(physicsData, &expected, sizeof(expected)) != 0)
+    {
+        LOG_ERROR("The last car of %s should be car_%i, found %s", kGames[game], car,
+                  physicsData ? physicsData->carId : "none");
+        return 1;
+    }
+    return 0;
+}
+
+double elapsedUs(std::chrono::steady_clock::time_point start)
+{
+    return std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count();
+}
+
+// Usage: PhysicsCache [--cars [value]]
+// Stores the physics data of generated cars of two games in the controller's PhysicsCache, and checks that the last
+// car of each game is found again once the file is written and mapped, that storing a car again with the same values
+// leaves the file alone, and that storing it with new values makes it the game's last car. Also measures mapping the
+// file and finding a game's last car in it.
+int main(int argc, char *argv[])
+{
+    LogManager::getSingleton().init();
+
+    const std::vector<std::string_view> args(argv + 1, argv + argc);
+    std::string carsStr(cmdLine::getOption(args, "--cars"));
+    int carCount = carsStr.empty() ? 500 : std::stoi(carsStr);
+
+    std::filesystem::path filePath = std::filesystem::temp_directory_path() / "PhysicsCache.cache";
+    std::error_code error;
+    std::filesystem::remove(filePath, error);
+
+    int errorCount = 0;
+    PhysicsCache physicsCache;
+    physicsCache.init(filePath.string());
+    for (int car = 0; car < carCount; car++)
+    {
+        physicsCache.store(kGames[0], makeCar(0, car));
+        physicsCache.store(kGames[1], makeCar(1, car));
+    }
+    physicsCache.deinit();
+
+    auto start = std::chrono::steady_clock::now();
+    physicsCache.init(filePath.string());
+    double initUs = elapsedUs(start);
+
+    start = std::chrono::steady_clock::now();
+    errorCount += checkLastCar(physicsCache, 0, carCount - 1);
+    errorCount += checkLastCar(physicsCache, 1, carCount - 1);
+    double findUs = elapsedUs(start) / 2.0;
+
+    LOG_INFO("%-32s %8.1f us, %zu cars, %ju bytes", "PhysicsCache::init", initUs, physicsCache.getCarCount(),
+             (uintmax_t)std::filesystem::file_size(filePath));
+    LOG_INFO("%-32s %8.1f us", "PhysicsCache::findLastCar", findUs);
+
+    if (physicsCache.getCarCount() != (size_t)carCount * 2)
+    {
+        LOG_ERROR("Found %zu cars instead of %i", physicsCache.getCarCount(), carCount * 2);
+        errorCount++;
+    }
+
+    // The same values again change nothing, so the file isn't written on exit.
+    auto writeTime = std::filesystem::last_write_time(filePath);
+    physicsCache.store(kGames[0], makeCar(0, carCount - 1));
+    physicsCache.deinit();
+    if (std::filesystem::last_write_time(filePath) != writeTime)
+    {
+        LOG_ERROR("The file was written again without changes");
+        errorCount++;
+    }
+
+    // An older car driven again becomes the game's last car, without adding a record.
+    physicsCache.init(filePath.string());
+    plugin::PhysicsData changedCar = makeCar(0, 0);
+    physicsCache.store(kGames[0], changedCar);
+    physicsCache.deinit();
+    physicsCache.init(filePath.string());
+    errorCount += checkLastCar(physicsCache, 0, 0);
+    errorCount += checkLastCar(physicsCache, 1, carCount - 1);
+    if (physicsCache.getCarCount() != (size_t)carCount * 2)
+    {
+        LOG_ERROR("Found %zu cars instead of %i after storing a car again", physicsCache.getCarCount(), carCount * 2);
+        errorCount++;
+    }
+    physicsCache.deinit();
+
+    std::filesystem::remove(filePath, error);
+
+    LogManager::getSingleton().deinit();
+    return errorCount == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
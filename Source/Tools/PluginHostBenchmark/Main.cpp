@@ -0,0 +1,352 @@
+//
+// SliProSuperPro
+// A Shift Light Indicator controller
+// Copyright 2025 Fixfactory
+//
+// This file is part of SliProSuperPro.
+//
+// SliProSuperPro is free software: you can redistribute it and/or modify it under
+// the terms of the GNU General Public License as published by the Free
+// Software Foundation, either version 3 of the License, or any later version.
+//
+// SliProSuperPro is distributed in the hope that it will be useful, but WITHOUT
+// ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+// FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+// more details.
+//
+// You should have received a copy of the GNU General Public License along
+// with SliProSuperPro. If not, see <http://www.gnu.org/licenses/>.
+//
+
+#include <string>
+#include <vector>
+#include <string_view>
+#include <thread>
+#include <chrono>
+#include <atomic>
+#include <memory>
+#include <algorithm>
+#include <cstdlib>
+
+#include "Log.h"
+#include "CommandLine.h"
+#include "PluginLibrary.h"
+#include "PluginHostProtocol.h"
+#include "Timing.h"
+
+// The controller gives the host this long to publish a frame before using the last one, like PluginHostClient.
+const std::chrono::milliseconds kFrameWait{ 1 };
+
+long long nowNs()
+{
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch())
+        .count();
+}
+
+struct Latency
+{
+    double sumNs{ 0.0 };
+    double maxNs{ 0.0 };
+    int frameCount{ 0 };
+
+    void add(double ns)
+    {
+        sumNs += ns;
+        maxNs = std::max(maxNs, ns);
+        frameCount++;
+    }
+
+    void log(const char *name) const
+    {
+        LOG_INFO("%-24s avg %8.3f ms, max %8.3f ms over %i frames", name, frameCount ? sumNs / frameCount / 1e6 : 0.0,
+                 maxNs / 1e6, frameCount);
+    }
+};
+
+pluginHost::Frame makeFrame(int sequence)
+{
+    pluginHost::Frame frame{};
+    frame.fetchTimeNs = sequence;
+    frame.hasTelemetryData = true;
+    frame.telemetryData.gear = sequence;
+    return frame;
+}
+
+pluginHost::Frame makePhysicsFrame(int sequence, float rpmLimit)
+{
+    pluginHost::Frame frame = makeFrame(sequence);
+    frame.hasPhysicsData = true;
+    frame.physicsData.rpmLimit = rpmLimit;
+    return frame;
+}
+
+// Publishes more frames than the ring holds without reading any, like a controller that stalls, and checks that the
+// newest frames are the ones kept and that physics data isn't lost.
+int checkFullRing()
+{
+    int errorCount = 0;
+    auto ring = std::make_unique<pluginHost::Ring>();
+    constexpr int kPublishedCount = pluginHost::kFrameCount * 2 + 3;
+
+    pluginHost::publishFrame(*ring, makePhysicsFrame(0, 7000.f));
+    for (int sequence = 1; sequence < kPublishedCount; sequence++)
+    {
+        pluginHost::publishFrame(*ring, makeFrame(sequence));
+    }
+
+    std::vector<pluginHost::Frame> frames;
+    pluginHost::readFrames(*ring, [&frames](const pluginHost::Frame &frame) { frames.push_back(frame); });
+    if (frames.size() != pluginHost::kFrameCount || frames.back().telemetryData.gear != kPublishedCount - 1)
+    {
+        LOG_ERROR("The newest frames should be kept when the ring is full");
+        errorCount++;
+    }
+    if (std::none_of(frames.begin(), frames.end(), [](auto &frame) { return frame.physicsData.rpmLimit == 7000.f; }))
+    {
+        LOG_ERROR("The physics data of a dropped frame was lost");
+        errorCount++;
+    }
+
+    // Newer physics data wins over the one of a dropped frame.
+    pluginHost::publishFrame(*ring, makePhysicsFrame(0, 7000.f));
+    pluginHost::publishFrame(*ring, makePhysicsFrame(1, 8000.f));
+    for (int sequence = 2; sequence < kPublishedCount; sequence++)
+    {
+        pluginHost::publishFrame(*ring, makeFrame(sequence));
+    }
+
+    float rpmLimit = 0.f;
+    pluginHost::readFrames(*ring, [&rpmLimit](const pluginHost::Frame &frame) {
+        if (frame.hasPhysicsData)
+        {
+            rpmLimit = frame.physicsData.rpmLimit;
+        }
+    });
+    if (rpmLimit != 8000.f)
+    {
+        LOG_ERROR("The physics data of a dropped frame replaced newer physics data");
+        errorCount++;
+    }
+
+    return errorCount;
+}
+
+// A plugin that only returns physics data when asked, like ACC, whose physics data changes while it sends telemetry.
+// Checks that the host asks for it again, and that the controller has none until the new one arrives, so
+// PhysicsManager keeps asking instead of keeping the old one.
+int checkPhysicsGeneration()
+{
+    int errorCount = 0;
+    auto ring = std::make_unique<pluginHost::Ring>();
+    pluginHost::PhysicsDataRequest request;
+    pluginHost::ReceivedPhysicsData received;
+
+    int physicsGeneration = 1;
+    float rpmLimit = 7000.f;
+    int loadingFrameCount = 0;
+    int requestCount = 0;
+
+    // Publishes a frame like HostManager::update, then reads it like PluginHostClient::readFrames.
+    auto runFrame = [&](int sequence) {
+        pluginHost::Frame frame = makeFrame(sequence);
+        frame.telemetryData.physicsGeneration = physicsGeneration;
+        if (request.update(frame.hasTelemetryData, frame.telemetryData))
+        {
+            requestCount++;
+            frame.hasPhysicsData = loadingFrameCount-- <= 0;
+            frame.physicsData.rpmLimit = rpmLimit;
+            request.setReceived(frame.hasPhysicsData);
+        }
+        pluginHost::publishFrame(*ring, frame);
+        pluginHost::readFrames(*ring, [&received](const pluginHost::Frame &frame) { received.add(frame, false); });
+    };
+
+    for (int sequence = 0; sequence < 10; sequence++)
+    {
+        runFrame(sequence);
+    }
+    if (requestCount != 1 || !received.hasPhysicsData() || received.getPhysicsData().rpmLimit != 7000.f)
+    {
+        LOG_ERROR("The physics data should be asked for once when telemetry starts");
+        errorCount++;
+    }
+
+    // The plugin rebuilds its physics data, and takes a few frames to have it.
+    physicsGeneration++;
+    rpmLimit = 8000.f;
+    loadingFrameCount = 3;
+    requestCount = 0;
+    for (int sequence = 10; sequence < 13; sequence++)
+    {
+        runFrame(sequence);
+        if (received.hasPhysicsData())
+        {
+            LOG_ERROR("The old physics data was kept after the plugin changed its physics generation");
+            errorCount++;
+        }
+    }
+    for (int sequence = 13; sequence < 20; sequence++)
+    {
+        runFrame(sequence);
+    }
+    if (requestCount != 4 || !received.hasPhysicsData() || received.getPhysicsData().rpmLimit != 8000.f)
+    {
+        LOG_ERROR("The physics data should be asked for until the plugin has the new one");
+        errorCount++;
+    }
+
+    // A full ring doesn't pass the physics data of a dropped frame on to frames of a newer generation.
+    pluginHost::publishFrame(*ring, makePhysicsFrame(20, 9000.f));
+    for (int sequence = 21; sequence < (int)pluginHost::kFrameCount * 2 + 21; sequence++)
+    {
+        pluginHost::Frame frame = makeFrame(sequence);
+        frame.telemetryData.physicsGeneration = physicsGeneration + 1;
+        pluginHost::publishFrame(*ring, frame);
+    }
+    pluginHost::readFrames(*ring, [&received](const pluginHost::Frame &frame) { received.add(frame, false); });
+    if (received.hasPhysicsData())
+    {
+        LOG_ERROR("The physics data of an older generation was moved to a newer frame");
+        errorCount++;
+    }
+
+    return errorCount;
+}
+
+// Publishes frames as fast as possible while they are read with pauses, and checks that every frame read is whole and
+// newer than the one before.
+int checkConcurrentFrames(std::chrono::duration<float> duration)
+{
+    auto ring = std::make_unique<pluginHost::Ring>();
+    std::atomic<bool> stop{ false };
+    std::thread host([&ring, &stop]() {
+        for (int sequence = 1; !stop.load(); sequence++)
+        {
+            pluginHost::publishFrame(*ring, makeFrame(sequence));
+        }
+    });
+
+    int errorCount = 0;
+    int frameCount = 0;
+    int lastSequence = 0;
+    auto endTime = std::chrono::steady_clock::now() + duration;
+    for (int read = 0; std::chrono::steady_clock::now() < endTime; read++)
+    {
+        frameCount += pluginHost::readFrames(*ring, [&](const pluginHost::Frame &frame) {
+            if (frame.telemetryData.gear != frame.fetchTimeNs || frame.telemetryData.gear <= lastSequence)
+            {
+                errorCount++;
+            }
+            lastSequence = frame.telemetryData.gear;
+        });
+
+        if (read % 16 == 0)
+        {
+            std::this_thread::sleep_for(std::chrono::microseconds(100));
+        }
+    }
+
+    stop.store(true);
+    host.join();
+
+    if (errorCount > 0)
+    {
+        LOG_ERROR("%i of %i frames read were torn or out of order", errorCount, frameCount);
+    }
+    return errorCount;
+}
+
+// The data of an in-process plugin is used as soon as the call returns.
+Latency measureInProcess(PluginLibrary &plugin, std::chrono::duration<float> duration)
+{
+    Latency latency;
+    auto endTime = std::chrono::steady_clock::now() + duration;
+    while (std::chrono::steady_clock::now() < endTime)
+    {
+        long long fetchTimeNs = nowNs();
+        plugin::TelemetryData telemetryData{};
+        plugin.getTelemetryData(&telemetryData, sizeof(telemetryData));
+        latency.add((double)(nowNs() - fetchTimeNs));
+        std::this_thread::sleep_for(timing::kMinFrameTime);
+    }
+    return latency;
+}
+
+// A thread calls the plugin and publishes frames like the plugin host, and both run at the application's frame rate.
+// The latency is from the host calling the plugin to the controller reading the newest frame.
+Latency measurePluginHost(PluginLibrary &plugin, std::chrono::duration<float> duration)
+{
+    auto ring = std::make_unique<pluginHost::Ring>();
+    std::atomic<bool> stop{ false };
+    std::thread host([&]() {
+        while (!stop.load())
+        {
+            pluginHost::Frame frame{};
+            frame.fetchTimeNs = nowNs();
+            frame.hasTelemetryData = plugin.getTelemetryData(&frame.telemetryData, sizeof(frame.telemetryData));
+            pluginHost::publishFrame(*ring, frame);
+            std::this_thread::sleep_for(timing::kMinFrameTime);
+        }
+    });
+
+    Latency latency;
+    auto endTime = std::chrono::steady_clock::now() + duration;
+    while (std::chrono::steady_clock::now() < endTime)
+    {
+        long long fetchTimeNs = 0;
+        auto onFrame = [&fetchTimeNs](const pluginHost::Frame &frame) { fetchTimeNs = frame.fetchTimeNs; };
+        if (pluginHost::readFrames(*ring, onFrame) == 0)
+        {
+            std::this_thread::sleep_for(kFrameWait);
+            pluginHost::readFrames(*ring, onFrame);
+        }
+        if (fetchTimeNs != 0)
+        {
+            latency.add((double)(nowNs() - fetchTimeNs));
+        }
+        std::this_thread::sleep_for(timing::kMinFrameTime);
+    }
+
+    stop.store(true);
+    host.join();
+    return latency;
+}
+
+// Usage: PluginHostBenchmark --plugin [path] [--seconds [value]]
+// Checks the frame ring the plugin host streams frames through: a full ring keeps the newest frames and their physics
+// data, physics data is fetched again when the plugin changes its physics generation, and frames read while they are
+// published are whole. Then compares the latency of a plugin called in-process
+// with the latency of the same plugin called from a thread that publishes its frames through the ring.
+int main(int argc, char *argv[])
+{
+    LogManager::getSingleton().init();
+
+    const std::vector<std::string_view> args(argv + 1, argv + argc);
+    std::string libraryPath(cmdLine::getOption(args, "--plugin"));
+    std::string seconds(cmdLine::getOption(args, "--seconds"));
+    auto duration = std::chrono::duration<float>(seconds.empty() ? 2.f : std::stof(seconds));
+
+    int errorCount = 0;
+    errorCount += checkFullRing();
+    errorCount += checkPhysicsGeneration();
+    errorCount += checkConcurrentFrames(duration / 4);
+
+    if (!libraryPath.empty())
+    {
+        PluginLibrary plugin;
+        if (!plugin.load(libraryPath))
+        {
+            LogManager::getSingleton().deinit();
+            return EXIT_FAILURE;
+        }
+
+        plugin.setGameIsRunning(true, "");
+        measureInProcess(plugin, duration / 2).log("In-process");
+        measurePluginHost(plugin, duration / 2).log("Plugin host ring");
+        plugin.setGameIsRunning(false, "");
+        plugin.unload();
+    }
+
+    LogManager::getSingleton().deinit();
+    return errorCount == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
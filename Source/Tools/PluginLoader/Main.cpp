@@ -0,0 +1,115 @@
+//
+// SliProSuperPro
+// A Shift Light Indicator controller
+// Copyright 2025 Fixfactory
+//
+// This file is part of SliProSuperPro.
+//
+// SliProSuperPro is free software: you can redistribute it and/or modify it under
+// the terms of the GNU General Public License as published by the Free
+// Software Foundation, either version 3 of the License, or any later version.
+//
+// SliProSuperPro is distributed in the hope that it will be useful, but WITHOUT
+// ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+// FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+// more details.
+//
+// You should have received a copy of the GNU General Public License along
+// with SliProSuperPro. If not, see <http://www.gnu.org/licenses/>.
+//
+
+#include <string>
+#include <vector>
+#include <string_view>
+#include <thread>
+#include <chrono>
+#include <cstdlib>
+
+#include "Log.h"
+#include "CommandLine.h"
+#include "PluginLibrary.h"
+
+const std::chrono::milliseconds kFrameInterval{ 10 };
+
+// Usage: PluginLoader --plugin [path] [--gamePath [path]] [--seconds [value]] [--expectTelemetry]
+// Loads a plugin the same way SliProSuperPro does, activates it and polls it for a while. Used to check plugin
+// libraries on machines without the game or a device, such as a Linux box receiving forwarded telemetry.
+int main(int argc, char *argv[])
+{
+    LogManager::getSingleton().init();
+
+    const std::vector<std::string_view> args(argv + 1, argv + argc);
+    std::string libraryPath(cmdLine::getOption(args, "--plugin"));
+    std::string gamePath(cmdLine::getOption(args, "--gamePath"));
+    std::string seconds(cmdLine::getOption(args, "--seconds"));
+    bool expectTelemetry = cmdLine::hasOption(args, "--expectTelemetry");
+
+    if (libraryPath.empty())
+    {
+        LOG_ERROR("Missing --plugin [path]");
+        LogManager::getSingleton().deinit();
+        return EXIT_FAILURE;
+    }
+
+    PluginLibrary plugin;
+    if (!plugin.load(libraryPath))
+    {
+        LogManager::getSingleton().deinit();
+        return EXIT_FAILURE;
+    }
+
+    LOG_INFO("Loaded %s (interface version %i) for %s", libraryPath.c_str(), plugin.interfaceVersion,
+             plugin.gameExecFileName.c_str());
+
+    plugin.setGameIsRunning(true, gamePath);
+
+    // Same rules as PhysicsManager: physics data is fetched when telemetry starts, and again every frame until the
+    // plugin has it, or every frame if the plugin asks.
+    bool physicsDataEveryFrame = plugin.getPhysicsDataEveryFrame();
+    auto duration = std::chrono::duration<float>(seconds.empty() ? 0.f : std::stof(seconds));
+    auto endTime = std::chrono::steady_clock::now() + duration;
+
+    int frameCount = 0;
+    int telemetryFrameCount = 0;
+    bool wasReceivingTelemetry = false;
+    bool isPhysicsDataPending = false;
+    do
+    {
+        plugin::TelemetryData telemetryData{};
+        bool hasTelemetryData = plugin.getTelemetryData(&telemetryData, sizeof(telemetryData));
+        if (hasTelemetryData)
+        {
+            telemetryFrameCount++;
+        }
+
+        isPhysicsDataPending = hasTelemetryData && (isPhysicsDataPending || !wasReceivingTelemetry);
+        if (physicsDataEveryFrame || isPhysicsDataPending)
+        {
+            plugin::PhysicsData physicsData{};
+            if (plugin.getPhysicsData(&physicsData, sizeof(physicsData)) && !physicsDataEveryFrame)
+            {
+                LOG_INFO("Physics data: %i gears, rpm limit %.0f", physicsData.gearCount, physicsData.rpmLimit);
+                isPhysicsDataPending = false;
+            }
+        }
+
+        if (hasTelemetryData && !wasReceivingTelemetry)
+        {
+            LOG_INFO("Telemetry data: gear %i, rpm %.0f, speed %.0f kph", telemetryData.gear, telemetryData.rpm,
+                     telemetryData.speedKph);
+        }
+        wasReceivingTelemetry = hasTelemetryData;
+
+        frameCount++;
+        std::this_thread::sleep_for(kFrameInterval);
+    } while (std::chrono::steady_clock::now() < endTime);
+
+    plugin.setGameIsRunning(false, "");
+    plugin.unload();
+
+    LOG_INFO("Received telemetry data in %i of %i frames", telemetryFrameCount, frameCount);
+
+    int exitCode = (expectTelemetry && telemetryFrameCount == 0) ? EXIT_FAILURE : EXIT_SUCCESS;
+    LogManager::getSingleton().deinit();
+    return exitCode;
+}
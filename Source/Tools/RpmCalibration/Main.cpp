@@ -0,0 +1,193 @@
+//
+// SliProSuperPro
+// A Shift Light Indicator controller
+// Copyright 2025 Fixfactory
+//
+// This file is part of SliProSuperPro.
+//
+// SliProSuperPro is free software: you can redistribute it and/or modify it under
+// the terms of the GNU General Public License as published by the Free
+// Software Foundation, either version 3 of the License, or any later version.
+//
+// SliProSuperPro is distributed in the hope that it will be useful, but WITHOUT
+// ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+// FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+// more details.
+//
+// You should have received a copy of the GNU General Public License along
+// with SliProSuperPro. If not, see <http://www.gnu.org/licenses/>.
+//
+
+#include <string>
+#include <vector>
+#include <string_view>
+#include <filesystem>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+
+#include "Log.h"
+#include "CommandLine.h"
+#include "RpmCalibrator.h"
+
+const float kFrameTime = 1.f / 60.f;
+
+// The simulated car. The limiter cuts the engine at kLimiterRpm and lets it fall back by kLimiterDrop, kLimiterHz
+// times a second.
+const float kRatios[] = { 3.2f, 2.3f, 1.8f, 1.45f, 1.2f, 1.0f };
+const int kForwardGearCount = (int)std::size(kRatios);
+const float kFinalDrive = 3.5f;
+const float kWheelRadius = 0.33f;
+const float kLimiterRpm = 7200.f;
+const float kLimiterDrop = 250.f;
+const float kLimiterHz = 8.f;
+
+float rpmPerKph(int forwardGear)
+{
+    return kRatios[forwardGear] * kFinalDrive / (kWheelRadius * 3.6f) * 60.f / (2.f * 3.14159265f);
+}
+
+// Full throttle from a standstill through every gear, sitting on the limiter in the gears in isOnLimiter and
+// shifting early in the others.
+int simulateRun(RpmCalibrator &calibrator, const bool *isOnLimiter, double &outSampleNs)
+{
+    int sampleCount = 0;
+    float speedKph = 5.f;
+    std::chrono::nanoseconds sampleTime{ 0 };
+    for (int forwardGear = 0; forwardGear < kForwardGearCount; forwardGear++)
+    {
+        float limiterTime = 0.f;
+        float shiftRpm = isOnLimiter[forwardGear] ? kLimiterRpm : 6000.f;
+        for (float time = 0.f; time < 30.f; time += kFrameTime)
+        {
+            plugin::TelemetryData telemetryData{};
+            telemetryData.gear = forwardGear + 2;
+            telemetryData.rpm = speedKph * rpmPerKph(forwardGear);
+            if (telemetryData.rpm >= shiftRpm && !isOnLimiter[forwardGear])
+            {
+                break;
+            }
+
+            if (telemetryData.rpm >= kLimiterRpm)
+            {
+                // The wheels follow the engine while it bounces off the limiter.
+                float phase = std::fmod(limiterTime * kLimiterHz, 1.f);
+                telemetryData.rpm = kLimiterRpm - kLimiterDrop * (phase < 0.5f ? phase * 2.f : 2.f - phase * 2.f);
+                speedKph = telemetryData.rpm / rpmPerKph(forwardGear);
+                limiterTime += kFrameTime;
+                if (limiterTime > 1.5f)
+                {
+                    speedKph = kLimiterRpm / rpmPerKph(forwardGear);
+                    break;
+                }
+            }
+            else
+            {
+                speedKph += 30.f / (float)(forwardGear + 2) * kFrameTime;
+            }
+            telemetryData.speedKph = speedKph;
+
+            auto start = std::chrono::steady_clock::now();
+            calibrator.addSample(telemetryData, kFrameTime);
+            sampleTime += std::chrono::steady_clock::now() - start;
+            sampleCount++;
+        }
+    }
+
+    outSampleNs = (double)sampleTime.count() / (double)sampleCount;
+    return sampleCount;
+}
+
+bool isClose(float value, float expected, float tolerance)
+{
+    return std::abs(value - expected) <= std::abs(expected) * tolerance;
+}
+
+// Usage: RpmCalibration [--runs [value]]
+// Drives a simulated car through its gears, some of them up to the rev limiter, with the controller's RpmCalibrator
+// listening. Then checks that the limiter and the RPM drop of each upshift learned from it are right once saved and
+// read back, and that they replace wrong physics data like a plugin with bad RPM values would report. A car never driven
+// up to its limiter keeps the plugin's limit and upshift RPMs.
+int main(int argc, char *argv[])
+{
+    LogManager::getSingleton().init();
+
+    const std::vector<std::string_view> args(argv + 1, argv + argc);
+    std::string runsStr(cmdLine::getOption(args, "--runs"));
+    int runs = runsStr.empty() ? 5 : std::stoi(runsStr);
+
+    std::filesystem::path filePath = std::filesystem::temp_directory_path() / "RpmCalibration.json";
+    std::error_code error;
+    std::filesystem::remove(filePath, error);
+
+    RpmCalibrator calibrator;
+    calibrator.init(filePath.string());
+    calibrator.selectCar("simulated");
+
+    int sampleCount = 0;
+    double sampleNs = 0.0;
+    for (int run = 0; run < runs; run++)
+    {
+        const bool isOnLimiter[kForwardGearCount] = { true, true, run % 2 == 0, false, false, false };
+        sampleCount += simulateRun(calibrator, isOnLimiter, sampleNs);
+    }
+
+    // A car never driven up to its limiter.
+    calibrator.selectCar("shortShifted");
+    for (int run = 0; run < runs; run++)
+    {
+        const bool isOnLimiter[kForwardGearCount] = {};
+        simulateRun(calibrator, isOnLimiter, sampleNs);
+    }
+    LOG_INFO("%-32s %8.1f ns/sample, %i samples", "RpmCalibrator::addSample", sampleNs, sampleCount);
+    calibrator.deinit();
+
+    // What a plugin with wrong RPM values reports.
+    plugin::PhysicsData physicsData{};
+    physicsData.gearCount = kForwardGearCount + 2;
+    physicsData.rpmLimit = 9000.f;
+    for (int i = 0; i < plugin::kMaxGearCount; i++)
+    {
+        physicsData.rpmDownshift[i] = 5000.f;
+        physicsData.rpmUpshift[i] = 8800.f;
+    }
+
+    calibrator.init(filePath.string());
+    calibrator.selectCar("simulated");
+    int errorCount = calibrator.apply(physicsData) ? 0 : 1;
+
+    // The peaks seen at 60 Hz are a little below the limiter.
+    bool isValid = isClose(physicsData.rpmLimit, kLimiterRpm, 0.01f);
+    LOG_INFO("RPM limit %.0f, expected %.0f%s", physicsData.rpmLimit, kLimiterRpm, isValid ? "" : "  <- wrong");
+    errorCount += isValid ? 0 : 1;
+
+    for (int gear = 3; gear < physicsData.gearCount; gear++)
+    {
+        float drop = physicsData.rpmDownshift[gear] / physicsData.rpmUpshift[gear - 1];
+        float expectedDrop = kRatios[gear - 2] / kRatios[gear - 3];
+        isValid = isClose(drop, expectedDrop, 0.005f) && physicsData.rpmUpshift[gear - 1] < physicsData.rpmLimit;
+        LOG_INFO("Gear %i: upshift %.0f, next gear starts at %.0f, drop %.3f, expected %.3f%s", gear - 2,
+                 physicsData.rpmUpshift[gear - 1], physicsData.rpmDownshift[gear], drop, expectedDrop,
+                 isValid ? "" : "  <- wrong");
+        errorCount += isValid ? 0 : 1;
+    }
+
+    // Without the limiter, the plugin's limit and upshifts stay.
+    physicsData.rpmLimit = 9000.f;
+    for (int i = 0; i < plugin::kMaxGearCount; i++)
+    {
+        physicsData.rpmUpshift[i] = 8800.f;
+    }
+    calibrator.selectCar("shortShifted");
+    errorCount += calibrator.apply(physicsData) ? 0 : 1;
+    isValid = physicsData.rpmLimit == 9000.f && physicsData.rpmUpshift[2] == 8800.f;
+    LOG_INFO("Short shifted: RPM limit %.0f, upshift %.0f, expected 9000, 8800%s", physicsData.rpmLimit,
+             physicsData.rpmUpshift[2], isValid ? "" : "  <- wrong");
+    errorCount += isValid ? 0 : 1;
+
+    calibrator.deinit();
+    std::filesystem::remove(filePath, error);
+
+    LogManager::getSingleton().deinit();
+    return errorCount == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
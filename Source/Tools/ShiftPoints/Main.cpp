@@ -0,0 +1,156 @@
+//
+// SliProSuperPro
+// A Shift Light Indicator controller
+// Copyright 2025 Fixfactory
+//
+// This file is part of SliProSuperPro.
+//
+// SliProSuperPro is free software: you can redistribute it and/or modify it under
+// the terms of the GNU General Public License as published by the Free
+// Software Foundation, either version 3 of the License, or any later version.
+//
+// SliProSuperPro is distributed in the hope that it will be useful, but WITHOUT
+// ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+// FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+// more details.
+//
+// You should have received a copy of the GNU General Public License along
+// with SliProSuperPro. If not, see <http://www.gnu.org/licenses/>.
+//
+
+#include <string>
+#include <vector>
+#include <string_view>
+#include <cmath>
+#include <cstring>
+#include <cstdlib>
+
+#include "Log.h"
+#include "CommandLine.h"
+#include "MappedFile.h"
+#include "NGP.h"
+#include "LspParser.h"
+#include "ShiftPointSolver.h"
+
+// Torque rises to its peak, then falls linearly: torque = kLineTorque - kLineSlope * rpm.
+const float kPeakRpm = 3000.f;
+const float kLineTorque = 520.f;
+const float kLineSlope = 0.04f;
+
+const float kRatios[] = { 3.5f, 2.4f, 1.8f, 1.4f, 1.15f, 0.95f };
+const int kForwardGearCount = (int)std::size(kRatios);
+
+plugin::PhysicsData makeLinearEngine(float rpmLimit)
+{
+    plugin::PhysicsData physicsData{};
+    physicsData.gearCount = kForwardGearCount + 2;
+    physicsData.rpmLimit = rpmLimit;
+    for (int i = 0; i < kForwardGearCount; i++)
+    {
+        physicsData.gearRatio[i + 2] = kRatios[i];
+    }
+
+    for (float rpm = 1000.f; rpm <= 9000.f; rpm += 500.f)
+    {
+        float torque = rpm < kPeakRpm ? 250.f + (rpm - 1000.f) * 0.0575f : kLineTorque - kLineSlope * rpm;
+        physicsData.torqueCurveRpm[physicsData.torqueCurvePointCount] = rpm;
+        physicsData.torqueCurveTorque[physicsData.torqueCurvePointCount++] = torque;
+    }
+    return physicsData;
+}
+
+// Where torque(rpm) * ratio = torque(rpm * nextRatio / ratio) * nextRatio on the falling line.
+float expectedUpshift(float ratio, float nextRatio)
+{
+    float drop = nextRatio / ratio;
+    return kLineTorque * (ratio - nextRatio) / (kLineSlope * (ratio - drop * nextRatio));
+}
+
+int checkLinearEngine(float rpmLimit)
+{
+    plugin::PhysicsData physicsData = makeLinearEngine(rpmLimit);
+    ShiftPointSolver solver;
+    if (!solver.apply(physicsData) || !solver.apply(physicsData))
+    {
+        LOG_ERROR("No shift points computed with a rev limit of %.0f", rpmLimit);
+        return 1;
+    }
+
+    int errorCount = 0;
+    for (int i = 0; i + 1 < kForwardGearCount; i++)
+    {
+        float expected = std::min<float>(expectedUpshift(kRatios[i], kRatios[i + 1]), rpmLimit);
+        float upshift = physicsData.rpmUpshift[i + 2];
+        float downshift = physicsData.rpmDownshift[i + 3];
+        bool isValid = std::abs(upshift - expected) < 1.f &&
+                       std::abs(downshift - expected * kRatios[i + 1] / kRatios[i]) < 1.f;
+        LOG_INFO("Gear %i: upshift %7.1f, expected %7.1f, next gear starts at %7.1f%s", i + 1, upshift, expected,
+                 downshift, isValid ? "" : "  <- wrong");
+        errorCount += isValid ? 0 : 1;
+    }
+    return errorCount;
+}
+
+int printLsp(const std::string &path)
+{
+    MappedFile file;
+    if (!file.open(path))
+    {
+        LOG_ERROR("Could not open file %s", path.c_str());
+        return 1;
+    }
+
+    rbrNgp::ngp::CarPhysics carPhysics{};
+    rbrNgp::ngp::parseCommon(file.getData(), file.getSize(), carPhysics);
+
+    plugin::PhysicsData physicsData{};
+    physicsData.gearCount = carPhysics.drive.numberOfGears;
+    physicsData.rpmLimit = carPhysics.controlUnit.rpmLimit;
+    memcpy(physicsData.gearRatio, carPhysics.drive.gearRatio, sizeof(carPhysics.drive.gearRatio));
+    physicsData.torqueCurvePointCount = carPhysics.engine.torqueCurvePointCount;
+    memcpy(physicsData.torqueCurveRpm, carPhysics.engine.torqueCurveRpm, sizeof(carPhysics.engine.torqueCurveRpm));
+    memcpy(physicsData.torqueCurveTorque, carPhysics.engine.torqueCurveTorque,
+           sizeof(carPhysics.engine.torqueCurveTorque));
+
+    float rpmDownshift[plugin::kMaxGearCount];
+    float rpmUpshift[plugin::kMaxGearCount];
+    if (!ShiftPointSolver::solve(physicsData, rpmDownshift, rpmUpshift))
+    {
+        LOG_ERROR("No shift points computed from %s", path.c_str());
+        return 1;
+    }
+
+    for (int gear = 2; gear < physicsData.gearCount && gear < (int)rbrNgp::ngp::kGearCount; gear++)
+    {
+        LOG_INFO("Gear %i: ratio %5.2f, control unit %5.0f to %5.0f, computed %5.0f to %5.0f", gear - 1,
+                 carPhysics.drive.gearRatio[gear], carPhysics.controlUnit.gearDownShift[gear],
+                 carPhysics.controlUnit.gearUpShift[gear], rpmDownshift[gear], rpmUpshift[gear]);
+    }
+    return 0;
+}
+
+// Usage: ShiftPoints [--lsp [path]]
+// Prints the shift points SliProSuperPro computes for an RBR car from its common.lsp, next to the ones of the car's
+// automatic gearbox. Without --lsp, checks the solver against an engine whose torque falls linearly past its peak,
+// where the best shift points are known exactly, with and without the rev limiter cutting them off.
+int main(int argc, char *argv[])
+{
+    LogManager::getSingleton().init();
+
+    const std::vector<std::string_view> args(argv + 1, argv + argc);
+    std::string lspPath(cmdLine::getOption(args, "--lsp"));
+
+    int errorCount = 0;
+    if (!lspPath.empty())
+    {
+        errorCount = printLsp(lspPath);
+    }
+    else
+    {
+        errorCount += checkLinearEngine(8500.f);
+        errorCount += checkLinearEngine(7200.f);
+    }
+
+    LogManager::getSingleton().deinit();
+    return errorCount == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}